@@ -0,0 +1,308 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <string.h>
+#include <string>
+
+#include "cbor_decode.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#define CBOR_DECODE_MAX_DEPTH   16
+#define CBOR_INDEFINITE         31
+#define CBOR_BREAK              0xff
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+struct CborReader
+{
+    const uint8_t   *m_Data;
+    size_t          m_Len;
+    size_t          m_Pos;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static bool ReadBytes(CborReader &f_rd, size_t f_cnt, uint64_t *f_value)
+{
+    if (f_rd.m_Len - f_rd.m_Pos < f_cnt) return false;
+
+    *f_value = 0;
+    for (size_t i = 0; i < f_cnt; ++i) *f_value = (*f_value << 8) | f_rd.m_Data[f_rd.m_Pos++];
+
+    return true;
+}
+
+// --- argument of the initial byte (RFC 8949, 3.1). CBOR_INDEFINITE is returned as is.
+
+static bool ReadArgument(CborReader &f_rd, uint8_t f_info, uint64_t *f_value)
+{
+    if (f_info < 24 || f_info == CBOR_INDEFINITE)
+    {
+        *f_value = f_info;
+        return true;
+    }
+
+    switch (f_info)
+    {
+        case 24: return ReadBytes(f_rd, 1, f_value);
+        case 25: return ReadBytes(f_rd, 2, f_value);
+        case 26: return ReadBytes(f_rd, 4, f_value);
+        case 27: return ReadBytes(f_rd, 8, f_value);
+        default: return false;
+    }
+}
+
+static double HalfToDouble(uint16_t f_half)
+{
+    int     l_exp  = (f_half >> 10) & 0x1f;
+    int     l_mant = f_half & 0x3ff;
+    double  l_val;
+
+    if (l_exp == 0) l_val = ldexp(l_mant, -24);
+    else if (l_exp != 31) l_val = ldexp(l_mant + 1024, l_exp - 25);
+    else l_val = l_mant == 0 ? INFINITY : NAN;
+
+    return f_half & 0x8000 ? -l_val : l_val;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static cJSON *DecodeItem(CborReader &f_rd, int f_depth);
+
+// --- text and byte strings, possibly chunked
+
+static bool DecodeString(CborReader &f_rd, uint8_t f_major, uint8_t f_info, std::string &f_out)
+{
+    uint64_t l_len;
+
+    if (!ReadArgument(f_rd, f_info, &l_len)) return false;
+
+    if (f_info == CBOR_INDEFINITE)
+    {
+        while (f_rd.m_Pos < f_rd.m_Len && f_rd.m_Data[f_rd.m_Pos] != CBOR_BREAK)
+        {
+            uint8_t l_ib = f_rd.m_Data[f_rd.m_Pos++];
+
+            if ((l_ib >> 5) != f_major || (l_ib & 0x1f) == CBOR_INDEFINITE) return false;
+            if (!DecodeString(f_rd, f_major, l_ib & 0x1f, f_out)) return false;
+        }
+
+        if (f_rd.m_Pos >= f_rd.m_Len) return false;
+
+        f_rd.m_Pos++;
+        return true;
+    }
+
+    if (f_rd.m_Len - f_rd.m_Pos < l_len) return false;
+
+    const uint8_t *l_src = f_rd.m_Data + f_rd.m_Pos;
+    f_rd.m_Pos += l_len;
+
+    if (f_major == 3)
+    {
+        f_out.append((const char *)l_src, l_len);
+    }
+    else
+    {
+        static const char s_hex[] = "0123456789abcdef";
+
+        for (uint64_t i = 0; i < l_len; ++i)
+        {
+            f_out += s_hex[l_src[i] >> 4];
+            f_out += s_hex[l_src[i] & 0x0f];
+        }
+    }
+
+    return true;
+}
+
+// --- arrays and maps. Returns false when the container is complete.
+
+static bool HasNext(CborReader &f_rd, bool f_indefinite, uint64_t &f_left)
+{
+    if (!f_indefinite) return f_left-- > 0;
+
+    if (f_rd.m_Pos < f_rd.m_Len && f_rd.m_Data[f_rd.m_Pos] == CBOR_BREAK)
+    {
+        f_rd.m_Pos++;
+        return false;
+    }
+
+    return true;        // --- a missing break fails in DecodeItem()
+}
+
+static cJSON *DecodeItem(CborReader &f_rd, int f_depth)
+{
+    if (f_rd.m_Pos >= f_rd.m_Len || f_depth > CBOR_DECODE_MAX_DEPTH) return NULL;
+
+    uint8_t  l_ib    = f_rd.m_Data[f_rd.m_Pos++];
+    uint8_t  l_major = l_ib >> 5;
+    uint8_t  l_info  = l_ib & 0x1f;
+    uint64_t l_arg;
+
+    if (l_major == 7)
+    {
+        switch (l_info)
+        {
+            case 20: return cJSON_CreateFalse();
+            case 21: return cJSON_CreateTrue();
+            case 22:
+            case 23: return cJSON_CreateNull();
+            case 25:
+                if (!ReadBytes(f_rd, 2, &l_arg)) return NULL;
+                return cJSON_CreateNumber(HalfToDouble((uint16_t)l_arg));
+            case 26:
+            {
+                if (!ReadBytes(f_rd, 4, &l_arg)) return NULL;
+
+                uint32_t l_bits = (uint32_t)l_arg;
+                float    l_float;
+                memcpy(&l_float, &l_bits, sizeof(l_float));
+
+                return cJSON_CreateNumber(l_float);
+            }
+            case 27:
+            {
+                if (!ReadBytes(f_rd, 8, &l_arg)) return NULL;
+
+                double l_double;
+                memcpy(&l_double, &l_arg, sizeof(l_double));
+
+                return cJSON_CreateNumber(l_double);
+            }
+            default:
+                return NULL;
+        }
+    }
+
+    if (l_major == 2 || l_major == 3)
+    {
+        std::string l_str;
+
+        if (!DecodeString(f_rd, l_major, l_info, l_str)) return NULL;
+        return cJSON_CreateString(l_str.c_str());
+    }
+
+    if (!ReadArgument(f_rd, l_info, &l_arg)) return NULL;
+
+    bool l_indefinite = l_info == CBOR_INDEFINITE;
+
+    switch (l_major)
+    {
+        case 0:
+            if (l_indefinite) return NULL;
+            return cJSON_CreateNumber((double)l_arg);
+
+        case 1:
+            if (l_indefinite) return NULL;
+            return cJSON_CreateNumber(-1.0 - (double)l_arg);
+
+        case 4:
+        {
+            cJSON *l_array = cJSON_CreateArray();
+
+            while (HasNext(f_rd, l_indefinite, l_arg))
+            {
+                cJSON *l_item = DecodeItem(f_rd, f_depth + 1);
+
+                if (!l_item)
+                {
+                    cJSON_Delete(l_array);
+                    return NULL;
+                }
+
+                cJSON_AddItemToArray(l_array, l_item);
+            }
+
+            return l_array;
+        }
+
+        case 5:
+        {
+            cJSON *l_map = cJSON_CreateObject();
+
+            while (HasNext(f_rd, l_indefinite, l_arg))
+            {
+                // --- JSON needs text keys
+
+                std::string l_key;
+                uint8_t     l_kb = f_rd.m_Pos < f_rd.m_Len ? f_rd.m_Data[f_rd.m_Pos++] : 0;
+                cJSON      *l_item = NULL;
+
+                if ((l_kb >> 5) == 3 && DecodeString(f_rd, 3, l_kb & 0x1f, l_key))
+                {
+                    l_item = DecodeItem(f_rd, f_depth + 1);
+                }
+
+                if (!l_item)
+                {
+                    cJSON_Delete(l_map);
+                    return NULL;
+                }
+
+                cJSON_AddItemToObject(l_map, l_key.c_str(), l_item);
+            }
+
+            return l_map;
+        }
+
+        case 6:
+            if (l_indefinite) return NULL;
+            return DecodeItem(f_rd, f_depth + 1);
+
+        default:
+            return NULL;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+cJSON *CborToJson(const uint8_t *f_data, size_t f_len)
+{
+    CborReader l_rd = { f_data, f_len, 0 };
+
+    cJSON *l_root = DecodeItem(l_rd, 0);
+
+    if (l_root && l_rd.m_Pos != l_rd.m_Len)
+    {
+        cJSON_Delete(l_root);
+        return NULL;
+    }
+
+    return l_root;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
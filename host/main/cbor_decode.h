@@ -0,0 +1,58 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CBOR_DECODE_H_
+#define	CBOR_DECODE_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "cJSON.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- decodes a CBOR payload of the firmware into the cJSON tree a JSON payload would
+//     give. Enough of RFC 8949 for what a broker side consumer sees: integers, floats
+//     (half, single, double), text, byte strings (as hex text), arrays and maps with
+//     text keys, definite or indefinite length. Tags are skipped.
+//
+//     Returns NULL when the data is malformed or has trailing bytes.
+
+cJSON *CborToJson(const uint8_t *f_data, size_t f_len);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
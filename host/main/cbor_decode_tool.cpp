@@ -0,0 +1,120 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+// --- prints CBOR MQTT payloads as JSON, e.g. with mosquitto_sub:
+//
+//       mosquitto_sub -t 'esplogger/sensor1' -C 1 | ./cbor_decode
+//       ./cbor_decode a364706d3130...
+//
+//     Arguments are hex encoded payloads, without arguments stdin is read as binary.
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "cJSON.h"
+#include "cbor_decode.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static bool HexToBinary(const char *f_hex, std::string &f_out)
+{
+    for (const char *l_p = f_hex; *l_p; )
+    {
+        if (isspace((unsigned char)*l_p)) { ++l_p; continue; }
+        if (!isxdigit((unsigned char)l_p[0]) || !isxdigit((unsigned char)l_p[1])) return false;
+
+        char l_byte[3] = { l_p[0], l_p[1], 0 };
+        f_out += (char)strtol(l_byte, NULL, 16);
+        l_p += 2;
+    }
+
+    return true;
+}
+
+static bool PrintPayload(const std::string &f_data)
+{
+    cJSON *l_root = CborToJson((const uint8_t *)f_data.data(), f_data.size());
+
+    if (!l_root)
+    {
+        fprintf(stderr, "cbor_decode: malformed payload (%zu bytes)\n", f_data.size());
+        return false;
+    }
+
+    char *l_str = cJSON_PrintUnformatted(l_root);
+    printf("%s\n", l_str);
+
+    cJSON_free(l_str);
+    cJSON_Delete(l_root);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+    bool l_ok = true;
+
+    if (argc < 2)
+    {
+        std::string l_data;
+        char        l_buf[512];
+        size_t      l_len;
+
+        while ((l_len = fread(l_buf, 1, sizeof(l_buf), stdin)) > 0) l_data.append(l_buf, l_len);
+
+        return PrintPayload(l_data) ? 0 : 1;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string l_data;
+
+        if (!HexToBinary(argv[i], l_data))
+        {
+            fprintf(stderr, "cbor_decode: '%s' is not hex\n", argv[i]);
+            l_ok = false;
+            continue;
+        }
+
+        l_ok = PrintPayload(l_data) && l_ok;
+    }
+
+    return l_ok ? 0 : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
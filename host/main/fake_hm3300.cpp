@@ -0,0 +1,144 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "i2c_host.h"
+
+#include "sim_script.h"
+#include "fake_hm3300.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *TAG = "FakeHM3300";
+
+#define HM3300_CMD_I2C_MODE     0x88
+#define HM3300_FRAME_LEN        29
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+struct FakeHM3300
+{
+    bool        m_I2cMode;
+    uint32_t    m_ReadCnt;
+    int64_t     m_StartUs;
+};
+
+static FakeHM3300 g_FakeHM3300;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static esp_err_t FakeHM3300Write(void *f_ctx, const uint8_t *f_data, size_t f_len)
+{
+    FakeHM3300 *l_dev = (FakeHM3300 *)f_ctx;
+
+    if (f_len == 1 && f_data[0] == HM3300_CMD_I2C_MODE) l_dev->m_I2cMode = true;
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static void PutWord(uint8_t *f_frame, int f_word, double f_value)
+{
+    uint16_t l_v = f_value <= 0 ? 0 : (f_value >= 65535 ? 65535 : (uint16_t)(f_value + 0.5));
+
+    // --- big endian like the real device
+
+    f_frame[f_word * 2]     = l_v >> 8;
+    f_frame[f_word * 2 + 1] = l_v & 0xff;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static esp_err_t FakeHM3300Read(void *f_ctx, uint8_t *f_data, size_t f_len)
+{
+    FakeHM3300 *l_dev = (FakeHM3300 *)f_ctx;
+    SimHM3300Def &l_def = g_SimScript.GetHM3300Def();
+
+    // --- the device NACKs until it was switched to I2C mode
+
+    if (!l_dev->m_I2cMode) return ESP_FAIL;
+
+    ++l_dev->m_ReadCnt;
+
+    double l_t = l_def.m_StepSec > 0 ? l_dev->m_ReadCnt * l_def.m_StepSec : (esp_timer_get_time() - l_dev->m_StartUs) / 1000000.0;
+
+    uint8_t l_frame[HM3300_FRAME_LEN];
+    memset(l_frame, 0, sizeof(l_frame));
+
+    PutWord(l_frame, 1, 1);
+
+    for (int i = 0; i < SIM_HM3300_FIELDS; i++) PutWord(l_frame, 2 + i, l_def.m_Fields[i].Sample(l_t));
+
+    // --- particle counts are not used by the driver, derive something plausible
+
+    for (int i = 0; i < 6; i++) PutWord(l_frame, 8 + i, 300.0 / (i + 1));
+
+    uint8_t l_sum = 0;
+    for (int i = 0; i < HM3300_FRAME_LEN - 1; i++) l_sum += l_frame[i];
+
+    l_frame[HM3300_FRAME_LEN - 1] = l_sum;
+
+    if (l_def.m_FailEvery > 0 && (l_dev->m_ReadCnt % l_def.m_FailEvery) == 0) l_frame[HM3300_FRAME_LEN - 1] ^= 0x5a;
+
+    memcpy(f_data, l_frame, f_len < sizeof(l_frame) ? f_len : sizeof(l_frame));
+    if (f_len > sizeof(l_frame)) memset(f_data + sizeof(l_frame), 0, f_len - sizeof(l_frame));
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t fake_hm3300_attach(void)
+{
+    SimHM3300Def &l_def = g_SimScript.GetHM3300Def();
+
+    if (!l_def.m_Present)
+    {
+        ESP_LOGI(TAG, "HM3300 not present on the simulated bus");
+        return ESP_OK;
+    }
+
+    g_FakeHM3300.m_I2cMode  = false;
+    g_FakeHM3300.m_ReadCnt  = 0;
+    g_FakeHM3300.m_StartUs  = esp_timer_get_time();
+
+    ESP_LOGI(TAG, "HM3300 attached to i2c %d address 0x%02x", l_def.m_Port, l_def.m_Address);
+
+    return i2c_host_attach_device(l_def.m_Port, l_def.m_Address, FakeHM3300Write, FakeHM3300Read, &g_FakeHM3300);
+}
@@ -0,0 +1,187 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <stdio.h>
+#include <string>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "rom/ets_sys.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "fake_sensor.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *TAG = "CFakeSensor";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+CFakeSensor::CFakeSensor(void)
+{
+	m_SensorNum		= 0;
+	m_Def			= NULL;
+	m_MeasureCnt	= 0;
+	m_StartUs		= 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool CFakeSensor::SetupSensor(gpio_num_t *f_pins,int *f_data)
+{
+	if (f_data[0] < 1 || f_data[0] > SIM_MAX_SENSORS)
+	{
+		ESP_LOGE(TAG,"Illegal sensor definition number %d",f_data[0]);
+		return false;
+	}
+
+	m_SensorNum		= f_data[0];
+	m_Def			= &g_SimScript.GetSensorDef(m_SensorNum);
+	m_StartUs		= esp_timer_get_time();
+
+	m_Values.assign(m_Def->m_Channels.size(),0.0);
+
+	ESP_LOGI(TAG,"Simulated sensor %d '%s' with %d channels",m_SensorNum,m_Def->m_Type.c_str(),(int)m_Values.size());
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool CFakeSensor::PerformMeasurement(void)
+{
+	if (!m_Def)
+	{
+		ESP_LOGE(TAG,"Error in PerformMeasurement() - using an uninitialized sensor");
+		return false;
+	}
+
+	++m_MeasureCnt;
+
+	// --- simulate the cost of the measurement: CPU first, then waiting for the device
+
+	if (m_Def->m_BusyUs > 0) ets_delay_us(m_Def->m_BusyUs);
+	if (m_Def->m_LatencyMs > 0) vTaskDelay(pdMS_TO_TICKS(m_Def->m_LatencyMs));
+
+	if (m_Def->m_FailEvery > 0 && (m_MeasureCnt % m_Def->m_FailEvery) == 0) return false;
+
+	double l_t = m_Def->m_StepSec > 0 ? m_MeasureCnt * m_Def->m_StepSec : (esp_timer_get_time() - m_StartUs) / 1000000.0;
+
+	for (size_t i = 0; i < m_Values.size(); i++)
+	{
+		m_Values[i] = m_Def->m_Channels[i].m_Gen.Sample(l_t);
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+std::string CFakeSensor::GetSensorValueString(void)
+{
+	std::string l_s = "CFakeSensor:";
+
+	for (size_t i = 0; i < m_Values.size(); i++)
+	{
+		char l_buf[64];
+		snprintf(l_buf,sizeof(l_buf)," %s %.2f",m_Def->m_Channels[i].m_Name.c_str(),m_Values[i]);
+		l_s += l_buf;
+	}
+
+	return l_s;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+std::string CFakeSensor::GetSensorDescriptionString(void)
+{
+	char l_buf[200];
+	snprintf(l_buf,200,"%s / simulated sensor %d",m_Def ? m_Def->m_Type.c_str() : "?",m_SensorNum);
+
+	return std::string(l_buf);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void CFakeSensor::AddValuesToJSON_MQTT(JsonWriter &f_writer)
+{
+	for (size_t i = 0; i < m_Values.size(); i++)
+	{
+		f_writer.Number(m_Def->m_Channels[i].m_Name.c_str(), m_Values[i]);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void CFakeSensor::AddValuesToJSON_API(JsonWriter &f_writer)
+{
+	for (size_t i = 0; i < m_Values.size(); i++)
+	{
+		AddApiValue(f_writer, m_Def->m_Channels[i].m_Name.c_str(), m_Def->m_Channels[i].m_Unit.c_str(),
+					"%.2f", m_Values[i], m_Def->m_Channels[i].m_Text.c_str());
+	}
+
+	f_writer.String("SensorType", m_Def ? m_Def->m_Type.c_str() : "Simulated Sensor");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t CFakeSensor::GetMeasurementPeriodMs(void)
+{
+	return m_Def && m_Def->m_PeriodMs > 0 ? m_Def->m_PeriodMs : CSENSOR_DEFAULT_PERIOD_MS;
+}
+
+uint32_t CFakeSensor::GetMeasurementDeadlineMs(void)
+{
+	return m_Def && m_Def->m_DeadlineMs > 0 ? m_Def->m_DeadlineMs : CSENSOR_DEFAULT_DEADLINE_MS;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int CFakeSensor::GetChannelCount(void)
+{
+	return (int)m_Values.size();
+}
+
+const char *CFakeSensor::GetChannelName(int f_ch)
+{
+	return f_ch >= 0 && f_ch < GetChannelCount() ? m_Def->m_Channels[f_ch].m_Name.c_str() : "";
+}
+
+float CFakeSensor::GetChannelValue(int f_ch)
+{
+	return f_ch >= 0 && f_ch < GetChannelCount() ? (float)m_Values[f_ch] : 0;
+}
@@ -0,0 +1,91 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FAKE_SENSOR_H_
+#define	FAKE_SENSOR_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "driver/gpio.h"
+#include "csensor.h"
+#include "sim_script.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- a scriptable sensor for the host build. Channels, timing and failures are taken
+//     from the simulation script (see sim_script.h).
+
+class CFakeSensor : public CSensor
+{
+
+public:
+
+	// --- construct
+
+	CFakeSensor(void);
+
+	// --- CSensor interface
+
+	virtual std::string GetSensorValueString(void);
+    virtual std::string GetSensorDescriptionString(void);
+ 	virtual bool PerformMeasurement(void);
+    virtual void AddValuesToJSON_MQTT(JsonWriter &f_writer);
+    virtual void AddValuesToJSON_API(JsonWriter &f_writer);
+	virtual int GetChannelCount(void);
+	virtual const char *GetChannelName(int f_ch);
+	virtual float GetChannelValue(int f_ch);
+	virtual uint32_t GetMeasurementPeriodMs(void);
+	virtual uint32_t GetMeasurementDeadlineMs(void);
+
+	// --- Pins: <not used> / Data: 0: number of the sensor definition in the script (1..SIM_MAX_SENSORS)
+
+ 	virtual bool SetupSensor(gpio_num_t *f_pins,int *f_data);
+
+private:
+
+	int						m_SensorNum;
+	SimSensorDef			*m_Def;
+
+	std::vector<double>		m_Values;
+	uint32_t				m_MeasureCnt;
+	int64_t					m_StartUs;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -0,0 +1,187 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+// --- checks FrameDecoder (main/frame_decoder.h) with known frames of every protocol:
+//     frames split across reads, after garbage, with a bad checksum and with a length
+//     field out of range. Run by ctest, the exit code is the number of failed cases.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include "frame_decoder.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the frames, from the data sheets where they have an example
+
+static const uint8_t g_Pm1006[]     = { 0x16, 0x11, 0x0b, 0x00, 0x00, 0x03, 0xe8, 0x00, 0x00, 0x07, 0xd0, 0x00, 0x00, 0x0b, 0xb8,
+                                        0x00, 0x00, 0x00, 0x00, 0x49 };
+static const uint8_t g_Pms5003[]    = { 0x42, 0x4d, 0x00, 0x1c, 0x00, 0x05, 0x00, 0x0c, 0x00, 0x11, 0x00, 0x05, 0x00, 0x0c, 0x00,
+                                        0x11, 0x03, 0x84, 0x01, 0x0e, 0x00, 0x32, 0x00, 0x06, 0x00, 0x02, 0x00, 0x01, 0x97, 0x00,
+                                        0x02, 0x57 };
+static const uint8_t g_Sds011[]     = { 0xaa, 0xc0, 0xd4, 0x04, 0x3a, 0x0a, 0xa1, 0x60, 0x1d, 0xab };
+static const uint8_t g_Mhz19[]      = { 0xff, 0x86, 0x02, 0x60, 0x47, 0x00, 0x00, 0x00, 0xd1 };
+static const uint8_t g_SenseairS8[] = { 0xfe, 0x04, 0x02, 0x01, 0x90, 0xac, 0xd8 };
+
+// --- none of them holds a header byte, so resyncs skip predictable counts
+
+static const uint8_t g_Garbage[]    = { 0x00, 0x13, 0x55, 0x80, 0x7f };
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+struct Received
+{
+    const uint8_t   *m_Frame;       // --- every frame passed to the callback must be this one
+    size_t          m_Len;
+    int             m_Count;
+    int             m_Wrong;
+};
+
+static void OnFrame(void *f_ctx, const uint8_t *f_frame, size_t f_len)
+{
+    Received *l_rcv = (Received *)f_ctx;
+
+    l_rcv->m_Count++;
+
+    if (f_len != l_rcv->m_Len || memcmp(f_frame, l_rcv->m_Frame, f_len) != 0) l_rcv->m_Wrong++;
+}
+
+static int g_Failed = 0;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- feeds f_data in pieces of f_piece bytes (0: all at once) and compares the counters
+
+template <class P>
+static void Expect(const char *f_proto, const char *f_case, const std::vector<uint8_t> &f_data, size_t f_piece,
+                   const uint8_t *f_frame, size_t f_len, uint32_t f_frames, uint32_t f_checksum, uint32_t f_length, uint32_t f_skipped)
+{
+    FrameDecoder<P> l_dec;
+    Received        l_rcv = { f_frame, f_len, 0, 0 };
+    int             l_returned = 0;
+
+    for (size_t l_pos = 0; l_pos < f_data.size(); )
+    {
+        size_t l_n = f_piece && f_piece < f_data.size() - l_pos ? f_piece : f_data.size() - l_pos;
+
+        l_returned += l_dec.Feed(f_data.data() + l_pos, l_n, OnFrame, &l_rcv);
+        l_pos      += l_n;
+    }
+
+    bool l_ok = l_dec.GetFrameCount() == f_frames && l_dec.GetChecksumErrorCount() == f_checksum &&
+                l_dec.GetLengthErrorCount() == f_length && l_dec.GetSkippedByteCount() == f_skipped &&
+                l_rcv.m_Count == (int)f_frames && l_returned == (int)f_frames && l_rcv.m_Wrong == 0;
+
+    if (l_ok) return;
+
+    printf("%-10s %-22s FAILED: frames %u/%u checksum %u/%u length %u/%u skipped %u/%u callbacks %d, %d wrong\n", f_proto, f_case,
+           (unsigned)l_dec.GetFrameCount(), (unsigned)f_frames, (unsigned)l_dec.GetChecksumErrorCount(), (unsigned)f_checksum,
+           (unsigned)l_dec.GetLengthErrorCount(), (unsigned)f_length, (unsigned)l_dec.GetSkippedByteCount(), (unsigned)f_skipped,
+           l_rcv.m_Count, l_rcv.m_Wrong);
+
+    g_Failed++;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+template <class P>
+static void CheckProtocol(const char *f_proto, const uint8_t *f_frame, size_t f_len)
+{
+    typedef FrameDecoder<P> Dec;
+
+    int l_failed = g_Failed;
+
+    std::vector<uint8_t> l_one(f_frame, f_frame + f_len);
+    std::vector<uint8_t> l_two(l_one);
+    l_two.insert(l_two.end(), f_frame, f_frame + f_len);
+
+    // --- in one piece, split at every position, byte by byte
+
+    Expect<P>(f_proto, "one read", l_one, 0, f_frame, f_len, 1, 0, 0, 0);
+
+    for (size_t l_split = 1; l_split < f_len; ++l_split)
+    {
+        Expect<P>(f_proto, "split read", l_one, l_split, f_frame, f_len, 1, 0, 0, 0);
+    }
+
+    Expect<P>(f_proto, "two frames bytewise", l_two, 1, f_frame, f_len, 2, 0, 0, 0);
+
+    // --- leading garbage, also in its own read
+
+    std::vector<uint8_t> l_garbage(g_Garbage, g_Garbage + sizeof(g_Garbage));
+    l_garbage.insert(l_garbage.end(), f_frame, f_frame + f_len);
+
+    Expect<P>(f_proto, "leading garbage", l_garbage, 0, f_frame, f_len, 1, 0, 0, sizeof(g_Garbage));
+    Expect<P>(f_proto, "garbage, split read", l_garbage, sizeof(g_Garbage), f_frame, f_len, 1, 0, 0, sizeof(g_Garbage));
+
+    // --- a bad checksum: the frame is skipped, the next one is found
+
+    std::vector<uint8_t> l_bad(l_two);
+    l_bad[f_len - 1 - Dec::TRAILER_LEN] ^= 0x01;
+
+    Expect<P>(f_proto, "bad checksum", l_bad, 0, f_frame, f_len, 1, 1, 0, f_len);
+    Expect<P>(f_proto, "bad checksum bytewise", l_bad, 1, f_frame, f_len, 1, 1, 0, f_len);
+
+    // --- a length field beyond MAX_LEN: only the prefix is dropped. Fixed length frames
+    //     have no length field.
+
+    if (!P::FIXED_LEN)
+    {
+        std::vector<uint8_t> l_long(f_frame, f_frame + Dec::PREFIX_LEN);
+        for (size_t i = 0; i < P::LEN_SIZE; ++i) l_long[P::LEN_OFFSET + i] = 0xff;
+        l_long.insert(l_long.end(), f_frame, f_frame + f_len);
+
+        Expect<P>(f_proto, "length out of range", l_long, 0, f_frame, f_len, 1, 0, 1, Dec::PREFIX_LEN);
+        Expect<P>(f_proto, "length bytewise", l_long, 1, f_frame, f_len, 1, 0, 1, Dec::PREFIX_LEN);
+    }
+
+    printf("%-10s %s\n", f_proto, g_Failed == l_failed ? "ok" : "FAILED");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+    CheckProtocol<FrameProtocolPm1006>("PM1006", g_Pm1006, sizeof(g_Pm1006));
+    CheckProtocol<FrameProtocolPms5003>("PMS5003", g_Pms5003, sizeof(g_Pms5003));
+    CheckProtocol<FrameProtocolSds011>("SDS011", g_Sds011, sizeof(g_Sds011));
+    CheckProtocol<FrameProtocolMhz19>("MH-Z19", g_Mhz19, sizeof(g_Mhz19));
+    CheckProtocol<FrameProtocolSenseairS8>("S8", g_SenseairS8, sizeof(g_SenseairS8));
+
+    if (g_Failed) printf("%d cases failed\n", g_Failed);
+
+    return g_Failed;
+}
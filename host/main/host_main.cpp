@@ -0,0 +1,640 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_ota_ops.h"
+#include "nvs_flash.h"
+#include "nvs_host.h"
+#include "httpd_host.h"
+#include "mqtt_host.h"
+#include "i2c_host.h"
+
+#include "sensor_manager.h"
+#include "sample_store.h"
+#include "sample_journal.h"
+#include "config_manager.h"
+#include "config_manager_defines.h"
+#include "mqtt_manager.h"
+#include "applogger.h"
+#include "ota_manager.h"
+#include "perf_metrics.h"
+#include "event_stream.h"
+#include "i2c_bus_manager.h"
+
+#include "sim_script.h"
+#include "cbor_decode.h"
+#include "fake_hm3300.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *TAG = "host_main";
+
+esp_err_t start_rest_server(const char *base_path);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+struct HostPost
+{
+    std::string                         m_Uri;
+    std::string                         m_File;
+    std::map<std::string,std::string>   m_Headers;
+};
+
+struct HostOptions
+{
+    const char                  *m_Script       = NULL;
+    const char                  *m_WwwDir       = NULL;
+    const char                  *m_NvsFile      = NULL;
+    const char                  *m_RunningImage = NULL;
+    const char                  *m_LogDir       = NULL;
+    double                      m_DurationSec   = 30;
+    int                         m_BenchRest     = 0;
+    int                         m_BenchMqtt     = 0;
+    int                         m_Streams       = 0;
+    bool                        m_MqttEcho      = false;
+    bool                        m_Revalidate    = false;
+    bool                        m_OtaCheck      = false;
+    esp_log_level_t             m_LogLevel      = ESP_LOG_WARN;
+    std::vector<std::string>    m_Gets;
+    std::vector<HostPost>       m_Posts;
+    std::map<std::string,std::string> m_PostHeaders;         // --- for the following --post
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- simple statistics over a series of durations in microseconds
+
+struct HostTiming
+{
+    std::vector<int64_t> m_Samples;
+
+    void Add(int64_t f_us)
+    {
+        m_Samples.push_back(f_us);
+    }
+
+    void Print(const char *f_name)
+    {
+        if (m_Samples.empty())
+        {
+            printf("%-28s n=0\n", f_name);
+            return;
+        }
+
+        std::vector<int64_t> l_sorted = m_Samples;
+        std::sort(l_sorted.begin(), l_sorted.end());
+
+        int64_t l_sum = 0;
+        for (int64_t l_v : l_sorted) l_sum += l_v;
+
+        size_t l_p95 = (l_sorted.size() * 95 + 99) / 100;
+        if (l_p95 > 0) l_p95--;
+
+        printf("%-28s n=%-6d avg=%8.1fus min=%8lldus p95=%8lldus max=%8lldus\n", f_name, (int)l_sorted.size(),
+               (double)l_sum / l_sorted.size(), (long long)l_sorted.front(), (long long)l_sorted[l_p95], (long long)l_sorted.back());
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static void Usage(const char *f_prog)
+{
+    printf("Usage: %s [options]\n"
+           "  --script <file>       simulation script (see host/scripts)\n"
+           "  --www <dir>           directory served by the web server (e.g. front/webapp/dist)\n"
+           "  --nvs <file>          keep the NVS contents in this file\n"
+           "  --log-dir <dir>       keep the AppLogger history files in this directory\n"
+           "  --duration <sec>      run time of the sensor acquisition (default 30)\n"
+           "  --get <uri>           issue a GET request after the run and print the response (repeatable)\n"
+           "  --post <uri> <file>   issue a POST request with the contents of file after the run (repeatable)\n"
+           "  --post-header <h: v>  send this header with the following --post requests\n"
+           "  --revalidate          repeat each --get with the ETag it returned (If-None-Match)\n"
+           "  --running-image <file> firmware image in the running partition (base of delta updates)\n"
+           "  --ota-check           check the update server (ota_url) after the run, restarts on an update\n"
+           "  --bench-rest <n>      time n requests to each REST API endpoint after the run\n"
+           "  --bench-mqtt <n>      compare size, encode and decode time of JSON and CBOR MQTT payloads\n"
+           "  --stream <n>          open n clients on /api/v1/stream and count their events after the run\n"
+           "  --mqtt-echo           print every published MQTT message\n"
+           "  --log-level <0..5>    ESP_LOGx level (default 2: warnings)\n", f_prog);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static bool ParseOptions(int argc, char **argv, HostOptions &f_opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string l_arg = argv[i];
+        bool l_hasval = i + 1 < argc;
+
+        if (l_arg == "--script" && l_hasval)            f_opt.m_Script = argv[++i];
+        else if (l_arg == "--www" && l_hasval)          f_opt.m_WwwDir = argv[++i];
+        else if (l_arg == "--nvs" && l_hasval)          f_opt.m_NvsFile = argv[++i];
+        else if (l_arg == "--log-dir" && l_hasval)      f_opt.m_LogDir = argv[++i];
+        else if (l_arg == "--duration" && l_hasval)     f_opt.m_DurationSec = atof(argv[++i]);
+        else if (l_arg == "--get" && l_hasval)          f_opt.m_Gets.push_back(argv[++i]);
+        else if (l_arg == "--post" && i + 2 < argc)     { f_opt.m_Posts.push_back({argv[i + 1], argv[i + 2], f_opt.m_PostHeaders}); i += 2; }
+        else if (l_arg == "--post-header" && l_hasval && strchr(argv[i + 1], ':'))
+        {
+            std::string l_hdr = argv[++i];
+            size_t      l_colon = l_hdr.find(':');
+
+            f_opt.m_PostHeaders[l_hdr.substr(0, l_colon)] = l_hdr.substr(l_hdr.find_first_not_of(' ', l_colon + 1));
+        }
+        else if (l_arg == "--bench-rest" && l_hasval)   f_opt.m_BenchRest = atoi(argv[++i]);
+        else if (l_arg == "--bench-mqtt" && l_hasval)   f_opt.m_BenchMqtt = atoi(argv[++i]);
+        else if (l_arg == "--stream" && l_hasval)       f_opt.m_Streams = atoi(argv[++i]);
+        else if (l_arg == "--revalidate")               f_opt.m_Revalidate = true;
+        else if (l_arg == "--running-image" && l_hasval) f_opt.m_RunningImage = argv[++i];
+        else if (l_arg == "--ota-check")                f_opt.m_OtaCheck = true;
+        else if (l_arg == "--log-level" && l_hasval)    f_opt.m_LogLevel = (esp_log_level_t)atoi(argv[++i]);
+        else if (l_arg == "--mqtt-echo")                f_opt.m_MqttEcho = true;
+        else
+        {
+            Usage(argv[0]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- same defaults as app_main() applies in bootstrap mode, but pointing to a local broker
+
+static void SetConfigDefaults(void)
+{
+    g_ConfigManager.BeginUpdate();
+
+    if (g_ConfigManager.GetStringValue(CFMGR_DEVICE_NAME, NULL, 0) == 0)
+        g_ConfigManager.SetStringValue(CFMGR_DEVICE_NAME,"HostDevice");
+
+    if (g_ConfigManager.GetStringValue(CFMGR_MQTT_SERVER, NULL, 0) == 0)
+        g_ConfigManager.SetStringValue(CFMGR_MQTT_SERVER,"mqtt://localhost");
+
+    if (g_ConfigManager.GetStringValue(CFMGR_MQTT_TOPIC, NULL, 0) == 0)
+        g_ConfigManager.SetStringValue(CFMGR_MQTT_TOPIC,"host/esplogger");
+
+    if (g_ConfigManager.GetIntValue(CFMGR_MQTT_TIME) == 0)
+        g_ConfigManager.SetIntValue(CFMGR_MQTT_TIME,60);
+
+    g_ConfigManager.EndUpdate();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static void BenchRest(int f_count)
+{
+    std::vector<std::string> l_uris = { "/api/v1/sensorcnt", "/api/v1/sensorstats", "/api/v1/journal/seq-0/cnt-8", "/api/v1/config", "/api/v1/version", "/api/v1/metrics", "/metrics", "/api/v1/log/idx-0/cnt-0" };
+
+    for (int i = 0; i < g_SensorManager.GetSensorCount(); i++)
+    {
+        l_uris.push_back("/api/v1/air/" + std::to_string(i + 1));
+        l_uris.push_back("/api/v1/history/" + std::to_string(i + 1) + "/raw");
+        l_uris.push_back("/api/v1/history/" + std::to_string(i + 1) + "/1m");
+    }
+
+    printf("\nREST timing (%d requests each)\n", f_count);
+
+    for (const std::string &l_uri : l_uris)
+    {
+        HostTiming          l_timing;
+        HttpdHostResponse_t l_resp;
+
+        for (int i = 0; i < f_count; i++)
+        {
+            int64_t l_start = esp_timer_get_time();
+            httpd_host_request(httpd_host_get_server(), HTTP_GET, l_uri.c_str(), {}, "", &l_resp);
+            l_timing.Add(esp_timer_get_time() - l_start);
+        }
+
+        char l_name[64];
+        snprintf(l_name, sizeof(l_name), "GET %s", l_uri.c_str());
+        l_timing.Print(l_name);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the payloads of the current sensor values in both formats: size, encoding on the
+//     device and parsing on the consumer side (both into a cJSON tree)
+
+static void BenchMqtt(int f_count)
+{
+    double l_time = (double)(esp_timer_get_time() / 1000) / 1000.0;
+
+    printf("\nMQTT payloads (%d runs each)           bytes   encode   decode\n", f_count);
+
+    for (int l_sensor = 0; l_sensor <= g_SensorManager.GetSensorCount(); l_sensor++)
+    {
+        int  l_senidx = l_sensor < g_SensorManager.GetSensorCount() ? l_sensor : MQTT_QUEUE_DEVICE_TOPIC;
+        char l_name[32];
+
+        if (l_senidx == MQTT_QUEUE_DEVICE_TOPIC) snprintf(l_name, sizeof(l_name), "combined");
+        else snprintf(l_name, sizeof(l_name), "sensor%d", l_senidx + 1);
+
+        size_t l_jsonlen = 0;
+
+        for (int l_format : { MQTT_FORMAT_JSON, MQTT_FORMAT_CBOR })
+        {
+            char    l_payload[MQTT_QUEUE_PAYLOAD_SIZE];
+            size_t  l_len = 0;
+            int64_t l_start = esp_timer_get_time();
+
+            for (int i = 0; i < f_count; i++)
+            {
+                l_len = g_MqttManager.EncodePayload(l_format, l_senidx, l_time, l_payload, sizeof(l_payload));
+            }
+
+            double l_encode = (double)(esp_timer_get_time() - l_start) / f_count;
+
+            if (!l_len)
+            {
+                printf("%-12s %-4s payload too large\n", l_name, l_format == MQTT_FORMAT_CBOR ? "cbor" : "json");
+                continue;
+            }
+
+            l_start = esp_timer_get_time();
+
+            for (int i = 0; i < f_count; i++)
+            {
+                cJSON *l_root = l_format == MQTT_FORMAT_CBOR ? CborToJson((const uint8_t *)l_payload, l_len) : cJSON_Parse(l_payload);
+                cJSON_Delete(l_root);
+            }
+
+            double l_decode = (double)(esp_timer_get_time() - l_start) / f_count;
+
+            if (l_format == MQTT_FORMAT_JSON)
+            {
+                l_jsonlen = l_len;
+                printf("%-12s json %21zu %7.2fus %7.2fus\n", l_name, l_len, l_encode, l_decode);
+            }
+            else
+            {
+                printf("%-12s cbor %21zu %7.2fus %7.2fus  (%d%% of json)\n", l_name, l_len, l_encode, l_decode,
+                       l_jsonlen ? (int)(100 * l_len / l_jsonlen) : 0);
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- what the bootloader would have started
+
+static bool LoadRunningImage(const char *f_file)
+{
+    FILE *l_file = fopen(f_file, "rb");
+
+    if (!l_file)
+    {
+        ESP_LOGE(TAG, "Cannot open %s", f_file);
+        return false;
+    }
+
+    const esp_partition_t *l_part = esp_ota_get_running_partition();
+    std::vector<char>      l_image(l_part->size);
+    size_t                 l_len = fread(l_image.data(), 1, l_image.size(), l_file);
+
+    fclose(l_file);
+
+    return esp_partition_erase_range(l_part, 0, l_part->size) == ESP_OK && esp_partition_write(l_part, 0, l_image.data(), l_len) == ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+    HostOptions l_opt;
+
+    if (!ParseOptions(argc, argv, l_opt)) return 2;
+
+    esp_log_level_set("*", l_opt.m_LogLevel);
+    mqtt_host_set_echo(l_opt.m_MqttEcho);
+    g_AppLogger.SetConsoleEcho(l_opt.m_LogLevel >= ESP_LOG_INFO);
+
+    if (l_opt.m_Script && !g_SimScript.LoadFile(l_opt.m_Script)) return 1;
+
+    g_SimScript.AddDefaults();
+
+    // ---- same order as app_main(). Wi-Fi, SPIFFS and the info LED do not exist here.
+
+    if (l_opt.m_NvsFile) nvs_host_set_backing_file(l_opt.m_NvsFile);
+    if (l_opt.m_RunningImage && !LoadRunningImage(l_opt.m_RunningImage)) return 1;
+
+    ESP_ERROR_CHECK(nvs_flash_init());
+    // ---- absolute, as --www changes the working directory
+
+    char l_logdir[PATH_MAX];
+
+    if (l_opt.m_LogDir && !realpath(l_opt.m_LogDir, l_logdir))
+    {
+        ESP_LOGE(TAG, "Log directory %s does not exist", l_opt.m_LogDir);
+        return 1;
+    }
+
+    ESP_ERROR_CHECK(g_AppLogger.InitAppLogger(l_opt.m_LogDir ? l_logdir : NULL));
+
+    g_OTAManager.logOTAInfo();
+
+    ESP_ERROR_CHECK(g_ConfigManager.InitConfigManager());
+
+    SetConfigDefaults();
+    g_SimScript.ApplyConfig();
+
+    g_AppLogger.Log("Host simulation started");
+
+    ESP_ERROR_CHECK(fake_hm3300_attach());
+    g_SensorManager.InitSensors();
+    ESP_ERROR_CHECK(g_SampleJournal.InitJournal());
+    ESP_ERROR_CHECK(g_SampleStore.InitStore());
+
+    // ---- the rest server keeps the base path in a small buffer (ESP_VFS_PATH_MAX), so
+    //      serve relative to the working directory
+
+    if (l_opt.m_WwwDir && chdir(l_opt.m_WwwDir) != 0)
+    {
+        ESP_LOGE(TAG, "Cannot change to www directory %s", l_opt.m_WwwDir);
+        return 1;
+    }
+
+    g_EventStream.InitStream();
+    start_rest_server(".");
+    g_MqttManager.InitManager();
+    g_OTAManager.InitPullUpdates();
+
+    // ---- the sensors run on their own tasks, we only drive the broker schedule
+
+    g_SensorManager.StartAcquisition();
+
+    // ---- event stream clients, the accepted ones are numbered by the stub in order
+
+    std::vector<HttpdHostResponse_t>    l_streams(l_opt.m_Streams);
+    std::vector<int>                    l_stream_idx(l_opt.m_Streams, -1);
+    int                                 l_async_cnt = 0;
+
+    for (int i = 0; i < l_opt.m_Streams; i++)
+    {
+        httpd_host_request(httpd_host_get_server(), HTTP_GET, "/api/v1/stream", {}, "", &l_streams[i]);
+
+        if (l_streams[i].m_Status == HTTPD_200) l_stream_idx[i] = l_async_cnt++;
+    }
+
+    int64_t     l_start = esp_timer_get_time();
+    size_t      l_broker_evt = 0;
+
+    std::vector<std::pair<double,bool>> l_schedule = g_SimScript.GetBrokerSchedule();
+    std::sort(l_schedule.begin(), l_schedule.end());
+
+    while (true)
+    {
+        double l_now = (esp_timer_get_time() - l_start) / 1000000.0;
+
+        if (l_now >= l_opt.m_DurationSec) break;
+
+        while (l_broker_evt < l_schedule.size() && l_schedule[l_broker_evt].first <= l_now)
+        {
+            mqtt_host_set_broker_available(l_schedule[l_broker_evt].second);
+            ESP_LOGW(TAG, "Broker %s at %.1fs", l_schedule[l_broker_evt].second ? "up" : "down", l_now);
+            l_broker_evt++;
+        }
+
+        vTaskDelay(50 / portTICK_PERIOD_MS);
+    }
+
+    // ---- write the pending journal page, so the requests below see it
+
+    g_SampleJournal.Flush();
+    g_AppLogger.Flush();
+    vTaskDelay(100 / portTICK_PERIOD_MS);
+
+    // ---- event streams
+
+    for (int i = 0; i < l_opt.m_Streams; i++)
+    {
+        HttpdHostResponse_t l_resp  = l_streams[i];
+        bool                l_done  = false;
+
+        if (l_stream_idx[i] >= 0) httpd_host_get_async_response(l_stream_idx[i], &l_resp, &l_done);
+
+        int l_samples = 0, l_logs = 0, l_keepalives = 0;
+
+        // --- events are separated by an empty line
+
+        for (size_t l_pos = 0, l_end; (l_end = l_resp.m_Body.find("\n\n", l_pos)) != std::string::npos; l_pos = l_end + 2)
+        {
+            std::string l_event = l_resp.m_Body.substr(l_pos, l_end - l_pos);
+
+            if (l_event.rfind("event: sample", 0) == 0) l_samples++;
+            else if (l_event.rfind("event: log", 0) == 0) l_logs++;
+            else if (l_event.rfind(": keepalive", 0) == 0) l_keepalives++;
+        }
+
+        printf("GET /api/v1/stream #%d -> %s (%s, %d bytes) samples=%d log=%d keepalive=%d%s\n", i + 1, l_resp.m_Status.c_str(),
+               l_resp.m_Headers["Content-Type"].c_str(), (int)l_resp.m_Body.size(), l_samples, l_logs, l_keepalives, l_done ? " completed" : "");
+
+        if (l_stream_idx[i] >= 0) httpd_host_close_async(l_stream_idx[i]);
+    }
+
+    // ---- requests and benchmarks
+
+    for (const std::string &l_uri : l_opt.m_Gets)
+    {
+        HttpdHostResponse_t l_resp;
+
+        esp_err_t l_err = httpd_host_request(httpd_host_get_server(), HTTP_GET, l_uri.c_str(), {}, "", &l_resp);
+
+        printf("GET %s -> %s (%s, %d bytes)\n", l_uri.c_str(), l_err == ESP_OK ? l_resp.m_Status.c_str() : "no handler",
+               l_resp.m_Headers["Content-Type"].c_str(), (int)l_resp.m_Body.size());
+
+        const std::string &l_type = l_resp.m_Headers["Content-Type"];
+
+        if (l_type == "application/json" || l_type.rfind("application/openmetrics-text", 0) == 0 || l_resp.m_Status != HTTPD_200)
+        {
+            printf("%s\n", l_resp.m_Body.c_str());
+        }
+
+        if (l_resp.m_Headers.count("ETag"))
+        {
+            printf("  ETag: %s  Cache-Control: %s  Content-Encoding: %s\n", l_resp.m_Headers["ETag"].c_str(),
+                   l_resp.m_Headers["Cache-Control"].c_str(), l_resp.m_Headers["Content-Encoding"].c_str());
+        }
+
+        // ---- what a browser does with a cached copy
+
+        if (l_opt.m_Revalidate && l_resp.m_Headers.count("ETag"))
+        {
+            HttpdHostResponse_t l_again;
+
+            httpd_host_request(httpd_host_get_server(), HTTP_GET, l_uri.c_str(), {{"If-None-Match", l_resp.m_Headers["ETag"]}}, "", &l_again);
+
+            printf("GET %s If-None-Match: %s -> %s (%d bytes)\n", l_uri.c_str(), l_resp.m_Headers["ETag"].c_str(),
+                   l_again.m_Status.c_str(), (int)l_again.m_Body.size());
+        }
+    }
+
+    for (const HostPost &l_post : l_opt.m_Posts)
+    {
+        FILE *l_file = fopen(l_post.m_File.c_str(), "rb");
+
+        if (!l_file)
+        {
+            ESP_LOGE(TAG, "Cannot open %s", l_post.m_File.c_str());
+            continue;
+        }
+
+        std::string l_body;
+        char        l_buf[4096];
+        size_t      l_len;
+
+        while ((l_len = fread(l_buf, 1, sizeof(l_buf), l_file)) > 0) l_body.append(l_buf, l_len);
+        fclose(l_file);
+
+        HttpdHostResponse_t l_resp;
+
+        int64_t   l_start = esp_timer_get_time();
+        esp_err_t l_err = httpd_host_request(httpd_host_get_server(), HTTP_POST, l_post.m_Uri.c_str(), l_post.m_Headers, l_body, &l_resp);
+
+        printf("POST %s (%d bytes, %.1fms) -> %s: %s\n", l_post.m_Uri.c_str(), (int)l_body.size(), (esp_timer_get_time() - l_start) / 1000.0,
+               l_err == ESP_OK ? l_resp.m_Status.c_str() : "no handler", l_resp.m_Body.c_str());
+        fflush(stdout);
+    }
+
+    if (l_opt.m_OtaCheck)
+    {
+        esp_err_t l_err = g_OTAManager.CheckForUpdate();
+
+        printf("Update check -> %s\n", esp_err_to_name(l_err));
+        fflush(stdout);
+    }
+
+    if (l_opt.m_BenchRest > 0) BenchRest(l_opt.m_BenchRest);
+    if (l_opt.m_BenchMqtt > 0) BenchMqtt(l_opt.m_BenchMqtt);
+
+    // ---- summary
+
+    MqttHostStats_t l_mqtt;
+    mqtt_host_get_stats(&l_mqtt);
+
+    I2cHostStats_t l_i2c;
+    i2c_host_get_stats(0, &l_i2c);
+
+    printf("\nSummary after %.1fs\n", (esp_timer_get_time() - l_start) / 1000000.0);
+
+    for (int i = 0; i < g_SensorManager.GetSensorCount(); i++)
+    {
+        SensorAcquisitionStats l_stats;
+        g_SensorManager.GetAcquisitionStats(i, &l_stats);
+
+        char l_name[32];
+        snprintf(l_name, sizeof(l_name), "Sensor %d (%ums/%ums)", i + 1, (unsigned)g_SensorManager.GetSensor(i)->GetMeasurementPeriodMs(),
+                 (unsigned)g_SensorManager.GetSensor(i)->GetMeasurementDeadlineMs());
+
+        printf("%-28s n=%u failed=%u missed=%u skipped=%u jitter avg=%lluus max=%uus duration max=%uus\n", l_name,
+               (unsigned)l_stats.m_Measurements, (unsigned)l_stats.m_Failures, (unsigned)l_stats.m_DeadlineMisses, (unsigned)l_stats.m_SkippedPeriods,
+               (unsigned long long)(l_stats.m_Measurements ? l_stats.m_SumJitterUs / l_stats.m_Measurements : 0),
+               (unsigned)l_stats.m_MaxJitterUs, (unsigned)l_stats.m_MaxDurationUs);
+    }
+
+    printf("%-28s published=%u rejected=%u bytes=%llu\n", "MQTT", (unsigned)l_mqtt.m_Published, (unsigned)l_mqtt.m_Rejected, (unsigned long long)l_mqtt.m_PayloadBytes);
+
+    MqttQueueStats l_queue;
+    g_MqttManager.GetQueueStats(&l_queue);
+
+    printf("%-28s queued=%u sent=%u acked=%u retries=%u dropped=%u depth=%u max=%u\n", "MQTT queue", (unsigned)l_queue.m_Queued,
+           (unsigned)l_queue.m_Sent, (unsigned)l_queue.m_Acked, (unsigned)l_queue.m_Retries, (unsigned)l_queue.m_Dropped,
+           (unsigned)l_queue.m_Depth, (unsigned)l_queue.m_MaxDepth);
+
+    MqttPublishStats l_publish;
+    g_MqttManager.GetPublishStats(&l_publish);
+
+    printf("%-28s cycles=%u latency last=%uus max=%uus duration last=%uus max=%uus\n", "MQTT publisher", (unsigned)l_publish.m_Cycles,
+           (unsigned)l_publish.m_LastLatencyUs, (unsigned)l_publish.m_MaxLatencyUs, (unsigned)l_publish.m_LastDurationUs,
+           (unsigned)l_publish.m_MaxDurationUs);
+    printf("%-28s transfers=%u nacks=%u bytes=%llu bus time=%lluus\n", "I2C port 0", (unsigned)l_i2c.m_Transfers, (unsigned)l_i2c.m_Nacks,
+           (unsigned long long)l_i2c.m_Bytes, (unsigned long long)l_i2c.m_BusTimeUs);
+
+    for (int i = 0; i < g_I2CBusManager.GetDeviceCount(); i++)
+    {
+        I2CDeviceStats l_dev;
+        g_I2CBusManager.GetDeviceStats(i, &l_dev);
+
+        char l_name[32];
+        snprintf(l_name, sizeof(l_name), "I2C %s", g_I2CBusManager.GetDeviceName(i));
+
+        printf("%-28s transfers=%u nacks=%u timeouts=%u latency avg=%lluus max=%uus\n", l_name, (unsigned)l_dev.m_Transfers,
+               (unsigned)l_dev.m_Nacks, (unsigned)l_dev.m_Timeouts,
+               (unsigned long long)(l_dev.m_Transfers ? l_dev.m_SumLatencyUs / l_dev.m_Transfers : 0), (unsigned)l_dev.m_MaxLatencyUs);
+    }
+    printf("%-28s %d lines\n", "AppLogger", g_AppLogger.GetLineCount());
+
+    SampleJournalInfo l_journal;
+    g_SampleJournal.GetInfo(&l_journal);
+
+    printf("%-28s pages written=%u sector erases=%u head=%u dropped=%u\n", "SampleJournal", (unsigned)l_journal.m_PagesWritten,
+           (unsigned)l_journal.m_SectorErases, (unsigned)l_journal.m_HeadSeq, (unsigned)l_journal.m_Dropped);
+
+    for (int i = 0; i < PERF_STAGE_CNT; i++)
+    {
+        PerfStageSummary l_summary;
+        g_PerfMetrics.GetSummary((perf_stage_t)i, &l_summary);
+
+        char l_name[40];
+        snprintf(l_name, sizeof(l_name), "Stage %s", PerfMetrics::GetStageName((perf_stage_t)i));
+
+        printf("%-28s n=%-6u min=%uus p50=%uus p99=%uus max=%uus\n", l_name, (unsigned)l_summary.m_Count,
+               (unsigned)l_summary.m_MinUs, (unsigned)l_summary.m_P50Us, (unsigned)l_summary.m_P99Us, (unsigned)l_summary.m_MaxUs);
+    }
+
+    fflush(stdout);
+
+    // ---- the FreeRTOS stub threads are detached, so leave without running destructors
+
+    _exit(0);
+}
@@ -0,0 +1,287 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+// --- creates a delta image (see main/ota_delta.h) which turns the firmware running on a
+//     device into a new one:
+//
+//       ./ota_delta old.bin new.bin update.delta
+//
+//     Prints the values for the update manifest: the SHA-256 of the new image and the
+//     app_elf_sha256 of the old one ("from"). Blocks of the old image are found at any
+//     offset of the new one with a rolling checksum, like rsync does.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "mbedtls/sha256.h"
+#include "esp_app_format.h"
+#include "ota_delta.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#define DELTA_BLOCK_SIZE        32          // --- also the shortest copy
+#define DELTA_MAX_CANDIDATES    16          // --- blocks with the same checksum which are compared
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static bool ReadFile(const char *f_name, std::vector<uint8_t> &f_out)
+{
+    FILE *l_file = fopen(f_name, "rb");
+
+    if (!l_file)
+    {
+        fprintf(stderr, "ota_delta: cannot open %s\n", f_name);
+        return false;
+    }
+
+    uint8_t l_buf[4096];
+    size_t  l_len;
+
+    while ((l_len = fread(l_buf, 1, sizeof(l_buf), l_file)) > 0) f_out.insert(f_out.end(), l_buf, l_buf + l_len);
+    fclose(l_file);
+
+    return true;
+}
+
+static void PutU32(std::string &f_out, uint32_t f_value)
+{
+    for (int i = 0; i < 4; i++) f_out += (char)(f_value >> (8 * i));
+}
+
+static void PrintHex(const char *f_name, const uint8_t *f_data, size_t f_len)
+{
+    printf("%-10s", f_name);
+    for (size_t i = 0; i < f_len; i++) printf("%02x", f_data[i]);
+    printf("\n");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- Adler-32 like checksum of a block, which can be moved by one byte cheaply
+
+struct RollingSum
+{
+    uint32_t m_A = 0;
+    uint32_t m_B = 0;
+
+    void Init(const uint8_t *f_data)
+    {
+        m_A = m_B = 0;
+
+        for (int i = 0; i < DELTA_BLOCK_SIZE; i++)
+        {
+            m_A += f_data[i];
+            m_B += m_A;
+        }
+    }
+
+    void Roll(uint8_t f_out, uint8_t f_in)
+    {
+        m_A += f_in - f_out;
+        m_B += m_A - DELTA_BLOCK_SIZE * f_out;
+    }
+
+    uint32_t Get(void) const { return (m_B << 16) ^ m_A; }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class DeltaWriter
+{
+public:
+
+    DeltaWriter(uint32_t f_image_size)
+    {
+        m_Out = OTA_DELTA_MAGIC;
+        m_Out += (char)OTA_DELTA_VERSION;
+        m_Out.append(3, '\0');
+        PutU32(m_Out, f_image_size);
+    }
+
+    void Copy(uint32_t f_offset, uint32_t f_len)
+    {
+        m_Out += OTA_DELTA_OP_COPY;
+        PutU32(m_Out, f_offset);
+        PutU32(m_Out, f_len);
+
+        m_Copied += f_len;
+    }
+
+    void Data(const uint8_t *f_data, uint32_t f_len)
+    {
+        if (!f_len) return;
+
+        m_Out += OTA_DELTA_OP_DATA;
+        PutU32(m_Out, f_len);
+        m_Out.append((const char *)f_data, f_len);
+    }
+
+    const std::string &Finish(void)
+    {
+        m_Out += OTA_DELTA_OP_END;
+        return m_Out;
+    }
+
+    uint32_t GetCopied(void) { return m_Copied; }
+
+private:
+
+    std::string m_Out;
+    uint32_t    m_Copied = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+    if (argc != 4)
+    {
+        fprintf(stderr, "Usage: %s <running image> <new image> <delta output>\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<uint8_t> l_old, l_new;
+
+    if (!ReadFile(argv[1], l_old) || !ReadFile(argv[2], l_new)) return 1;
+
+    // --- index of the old image, one entry per block
+
+    std::unordered_map<uint32_t, std::vector<uint32_t>> l_index;
+
+    for (size_t l_pos = 0; l_pos + DELTA_BLOCK_SIZE <= l_old.size(); l_pos += DELTA_BLOCK_SIZE)
+    {
+        RollingSum l_sum;
+        l_sum.Init(&l_old[l_pos]);
+
+        std::vector<uint32_t> &l_list = l_index[l_sum.Get()];
+        if (l_list.size() < DELTA_MAX_CANDIDATES) l_list.push_back(l_pos);
+    }
+
+    // --- walk through the new image, bytes without a match are collected as data
+
+    DeltaWriter l_writer(l_new.size());
+    RollingSum  l_sum;
+    size_t      l_pos     = 0;
+    size_t      l_literal = 0;          // --- start of the pending data
+    bool        l_valid   = false;
+
+    while (l_pos + DELTA_BLOCK_SIZE <= l_new.size())
+    {
+        if (!l_valid) l_sum.Init(&l_new[l_pos]);
+        l_valid = true;
+
+        size_t l_best_off = 0, l_best_len = 0, l_best_back = 0;
+        auto   l_found = l_index.find(l_sum.Get());
+
+        if (l_found != l_index.end())
+        {
+            for (uint32_t l_off : l_found->second)
+            {
+                if (memcmp(&l_old[l_off], &l_new[l_pos], DELTA_BLOCK_SIZE) != 0) continue;
+
+                // --- extend forward, and backward into the pending data
+
+                size_t l_len = DELTA_BLOCK_SIZE;
+                while (l_off + l_len < l_old.size() && l_pos + l_len < l_new.size() && l_old[l_off + l_len] == l_new[l_pos + l_len]) l_len++;
+
+                size_t l_back = 0;
+                while (l_back < l_off && l_back < l_pos - l_literal && l_old[l_off - l_back - 1] == l_new[l_pos - l_back - 1]) l_back++;
+
+                if (l_len + l_back > l_best_len + l_best_back)
+                {
+                    l_best_off  = l_off;
+                    l_best_len  = l_len;
+                    l_best_back = l_back;
+                }
+            }
+        }
+
+        if (!l_best_len)
+        {
+            if (l_pos + DELTA_BLOCK_SIZE < l_new.size()) l_sum.Roll(l_new[l_pos], l_new[l_pos + DELTA_BLOCK_SIZE]);
+            l_pos++;
+            continue;
+        }
+
+        l_writer.Data(&l_new[l_literal], l_pos - l_best_back - l_literal);
+        l_writer.Copy(l_best_off - l_best_back, l_best_len + l_best_back);
+
+        l_pos     += l_best_len;
+        l_literal  = l_pos;
+        l_valid    = false;
+    }
+
+    l_writer.Data(&l_new[l_literal], l_new.size() - l_literal);
+
+    const std::string &l_delta = l_writer.Finish();
+
+    FILE *l_file = fopen(argv[3], "wb");
+
+    if (!l_file || fwrite(l_delta.data(), 1, l_delta.size(), l_file) != l_delta.size())
+    {
+        fprintf(stderr, "ota_delta: cannot write %s\n", argv[3]);
+        return 1;
+    }
+
+    fclose(l_file);
+
+    // --- values for the manifest
+
+    uint8_t l_sha256[32];
+    mbedtls_sha256(l_new.data(), l_new.size(), l_sha256, 0);
+
+    printf("old image %zu bytes, new image %zu bytes, delta %zu bytes (%.1f%%), %u bytes copied\n", l_old.size(), l_new.size(),
+           l_delta.size(), l_new.size() ? 100.0 * l_delta.size() / l_new.size() : 0.0, (unsigned)l_writer.GetCopied());
+
+    PrintHex("sha256", l_sha256, sizeof(l_sha256));
+
+    size_t l_descpos = sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t);
+
+    if (l_old.size() >= l_descpos + sizeof(esp_app_desc_t) && ((const esp_app_desc_t *)&l_old[l_descpos])->magic_word == ESP_APP_DESC_MAGIC_WORD)
+    {
+        PrintHex("from", ((const esp_app_desc_t *)&l_old[l_descpos])->app_elf_sha256, 32);
+    }
+    else
+    {
+        printf("from      (%s has no app description)\n", argv[1]);
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
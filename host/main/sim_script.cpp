@@ -0,0 +1,533 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <fstream>
+
+#include "esp_log.h"
+
+#include "config_manager.h"
+#include "sim_script.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+static const char *TAG = "SimScript";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+SimScript g_SimScript;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *g_HM3300FieldNames[SIM_HM3300_FIELDS] =
+{
+    "pm1_spm", "pm25_spm", "pm10_spm", "pm1_ae", "pm25_ae", "pm10_ae"
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static bool ToDouble(const string &f_s, double &f_out)
+{
+    char *l_end;
+
+    f_out = strtod(f_s.c_str(), &l_end);
+    return !f_s.empty() && *l_end == 0;
+}
+
+static bool ToInt(const string &f_s, int &f_out)
+{
+    char *l_end;
+
+    f_out = (int)strtol(f_s.c_str(), &l_end, 0);
+    return !f_s.empty() && *l_end == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+SimGenerator::SimGenerator(void)
+{
+    m_Type      = Gen_Const;
+    m_P[0]      = 0;
+    m_P[1]      = 0;
+    m_P[2]      = 0;
+    m_ReplayPos = 0;
+    m_Rng       = 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SimGenerator::Seed(uint32_t f_seed)
+{
+    m_Rng = f_seed ? f_seed : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+double SimGenerator::NextUniform(void)
+{
+    // --- numerical recipes LCG: good enough and identical on every platform
+
+    m_Rng = m_Rng * 1664525u + 1013904223u;
+    return ((m_Rng >> 8) + 0.5) / 16777216.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool SimGenerator::Parse(const vector<string> &f_args, size_t f_start, string &f_err)
+{
+    if (f_start >= f_args.size())
+    {
+        f_err = "generator missing";
+        return false;
+    }
+
+    const string &l_name = f_args[f_start];
+    size_t l_argc = f_args.size() - f_start - 1;
+
+    int l_needed;
+
+    if (l_name == "const")          { m_Type = Gen_Const;   l_needed = 1; }
+    else if (l_name == "ramp")      { m_Type = Gen_Ramp;    l_needed = 2; }
+    else if (l_name == "sine")      { m_Type = Gen_Sine;    l_needed = 3; }
+    else if (l_name == "noise")     { m_Type = Gen_Noise;   l_needed = 2; }
+    else if (l_name == "step")      { m_Type = Gen_Step;    l_needed = 3; }
+    else if (l_name == "replay")
+    {
+        m_Type = Gen_Replay;
+
+        if (l_argc != 1)
+        {
+            f_err = "replay expects one comma separated list";
+            return false;
+        }
+
+        m_Replay.clear();
+        m_ReplayPos = 0;
+
+        string l_list = f_args[f_start + 1];
+        size_t l_pos = 0;
+
+        while (l_pos <= l_list.size())
+        {
+            size_t l_comma = l_list.find(',', l_pos);
+            if (l_comma == string::npos) l_comma = l_list.size();
+
+            double l_v;
+            if (!ToDouble(l_list.substr(l_pos, l_comma - l_pos), l_v))
+            {
+                f_err = "illegal number in replay list";
+                return false;
+            }
+
+            m_Replay.push_back(l_v);
+            l_pos = l_comma + 1;
+        }
+
+        return true;
+    }
+    else
+    {
+        f_err = "unknown generator '" + l_name + "'";
+        return false;
+    }
+
+    if ((int)l_argc != l_needed)
+    {
+        f_err = "generator '" + l_name + "' expects " + to_string(l_needed) + " parameters";
+        return false;
+    }
+
+    for (int i = 0; i < l_needed; i++)
+    {
+        if (!ToDouble(f_args[f_start + 1 + i], m_P[i]))
+        {
+            f_err = "illegal number '" + f_args[f_start + 1 + i] + "'";
+            return false;
+        }
+    }
+
+    if ((m_Type == Gen_Sine || m_Type == Gen_Step) && m_P[2] <= 0)
+    {
+        f_err = "period must be positive";
+        return false;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+double SimGenerator::Sample(double f_t)
+{
+    switch (m_Type)
+    {
+        case Gen_Const:
+            return m_P[0];
+
+        case Gen_Ramp:
+            return m_P[0] + m_P[1] * f_t;
+
+        case Gen_Sine:
+            return m_P[0] + m_P[1] * sin(2.0 * M_PI * f_t / m_P[2]);
+
+        case Gen_Noise:
+        {
+            // --- Box-Muller
+
+            double l_u1 = NextUniform();
+            double l_u2 = NextUniform();
+
+            return m_P[0] + m_P[1] * sqrt(-2.0 * log(l_u1)) * cos(2.0 * M_PI * l_u2);
+        }
+
+        case Gen_Step:
+            return fmod(f_t, m_P[2]) < m_P[2] / 2 ? m_P[0] : m_P[1];
+
+        case Gen_Replay:
+        {
+            double l_v = m_Replay[m_ReplayPos];
+            m_ReplayPos = (m_ReplayPos + 1) % m_Replay.size();
+
+            return l_v;
+        }
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+SimScript::SimScript(void)
+{
+    for (int i = 0; i < SIM_MAX_SENSORS; i++)
+    {
+        m_Sensors[i].m_Type         = "Simulated Sensor";
+        m_Sensors[i].m_LatencyMs    = 0;
+        m_Sensors[i].m_BusyUs       = 0;
+        m_Sensors[i].m_FailEvery    = 0;
+        m_Sensors[i].m_StepSec      = 0;
+        m_Sensors[i].m_Seed         = i + 1;
+        m_Sensors[i].m_PeriodMs     = 0;
+        m_Sensors[i].m_DeadlineMs   = 0;
+    }
+
+    m_HM3300.m_Present      = true;
+    m_HM3300.m_Port         = 0;
+    m_HM3300.m_Address      = 0x40;
+    m_HM3300.m_FailEvery    = 0;
+    m_HM3300.m_StepSec      = 0;
+
+    // --- some plausible dust values unless the script says otherwise
+
+    string l_err;
+
+    m_HM3300.m_Fields[0].Parse({ "sine", "6",  "2", "600" },  0, l_err);
+    m_HM3300.m_Fields[1].Parse({ "sine", "10", "4", "600" },  0, l_err);
+    m_HM3300.m_Fields[2].Parse({ "sine", "14", "5", "600" },  0, l_err);
+    m_HM3300.m_Fields[3].Parse({ "sine", "5",  "2", "600" },  0, l_err);
+    m_HM3300.m_Fields[4].Parse({ "sine", "9",  "4", "600" },  0, l_err);
+    m_HM3300.m_Fields[5].Parse({ "sine", "12", "5", "600" },  0, l_err);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+SimSensorDef &SimScript::GetSensorDef(int f_num)
+{
+    assert(f_num >= 1 && f_num <= SIM_MAX_SENSORS);
+    return m_Sensors[f_num - 1];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+vector<string> SimScript::Tokenize(const string &f_line)
+{
+    vector<string> l_tokens;
+    size_t l_pos = 0;
+
+    while (l_pos < f_line.size())
+    {
+        while (l_pos < f_line.size() && isspace((unsigned char)f_line[l_pos])) l_pos++;
+
+        if (l_pos >= f_line.size() || f_line[l_pos] == '#') break;
+
+        string l_tok;
+
+        if (f_line[l_pos] == '"')
+        {
+            size_t l_end = f_line.find('"', l_pos + 1);
+            if (l_end == string::npos) l_end = f_line.size();
+
+            l_tok = f_line.substr(l_pos + 1, l_end - l_pos - 1);
+            l_pos = l_end + 1;
+        }
+        else
+        {
+            size_t l_end = l_pos;
+            while (l_end < f_line.size() && !isspace((unsigned char)f_line[l_end])) l_end++;
+
+            l_tok = f_line.substr(l_pos, l_end - l_pos);
+            l_pos = l_end;
+        }
+
+        l_tokens.push_back(l_tok);
+    }
+
+    return l_tokens;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool SimScript::ParseLine(const string &f_line, string &f_err)
+{
+    vector<string> l_tok = Tokenize(f_line);
+
+    if (l_tok.empty()) return true;
+
+    const string &l_cmd = l_tok[0];
+
+    // --- config str|int <key> <value>
+
+    if (l_cmd == "config")
+    {
+        int l_dummy;
+
+        if (l_tok.size() != 4 || (l_tok[1] != "str" && l_tok[1] != "int"))
+        {
+            f_err = "usage: config str|int <key> <value>";
+            return false;
+        }
+
+        if (l_tok[1] == "int" && !ToInt(l_tok[3], l_dummy))
+        {
+            f_err = "illegal int value '" + l_tok[3] + "'";
+            return false;
+        }
+
+        m_Config.push_back({ l_tok[2], l_tok[3], l_tok[1] == "int" });
+        return true;
+    }
+
+    // --- sensor <n> ...
+
+    if (l_cmd == "sensor")
+    {
+        int l_num;
+
+        if (l_tok.size() < 4 || !ToInt(l_tok[1], l_num) || l_num < 1 || l_num > SIM_MAX_SENSORS)
+        {
+            f_err = "usage: sensor <1.." + to_string(SIM_MAX_SENSORS) + "> <attribute> ...";
+            return false;
+        }
+
+        SimSensorDef &l_def = m_Sensors[l_num - 1];
+        const string &l_attr = l_tok[2];
+
+        if (l_attr == "type")
+        {
+            l_def.m_Type = l_tok[3];
+            return true;
+        }
+
+        if (l_attr == "channel")
+        {
+            if (l_tok.size() < 7)
+            {
+                f_err = "usage: sensor <n> channel <name> <unit> <text> <generator...>";
+                return false;
+            }
+
+            SimChannel l_ch;
+
+            l_ch.m_Name = l_tok[3];
+            l_ch.m_Unit = l_tok[4];
+            l_ch.m_Text = l_tok[5];
+            l_ch.m_Gen.Seed(l_def.m_Seed * 7919 + l_def.m_Channels.size());
+
+            if (!l_ch.m_Gen.Parse(l_tok, 6, f_err)) return false;
+
+            l_def.m_Channels.push_back(l_ch);
+            return true;
+        }
+
+        int l_ival;
+        double l_dval;
+
+        if (l_attr == "latency" && ToInt(l_tok[3], l_ival))     { l_def.m_LatencyMs = l_ival;   return true; }
+        if (l_attr == "busy" && ToInt(l_tok[3], l_ival))        { l_def.m_BusyUs = l_ival;      return true; }
+        if (l_attr == "fail" && ToInt(l_tok[3], l_ival))        { l_def.m_FailEvery = l_ival;   return true; }
+        if (l_attr == "step" && ToDouble(l_tok[3], l_dval))     { l_def.m_StepSec = l_dval;     return true; }
+        if (l_attr == "period" && ToInt(l_tok[3], l_ival))      { l_def.m_PeriodMs = l_ival;    return true; }
+        if (l_attr == "deadline" && ToInt(l_tok[3], l_ival))    { l_def.m_DeadlineMs = l_ival;  return true; }
+
+        if (l_attr == "seed" && ToInt(l_tok[3], l_ival))
+        {
+            l_def.m_Seed = l_ival;
+            for (size_t i = 0; i < l_def.m_Channels.size(); i++) l_def.m_Channels[i].m_Gen.Seed(l_ival * 7919 + i);
+            return true;
+        }
+
+        f_err = "unknown or malformed sensor attribute '" + l_attr + "'";
+        return false;
+    }
+
+    // --- hm3300 ...
+
+    if (l_cmd == "hm3300")
+    {
+        if (l_tok.size() == 2 && l_tok[1] == "absent")
+        {
+            m_HM3300.m_Present = false;
+            return true;
+        }
+
+        if (l_tok.size() < 3)
+        {
+            f_err = "usage: hm3300 <field> <generator...>";
+            return false;
+        }
+
+        int l_ival;
+        double l_dval;
+
+        if (l_tok[1] == "fail" && ToInt(l_tok[2], l_ival))      { m_HM3300.m_FailEvery = l_ival;    return true; }
+        if (l_tok[1] == "step" && ToDouble(l_tok[2], l_dval))   { m_HM3300.m_StepSec = l_dval;      return true; }
+
+        for (int i = 0; i < SIM_HM3300_FIELDS; i++)
+        {
+            if (l_tok[1] == g_HM3300FieldNames[i]) return m_HM3300.m_Fields[i].Parse(l_tok, 2, f_err);
+        }
+
+        f_err = "unknown hm3300 field '" + l_tok[1] + "'";
+        return false;
+    }
+
+    // --- broker up|down <at sec>
+
+    if (l_cmd == "broker")
+    {
+        double l_at;
+
+        if (l_tok.size() != 3 || (l_tok[1] != "up" && l_tok[1] != "down") || !ToDouble(l_tok[2], l_at))
+        {
+            f_err = "usage: broker up|down <at sec>";
+            return false;
+        }
+
+        m_BrokerSchedule.push_back(make_pair(l_at, l_tok[1] == "up"));
+        return true;
+    }
+
+    f_err = "unknown statement '" + l_cmd + "'";
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool SimScript::LoadFile(const char *f_path)
+{
+    ifstream l_in(f_path);
+
+    if (!l_in)
+    {
+        ESP_LOGE(TAG, "Cannot open script %s", f_path);
+        return false;
+    }
+
+    string  l_line;
+    int     l_lineno = 0;
+    bool    l_ok = true;
+
+    while (getline(l_in, l_line))
+    {
+        string l_err;
+
+        ++l_lineno;
+
+        if (!ParseLine(l_line, l_err))
+        {
+            ESP_LOGE(TAG, "%s:%d: %s", f_path, l_lineno, l_err.c_str());
+            l_ok = false;
+        }
+    }
+
+    return l_ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SimScript::ApplyConfig(void)
+{
+    g_ConfigManager.BeginUpdate();
+
+    for (const ConfigEntry &l_e : m_Config)
+    {
+        int       l_key = ConfigManager::FindKey(l_e.m_Key.c_str());
+        esp_err_t l_err = ESP_ERR_NOT_FOUND;
+
+        if (l_key >= 0)
+        {
+            if (l_e.m_IsInt) l_err = g_ConfigManager.SetIntValue((cfmgr_key_t)l_key, atoi(l_e.m_Value.c_str()));
+            else l_err = g_ConfigManager.SetStringValue((cfmgr_key_t)l_key, l_e.m_Value.c_str());
+        }
+
+        if (l_err != ESP_OK) ESP_LOGE(TAG, "config %s: %s", l_e.m_Key.c_str(), esp_err_to_name(l_err));
+    }
+
+    g_ConfigManager.EndUpdate();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SimScript::AddDefaults(void)
+{
+    string l_err;
+
+    for (int i = 0; i < SIM_MAX_SENSORS; i++)
+    {
+        if (!m_Sensors[i].m_Channels.empty()) continue;
+
+        string l_prefix = "sensor " + to_string(i + 1) + " channel ";
+
+        ParseLine(l_prefix + "temp C Temperature sine 21.5 2.5 900", l_err);
+        ParseLine(l_prefix + "hum % Humidity noise 45 1.5", l_err);
+    }
+}
@@ -0,0 +1,185 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SIM_SCRIPT_H_
+#define	SIM_SCRIPT_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#define SIM_MAX_SENSORS     4
+#define SIM_HM3300_FIELDS   6
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- a value generator for one simulated channel. f_t is the simulated time in seconds.
+//
+//     const <v>                        constant value
+//     ramp <start> <slope/s>           linear ramp
+//     sine <offset> <amplitude> <period s>
+//     noise <mean> <stddev>            gaussian noise (seeded, reproducible)
+//     step <v1> <v2> <period s>        square wave, v1 for the first half of the period
+//     replay <v1,v2,...>               cycles through the list, one value per sample
+
+class SimGenerator
+{
+public:
+    SimGenerator(void);
+
+    bool Parse(const std::vector<std::string> &f_args, size_t f_start, std::string &f_err);
+    void Seed(uint32_t f_seed);
+
+    double Sample(double f_t);
+
+private:
+
+    enum GenType { Gen_Const, Gen_Ramp, Gen_Sine, Gen_Noise, Gen_Step, Gen_Replay };
+
+    double NextUniform(void);
+
+    GenType             m_Type;
+    double              m_P[3];
+    std::vector<double> m_Replay;
+    size_t              m_ReplayPos;
+    uint32_t            m_Rng;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+struct SimChannel
+{
+    std::string     m_Name;
+    std::string     m_Unit;
+    std::string     m_Text;
+    SimGenerator    m_Gen;
+};
+
+// --- behaviour of one CFakeSensor
+
+struct SimSensorDef
+{
+    std::string             m_Type;
+    std::vector<SimChannel> m_Channels;
+
+    int                     m_LatencyMs;    // --- blocking time per measurement (vTaskDelay)
+    int                     m_BusyUs;       // --- CPU time per measurement (busy wait)
+    int                     m_FailEvery;    // --- every n-th measurement fails (0: never)
+    double                  m_StepSec;      // --- simulated time per measurement (0: wall clock)
+    uint32_t                m_Seed;
+    int                     m_PeriodMs;     // --- acquisition period (0: CSensor default)
+    int                     m_DeadlineMs;   // --- acquisition deadline (0: CSensor default)
+};
+
+// --- behaviour of the emulated HM3300 on the I2C bus
+
+struct SimHM3300Def
+{
+    bool                    m_Present;
+    int                     m_Port;
+    int                     m_Address;
+    SimGenerator            m_Fields[SIM_HM3300_FIELDS];  // --- pm1_spm pm25_spm pm10_spm pm1_ae pm25_ae pm10_ae
+    int                     m_FailEvery;                  // --- every n-th read has a bad checksum
+    double                  m_StepSec;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the simulation script. One statement per line, '#' starts a comment, strings with
+//     blanks are double quoted.
+//
+//     config str <key> <value>                         preset a ConfigManager string
+//     config int <key> <value>                         preset a ConfigManager int
+//     sensor <n> type <text>
+//     sensor <n> channel <name> <unit> <text> <generator...>
+//     sensor <n> latency <ms> | busy <us> | fail <every> | step <sec> | seed <n>
+//     sensor <n> period <ms> | deadline <ms>           acquisition timing
+//     hm3300 <field> <generator...>                    field: pm1_spm ... pm10_ae
+//     hm3300 fail <every> | step <sec> | absent
+//     broker down <at sec> | broker up <at sec>        MQTT broker outage schedule
+
+class SimScript
+{
+public:
+    SimScript(void);
+
+    bool LoadFile(const char *f_path);
+    bool ParseLine(const std::string &f_line, std::string &f_err);
+
+    // --- presets the config keys of the script in the ConfigManager
+
+    void ApplyConfig(void);
+
+    // --- gives sensors without a channel definition a default set
+
+    void AddDefaults(void);
+
+    SimSensorDef &GetSensorDef(int f_num);
+    SimHM3300Def &GetHM3300Def(void)
+    {
+        return m_HM3300;
+    }
+
+    const std::vector<std::pair<double,bool>> &GetBrokerSchedule(void) const
+    {
+        return m_BrokerSchedule;
+    }
+
+    static std::vector<std::string> Tokenize(const std::string &f_line);
+
+private:
+
+    struct ConfigEntry
+    {
+        std::string m_Key;
+        std::string m_Value;
+        bool        m_IsInt;
+    };
+
+    std::vector<ConfigEntry>            m_Config;
+    SimSensorDef                        m_Sensors[SIM_MAX_SENSORS];
+    SimHM3300Def                        m_HM3300;
+    std::vector<std::pair<double,bool>> m_BrokerSchedule;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+extern SimScript g_SimScript;
+
+#endif
@@ -0,0 +1,637 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdarg.h>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <map>
+
+#include "sdkconfig.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "esp_mac.h"
+#include "esp_chip_info.h"
+#include "esp_idf_version.h"
+#include "esp_app_desc.h"
+#include "esp_partition.h"
+#include "esp_ota_ops.h"
+#include "esp_wifi.h"
+#include "driver/gpio.h"
+#include "rom/ets_sys.h"
+#include "esp_rom_crc.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+static const char *TAG = "host";
+
+static const chrono::steady_clock::time_point g_StartTime = chrono::steady_clock::now();
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- esp_err
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code)
+    {
+        case ESP_OK:                        return "ESP_OK";
+        case ESP_FAIL:                      return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:                return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:           return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE:         return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:          return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:             return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED:         return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:               return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE:      return "ESP_ERR_INVALID_RESPONSE";
+        case ESP_ERR_INVALID_CRC:           return "ESP_ERR_INVALID_CRC";
+        case ESP_ERR_INVALID_VERSION:       return "ESP_ERR_INVALID_VERSION";
+        case ESP_ERR_NOT_FINISHED:          return "ESP_ERR_NOT_FINISHED";
+        case ESP_ERR_NVS_NOT_INITIALIZED:   return "ESP_ERR_NVS_NOT_INITIALIZED";
+        case ESP_ERR_NVS_NOT_FOUND:         return "ESP_ERR_NVS_NOT_FOUND";
+        case ESP_ERR_NVS_TYPE_MISMATCH:     return "ESP_ERR_NVS_TYPE_MISMATCH";
+        case ESP_ERR_NVS_INVALID_LENGTH:    return "ESP_ERR_NVS_INVALID_LENGTH";
+        case ESP_ERR_NVS_NO_FREE_PAGES:     return "ESP_ERR_NVS_NO_FREE_PAGES";
+        case ESP_ERR_NVS_NEW_VERSION_FOUND: return "ESP_ERR_NVS_NEW_VERSION_FOUND";
+        case ESP_ERR_OTA_VALIDATE_FAILED:   return "ESP_ERR_OTA_VALIDATE_FAILED";
+        case ESP_ERR_HTTPD_INVALID_REQ:     return "ESP_ERR_HTTPD_INVALID_REQ";
+        case ESP_ERR_HTTPD_RESP_SEND:       return "ESP_ERR_HTTPD_RESP_SEND";
+    }
+
+    return "UNKNOWN ERROR";
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- esp_log
+
+static esp_log_level_t  g_LogLevel = ESP_LOG_INFO;
+static mutex            g_LogMutex;
+
+void esp_log_level_set(const char *f_tag, esp_log_level_t f_level)
+{
+    g_LogLevel = f_level;
+}
+
+esp_log_level_t esp_log_level_get(const char *f_tag)
+{
+    return g_LogLevel;
+}
+
+uint32_t esp_log_timestamp(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+void esp_log_write(esp_log_level_t f_level, const char *f_tag, const char *f_format, ...)
+{
+    lock_guard<mutex> l_lock(g_LogMutex);
+
+    va_list l_args;
+    va_start(l_args, f_format);
+    vfprintf(stderr, f_format, l_args);
+    va_end(l_args);
+}
+
+void esp_log_buffer_hexdump_internal(const char *f_tag, const void *f_buffer, uint16_t f_len, esp_log_level_t f_level)
+{
+    if (esp_log_level_get(f_tag) < f_level) return;
+
+    lock_guard<mutex> l_lock(g_LogMutex);
+
+    const uint8_t *l_buf = (const uint8_t *)f_buffer;
+
+    for (uint16_t i = 0; i < f_len; i += 16)
+    {
+        fprintf(stderr, "%s: %08x ", f_tag, i);
+
+        for (uint16_t j = i; j < i + 16 && j < f_len; j++) fprintf(stderr, " %02x", l_buf[j]);
+
+        fprintf(stderr, "\n");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- esp_timer / esp_system
+
+int64_t esp_timer_get_time(void)
+{
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - g_StartTime).count();
+}
+
+uint32_t esp_get_free_heap_size(void)
+{
+    // --- there is no meaningful heap limit on the host. Report the size of a typical ESP32.
+
+    return 200 * 1024;
+}
+
+uint32_t esp_get_minimum_free_heap_size(void)
+{
+    return esp_get_free_heap_size();
+}
+
+void ets_delay_us(uint32_t f_us)
+{
+    int64_t l_end = esp_timer_get_time() + f_us;
+
+    while (esp_timer_get_time() < l_end)
+    {
+    }
+}
+
+uint32_t esp_rom_crc32_le(uint32_t f_crc, uint8_t const *f_buf, uint32_t f_len)
+{
+    f_crc = ~f_crc;
+
+    for (uint32_t i = 0; i < f_len; i++)
+    {
+        f_crc ^= f_buf[i];
+        for (int k = 0; k < 8; k++) f_crc = (f_crc >> 1) ^ (0xEDB88320u & (0u - (f_crc & 1u)));
+    }
+
+    return ~f_crc;
+}
+
+void esp_restart(void)
+{
+    ESP_LOGW(TAG, "esp_restart() called - terminating host simulation");
+
+    fflush(stdout);
+    fflush(stderr);
+    exit(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t esp_read_mac(uint8_t *f_mac, esp_mac_type_t f_type)
+{
+    static const uint8_t l_mac[6] = { 0x02, 0x00, 0x00, 0x4c, 0x4f, 0x47 };
+
+    memcpy(f_mac, l_mac, sizeof(l_mac));
+    f_mac[5] += (uint8_t)f_type;
+
+    return ESP_OK;
+}
+
+void esp_chip_info(esp_chip_info_t *f_out_info)
+{
+    memset(f_out_info, 0, sizeof(*f_out_info));
+
+    f_out_info->model   = CHIP_POSIX_LINUX;
+    f_out_info->cores   = 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static bool read_running_app_desc(esp_app_desc_t *f_desc);
+
+// --- the description of a real image in the running partition (host_main --running-image),
+//     otherwise one of the host build
+
+const esp_app_desc_t *esp_app_get_description(void)
+{
+    static esp_app_desc_t l_desc;
+
+    if (read_running_app_desc(&l_desc)) return &l_desc;
+
+    if (l_desc.magic_word != ESP_APP_DESC_MAGIC_WORD)
+    {
+        l_desc.magic_word = ESP_APP_DESC_MAGIC_WORD;
+
+        strlcpy(l_desc.version,         "host",                 sizeof(l_desc.version));
+        strlcpy(l_desc.project_name,    CONFIG_PRODUCT_NAME,    sizeof(l_desc.project_name));
+        strlcpy(l_desc.time,            __TIME__,               sizeof(l_desc.time));
+        strlcpy(l_desc.date,            __DATE__,               sizeof(l_desc.date));
+        strlcpy(l_desc.idf_ver,         IDF_VER,                sizeof(l_desc.idf_ver));
+    }
+
+    return &l_desc;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- partitions: the layout of partitions_example.csv, backed by lazily allocated memory
+
+struct HostPartition
+{
+    esp_partition_t     m_Part;
+    vector<uint8_t>     m_Data;
+};
+
+static mutex g_PartitionMutex;
+
+static HostPartition g_Partitions[] =
+{
+    { { NULL, ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS,    0x9000,   0x4000,   0x1000, "nvs",    false, false }, {} },
+    { { NULL, ESP_PARTITION_TYPE_APP,  ESP_PARTITION_SUBTYPE_APP_OTA_0,   0x10000,  0x180000, 0x1000, "ota_0",  false, false }, {} },
+    { { NULL, ESP_PARTITION_TYPE_APP,  ESP_PARTITION_SUBTYPE_APP_OTA_1,   0x190000, 0x180000, 0x1000, "ota_1",  false, false }, {} },
+    { { NULL, ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, 0x310000, 0x80000,  0x1000, "www",    false, false }, {} },
+    { { NULL, ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40,     0x390000, 0x40000,  0x1000, "samples", false, false }, {} },
+};
+
+static const int g_PartitionCnt = sizeof(g_Partitions) / sizeof(g_Partitions[0]);
+
+static const esp_partition_t *g_RunningPartition = &g_Partitions[1].m_Part;
+
+static bool read_running_app_desc(esp_app_desc_t *f_desc)
+{
+    esp_app_desc_t l_desc;
+
+    if (esp_partition_read(g_RunningPartition, sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t), &l_desc, sizeof(l_desc)) != ESP_OK ||
+        l_desc.magic_word != ESP_APP_DESC_MAGIC_WORD)
+    {
+        return false;
+    }
+
+    memcpy(f_desc, &l_desc, sizeof(l_desc));
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static HostPartition *FindHostPartition(const esp_partition_t *f_part)
+{
+    for (int i = 0; i < g_PartitionCnt; i++)
+    {
+        if (&g_Partitions[i].m_Part == f_part)
+        {
+            if (g_Partitions[i].m_Data.empty()) g_Partitions[i].m_Data.assign(f_part->size, 0xff);
+            return &g_Partitions[i];
+        }
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t f_type, esp_partition_subtype_t f_subtype, const char *f_label)
+{
+    for (int i = 0; i < g_PartitionCnt; i++)
+    {
+        const esp_partition_t *l_p = &g_Partitions[i].m_Part;
+
+        if (f_type != ESP_PARTITION_TYPE_ANY && l_p->type != f_type) continue;
+        if (f_subtype != ESP_PARTITION_SUBTYPE_ANY && l_p->subtype != f_subtype) continue;
+        if (f_label && strcmp(f_label, l_p->label) != 0) continue;
+
+        return l_p;
+    }
+
+    return NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *f_part, size_t f_src_offset, void *f_dst, size_t f_size)
+{
+    lock_guard<mutex> l_lock(g_PartitionMutex);
+
+    HostPartition *l_hp = FindHostPartition(f_part);
+
+    if (!l_hp) return ESP_ERR_INVALID_ARG;
+    if (f_src_offset + f_size > f_part->size) return ESP_ERR_INVALID_SIZE;
+
+    memcpy(f_dst, l_hp->m_Data.data() + f_src_offset, f_size);
+
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *f_part, size_t f_dst_offset, const void *f_src, size_t f_size)
+{
+    lock_guard<mutex> l_lock(g_PartitionMutex);
+
+    HostPartition *l_hp = FindHostPartition(f_part);
+
+    if (!l_hp) return ESP_ERR_INVALID_ARG;
+    if (f_dst_offset + f_size > f_part->size) return ESP_ERR_INVALID_SIZE;
+
+    // --- NOR flash semantics: writing can only clear bits
+
+    const uint8_t *l_src = (const uint8_t *)f_src;
+    uint8_t *l_dst = l_hp->m_Data.data() + f_dst_offset;
+
+    for (size_t i = 0; i < f_size; i++) l_dst[i] &= l_src[i];
+
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *f_part, size_t f_offset, size_t f_size)
+{
+    lock_guard<mutex> l_lock(g_PartitionMutex);
+
+    HostPartition *l_hp = FindHostPartition(f_part);
+
+    if (!l_hp) return ESP_ERR_INVALID_ARG;
+    if (f_offset % f_part->erase_size || f_size % f_part->erase_size) return ESP_ERR_INVALID_ARG;
+    if (f_offset + f_size > f_part->size) return ESP_ERR_INVALID_SIZE;
+
+    memset(l_hp->m_Data.data() + f_offset, 0xff, f_size);
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- OTA: images are written into the memory partition and checked for the image magic
+
+struct HostOtaSession
+{
+    const esp_partition_t   *m_Part;
+    size_t                  m_Written;
+};
+
+static map<esp_ota_handle_t, HostOtaSession>    g_OtaSessions;
+static esp_ota_handle_t                         g_OtaNextHandle = 1;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+const esp_partition_t *esp_ota_get_running_partition(void)
+{
+    return g_RunningPartition;
+}
+
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *f_start_from)
+{
+    if (!f_start_from) f_start_from = g_RunningPartition;
+
+    return esp_partition_find_first(ESP_PARTITION_TYPE_APP,
+                                    f_start_from->subtype == ESP_PARTITION_SUBTYPE_APP_OTA_0 ? ESP_PARTITION_SUBTYPE_APP_OTA_1 : ESP_PARTITION_SUBTYPE_APP_OTA_0,
+                                    NULL);
+}
+
+const esp_partition_t *esp_ota_get_last_invalid_partition(void)
+{
+    return NULL;
+}
+
+esp_err_t esp_ota_get_partition_description(const esp_partition_t *f_partition, esp_app_desc_t *f_app_desc)
+{
+    if (f_partition == g_RunningPartition)
+    {
+        memcpy(f_app_desc, esp_app_get_description(), sizeof(esp_app_desc_t));
+        return ESP_OK;
+    }
+
+    // --- the app description follows the image header and the first segment header
+
+    esp_err_t l_err = esp_partition_read(f_partition, sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t), f_app_desc, sizeof(esp_app_desc_t));
+    if (l_err != ESP_OK) return l_err;
+
+    return f_app_desc->magic_word == ESP_APP_DESC_MAGIC_WORD ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t esp_ota_begin(const esp_partition_t *f_partition, size_t f_image_size, esp_ota_handle_t *f_out_handle)
+{
+    if (!f_partition || f_partition == g_RunningPartition) return ESP_ERR_INVALID_ARG;
+
+    if (f_image_size != OTA_WITH_SEQUENTIAL_WRITES)
+    {
+        size_t l_erase = f_image_size == OTA_SIZE_UNKNOWN ? f_partition->size : ((f_image_size + f_partition->erase_size - 1) / f_partition->erase_size) * f_partition->erase_size;
+
+        esp_err_t l_err = esp_partition_erase_range(f_partition, 0, l_erase);
+        if (l_err != ESP_OK) return l_err;
+    }
+
+    lock_guard<mutex> l_lock(g_PartitionMutex);
+
+    *f_out_handle = g_OtaNextHandle++;
+    g_OtaSessions[*f_out_handle] = { f_partition, 0 };
+
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_write(esp_ota_handle_t f_handle, const void *f_data, size_t f_size)
+{
+    HostOtaSession l_session;
+
+    {
+        lock_guard<mutex> l_lock(g_PartitionMutex);
+
+        auto l_it = g_OtaSessions.find(f_handle);
+        if (l_it == g_OtaSessions.end()) return ESP_ERR_INVALID_ARG;
+
+        l_session = l_it->second;
+    }
+
+    if (l_session.m_Written == 0 && f_size > 0 && ((const uint8_t *)f_data)[0] != ESP_IMAGE_HEADER_MAGIC)
+    {
+        ESP_LOGE(TAG, "OTA image has invalid magic byte 0x%02x", ((const uint8_t *)f_data)[0]);
+        return ESP_ERR_OTA_VALIDATE_FAILED;
+    }
+
+    // --- erase sectors as we go (sequential write mode)
+
+    size_t l_end = l_session.m_Written + f_size;
+    size_t l_erase_size = l_session.m_Part->erase_size;
+    size_t l_first = (l_session.m_Written + l_erase_size - 1) / l_erase_size * l_erase_size;
+
+    for (size_t l_sec = l_first; l_sec < l_end; l_sec += l_erase_size)
+    {
+        if (esp_partition_erase_range(l_session.m_Part, l_sec, l_erase_size) != ESP_OK) return ESP_ERR_INVALID_SIZE;
+    }
+
+    esp_err_t l_err = esp_partition_write(l_session.m_Part, l_session.m_Written, f_data, f_size);
+    if (l_err != ESP_OK) return l_err;
+
+    lock_guard<mutex> l_lock(g_PartitionMutex);
+    g_OtaSessions[f_handle].m_Written = l_end;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_end(esp_ota_handle_t f_handle)
+{
+    size_t                  l_written;
+    const esp_partition_t   *l_part;
+
+    {
+        lock_guard<mutex> l_lock(g_PartitionMutex);
+
+        auto l_it = g_OtaSessions.find(f_handle);
+        if (l_it == g_OtaSessions.end()) return ESP_ERR_NOT_FOUND;
+
+        l_written   = l_it->second.m_Written;
+        l_part      = l_it->second.m_Part;
+        g_OtaSessions.erase(l_it);
+    }
+
+    // --- a checksum of the written image, to compare it with the uploaded file
+
+    uint32_t l_hash = 2166136261u;
+
+    for (size_t l_pos = 0; l_pos < l_written; )
+    {
+        uint8_t l_buf[4096];
+        size_t  l_len = l_written - l_pos < sizeof(l_buf) ? l_written - l_pos : sizeof(l_buf);
+
+        if (esp_partition_read(l_part, l_pos, l_buf, l_len) != ESP_OK) break;
+
+        for (size_t i = 0; i < l_len; i++) l_hash = (l_hash ^ l_buf[i]) * 16777619u;
+        l_pos += l_len;
+    }
+
+    ESP_LOGW(TAG, "OTA image of %u bytes written to %s, FNV-1a 0x%08x", (unsigned)l_written, l_part->label, (unsigned)l_hash);
+
+    return l_written > sizeof(esp_image_header_t) ? ESP_OK : ESP_ERR_OTA_VALIDATE_FAILED;
+}
+
+esp_err_t esp_ota_abort(esp_ota_handle_t f_handle)
+{
+    lock_guard<mutex> l_lock(g_PartitionMutex);
+
+    return g_OtaSessions.erase(f_handle) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *f_partition)
+{
+    if (!f_partition || f_partition->type != ESP_PARTITION_TYPE_APP) return ESP_ERR_INVALID_ARG;
+
+    ESP_LOGI(TAG, "Boot partition set to %s", f_partition->label);
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- Wi-Fi: a fixed set of fake access points
+
+static const wifi_ap_record_t g_FakeAPs[] =
+{
+    { { 0x02, 0x11, 0x22, 0x33, 0x44, 0x01 }, "HostNet",       6,  -48 },
+    { { 0x02, 0x11, 0x22, 0x33, 0x44, 0x02 }, "HostNet-Guest", 6,  -55 },
+    { { 0x02, 0x11, 0x22, 0x33, 0x44, 0x03 }, "Neighbour",     11, -81 },
+};
+
+static const uint16_t g_FakeAPCnt = sizeof(g_FakeAPs) / sizeof(g_FakeAPs[0]);
+
+esp_err_t esp_wifi_scan_start(const wifi_scan_config_t *f_config, bool f_block)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_scan_get_ap_num(uint16_t *f_number)
+{
+    *f_number = g_FakeAPCnt;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_scan_get_ap_records(uint16_t *f_number, wifi_ap_record_t *f_ap_records)
+{
+    if (*f_number > g_FakeAPCnt) *f_number = g_FakeAPCnt;
+
+    memcpy(f_ap_records, g_FakeAPs, *f_number * sizeof(wifi_ap_record_t));
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *f_ap_info)
+{
+    memcpy(f_ap_info, &g_FakeAPs[0], sizeof(wifi_ap_record_t));
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- GPIO: remember output levels, inputs read as high (pull-up)
+
+static int g_GpioLevel[GPIO_NUM_MAX];
+
+static bool IsValidGpio(gpio_num_t f_gpio)
+{
+    return f_gpio >= 0 && f_gpio < GPIO_NUM_MAX;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t f_gpio)
+{
+    if (!IsValidGpio(f_gpio)) return ESP_ERR_INVALID_ARG;
+
+    g_GpioLevel[f_gpio] = 1;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_direction(gpio_num_t f_gpio, gpio_mode_t f_mode)
+{
+    return IsValidGpio(f_gpio) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_set_pull_mode(gpio_num_t f_gpio, gpio_pull_mode_t f_pull)
+{
+    if (!IsValidGpio(f_gpio)) return ESP_ERR_INVALID_ARG;
+
+    g_GpioLevel[f_gpio] = f_pull == GPIO_PULLDOWN_ONLY ? 0 : 1;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t f_gpio, uint32_t f_level)
+{
+    if (!IsValidGpio(f_gpio)) return ESP_ERR_INVALID_ARG;
+
+    g_GpioLevel[f_gpio] = f_level ? 1 : 0;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t f_gpio)
+{
+    return IsValidGpio(f_gpio) ? g_GpioLevel[f_gpio] : 0;
+}
+
+esp_err_t gpio_dump_io_configuration(FILE *f_out, uint64_t f_mask)
+{
+    for (int i = 0; i < GPIO_NUM_MAX; i++)
+    {
+        if (f_mask & (1ULL << i)) fprintf(f_out, "IO[%d] level: %d\n", i, g_GpioLevel[i]);
+    }
+
+    return ESP_OK;
+}
@@ -0,0 +1,728 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <string>
+#include <map>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/timers.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+typedef chrono::steady_clock HostClock;
+
+static const HostClock::time_point g_StartTime = HostClock::now();
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- a task is a std::thread plus the state needed for direct to task notifications
+
+struct HostTask
+{
+    string                  m_Name;
+    TaskFunction_t          m_Code;
+    void                    *m_Param;
+
+    mutex                   m_NotifyMutex;
+    condition_variable      m_NotifyCond;
+    uint32_t                m_NotifyValue;
+    bool                    m_NotifyPending;
+};
+
+// --- thrown by vTaskDelete(NULL) to unwind the calling thread
+
+struct HostTaskExit
+{
+};
+
+static thread_local HostTask *t_CurrentTask = NULL;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static recursive_mutex g_CriticalMutex;
+
+void host_enter_critical(portMUX_TYPE *f_mux)
+{
+    g_CriticalMutex.lock();
+}
+
+void host_exit_critical(portMUX_TYPE *f_mux)
+{
+    g_CriticalMutex.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static HostClock::time_point TickToTimePoint(TickType_t f_tick)
+{
+    return g_StartTime + chrono::milliseconds(pdTICKS_TO_MS(f_tick));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+TickType_t xTaskGetTickCount(void)
+{
+    auto l_elapsed = chrono::duration_cast<chrono::milliseconds>(HostClock::now() - g_StartTime);
+    return pdMS_TO_TICKS(l_elapsed.count());
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return xTaskGetTickCount();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static void TaskTrampoline(HostTask *f_task)
+{
+    t_CurrentTask = f_task;
+
+    try
+    {
+        f_task->m_Code(f_task->m_Param);
+    }
+    catch (const HostTaskExit &)
+    {
+        // --- task deleted itself
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t f_code, const char *f_name, uint32_t f_stack, void *f_param,
+                                   UBaseType_t f_prio, TaskHandle_t *f_handle, BaseType_t f_core)
+{
+    // --- task objects are never freed: handles may be used after the task ended
+
+    HostTask *l_task = new HostTask;
+
+    l_task->m_Name          = f_name ? f_name : "";
+    l_task->m_Code          = f_code;
+    l_task->m_Param         = f_param;
+    l_task->m_NotifyValue   = 0;
+    l_task->m_NotifyPending = false;
+
+    if (f_handle) *f_handle = l_task;
+
+    thread(TaskTrampoline, l_task).detach();
+
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t f_code, const char *f_name, uint32_t f_stack, void *f_param,
+                       UBaseType_t f_prio, TaskHandle_t *f_handle)
+{
+    return xTaskCreatePinnedToCore(f_code, f_name, f_stack, f_param, f_prio, f_handle, tskNO_AFFINITY);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void vTaskDelete(TaskHandle_t f_task)
+{
+    // --- only self deletion is supported - a std::thread cannot be killed from outside
+
+    if (f_task == NULL || f_task == t_CurrentTask)
+    {
+        throw HostTaskExit();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void vTaskDelay(const TickType_t f_ticks)
+{
+    this_thread::sleep_for(chrono::milliseconds(pdTICKS_TO_MS(f_ticks)));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+BaseType_t xTaskDelayUntil(TickType_t *f_prev_wake, const TickType_t f_increment)
+{
+    TickType_t l_wake = *f_prev_wake + f_increment;
+    TickType_t l_now  = xTaskGetTickCount();
+
+    *f_prev_wake = l_wake;
+
+    // --- like FreeRTOS: if the wake time already passed, return immediately
+
+    if ((int32_t)(l_wake - l_now) <= 0) return pdFALSE;
+
+    this_thread::sleep_until(TickToTimePoint(l_wake));
+    return pdTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static HostTask *GetCurrentTask(void)
+{
+    // --- threads not created by xTaskCreate (e.g. main) get a task object on first use
+
+    if (!t_CurrentTask)
+    {
+        t_CurrentTask = new HostTask;
+        t_CurrentTask->m_Name           = "main";
+        t_CurrentTask->m_Code           = NULL;
+        t_CurrentTask->m_Param          = NULL;
+        t_CurrentTask->m_NotifyValue    = 0;
+        t_CurrentTask->m_NotifyPending  = false;
+    }
+
+    return t_CurrentTask;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return GetCurrentTask();
+}
+
+const char *pcTaskGetName(TaskHandle_t f_task)
+{
+    if (!f_task) f_task = GetCurrentTask();
+    return f_task->m_Name.c_str();
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t f_task)
+{
+    // --- not meaningful on the host
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+BaseType_t xTaskGenericNotify(TaskHandle_t f_task, uint32_t f_value, eNotifyAction f_action)
+{
+    assert(f_task);
+
+    lock_guard<mutex> l_lock(f_task->m_NotifyMutex);
+
+    BaseType_t l_ret = pdPASS;
+
+    switch (f_action)
+    {
+        case eNoAction:                                                         break;
+        case eSetBits:                  f_task->m_NotifyValue |= f_value;       break;
+        case eIncrement:                f_task->m_NotifyValue++;                break;
+        case eSetValueWithOverwrite:    f_task->m_NotifyValue = f_value;        break;
+        case eSetValueWithoutOverwrite:
+            if (f_task->m_NotifyPending) l_ret = pdFAIL;
+            else f_task->m_NotifyValue = f_value;
+            break;
+    }
+
+    f_task->m_NotifyPending = true;
+    f_task->m_NotifyCond.notify_all();
+
+    return l_ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- wait until a notification is pending or the timeout expired. Caller holds the lock.
+
+static bool WaitForNotification(HostTask *f_task, unique_lock<mutex> &f_lock, TickType_t f_ticks)
+{
+    auto l_pred = [f_task] { return f_task->m_NotifyPending; };
+
+    if (f_ticks == portMAX_DELAY)
+    {
+        f_task->m_NotifyCond.wait(f_lock, l_pred);
+        return true;
+    }
+
+    return f_task->m_NotifyCond.wait_for(f_lock, chrono::milliseconds(pdTICKS_TO_MS(f_ticks)), l_pred);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t ulTaskNotifyTake(BaseType_t f_clear_on_exit, TickType_t f_ticks)
+{
+    HostTask *l_task = GetCurrentTask();
+    unique_lock<mutex> l_lock(l_task->m_NotifyMutex);
+
+    if (l_task->m_NotifyValue == 0)
+    {
+        l_task->m_NotifyPending = false;
+        WaitForNotification(l_task, l_lock, f_ticks);
+    }
+
+    uint32_t l_value = l_task->m_NotifyValue;
+
+    if (l_value)
+    {
+        if (f_clear_on_exit) l_task->m_NotifyValue = 0;
+        else l_task->m_NotifyValue--;
+    }
+
+    l_task->m_NotifyPending = false;
+
+    return l_value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+BaseType_t xTaskNotifyWait(uint32_t f_clear_on_entry, uint32_t f_clear_on_exit, uint32_t *f_value, TickType_t f_ticks)
+{
+    HostTask *l_task = GetCurrentTask();
+    unique_lock<mutex> l_lock(l_task->m_NotifyMutex);
+
+    if (!l_task->m_NotifyPending)
+    {
+        l_task->m_NotifyValue &= ~f_clear_on_entry;
+    }
+
+    bool l_got = WaitForNotification(l_task, l_lock, f_ticks);
+
+    if (f_value) *f_value = l_task->m_NotifyValue;
+
+    if (l_got)
+    {
+        l_task->m_NotifyValue &= ~f_clear_on_exit;
+    }
+
+    l_task->m_NotifyPending = false;
+
+    return l_got ? pdTRUE : pdFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- queues (and semaphores, which are queues with an item size of zero)
+
+struct HostQueue
+{
+    mutex                   m_Mutex;
+    condition_variable      m_CanSend;
+    condition_variable      m_CanReceive;
+
+    UBaseType_t             m_Length;
+    UBaseType_t             m_ItemSize;
+    UBaseType_t             m_Count;
+
+    deque<vector<uint8_t>>  m_Items;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+template <class Pred> static bool WaitOn(condition_variable &f_cond, unique_lock<mutex> &f_lock, TickType_t f_ticks, Pred f_pred)
+{
+    if (f_ticks == portMAX_DELAY)
+    {
+        f_cond.wait(f_lock, f_pred);
+        return true;
+    }
+
+    return f_cond.wait_for(f_lock, chrono::milliseconds(pdTICKS_TO_MS(f_ticks)), f_pred);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+QueueHandle_t xQueueGenericCreate(UBaseType_t f_length, UBaseType_t f_item_size)
+{
+    HostQueue *l_q = new HostQueue;
+
+    l_q->m_Length   = f_length;
+    l_q->m_ItemSize = f_item_size;
+    l_q->m_Count    = 0;
+
+    return l_q;
+}
+
+QueueHandle_t xQueueCreateCountingSemaphore(UBaseType_t f_max, UBaseType_t f_initial)
+{
+    HostQueue *l_q = xQueueGenericCreate(f_max, 0);
+    l_q->m_Count = f_initial;
+
+    return l_q;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+BaseType_t xQueueGenericSend(QueueHandle_t f_queue, const void *f_item, TickType_t f_ticks, BaseType_t f_position)
+{
+    unique_lock<mutex> l_lock(f_queue->m_Mutex);
+
+    if (f_position == queueOVERWRITE && f_queue->m_Count == f_queue->m_Length && f_queue->m_Count > 0)
+    {
+        f_queue->m_Items.pop_back();
+        f_queue->m_Count--;
+    }
+
+    if (!WaitOn(f_queue->m_CanSend, l_lock, f_ticks, [f_queue] { return f_queue->m_Count < f_queue->m_Length; }))
+    {
+        return errQUEUE_FULL;
+    }
+
+    if (f_queue->m_ItemSize)
+    {
+        const uint8_t *l_src = (const uint8_t *)f_item;
+        vector<uint8_t> l_item(l_src, l_src + f_queue->m_ItemSize);
+
+        if (f_position == queueSEND_TO_FRONT) f_queue->m_Items.push_front(std::move(l_item));
+        else f_queue->m_Items.push_back(std::move(l_item));
+    }
+
+    f_queue->m_Count++;
+    f_queue->m_CanReceive.notify_one();
+
+    return pdPASS;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static BaseType_t QueueFetch(QueueHandle_t f_queue, void *f_buffer, TickType_t f_ticks, bool f_remove)
+{
+    unique_lock<mutex> l_lock(f_queue->m_Mutex);
+
+    if (!WaitOn(f_queue->m_CanReceive, l_lock, f_ticks, [f_queue] { return f_queue->m_Count > 0; }))
+    {
+        return errQUEUE_EMPTY;
+    }
+
+    if (f_queue->m_ItemSize)
+    {
+        if (f_buffer) memcpy(f_buffer, f_queue->m_Items.front().data(), f_queue->m_ItemSize);
+        if (f_remove) f_queue->m_Items.pop_front();
+    }
+
+    if (f_remove)
+    {
+        f_queue->m_Count--;
+        f_queue->m_CanSend.notify_one();
+    }
+    else
+    {
+        f_queue->m_CanReceive.notify_one();
+    }
+
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t f_queue, void *f_buffer, TickType_t f_ticks)
+{
+    return QueueFetch(f_queue, f_buffer, f_ticks, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t f_queue, void *f_buffer, TickType_t f_ticks)
+{
+    return QueueFetch(f_queue, f_buffer, f_ticks, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t f_queue)
+{
+    lock_guard<mutex> l_lock(f_queue->m_Mutex);
+    return f_queue->m_Count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(const QueueHandle_t f_queue)
+{
+    lock_guard<mutex> l_lock(f_queue->m_Mutex);
+    return f_queue->m_Length - f_queue->m_Count;
+}
+
+BaseType_t xQueueReset(QueueHandle_t f_queue)
+{
+    lock_guard<mutex> l_lock(f_queue->m_Mutex);
+
+    f_queue->m_Items.clear();
+    f_queue->m_Count = 0;
+    f_queue->m_CanSend.notify_all();
+
+    return pdPASS;
+}
+
+void vQueueDelete(QueueHandle_t f_queue)
+{
+    delete f_queue;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- event groups
+
+struct HostEventGroup
+{
+    mutex               m_Mutex;
+    condition_variable  m_Cond;
+    EventBits_t         m_Bits;
+};
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    HostEventGroup *l_grp = new HostEventGroup;
+    l_grp->m_Bits = 0;
+
+    return l_grp;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t f_group, const EventBits_t f_bits)
+{
+    lock_guard<mutex> l_lock(f_group->m_Mutex);
+
+    f_group->m_Bits |= f_bits;
+    f_group->m_Cond.notify_all();
+
+    return f_group->m_Bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t f_group, const EventBits_t f_bits)
+{
+    lock_guard<mutex> l_lock(f_group->m_Mutex);
+
+    EventBits_t l_old = f_group->m_Bits;
+    f_group->m_Bits &= ~f_bits;
+
+    return l_old;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t f_group)
+{
+    lock_guard<mutex> l_lock(f_group->m_Mutex);
+    return f_group->m_Bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t f_group, const EventBits_t f_bits, const BaseType_t f_clear_on_exit,
+                                const BaseType_t f_wait_for_all, TickType_t f_ticks)
+{
+    unique_lock<mutex> l_lock(f_group->m_Mutex);
+
+    auto l_pred = [f_group, f_bits, f_wait_for_all]
+    {
+        return f_wait_for_all ? ((f_group->m_Bits & f_bits) == f_bits) : ((f_group->m_Bits & f_bits) != 0);
+    };
+
+    bool l_ok = WaitOn(f_group->m_Cond, l_lock, f_ticks, l_pred);
+
+    EventBits_t l_ret = f_group->m_Bits;
+    if (l_ok && f_clear_on_exit) f_group->m_Bits &= ~f_bits;
+
+    return l_ret;
+}
+
+void vEventGroupDelete(EventGroupHandle_t f_group)
+{
+    delete f_group;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- software timers: one service thread executes all callbacks in expiry order
+
+struct HostTimer
+{
+    string                  m_Name;
+    TickType_t              m_Period;
+    bool                    m_AutoReload;
+    void                    *m_Id;
+    TimerCallbackFunction_t m_Callback;
+
+    bool                    m_Active;
+    bool                    m_Deleted;
+    HostClock::time_point   m_Expiry;
+};
+
+static mutex                g_TimerMutex;
+static condition_variable   g_TimerCond;
+static vector<HostTimer *>  g_Timers;
+static bool                 g_TimerServiceRunning = false;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static void TimerServiceThread(void)
+{
+    t_CurrentTask = new HostTask;
+    t_CurrentTask->m_Name           = "Tmr Svc";
+    t_CurrentTask->m_NotifyValue    = 0;
+    t_CurrentTask->m_NotifyPending  = false;
+
+    unique_lock<mutex> l_lock(g_TimerMutex);
+
+    while (true)
+    {
+        // --- find the next timer to expire
+
+        HostTimer *l_next = NULL;
+
+        for (HostTimer *l_t : g_Timers)
+        {
+            if (l_t->m_Active && (!l_next || l_t->m_Expiry < l_next->m_Expiry)) l_next = l_t;
+        }
+
+        if (!l_next)
+        {
+            g_TimerCond.wait(l_lock);
+            continue;
+        }
+
+        if (HostClock::now() < l_next->m_Expiry)
+        {
+            g_TimerCond.wait_until(l_lock, l_next->m_Expiry);
+            continue;
+        }
+
+        // --- expired: re-arm or stop, then run the callback without holding the lock
+
+        if (l_next->m_AutoReload)
+        {
+            l_next->m_Expiry += chrono::milliseconds(pdTICKS_TO_MS(l_next->m_Period));
+        }
+        else
+        {
+            l_next->m_Active = false;
+        }
+
+        l_lock.unlock();
+        l_next->m_Callback(l_next);
+        l_lock.lock();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+TimerHandle_t xTimerCreate(const char *f_name, TickType_t f_period, UBaseType_t f_autoreload,
+                           void *f_timer_id, TimerCallbackFunction_t f_callback)
+{
+    HostTimer *l_t = new HostTimer;
+
+    l_t->m_Name         = f_name ? f_name : "";
+    l_t->m_Period       = f_period;
+    l_t->m_AutoReload   = f_autoreload != 0;
+    l_t->m_Id           = f_timer_id;
+    l_t->m_Callback     = f_callback;
+    l_t->m_Active       = false;
+    l_t->m_Deleted      = false;
+
+    lock_guard<mutex> l_lock(g_TimerMutex);
+
+    g_Timers.push_back(l_t);
+
+    if (!g_TimerServiceRunning)
+    {
+        thread(TimerServiceThread).detach();
+        g_TimerServiceRunning = true;
+    }
+
+    return l_t;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+BaseType_t xTimerStart(TimerHandle_t f_timer, TickType_t f_ticks_to_wait)
+{
+    if (!f_timer) return pdFAIL;
+
+    lock_guard<mutex> l_lock(g_TimerMutex);
+
+    f_timer->m_Active = true;
+    f_timer->m_Expiry = HostClock::now() + chrono::milliseconds(pdTICKS_TO_MS(f_timer->m_Period));
+    g_TimerCond.notify_all();
+
+    return pdPASS;
+}
+
+BaseType_t xTimerReset(TimerHandle_t f_timer, TickType_t f_ticks_to_wait)
+{
+    return xTimerStart(f_timer, f_ticks_to_wait);
+}
+
+BaseType_t xTimerStop(TimerHandle_t f_timer, TickType_t f_ticks_to_wait)
+{
+    if (!f_timer) return pdFAIL;
+
+    lock_guard<mutex> l_lock(g_TimerMutex);
+
+    f_timer->m_Active = false;
+    g_TimerCond.notify_all();
+
+    return pdPASS;
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t f_timer, TickType_t f_period, TickType_t f_ticks_to_wait)
+{
+    if (!f_timer) return pdFAIL;
+
+    {
+        lock_guard<mutex> l_lock(g_TimerMutex);
+        f_timer->m_Period = f_period;
+    }
+
+    return xTimerStart(f_timer, f_ticks_to_wait);
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t f_timer)
+{
+    lock_guard<mutex> l_lock(g_TimerMutex);
+    return f_timer->m_Active ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xTimerDelete(TimerHandle_t f_timer, TickType_t f_ticks_to_wait)
+{
+    if (!f_timer) return pdFAIL;
+
+    // --- the object is kept alive (the service thread might be running its callback)
+    //     but it is never scheduled again
+
+    lock_guard<mutex> l_lock(g_TimerMutex);
+
+    f_timer->m_Active   = false;
+    f_timer->m_Deleted  = true;
+    g_TimerCond.notify_all();
+
+    return pdPASS;
+}
+
+void *pvTimerGetTimerID(const TimerHandle_t f_timer)
+{
+    return f_timer->m_Id;
+}
@@ -0,0 +1,97 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include "host_compat.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+size_t host_strlcpy(char *f_dst, const char *f_src, size_t f_size)
+{
+    size_t l_len = strlen(f_src);
+
+    if (f_size)
+    {
+        size_t l_copy = l_len < f_size - 1 ? l_len : f_size - 1;
+
+        memcpy(f_dst, f_src, l_copy);
+        f_dst[l_copy] = 0;
+    }
+
+    return l_len;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+size_t host_strlcat(char *f_dst, const char *f_src, size_t f_size)
+{
+    size_t l_dlen = strnlen(f_dst, f_size);
+
+    if (l_dlen == f_size) return f_size + strlen(f_src);
+
+    return l_dlen + host_strlcpy(f_dst + l_dlen, f_src, f_size - l_dlen);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+char *host_itoa(int f_value, char *f_str, int f_base)
+{
+    // --- newlib semantics: only base 10 values are signed
+
+    char            l_tmp[34];
+    int             l_pos = 0;
+    bool            l_neg = f_base == 10 && f_value < 0;
+    unsigned int    l_val = l_neg ? 0u - (unsigned int)f_value : (unsigned int)f_value;
+
+    if (f_base < 2 || f_base > 36)
+    {
+        f_str[0] = 0;
+        return f_str;
+    }
+
+    do
+    {
+        unsigned int l_digit = l_val % f_base;
+        l_tmp[l_pos++] = (char)(l_digit < 10 ? '0' + l_digit : 'a' + l_digit - 10);
+        l_val /= f_base;
+    }
+    while (l_val);
+
+    char *l_out = f_str;
+
+    if (l_neg) *l_out++ = '-';
+    while (l_pos) *l_out++ = l_tmp[--l_pos];
+    *l_out = 0;
+
+    return f_str;
+}
@@ -0,0 +1,246 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <string>
+
+#include "esp_log.h"
+#include "esp_http_client.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+static const char *TAG = "http_client_host";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+struct esp_http_client
+{
+    string      m_Url;
+    int         m_TimeoutMs;
+    int         m_Socket;
+    int         m_Status;
+    int64_t     m_ContentLength;        // --- -1: until the server closes
+    int64_t     m_BodyRead;
+    string      m_Pending;              // --- body bytes received with the headers
+    bool        m_Eof;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *f_config)
+{
+    if (!f_config || !f_config->url) return NULL;
+
+    esp_http_client *l_client = new esp_http_client();
+
+    l_client->m_Url             = f_config->url;
+    l_client->m_TimeoutMs       = f_config->timeout_ms ? f_config->timeout_ms : 5000;
+    l_client->m_Socket          = -1;
+    l_client->m_Status          = 0;
+    l_client->m_ContentLength   = -1;
+    l_client->m_BodyRead        = 0;
+    l_client->m_Eof             = false;
+
+    return l_client;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t f_client, int f_write_len)
+{
+    const string &l_url = f_client->m_Url;
+
+    if (l_url.compare(0, 7, "http://") != 0)
+    {
+        ESP_LOGE(TAG, "Only http:// is supported on the host (%s)", l_url.c_str());
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    size_t l_path  = l_url.find('/', 7);
+    string l_host  = l_url.substr(7, l_path == string::npos ? string::npos : l_path - 7);
+    string l_port  = "80";
+    size_t l_colon = l_host.find(':');
+
+    if (l_colon != string::npos)
+    {
+        l_port = l_host.substr(l_colon + 1);
+        l_host = l_host.substr(0, l_colon);
+    }
+
+    struct addrinfo l_hints = {}, *l_addrs;
+
+    l_hints.ai_family   = AF_UNSPEC;
+    l_hints.ai_socktype = SOCK_STREAM;
+
+    if (getaddrinfo(l_host.c_str(), l_port.c_str(), &l_hints, &l_addrs) != 0) return ESP_FAIL;
+
+    for (struct addrinfo *l_a = l_addrs; l_a && f_client->m_Socket < 0; l_a = l_a->ai_next)
+    {
+        int l_sock = socket(l_a->ai_family, l_a->ai_socktype, l_a->ai_protocol);
+        if (l_sock < 0) continue;
+
+        struct timeval l_tv = { f_client->m_TimeoutMs / 1000, (f_client->m_TimeoutMs % 1000) * 1000 };
+        setsockopt(l_sock, SOL_SOCKET, SO_RCVTIMEO, &l_tv, sizeof(l_tv));
+        setsockopt(l_sock, SOL_SOCKET, SO_SNDTIMEO, &l_tv, sizeof(l_tv));
+
+        if (connect(l_sock, l_a->ai_addr, l_a->ai_addrlen) == 0) f_client->m_Socket = l_sock;
+        else close(l_sock);
+    }
+
+    freeaddrinfo(l_addrs);
+
+    if (f_client->m_Socket < 0) return ESP_FAIL;
+
+    string l_request = "GET " + (l_path == string::npos ? string("/") : l_url.substr(l_path)) + " HTTP/1.1\r\n"
+                       "Host: " + l_url.substr(7, l_path == string::npos ? string::npos : l_path - 7) + "\r\n"
+                       "User-Agent: ESP32 HTTP Client/1.0\r\n"
+                       "Connection: close\r\n\r\n";
+
+    if (send(f_client->m_Socket, l_request.data(), l_request.size(), 0) != (ssize_t)l_request.size()) return ESP_FAIL;
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t f_client)
+{
+    string l_head;
+    char   l_buf[1024];
+    size_t l_end;
+
+    while ((l_end = l_head.find("\r\n\r\n")) == string::npos)
+    {
+        ssize_t l_len = recv(f_client->m_Socket, l_buf, sizeof(l_buf), 0);
+        if (l_len <= 0) return ESP_FAIL;
+
+        l_head.append(l_buf, l_len);
+    }
+
+    f_client->m_Pending = l_head.substr(l_end + 4);
+    l_head.resize(l_end + 2);
+
+    sscanf(l_head.c_str(), "HTTP/%*s %d", &f_client->m_Status);
+
+    for (size_t l_pos = l_head.find("\r\n"); l_pos != string::npos && l_pos + 2 < l_head.size(); l_pos = l_head.find("\r\n", l_pos + 2))
+    {
+        if (strncasecmp(l_head.c_str() + l_pos + 2, "Content-Length:", 15) == 0)
+        {
+            f_client->m_ContentLength = strtoll(l_head.c_str() + l_pos + 17, NULL, 10);
+        }
+    }
+
+    return f_client->m_ContentLength;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t f_client)
+{
+    return f_client->m_Status;
+}
+
+int64_t esp_http_client_get_content_length(esp_http_client_handle_t f_client)
+{
+    return f_client->m_ContentLength;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int esp_http_client_read(esp_http_client_handle_t f_client, char *f_buffer, int f_len)
+{
+    if (f_client->m_ContentLength >= 0 && f_len > f_client->m_ContentLength - f_client->m_BodyRead)
+    {
+        f_len = f_client->m_ContentLength - f_client->m_BodyRead;
+    }
+
+    int l_read = 0;
+
+    if (!f_client->m_Pending.empty())
+    {
+        l_read = f_len < (int)f_client->m_Pending.size() ? f_len : f_client->m_Pending.size();
+
+        memcpy(f_buffer, f_client->m_Pending.data(), l_read);
+        f_client->m_Pending.erase(0, l_read);
+    }
+
+    // --- like the target: fill the buffer unless the body ends
+
+    while (l_read < f_len && !f_client->m_Eof)
+    {
+        ssize_t l_len = recv(f_client->m_Socket, f_buffer + l_read, f_len - l_read, 0);
+
+        if (l_len < 0) return -1;
+        if (l_len == 0) f_client->m_Eof = true;
+
+        l_read += l_len;
+    }
+
+    f_client->m_BodyRead += l_read;
+
+    return l_read;
+}
+
+bool esp_http_client_is_complete_data_received(esp_http_client_handle_t f_client)
+{
+    return f_client->m_ContentLength >= 0 ? f_client->m_BodyRead == f_client->m_ContentLength : f_client->m_Eof;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t f_client)
+{
+    if (f_client->m_Socket >= 0) close(f_client->m_Socket);
+
+    f_client->m_Socket = -1;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t f_client)
+{
+    esp_http_client_close(f_client);
+    delete f_client;
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
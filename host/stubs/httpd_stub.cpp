@@ -0,0 +1,459 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <mutex>
+#include <vector>
+#include <string>
+#include <map>
+#include <strings.h>
+
+#include "esp_log.h"
+#include "esp_http_server.h"
+#include "httpd_host.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+static const char *TAG = "httpd_host";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+struct HostHttpServer
+{
+    httpd_config_t          m_Config;
+    vector<httpd_uri_t>     m_Handlers;
+    mutex                   m_Mutex;        // --- the target server handles one request at a time
+};
+
+// --- per request state hidden behind httpd_req_t::aux
+
+struct HostHttpRequest
+{
+    map<string,string>      m_Headers;
+    const string            *m_Body;
+    size_t                  m_BodyPos;
+    HttpdHostResponse_t     *m_Response;
+    bool                    m_Sent;
+    bool                    m_TypeSet;
+    bool                    m_Async;        // --- continued after the handler returned
+    bool                    m_Closed;       // --- by the client, async requests only
+};
+
+// --- an async request owns copies of what the original one referenced
+
+struct HostAsyncRequest
+{
+    HostHttpRequest         m_State;
+    string                  m_RequestBody;
+    HttpdHostResponse_t     m_Response;
+    bool                    m_Completed;
+};
+
+#define HOST_HTTPD_RECV_SEGMENT             1436
+
+static mutex                        g_AsyncMutex;       // --- the async requests are used by other tasks
+static vector<HostAsyncRequest *>   g_AsyncRequests;
+
+static HostHttpServer *g_LastServer = NULL;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+httpd_handle_t httpd_host_get_server(void)
+{
+    return g_LastServer;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t httpd_start(httpd_handle_t *f_handle, const httpd_config_t *f_config)
+{
+    HostHttpServer *l_srv = new HostHttpServer;
+    l_srv->m_Config = *f_config;
+
+    *f_handle = l_srv;
+    g_LastServer = l_srv;
+
+    ESP_LOGI(TAG, "In-process http server started (port %d not opened)", f_config->server_port);
+
+    return ESP_OK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t f_handle)
+{
+    HostHttpServer *l_srv = (HostHttpServer *)f_handle;
+
+    if (g_LastServer == l_srv) g_LastServer = NULL;
+    delete l_srv;
+
+    return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t f_handle, const httpd_uri_t *f_uri_handler)
+{
+    HostHttpServer *l_srv = (HostHttpServer *)f_handle;
+
+    if (l_srv->m_Handlers.size() >= l_srv->m_Config.max_uri_handlers)
+    {
+        ESP_LOGE(TAG, "No slots left for registering handler %s (max_uri_handlers %d)", f_uri_handler->uri, l_srv->m_Config.max_uri_handlers);
+        return ESP_ERR_HTTPD_BASE + 1;
+    }
+
+    l_srv->m_Handlers.push_back(*f_uri_handler);
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- same semantics as the IDF implementation: '*' at the end matches anything,
+//     '?' at the end makes the preceding character optional
+
+bool httpd_uri_match_wildcard(const char *f_template, const char *f_uri, size_t f_len)
+{
+    size_t l_exact = strlen(f_template);
+
+    bool l_asterisk = l_exact > 0 && f_template[l_exact - 1] == '*';
+    if (l_asterisk) l_exact--;
+
+    bool l_quest = l_exact > 1 && f_template[l_exact - 1] == '?';
+    if (l_quest) l_exact -= 2;
+
+    if (f_len < l_exact || strncmp(f_template, f_uri, l_exact) != 0) return false;
+
+    size_t l_rest = f_len - l_exact;
+
+    // --- the character in front of '?' may or may not be there
+
+    if (l_quest && l_rest > 0 && f_uri[l_exact] == f_template[l_exact]) l_rest--;
+
+    return l_rest == 0 || l_asterisk;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t httpd_host_request(httpd_handle_t f_handle, httpd_method_t f_method, const char *f_uri,
+                             const map<string,string> &f_headers, const string &f_body,
+                             HttpdHostResponse_t *f_response)
+{
+    HostHttpServer *l_srv = (HostHttpServer *)f_handle;
+
+    if (!l_srv) return ESP_ERR_INVALID_STATE;
+    if (strlen(f_uri) > HTTPD_MAX_URI_LEN) return ESP_ERR_INVALID_ARG;
+
+    lock_guard<mutex> l_lock(l_srv->m_Mutex);
+
+    // --- the query string is not part of the match, just like on the target
+
+    size_t l_match_len = strcspn(f_uri, "?");
+
+    const httpd_uri_t *l_handler = NULL;
+
+    for (const httpd_uri_t &l_h : l_srv->m_Handlers)
+    {
+        if (l_h.method != f_method) continue;
+
+        bool l_match = l_srv->m_Config.uri_match_fn ? l_srv->m_Config.uri_match_fn(l_h.uri, f_uri, l_match_len)
+                                                    : (strlen(l_h.uri) == l_match_len && strncmp(l_h.uri, f_uri, l_match_len) == 0);
+        if (l_match)
+        {
+            l_handler = &l_h;
+            break;
+        }
+    }
+
+    f_response->m_Status        = HTTPD_404;
+    f_response->m_Headers.clear();
+    f_response->m_Body.clear();
+    f_response->m_Chunks        = 0;
+    f_response->m_HandlerResult = ESP_ERR_NOT_FOUND;
+
+    if (!l_handler) return ESP_ERR_NOT_FOUND;
+
+    f_response->m_Status = HTTPD_200;
+
+    // --- header names are case insensitive: store them lower case
+
+    HostHttpRequest l_state;
+
+    for (auto &l_kv : f_headers)
+    {
+        string l_name = l_kv.first;
+        for (char &c : l_name) c = (char)tolower((unsigned char)c);
+        l_state.m_Headers[l_name] = l_kv.second;
+    }
+
+    l_state.m_Body      = &f_body;
+    l_state.m_BodyPos   = 0;
+    l_state.m_Response  = f_response;
+    l_state.m_Sent      = false;
+    l_state.m_TypeSet   = false;
+    l_state.m_Async     = false;
+    l_state.m_Closed    = false;
+
+    httpd_req_t *l_req = (httpd_req_t *)calloc(1, sizeof(httpd_req_t));
+
+    l_req->handle       = l_srv;
+    l_req->method       = f_method;
+    l_req->content_len  = f_body.size();
+    l_req->aux          = &l_state;
+    l_req->user_ctx     = l_handler->user_ctx;
+    strcpy((char *)l_req->uri, f_uri);
+
+    f_response->m_HandlerResult = l_handler->handler(l_req);
+
+    free(l_req);
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static HostHttpRequest *GetState(httpd_req_t *f_req)
+{
+    return (HostHttpRequest *)f_req->aux;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int httpd_req_recv(httpd_req_t *f_req, char *f_buf, size_t f_buf_len)
+{
+    HostHttpRequest *l_state = GetState(f_req);
+
+    // --- like lwIP, at most one TCP segment per call
+
+    size_t l_left = l_state->m_Body->size() - l_state->m_BodyPos;
+    size_t l_len = f_buf_len < l_left ? f_buf_len : l_left;
+
+    if (l_len > HOST_HTTPD_RECV_SEGMENT) l_len = HOST_HTTPD_RECV_SEGMENT;
+
+    memcpy(f_buf, l_state->m_Body->data() + l_state->m_BodyPos, l_len);
+    l_state->m_BodyPos += l_len;
+
+    return (int)l_len;
+}
+
+size_t httpd_req_get_hdr_value_len(httpd_req_t *f_req, const char *f_field)
+{
+    HostHttpRequest *l_state = GetState(f_req);
+
+    string l_name = f_field;
+    for (char &c : l_name) c = (char)tolower((unsigned char)c);
+
+    auto l_it = l_state->m_Headers.find(l_name);
+
+    return l_it == l_state->m_Headers.end() ? 0 : l_it->second.size();
+}
+
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *f_req, const char *f_field, char *f_val, size_t f_val_size)
+{
+    HostHttpRequest *l_state = GetState(f_req);
+
+    string l_name = f_field;
+    for (char &c : l_name) c = (char)tolower((unsigned char)c);
+
+    auto l_it = l_state->m_Headers.find(l_name);
+    if (l_it == l_state->m_Headers.end()) return ESP_ERR_NOT_FOUND;
+
+    strlcpy(f_val, l_it->second.c_str(), f_val_size);
+
+    return l_it->second.size() < f_val_size ? ESP_OK : ESP_ERR_HTTPD_BASE + 6;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t httpd_resp_set_status(httpd_req_t *f_req, const char *f_status)
+{
+    GetState(f_req)->m_Response->m_Status = f_status;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *f_req, const char *f_type)
+{
+    GetState(f_req)->m_Response->m_Headers["Content-Type"] = f_type;
+    GetState(f_req)->m_TypeSet = true;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *f_req, const char *f_field, const char *f_value)
+{
+    GetState(f_req)->m_Response->m_Headers[f_field] = f_value;
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static unique_lock<mutex> LockAsync(HostHttpRequest *f_state)
+{
+    return f_state->m_Async ? unique_lock<mutex>(g_AsyncMutex) : unique_lock<mutex>();
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *f_req, const char *f_buf, ssize_t f_buf_len)
+{
+    HostHttpRequest *l_state = GetState(f_req);
+    unique_lock<mutex> l_lock = LockAsync(l_state);
+
+    if (l_state->m_Closed) return ESP_ERR_HTTPD_RESP_SEND;
+
+    if (l_state->m_Sent) return ESP_ERR_HTTPD_RESP_SEND;
+
+    if (!l_state->m_TypeSet) l_state->m_Response->m_Headers["Content-Type"] = HTTPD_TYPE_TEXT;
+    if (f_buf_len == HTTPD_RESP_USE_STRLEN) f_buf_len = f_buf ? strlen(f_buf) : 0;
+
+    if (f_buf) l_state->m_Response->m_Body.assign(f_buf, f_buf_len);
+    l_state->m_Sent = true;
+
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t *f_req, const char *f_buf, ssize_t f_buf_len)
+{
+    HostHttpRequest *l_state = GetState(f_req);
+    unique_lock<mutex> l_lock = LockAsync(l_state);
+
+    if (l_state->m_Closed) return ESP_ERR_HTTPD_RESP_SEND;
+
+    if (l_state->m_Sent) return ESP_ERR_HTTPD_RESP_SEND;
+
+    if (!l_state->m_TypeSet) l_state->m_Response->m_Headers["Content-Type"] = HTTPD_TYPE_TEXT;
+    if (f_buf_len == HTTPD_RESP_USE_STRLEN) f_buf_len = f_buf ? strlen(f_buf) : 0;
+
+    // --- a zero length chunk terminates the response
+
+    if (f_buf == NULL || f_buf_len == 0)
+    {
+        l_state->m_Sent = true;
+        return ESP_OK;
+    }
+
+    l_state->m_Response->m_Body.append(f_buf, f_buf_len);
+    l_state->m_Response->m_Chunks++;
+
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_err(httpd_req_t *f_req, httpd_err_code_t f_error, const char *f_msg)
+{
+    HostHttpRequest *l_state = GetState(f_req);
+
+    const char *l_status;
+
+    switch (f_error)
+    {
+        case HTTPD_400_BAD_REQUEST:     l_status = HTTPD_400;   break;
+        case HTTPD_404_NOT_FOUND:       l_status = HTTPD_404;   break;
+        case HTTPD_408_REQ_TIMEOUT:     l_status = HTTPD_408;   break;
+        case HTTPD_413_CONTENT_TOO_LARGE: l_status = HTTPD_413; break;
+        default:                        l_status = HTTPD_500;   break;
+    }
+
+    // --- an error replaces whatever was sent so far
+
+    l_state->m_Response->m_Status = l_status;
+    l_state->m_Response->m_Body = f_msg ? f_msg : l_status;
+    l_state->m_Response->m_Headers["Content-Type"] = HTTPD_TYPE_TEXT;
+    l_state->m_Sent = true;
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t httpd_req_async_handler_begin(httpd_req_t *f_req, httpd_req_t **f_out)
+{
+    HostHttpRequest  *l_state = GetState(f_req);
+    HostAsyncRequest *l_async = new HostAsyncRequest;
+
+    l_async->m_RequestBody          = *l_state->m_Body;
+    l_async->m_Response             = *l_state->m_Response;
+    l_async->m_Completed            = false;
+
+    l_async->m_State                = *l_state;
+    l_async->m_State.m_Body         = &l_async->m_RequestBody;
+    l_async->m_State.m_Response     = &l_async->m_Response;
+    l_async->m_State.m_Async        = true;
+
+    httpd_req_t *l_req = (httpd_req_t *)malloc(sizeof(httpd_req_t));
+
+    memcpy(l_req, f_req, sizeof(httpd_req_t));
+    l_req->aux = &l_async->m_State;
+
+    lock_guard<mutex> l_lock(g_AsyncMutex);
+    g_AsyncRequests.push_back(l_async);
+
+    *f_out = l_req;
+    return ESP_OK;
+}
+
+esp_err_t httpd_req_async_handler_complete(httpd_req_t *f_req)
+{
+    HostHttpRequest *l_state = GetState(f_req);
+
+    {
+        lock_guard<mutex> l_lock(g_AsyncMutex);
+
+        for (HostAsyncRequest *l_async : g_AsyncRequests)
+        {
+            if (&l_async->m_State == l_state) l_async->m_Completed = true;
+        }
+
+        l_state->m_Sent = true;
+    }
+
+    free(f_req);
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool httpd_host_get_async_response(int f_idx, HttpdHostResponse_t *f_response, bool *f_completed)
+{
+    lock_guard<mutex> l_lock(g_AsyncMutex);
+
+    if (f_idx < 0 || f_idx >= (int)g_AsyncRequests.size()) return false;
+
+    *f_response  = g_AsyncRequests[f_idx]->m_Response;
+    *f_completed = g_AsyncRequests[f_idx]->m_Completed;
+
+    return true;
+}
+
+void httpd_host_close_async(int f_idx)
+{
+    lock_guard<mutex> l_lock(g_AsyncMutex);
+
+    if (f_idx >= 0 && f_idx < (int)g_AsyncRequests.size()) g_AsyncRequests[f_idx]->m_State.m_Closed = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,356 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <chrono>
+#include <thread>
+
+#include "esp_log.h"
+#include "driver/i2c_master.h"
+#include "i2c_host.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+static const char *TAG = "i2c_host";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+struct HostI2cDevice
+{
+    i2c_host_write_cb_t m_Write;
+    i2c_host_read_cb_t  m_Read;
+    void                *m_Ctx;
+};
+
+struct HostI2cBus
+{
+    bool                            m_Installed;
+    map<uint8_t, HostI2cDevice>     m_Devices;
+    I2cHostStats_t                  m_Stats;
+
+    // --- serializes transfers on one bus like the hardware does
+
+    mutex                           m_BusMutex;
+};
+
+static HostI2cBus   g_I2cBus[I2C_NUM_MAX];
+static mutex        g_I2cMutex;
+
+// --- the handles of the driver
+
+struct HostI2cOp
+{
+    i2c_master_dev_t    *m_Dev;
+    const uint8_t       *m_Write;
+    size_t              m_WriteLen;
+    uint8_t             *m_Read;
+    size_t              m_ReadLen;
+};
+
+struct i2c_master_bus_t
+{
+    i2c_port_num_t          m_Port;
+    size_t                  m_QueueDepth;       // --- 0: synchronous
+
+    mutex                   m_QueueMutex;
+    condition_variable      m_QueueCond;
+    deque<HostI2cOp>        m_Queue;
+    int                     m_Pending;          // --- queued or running
+    bool                    m_Stop;
+    thread                  m_Thread;
+};
+
+struct i2c_master_dev_t
+{
+    i2c_master_bus_t        *m_Bus;
+    uint8_t                 m_Address;
+    uint32_t                m_SclSpeed;
+    i2c_master_callback_t   m_OnDone;
+    void                    *m_UserData;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t i2c_host_attach_device(i2c_port_t f_port, uint8_t f_address, i2c_host_write_cb_t f_write, i2c_host_read_cb_t f_read, void *f_ctx)
+{
+    if (f_port < 0 || f_port >= I2C_NUM_MAX) return ESP_ERR_INVALID_ARG;
+
+    lock_guard<mutex> l_lock(g_I2cMutex);
+    g_I2cBus[f_port].m_Devices[f_address] = { f_write, f_read, f_ctx };
+
+    return ESP_OK;
+}
+
+void i2c_host_get_stats(i2c_port_t f_port, I2cHostStats_t *f_stats)
+{
+    lock_guard<mutex> l_lock(g_I2cMutex);
+    *f_stats = g_I2cBus[f_port].m_Stats;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- one transaction: optional write phase, optional (repeated start) read phase
+
+static esp_err_t Transfer(i2c_port_t f_port, uint8_t f_address, uint32_t f_clk, const uint8_t *f_wbuf, size_t f_wlen, uint8_t *f_rbuf, size_t f_rlen)
+{
+    HostI2cBus &l_bus = g_I2cBus[f_port];
+    HostI2cDevice l_dev;
+    bool l_found;
+
+    {
+        lock_guard<mutex> l_lock(g_I2cMutex);
+
+        auto l_it = l_bus.m_Devices.find(f_address);
+        l_found = l_it != l_bus.m_Devices.end();
+        if (l_found) l_dev = l_it->second;
+    }
+
+    lock_guard<mutex> l_buslock(l_bus.m_BusMutex);
+
+    // --- address byte(s) plus data, 9 clocks each
+
+    size_t l_bytes = (f_wlen ? f_wlen + 1 : 0) + (f_rlen ? f_rlen + 1 : 0);
+    uint64_t l_us = (uint64_t)l_bytes * 9 * 1000000 / f_clk;
+
+    esp_err_t l_err = ESP_FAIL;
+
+    if (l_found)
+    {
+        l_err = ESP_OK;
+
+        if (f_wlen && l_dev.m_Write) l_err = l_dev.m_Write(l_dev.m_Ctx, f_wbuf, f_wlen);
+        if (l_err == ESP_OK && f_rlen)
+        {
+            l_err = l_dev.m_Read ? l_dev.m_Read(l_dev.m_Ctx, f_rbuf, f_rlen) : ESP_FAIL;
+        }
+    }
+
+    this_thread::sleep_for(chrono::microseconds(l_us));
+
+    lock_guard<mutex> l_lock(g_I2cMutex);
+
+    l_bus.m_Stats.m_Transfers++;
+    l_bus.m_Stats.m_Bytes     += f_wlen + f_rlen;
+    l_bus.m_Stats.m_BusTimeUs += l_us;
+    if (l_err != ESP_OK) l_bus.m_Stats.m_Nacks++;
+
+    return l_err;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the thread of an asynchronous bus
+
+static void BusThread(i2c_master_bus_t *f_bus)
+{
+    unique_lock<mutex> l_lock(f_bus->m_QueueMutex);
+
+    while (1)
+    {
+        f_bus->m_QueueCond.wait(l_lock, [f_bus] { return f_bus->m_Stop || !f_bus->m_Queue.empty(); });
+        if (f_bus->m_Queue.empty()) return;
+
+        HostI2cOp l_op = f_bus->m_Queue.front();
+        f_bus->m_Queue.pop_front();
+
+        l_lock.unlock();
+
+        i2c_master_dev_t *l_dev = l_op.m_Dev;
+        esp_err_t l_err = Transfer(f_bus->m_Port, l_dev->m_Address, l_dev->m_SclSpeed, l_op.m_Write, l_op.m_WriteLen, l_op.m_Read, l_op.m_ReadLen);
+
+        if (l_dev->m_OnDone)
+        {
+            i2c_master_event_data_t l_evt;
+
+            l_evt.event = l_err == ESP_OK ? I2C_EVENT_DONE : l_err == ESP_ERR_TIMEOUT ? I2C_EVENT_TIMEOUT : I2C_EVENT_NACK;
+            l_dev->m_OnDone(l_dev, &l_evt, l_dev->m_UserData);
+        }
+
+        l_lock.lock();
+
+        f_bus->m_Pending--;
+        f_bus->m_QueueCond.notify_all();
+    }
+}
+
+static esp_err_t Submit(i2c_master_dev_t *f_dev, const uint8_t *f_wbuf, size_t f_wlen, uint8_t *f_rbuf, size_t f_rlen, int f_timeout_ms)
+{
+    if (!f_dev) return ESP_ERR_INVALID_ARG;
+
+    i2c_master_bus_t *l_bus = f_dev->m_Bus;
+
+    if (!l_bus->m_QueueDepth) return Transfer(l_bus->m_Port, f_dev->m_Address, f_dev->m_SclSpeed, f_wbuf, f_wlen, f_rbuf, f_rlen);
+
+    // --- wait for a free place in the queue, like the driver does
+
+    unique_lock<mutex> l_lock(l_bus->m_QueueMutex);
+
+    auto l_space = [l_bus] { return l_bus->m_Queue.size() < l_bus->m_QueueDepth; };
+
+    if (f_timeout_ms < 0) l_bus->m_QueueCond.wait(l_lock, l_space);
+    else if (!l_bus->m_QueueCond.wait_for(l_lock, chrono::milliseconds(f_timeout_ms), l_space)) return ESP_ERR_TIMEOUT;
+
+    l_bus->m_Queue.push_back({ f_dev, f_wbuf, f_wlen, f_rbuf, f_rlen });
+    l_bus->m_Pending++;
+    l_bus->m_QueueCond.notify_all();
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *f_config, i2c_master_bus_handle_t *f_ret_bus)
+{
+    i2c_port_num_t l_port = f_config->i2c_port;
+
+    if (l_port < 0 || l_port >= I2C_NUM_MAX || !f_ret_bus) return ESP_ERR_INVALID_ARG;
+
+    {
+        lock_guard<mutex> l_lock(g_I2cMutex);
+
+        if (g_I2cBus[l_port].m_Installed)
+        {
+            ESP_LOGE(TAG, "i2c port %d is in use", l_port);
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        g_I2cBus[l_port].m_Installed = true;
+    }
+
+    i2c_master_bus_t *l_bus = new i2c_master_bus_t();
+
+    l_bus->m_Port       = l_port;
+    l_bus->m_QueueDepth = f_config->trans_queue_depth;
+    l_bus->m_Pending    = 0;
+    l_bus->m_Stop       = false;
+
+    if (l_bus->m_QueueDepth) l_bus->m_Thread = thread(BusThread, l_bus);
+
+    *f_ret_bus = l_bus;
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_del_master_bus(i2c_master_bus_handle_t f_bus)
+{
+    if (!f_bus) return ESP_ERR_INVALID_ARG;
+
+    if (f_bus->m_Thread.joinable())
+    {
+        {
+            lock_guard<mutex> l_lock(f_bus->m_QueueMutex);
+            f_bus->m_Stop = true;
+            f_bus->m_QueueCond.notify_all();
+        }
+
+        f_bus->m_Thread.join();
+    }
+
+    lock_guard<mutex> l_lock(g_I2cMutex);
+    g_I2cBus[f_bus->m_Port].m_Installed = false;
+
+    delete f_bus;
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t f_bus, const i2c_device_config_t *f_config, i2c_master_dev_handle_t *f_ret_dev)
+{
+    if (!f_bus || !f_config || !f_ret_dev || f_config->dev_addr_length != I2C_ADDR_BIT_LEN_7) return ESP_ERR_INVALID_ARG;
+
+    i2c_master_dev_t *l_dev = new i2c_master_dev_t();
+
+    l_dev->m_Bus        = f_bus;
+    l_dev->m_Address    = (uint8_t)f_config->device_address;
+    l_dev->m_SclSpeed   = f_config->scl_speed_hz ? f_config->scl_speed_hz : 100000;
+    l_dev->m_OnDone     = NULL;
+    l_dev->m_UserData   = NULL;
+
+    *f_ret_dev = l_dev;
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t f_dev)
+{
+    delete f_dev;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_wait_all_done(i2c_master_bus_handle_t f_bus, int f_timeout_ms)
+{
+    if (!f_bus) return ESP_ERR_INVALID_ARG;
+
+    unique_lock<mutex> l_lock(f_bus->m_QueueMutex);
+
+    auto l_idle = [f_bus] { return f_bus->m_Pending == 0; };
+
+    if (f_timeout_ms < 0) f_bus->m_QueueCond.wait(l_lock, l_idle);
+    else if (!f_bus->m_QueueCond.wait_for(l_lock, chrono::milliseconds(f_timeout_ms), l_idle)) return ESP_ERR_TIMEOUT;
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_register_event_callbacks(i2c_master_dev_handle_t f_dev, const i2c_master_event_callbacks_t *f_cbs, void *f_user_data)
+{
+    if (!f_dev || !f_cbs) return ESP_ERR_INVALID_ARG;
+
+    f_dev->m_OnDone     = f_cbs->on_trans_done;
+    f_dev->m_UserData   = f_user_data;
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t f_dev, const uint8_t *f_write_buffer, size_t f_write_size, int f_xfer_timeout_ms)
+{
+    return Submit(f_dev, f_write_buffer, f_write_size, NULL, 0, f_xfer_timeout_ms);
+}
+
+esp_err_t i2c_master_receive(i2c_master_dev_handle_t f_dev, uint8_t *f_read_buffer, size_t f_read_size, int f_xfer_timeout_ms)
+{
+    return Submit(f_dev, NULL, 0, f_read_buffer, f_read_size, f_xfer_timeout_ms);
+}
+
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t f_dev, const uint8_t *f_write_buffer, size_t f_write_size,
+                                      uint8_t *f_read_buffer, size_t f_read_size, int f_xfer_timeout_ms)
+{
+    return Submit(f_dev, f_write_buffer, f_write_size, f_read_buffer, f_read_size, f_xfer_timeout_ms);
+}
@@ -0,0 +1,113 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_DRIVER_GPTIMER_H_
+#define	HOST_DRIVER_GPTIMER_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the general purpose timer, declarations only (see driver/uart.h)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct gptimer_t *gptimer_handle_t;
+
+typedef enum {
+    GPTIMER_CLK_SRC_DEFAULT = 0
+} gptimer_clock_source_t;
+
+typedef enum {
+    GPTIMER_COUNT_DOWN = 0,
+    GPTIMER_COUNT_UP
+} gptimer_count_direction_t;
+
+typedef struct {
+    gptimer_clock_source_t      clk_src;
+    gptimer_count_direction_t   direction;
+    uint32_t                    resolution_hz;
+    int                         intr_priority;
+    struct {
+        uint32_t intr_shared : 1;
+    } flags;
+} gptimer_config_t;
+
+typedef struct {
+    uint64_t count_value;
+    uint64_t alarm_value;
+} gptimer_alarm_event_data_t;
+
+// --- on the target called from the interrupt, returns true if a task was woken
+
+typedef bool (*gptimer_alarm_cb_t)(gptimer_handle_t f_timer, const gptimer_alarm_event_data_t *f_edata, void *f_ctx);
+
+typedef struct {
+    gptimer_alarm_cb_t on_alarm;
+} gptimer_event_callbacks_t;
+
+typedef struct {
+    uint64_t alarm_count;
+    uint64_t reload_count;
+    struct {
+        uint32_t auto_reload_on_alarm : 1;
+    } flags;
+} gptimer_alarm_config_t;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t gptimer_new_timer(const gptimer_config_t *f_config, gptimer_handle_t *f_timer);
+esp_err_t gptimer_del_timer(gptimer_handle_t f_timer);
+esp_err_t gptimer_register_event_callbacks(gptimer_handle_t f_timer, const gptimer_event_callbacks_t *f_cbs, void *f_ctx);
+esp_err_t gptimer_set_alarm_action(gptimer_handle_t f_timer, const gptimer_alarm_config_t *f_config);
+esp_err_t gptimer_set_raw_count(gptimer_handle_t f_timer, uint64_t f_value);
+esp_err_t gptimer_get_raw_count(gptimer_handle_t f_timer, uint64_t *f_value);
+esp_err_t gptimer_enable(gptimer_handle_t f_timer);
+esp_err_t gptimer_disable(gptimer_handle_t f_timer);
+esp_err_t gptimer_start(gptimer_handle_t f_timer);
+esp_err_t gptimer_stop(gptimer_handle_t f_timer);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
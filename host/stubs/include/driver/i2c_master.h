@@ -0,0 +1,111 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_DRIVER_I2C_MASTER_H_
+#define	HOST_DRIVER_I2C_MASTER_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- I2C master driver (bus and device handles) for the host build. Transfers are
+//     routed to emulated devices registered with i2c_host_attach_device() (see
+//     i2c_host.h). A transfer to an address without a device fails like a NACK on the
+//     real bus.
+//
+//     A bus with trans_queue_depth > 0 works asynchronously like on the target: the
+//     transfer functions queue the transaction and return, a thread of the bus does them
+//     in order and calls on_trans_done of the device.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "driver/i2c_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    i2c_port_num_t      i2c_port;
+    gpio_num_t          sda_io_num;
+    gpio_num_t          scl_io_num;
+    i2c_clock_source_t  clk_source;
+    uint8_t             glitch_ignore_cnt;
+    int                 intr_priority;
+    size_t              trans_queue_depth;
+    struct {
+        uint32_t        enable_internal_pullup : 1;
+    } flags;
+} i2c_master_bus_config_t;
+
+typedef struct {
+    i2c_addr_bit_len_t  dev_addr_length;
+    uint16_t            device_address;
+    uint32_t            scl_speed_hz;
+    uint32_t            scl_wait_us;
+    struct {
+        uint32_t        disable_ack_check : 1;
+    } flags;
+} i2c_device_config_t;
+
+typedef struct {
+    i2c_master_callback_t on_trans_done;
+} i2c_master_event_callbacks_t;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *f_config, i2c_master_bus_handle_t *f_ret_bus);
+esp_err_t i2c_del_master_bus(i2c_master_bus_handle_t f_bus);
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t f_bus, const i2c_device_config_t *f_config, i2c_master_dev_handle_t *f_ret_dev);
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t f_dev);
+esp_err_t i2c_master_bus_wait_all_done(i2c_master_bus_handle_t f_bus, int f_timeout_ms);
+
+esp_err_t i2c_master_register_event_callbacks(i2c_master_dev_handle_t f_dev, const i2c_master_event_callbacks_t *f_cbs, void *f_user_data);
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t f_dev, const uint8_t *f_write_buffer, size_t f_write_size, int f_xfer_timeout_ms);
+esp_err_t i2c_master_receive(i2c_master_dev_handle_t f_dev, uint8_t *f_read_buffer, size_t f_read_size, int f_xfer_timeout_ms);
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t f_dev, const uint8_t *f_write_buffer, size_t f_write_size,
+                                      uint8_t *f_read_buffer, size_t f_read_size, int f_xfer_timeout_ms);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
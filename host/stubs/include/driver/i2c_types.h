@@ -0,0 +1,92 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_DRIVER_I2C_TYPES_H_
+#define	HOST_DRIVER_I2C_TYPES_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- types of the I2C master driver (driver/i2c_master.h) for the host build
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef int i2c_port_t;
+typedef int i2c_port_num_t;
+
+#define I2C_NUM_0   0
+#define I2C_NUM_1   1
+#define I2C_NUM_MAX 2
+
+typedef enum {
+    I2C_CLK_SRC_DEFAULT = 0
+} i2c_clock_source_t;
+
+typedef enum {
+    I2C_ADDR_BIT_LEN_7 = 0,
+    I2C_ADDR_BIT_LEN_10
+} i2c_addr_bit_len_t;
+
+typedef struct i2c_master_bus_t *i2c_master_bus_handle_t;
+typedef struct i2c_master_dev_t *i2c_master_dev_handle_t;
+
+typedef enum {
+    I2C_EVENT_ALIVE = 0,
+    I2C_EVENT_DONE,
+    I2C_EVENT_NACK,
+    I2C_EVENT_TIMEOUT
+} i2c_master_event_t;
+
+typedef struct {
+    i2c_master_event_t event;
+} i2c_master_event_data_t;
+
+// --- on the target called from the interrupt, returns true if a task was woken
+
+typedef bool (*i2c_master_callback_t)(i2c_master_dev_handle_t f_dev, const i2c_master_event_data_t *f_evt, void *f_arg);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,138 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_DRIVER_UART_H_
+#define	HOST_DRIVER_UART_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- declarations only: the UART based sensor drivers are compiled (target esp_drivers)
+//     but not linked into the host build, there is no implementation behind them.
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "driver/gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef int uart_port_t;
+
+#define UART_PIN_NO_CHANGE  (-1)
+
+typedef enum {
+    UART_DATA_5_BITS = 0,
+    UART_DATA_6_BITS,
+    UART_DATA_7_BITS,
+    UART_DATA_8_BITS
+} uart_word_length_t;
+
+typedef enum {
+    UART_PARITY_DISABLE = 0,
+    UART_PARITY_EVEN    = 2,
+    UART_PARITY_ODD     = 3
+} uart_parity_t;
+
+typedef enum {
+    UART_STOP_BITS_1    = 1,
+    UART_STOP_BITS_1_5,
+    UART_STOP_BITS_2
+} uart_stop_bits_t;
+
+typedef enum {
+    UART_HW_FLOWCTRL_DISABLE = 0,
+    UART_HW_FLOWCTRL_RTS,
+    UART_HW_FLOWCTRL_CTS,
+    UART_HW_FLOWCTRL_CTS_RTS
+} uart_hw_flowcontrol_t;
+
+typedef enum {
+    UART_SCLK_DEFAULT = 0,
+    UART_SCLK_APB     = 0,
+    UART_SCLK_REF_TICK
+} uart_sclk_t;
+
+typedef struct {
+    int                     baud_rate;
+    uart_word_length_t      data_bits;
+    uart_parity_t           parity;
+    uart_stop_bits_t        stop_bits;
+    uart_hw_flowcontrol_t   flow_ctrl;
+    uint8_t                 rx_flow_ctrl_thresh;
+    uart_sclk_t             source_clk;
+} uart_config_t;
+
+// --- the events the driver posts to the queue of uart_driver_install()
+
+typedef enum {
+    UART_DATA = 0,
+    UART_BREAK,
+    UART_BUFFER_FULL,
+    UART_FIFO_OVF,
+    UART_FRAME_ERR,
+    UART_PARITY_ERR,
+    UART_DATA_BREAK,
+    UART_PATTERN_DET,
+    UART_EVENT_MAX
+} uart_event_type_t;
+
+typedef struct {
+    uart_event_type_t   type;
+    size_t              size;
+    bool                timeout_flag;
+} uart_event_t;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t uart_driver_install(uart_port_t f_uart, int f_rx_size, int f_tx_size, int f_queue_size, QueueHandle_t *f_queue, int f_intr_flags);
+esp_err_t uart_param_config(uart_port_t f_uart, const uart_config_t *f_config);
+esp_err_t uart_set_pin(uart_port_t f_uart, int f_tx, int f_rx, int f_rts, int f_cts);
+esp_err_t uart_set_rx_timeout(uart_port_t f_uart, const uint8_t f_tout);
+esp_err_t uart_get_buffered_data_len(uart_port_t f_uart, size_t *f_size);
+int uart_read_bytes(uart_port_t f_uart, void *f_buf, uint32_t f_length, TickType_t f_ticks);
+esp_err_t uart_flush_input(uart_port_t f_uart);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
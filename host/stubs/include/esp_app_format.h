@@ -0,0 +1,91 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_ESP_APP_FORMAT_H_
+#define	HOST_ESP_APP_FORMAT_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- image layout identical to the target so OTA parsing works on real .bin files
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_IMAGE_HEADER_MAGIC  0xE9
+#define ESP_APP_DESC_MAGIC_WORD 0xABCD5432
+
+typedef struct {
+    uint8_t     magic;
+    uint8_t     segment_count;
+    uint8_t     spi_mode;
+    uint8_t     spi_speed_size;
+    uint32_t    entry_addr;
+    uint8_t     wp_pin;
+    uint8_t     spi_pin_drv[3];
+    uint16_t    chip_id;
+    uint8_t     min_chip_rev;
+    uint16_t    min_chip_rev_full;
+    uint16_t    max_chip_rev_full;
+    uint8_t     reserved[4];
+    uint8_t     hash_appended;
+} __attribute__((packed)) esp_image_header_t;
+
+typedef struct {
+    uint32_t    load_addr;
+    uint32_t    data_len;
+} esp_image_segment_header_t;
+
+typedef struct {
+    uint32_t    magic_word;
+    uint32_t    secure_version;
+    uint32_t    reserv1[2];
+    char        version[32];
+    char        project_name[32];
+    char        time[16];
+    char        date[16];
+    char        idf_ver[32];
+    uint8_t     app_elf_sha256[32];
+    uint32_t    reserv2[20];
+} esp_app_desc_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -0,0 +1,78 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_ESP_HTTP_CLIENT_H_
+#define	HOST_ESP_HTTP_CLIENT_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the part of the esp_http_client API used by the OTA manager: GET requests with
+//     open / fetch_headers / read. Plain http only, with a Content-Length or until the
+//     server closes the connection.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct esp_http_client *esp_http_client_handle_t;
+
+typedef struct
+{
+    const char  *url;
+    int         timeout_ms;
+    int         buffer_size;
+    esp_err_t   (*crt_bundle_attach)(void *conf);
+} esp_http_client_config_t;
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *f_config);
+esp_err_t esp_http_client_open(esp_http_client_handle_t f_client, int f_write_len);
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t f_client);
+int esp_http_client_get_status_code(esp_http_client_handle_t f_client);
+int64_t esp_http_client_get_content_length(esp_http_client_handle_t f_client);
+int esp_http_client_read(esp_http_client_handle_t f_client, char *f_buffer, int f_len);
+bool esp_http_client_is_complete_data_received(esp_http_client_handle_t f_client);
+esp_err_t esp_http_client_close(esp_http_client_handle_t f_client);
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t f_client);
+
+#ifdef __cplusplus
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
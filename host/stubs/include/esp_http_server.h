@@ -0,0 +1,194 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_ESP_HTTP_SERVER_H_
+#define	HOST_ESP_HTTP_SERVER_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- an in-process replacement for the IDF http server. Handlers are registered exactly
+//     like on the target; requests are injected with httpd_host_request() (httpd_host.h)
+//     instead of arriving over a socket.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#define HTTPD_MAX_URI_LEN       512
+#define HTTPD_RESP_USE_STRLEN   -1
+
+#define HTTPD_SOCK_ERR_FAIL     -1
+#define HTTPD_SOCK_ERR_INVALID  -2
+#define HTTPD_SOCK_ERR_TIMEOUT  -3
+
+#define HTTPD_200               "200 OK"
+#define HTTPD_204               "204 No Content"
+#define HTTPD_304               "304 Not Modified"
+#define HTTPD_400               "400 Bad Request"
+#define HTTPD_404               "404 Not Found"
+#define HTTPD_408               "408 Request Timeout"
+#define HTTPD_413               "413 Content Too Large"
+#define HTTPD_500               "500 Internal Server Error"
+
+#define HTTPD_TYPE_JSON         "application/json"
+#define HTTPD_TYPE_TEXT         "text/html"
+#define HTTPD_TYPE_OCTET        "application/octet-stream"
+
+typedef void *httpd_handle_t;
+
+typedef enum {
+    HTTP_DELETE = 0,
+    HTTP_GET    = 1,
+    HTTP_HEAD   = 2,
+    HTTP_POST   = 3,
+    HTTP_PUT    = 4
+} httpd_method_t;
+
+typedef enum {
+    HTTPD_500_INTERNAL_SERVER_ERROR = 0,
+    HTTPD_501_METHOD_NOT_IMPLEMENTED,
+    HTTPD_505_VERSION_NOT_SUPPORTED,
+    HTTPD_400_BAD_REQUEST,
+    HTTPD_401_UNAUTHORIZED,
+    HTTPD_403_FORBIDDEN,
+    HTTPD_404_NOT_FOUND,
+    HTTPD_405_METHOD_NOT_ALLOWED,
+    HTTPD_408_REQ_TIMEOUT,
+    HTTPD_411_LENGTH_REQUIRED,
+    HTTPD_413_CONTENT_TOO_LARGE,
+    HTTPD_414_URI_TOO_LONG,
+    HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE,
+    HTTPD_ERR_CODE_MAX
+} httpd_err_code_t;
+
+typedef struct httpd_req {
+    httpd_handle_t  handle;
+    int             method;
+    const char      uri[HTTPD_MAX_URI_LEN + 1];
+    size_t          content_len;
+    void            *aux;
+    void            *user_ctx;
+    void            *sess_ctx;
+    void            (*free_ctx)(void *ctx);
+    bool            ignore_sess_ctx_changes;
+} httpd_req_t;
+
+typedef struct httpd_uri {
+    const char      *uri;
+    httpd_method_t  method;
+    esp_err_t       (*handler)(httpd_req_t *r);
+    void            *user_ctx;
+} httpd_uri_t;
+
+typedef bool (*httpd_uri_match_func_t)(const char *f_reference_uri, const char *f_uri_to_match, size_t f_match_upto);
+
+typedef struct httpd_config {
+    unsigned                task_priority;
+    size_t                  stack_size;
+    int                     core_id;
+    uint16_t                server_port;
+    uint16_t                ctrl_port;
+    uint16_t                max_open_sockets;
+    uint16_t                max_uri_handlers;
+    uint16_t                max_resp_headers;
+    uint16_t                backlog_conn;
+    bool                    lru_purge_enable;
+    uint16_t                recv_wait_timeout;
+    uint16_t                send_wait_timeout;
+    httpd_uri_match_func_t  uri_match_fn;
+} httpd_config_t;
+
+#define HTTPD_DEFAULT_CONFIG() {            \
+        .task_priority      = 5,            \
+        .stack_size         = 4096,         \
+        .core_id            = 0x7FFFFFFF,   \
+        .server_port        = 80,           \
+        .ctrl_port          = 32768,        \
+        .max_open_sockets   = 7,            \
+        .max_uri_handlers   = 8,            \
+        .max_resp_headers   = 8,            \
+        .backlog_conn       = 5,            \
+        .lru_purge_enable   = false,        \
+        .recv_wait_timeout  = 5,            \
+        .send_wait_timeout  = 5,            \
+        .uri_match_fn       = NULL,         \
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t httpd_start(httpd_handle_t *f_handle, const httpd_config_t *f_config);
+esp_err_t httpd_stop(httpd_handle_t f_handle);
+esp_err_t httpd_register_uri_handler(httpd_handle_t f_handle, const httpd_uri_t *f_uri_handler);
+
+bool httpd_uri_match_wildcard(const char *f_template, const char *f_uri, size_t f_len);
+
+int httpd_req_recv(httpd_req_t *f_req, char *f_buf, size_t f_buf_len);
+size_t httpd_req_get_hdr_value_len(httpd_req_t *f_req, const char *f_field);
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *f_req, const char *f_field, char *f_val, size_t f_val_size);
+
+esp_err_t httpd_resp_set_status(httpd_req_t *f_req, const char *f_status);
+esp_err_t httpd_resp_set_type(httpd_req_t *f_req, const char *f_type);
+esp_err_t httpd_resp_set_hdr(httpd_req_t *f_req, const char *f_field, const char *f_value);
+esp_err_t httpd_resp_send(httpd_req_t *f_req, const char *f_buf, ssize_t f_buf_len);
+esp_err_t httpd_resp_send_chunk(httpd_req_t *f_req, const char *f_buf, ssize_t f_buf_len);
+esp_err_t httpd_resp_send_err(httpd_req_t *f_req, httpd_err_code_t f_error, const char *f_msg);
+
+static inline esp_err_t httpd_resp_sendstr(httpd_req_t *f_req, const char *f_str)
+{
+    return httpd_resp_send(f_req, f_str, (f_str == NULL) ? 0 : HTTPD_RESP_USE_STRLEN);
+}
+
+static inline esp_err_t httpd_resp_sendstr_chunk(httpd_req_t *f_req, const char *f_str)
+{
+    return httpd_resp_send_chunk(f_req, f_str, (f_str == NULL) ? 0 : HTTPD_RESP_USE_STRLEN);
+}
+
+esp_err_t httpd_req_async_handler_begin(httpd_req_t *f_req, httpd_req_t **f_out);
+esp_err_t httpd_req_async_handler_complete(httpd_req_t *f_req);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
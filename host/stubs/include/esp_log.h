@@ -0,0 +1,93 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_ESP_LOG_H_
+#define	HOST_ESP_LOG_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the host build has one global level for all tags (set with esp_log_level_set("*",...))
+
+void esp_log_level_set(const char *f_tag, esp_log_level_t f_level);
+esp_log_level_t esp_log_level_get(const char *f_tag);
+
+uint32_t esp_log_timestamp(void);
+void esp_log_write(esp_log_level_t f_level, const char *f_tag, const char *f_format, ...) __attribute__ ((format (printf, 3, 4)));
+void esp_log_buffer_hexdump_internal(const char *f_tag, const void *f_buffer, uint16_t f_len, esp_log_level_t f_level);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#define ESP_HOST_LOG(level, letter, tag, format, ...) \
+    do { if (esp_log_level_get(tag) >= level) esp_log_write(level, tag, letter " (%u) %s: " format "\n", (unsigned)esp_log_timestamp(), tag, ##__VA_ARGS__); } while (0)
+
+#define ESP_LOGE(tag, format, ...) ESP_HOST_LOG(ESP_LOG_ERROR,   "E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) ESP_HOST_LOG(ESP_LOG_WARN,    "W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) ESP_HOST_LOG(ESP_LOG_INFO,    "I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) ESP_HOST_LOG(ESP_LOG_DEBUG,   "D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) ESP_HOST_LOG(ESP_LOG_VERBOSE, "V", tag, format, ##__VA_ARGS__)
+
+#define ESP_LOG_BUFFER_HEXDUMP(tag, buffer, buff_len, level) \
+    esp_log_buffer_hexdump_internal(tag, buffer, buff_len, level)
+
+#define ESP_LOG_BUFFER_HEX_LEVEL(tag, buffer, buff_len, level) \
+    esp_log_buffer_hexdump_internal(tag, buffer, buff_len, level)
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
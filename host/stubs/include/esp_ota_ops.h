@@ -0,0 +1,72 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_ESP_OTA_OPS_H_
+#define	HOST_ESP_OTA_OPS_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_partition.h"
+#include "esp_app_desc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t esp_ota_handle_t;
+
+#define OTA_SIZE_UNKNOWN            0xffffffff
+#define OTA_WITH_SEQUENTIAL_WRITES  0xfffffffe
+
+const esp_partition_t *esp_ota_get_running_partition(void);
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *f_start_from);
+const esp_partition_t *esp_ota_get_last_invalid_partition(void);
+esp_err_t esp_ota_get_partition_description(const esp_partition_t *f_partition, esp_app_desc_t *f_app_desc);
+
+esp_err_t esp_ota_begin(const esp_partition_t *f_partition, size_t f_image_size, esp_ota_handle_t *f_out_handle);
+esp_err_t esp_ota_write(esp_ota_handle_t f_handle, const void *f_data, size_t f_size);
+esp_err_t esp_ota_end(esp_ota_handle_t f_handle);
+esp_err_t esp_ota_abort(esp_ota_handle_t f_handle);
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *f_partition);
+
+#ifdef __cplusplus
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
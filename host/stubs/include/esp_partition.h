@@ -0,0 +1,89 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_ESP_PARTITION_H_
+#define	HOST_ESP_PARTITION_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- partitions are plain memory buffers on the host (see esp_system_stub.cpp)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ESP_PARTITION_TYPE_APP  = 0x00,
+    ESP_PARTITION_TYPE_DATA = 0x01,
+    ESP_PARTITION_TYPE_ANY  = 0xff
+} esp_partition_type_t;
+
+typedef enum {
+    ESP_PARTITION_SUBTYPE_APP_OTA_0     = 0x10,
+    ESP_PARTITION_SUBTYPE_APP_OTA_1     = 0x11,
+    ESP_PARTITION_SUBTYPE_DATA_NVS      = 0x02,
+    ESP_PARTITION_SUBTYPE_DATA_SPIFFS   = 0x82,
+    ESP_PARTITION_SUBTYPE_ANY           = 0xff
+} esp_partition_subtype_t;
+
+typedef struct {
+    void                    *flash_chip;
+    esp_partition_type_t    type;
+    esp_partition_subtype_t subtype;
+    uint32_t                address;
+    uint32_t                size;
+    uint32_t                erase_size;
+    char                    label[17];
+    bool                    encrypted;
+    bool                    readonly;
+} esp_partition_t;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t f_type, esp_partition_subtype_t f_subtype, const char *f_label);
+
+esp_err_t esp_partition_read(const esp_partition_t *f_part, size_t f_src_offset, void *f_dst, size_t f_size);
+esp_err_t esp_partition_write(const esp_partition_t *f_part, size_t f_dst_offset, const void *f_src, size_t f_size);
+esp_err_t esp_partition_erase_range(const esp_partition_t *f_part, size_t f_offset, size_t f_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
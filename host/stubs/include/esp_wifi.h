@@ -0,0 +1,94 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_ESP_WIFI_H_
+#define	HOST_ESP_WIFI_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- just enough of the Wi-Fi API to serve the scan and status handlers. The scan
+//     returns a fixed list of fake access points.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    WIFI_SCAN_TYPE_ACTIVE = 0,
+    WIFI_SCAN_TYPE_PASSIVE
+} wifi_scan_type_t;
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+} wifi_active_scan_time_t;
+
+typedef struct {
+    wifi_active_scan_time_t active;
+    uint32_t                passive;
+} wifi_scan_time_t;
+
+typedef struct {
+    uint8_t             *ssid;
+    uint8_t             *bssid;
+    uint8_t             channel;
+    bool                show_hidden;
+    wifi_scan_type_t    scan_type;
+    wifi_scan_time_t    scan_time;
+} wifi_scan_config_t;
+
+typedef struct {
+    uint8_t     bssid[6];
+    uint8_t     ssid[33];
+    uint8_t     primary;
+    int8_t      rssi;
+} wifi_ap_record_t;
+
+esp_err_t esp_wifi_scan_start(const wifi_scan_config_t *f_config, bool f_block);
+esp_err_t esp_wifi_scan_get_ap_records(uint16_t *f_number, wifi_ap_record_t *f_ap_records);
+esp_err_t esp_wifi_scan_get_ap_num(uint16_t *f_number);
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *f_ap_info);
+
+#ifdef __cplusplus
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -0,0 +1,115 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_FREERTOS_H_
+#define	HOST_FREERTOS_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- minimal FreeRTOS API for the host build. Tasks are mapped to std::thread, ticks
+//     are milliseconds since program start, critical sections share one global
+//     recursive mutex. See freertos_stub.cpp for the implementation.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "sdkconfig.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef uint32_t    TickType_t;
+typedef int         BaseType_t;
+typedef unsigned    UBaseType_t;
+typedef uint32_t    StackType_t;
+
+#define pdFALSE             ((BaseType_t)0)
+#define pdTRUE              ((BaseType_t)1)
+#define pdFAIL              pdFALSE
+#define pdPASS              pdTRUE
+#define errQUEUE_EMPTY      ((BaseType_t)0)
+#define errQUEUE_FULL       ((BaseType_t)0)
+
+#define configTICK_RATE_HZ  CONFIG_FREERTOS_HZ
+#define portTICK_PERIOD_MS  ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY       ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000U))
+#define pdTICKS_TO_MS(t)    ((uint32_t)(((uint64_t)(t) * 1000U) / configTICK_RATE_HZ))
+
+#define configMAX_TASK_NAME_LEN 16
+
+#define tskNO_AFFINITY      0x7FFFFFFF
+#define tskIDLE_PRIORITY    0
+
+#define portNUM_PROCESSORS  2
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- critical sections. The spinlock object is kept for source compatibility only
+
+typedef struct {
+    int m_unused;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+
+void host_enter_critical(portMUX_TYPE *f_mux);
+void host_exit_critical(portMUX_TYPE *f_mux);
+
+#define taskENTER_CRITICAL(mux)         host_enter_critical(mux)
+#define taskEXIT_CRITICAL(mux)          host_exit_critical(mux)
+#define taskENTER_CRITICAL_ISR(mux)     host_enter_critical(mux)
+#define taskEXIT_CRITICAL_ISR(mux)      host_exit_critical(mux)
+#define portENTER_CRITICAL(mux)         host_enter_critical(mux)
+#define portEXIT_CRITICAL(mux)          host_exit_critical(mux)
+#define portYIELD_FROM_ISR(x)           ((void)(x))
+
+#define spinlock_initialize(mux)        ((void)(mux))
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,77 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_FREERTOS_QUEUE_H_
+#define	HOST_FREERTOS_QUEUE_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct HostQueue *QueueHandle_t;
+
+#define queueSEND_TO_BACK       0
+#define queueSEND_TO_FRONT      1
+#define queueOVERWRITE          2
+
+QueueHandle_t xQueueGenericCreate(UBaseType_t f_length, UBaseType_t f_item_size);
+BaseType_t xQueueGenericSend(QueueHandle_t f_queue, const void *f_item, TickType_t f_ticks, BaseType_t f_position);
+BaseType_t xQueueReceive(QueueHandle_t f_queue, void *f_buffer, TickType_t f_ticks);
+BaseType_t xQueuePeek(QueueHandle_t f_queue, void *f_buffer, TickType_t f_ticks);
+UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t f_queue);
+UBaseType_t uxQueueSpacesAvailable(const QueueHandle_t f_queue);
+BaseType_t xQueueReset(QueueHandle_t f_queue);
+void vQueueDelete(QueueHandle_t f_queue);
+
+#define xQueueCreate(len, size)                     xQueueGenericCreate(len, size)
+#define xQueueSend(q, item, ticks)                  xQueueGenericSend(q, item, ticks, queueSEND_TO_BACK)
+#define xQueueSendToBack(q, item, ticks)            xQueueGenericSend(q, item, ticks, queueSEND_TO_BACK)
+#define xQueueSendToFront(q, item, ticks)           xQueueGenericSend(q, item, ticks, queueSEND_TO_FRONT)
+#define xQueueOverwrite(q, item)                    xQueueGenericSend(q, item, 0, queueOVERWRITE)
+#define xQueueSendFromISR(q, item, woken)           ((void)(woken), xQueueGenericSend(q, item, 0, queueSEND_TO_BACK))
+#define xQueueReceiveFromISR(q, buf, woken)         ((void)(woken), xQueueReceive(q, buf, 0))
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,70 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_FREERTOS_SEMPHR_H_
+#define	HOST_FREERTOS_SEMPHR_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- like on the target, semaphores are queues with an item size of zero
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+QueueHandle_t xQueueCreateCountingSemaphore(UBaseType_t f_max, UBaseType_t f_initial);
+
+#define xSemaphoreCreateBinary()                    xQueueGenericCreate(1, 0)
+#define xSemaphoreCreateMutex()                     xQueueCreateCountingSemaphore(1, 1)
+#define xSemaphoreCreateCounting(max, initial)      xQueueCreateCountingSemaphore(max, initial)
+#define xSemaphoreTake(sem, ticks)                  xQueueReceive(sem, NULL, ticks)
+#define xSemaphoreGive(sem)                         xQueueGenericSend(sem, NULL, 0, queueSEND_TO_BACK)
+#define xSemaphoreGiveFromISR(sem, woken)           ((void)(woken), xQueueGenericSend(sem, NULL, 0, queueSEND_TO_BACK))
+#define uxSemaphoreGetCount(sem)                    uxQueueMessagesWaiting(sem)
+#define vSemaphoreDelete(sem)                       vQueueDelete(sem)
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,97 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_FREERTOS_TASK_H_
+#define	HOST_FREERTOS_TASK_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct HostTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+typedef enum {
+    eNoAction = 0,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite
+} eNotifyAction;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t f_code, const char *f_name, uint32_t f_stack, void *f_param,
+                                   UBaseType_t f_prio, TaskHandle_t *f_handle, BaseType_t f_core);
+
+BaseType_t xTaskCreate(TaskFunction_t f_code, const char *f_name, uint32_t f_stack, void *f_param,
+                       UBaseType_t f_prio, TaskHandle_t *f_handle);
+
+void vTaskDelete(TaskHandle_t f_task);
+void vTaskDelay(const TickType_t f_ticks);
+BaseType_t xTaskDelayUntil(TickType_t *f_prev_wake, const TickType_t f_increment);
+
+#define vTaskDelayUntil(prev, inc) ((void)xTaskDelayUntil(prev, inc))
+
+TickType_t xTaskGetTickCount(void);
+TickType_t xTaskGetTickCountFromISR(void);
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+const char *pcTaskGetName(TaskHandle_t f_task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t f_task);
+
+// --- direct to task notifications
+
+BaseType_t xTaskGenericNotify(TaskHandle_t f_task, uint32_t f_value, eNotifyAction f_action);
+uint32_t ulTaskNotifyTake(BaseType_t f_clear_on_exit, TickType_t f_ticks);
+BaseType_t xTaskNotifyWait(uint32_t f_clear_on_entry, uint32_t f_clear_on_exit, uint32_t *f_value, TickType_t f_ticks);
+
+#define xTaskNotifyGive(task)                       xTaskGenericNotify(task, 0, eIncrement)
+#define vTaskNotifyGiveFromISR(task, woken)         ((void)(woken), (void)xTaskGenericNotify(task, 0, eIncrement))
+#define xTaskNotify(task, value, action)            xTaskGenericNotify(task, value, action)
+#define xTaskNotifyFromISR(task, value, action, w)  ((void)(w), xTaskGenericNotify(task, value, action))
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
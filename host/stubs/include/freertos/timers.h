@@ -0,0 +1,73 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_FREERTOS_TIMERS_H_
+#define	HOST_FREERTOS_TIMERS_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- software timers. All callbacks run on one "timer service" thread just like on
+//     the target, so a blocking callback delays every other timer.
+
+typedef struct HostTimer *TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t f_timer);
+
+TimerHandle_t xTimerCreate(const char *f_name, TickType_t f_period, UBaseType_t f_autoreload,
+                           void *f_timer_id, TimerCallbackFunction_t f_callback);
+
+BaseType_t xTimerStart(TimerHandle_t f_timer, TickType_t f_ticks_to_wait);
+BaseType_t xTimerStop(TimerHandle_t f_timer, TickType_t f_ticks_to_wait);
+BaseType_t xTimerReset(TimerHandle_t f_timer, TickType_t f_ticks_to_wait);
+BaseType_t xTimerDelete(TimerHandle_t f_timer, TickType_t f_ticks_to_wait);
+BaseType_t xTimerChangePeriod(TimerHandle_t f_timer, TickType_t f_period, TickType_t f_ticks_to_wait);
+BaseType_t xTimerIsTimerActive(TimerHandle_t f_timer);
+
+void *pvTimerGetTimerID(const TimerHandle_t f_timer);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
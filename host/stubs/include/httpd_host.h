@@ -0,0 +1,83 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_HTTPD_HOST_H_
+#define	HOST_HTTPD_HOST_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- host only: drive the in-process http server from the simulation
+
+#include <string>
+#include <map>
+
+#include "esp_http_server.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct HttpdHostResponse
+{
+    std::string                         m_Status;
+    std::map<std::string,std::string>   m_Headers;
+    std::string                         m_Body;
+    int                                 m_Chunks;
+    esp_err_t                           m_HandlerResult;
+} HttpdHostResponse_t;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- dispatch one request to the registered handler. Returns ESP_ERR_NOT_FOUND if no
+//     handler matched the uri.
+
+esp_err_t httpd_host_request(httpd_handle_t f_handle, httpd_method_t f_method, const char *f_uri,
+                             const std::map<std::string,std::string> &f_headers, const std::string &f_body,
+                             HttpdHostResponse_t *f_response);
+
+// --- the most recently started server (the firmware does not hand its handle out)
+
+httpd_handle_t httpd_host_get_server(void);
+
+// --- requests a handler continued with httpd_req_async_handler_begin() (event streams),
+//     numbered in the order they were started. The response holds everything sent so
+//     far, including what the handler sent before. Returns false for an unknown index.
+
+bool httpd_host_get_async_response(int f_idx, HttpdHostResponse_t *f_response, bool *f_completed);
+
+// --- the client hangs up: further sends fail like on a closed socket
+
+void httpd_host_close_async(int f_idx);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
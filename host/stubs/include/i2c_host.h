@@ -0,0 +1,71 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_I2C_HOST_H_
+#define	HOST_I2C_HOST_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- host only: emulated I2C devices. The callbacks run in the task doing the
+//     transfer, or in the thread of an asynchronous bus. The stub adds the time the
+//     transfer would need on the wire (9 clocks per byte at the clock speed of the
+//     device) so that bus timing shows up in measurements.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "driver/i2c_types.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef esp_err_t (*i2c_host_write_cb_t)(void *f_ctx, const uint8_t *f_data, size_t f_len);
+typedef esp_err_t (*i2c_host_read_cb_t)(void *f_ctx, uint8_t *f_data, size_t f_len);
+
+typedef struct
+{
+    uint32_t    m_Transfers;
+    uint32_t    m_Nacks;
+    uint64_t    m_Bytes;
+    uint64_t    m_BusTimeUs;
+} I2cHostStats_t;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t i2c_host_attach_device(i2c_port_t f_port, uint8_t f_address, i2c_host_write_cb_t f_write, i2c_host_read_cb_t f_read, void *f_ctx);
+void i2c_host_get_stats(i2c_port_t f_port, I2cHostStats_t *f_stats);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
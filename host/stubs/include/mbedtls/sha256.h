@@ -0,0 +1,70 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_MBEDTLS_SHA256_H_
+#define	HOST_MBEDTLS_SHA256_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- SHA-256 with the mbedtls API (FIPS 180-4), SHA-224 is not supported
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint32_t        m_State[8];
+    uint64_t        m_Length;           // --- bytes
+    unsigned char   m_Block[64];
+    size_t          m_BlockLen;
+} mbedtls_sha256_context;
+
+void mbedtls_sha256_init(mbedtls_sha256_context *f_ctx);
+void mbedtls_sha256_free(mbedtls_sha256_context *f_ctx);
+int mbedtls_sha256_starts(mbedtls_sha256_context *f_ctx, int f_is224);
+int mbedtls_sha256_update(mbedtls_sha256_context *f_ctx, const unsigned char *f_input, size_t f_len);
+int mbedtls_sha256_finish(mbedtls_sha256_context *f_ctx, unsigned char f_output[32]);
+int mbedtls_sha256(const unsigned char *f_input, size_t f_len, unsigned char f_output[32], int f_is224);
+
+#ifdef __cplusplus
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -0,0 +1,137 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_MQTT_CLIENT_H_
+#define	HOST_MQTT_CLIENT_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- loopback MQTT client for the host build. Nothing leaves the process; published
+//     messages are counted (see mqtt_host.h) and events are delivered on a separate
+//     thread just like the client task on the target does.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct esp_mqtt_client *esp_mqtt_client_handle_t;
+
+typedef enum {
+    MQTT_EVENT_ANY = -1,
+    MQTT_EVENT_ERROR = 0,
+    MQTT_EVENT_CONNECTED,
+    MQTT_EVENT_DISCONNECTED,
+    MQTT_EVENT_SUBSCRIBED,
+    MQTT_EVENT_UNSUBSCRIBED,
+    MQTT_EVENT_PUBLISHED,
+    MQTT_EVENT_DATA,
+    MQTT_EVENT_BEFORE_CONNECT,
+    MQTT_EVENT_DELETED
+} esp_mqtt_event_id_t;
+
+typedef struct esp_mqtt_event_t {
+    esp_mqtt_event_id_t         event_id;
+    esp_mqtt_client_handle_t    client;
+    char                        *data;
+    int                         data_len;
+    int                         total_data_len;
+    int                         current_data_offset;
+    char                        *topic;
+    int                         topic_len;
+    int                         msg_id;
+    int                         session_present;
+    bool                        retain;
+    int                         qos;
+    bool                        dup;
+} esp_mqtt_event_t;
+
+typedef esp_mqtt_event_t *esp_mqtt_event_handle_t;
+
+typedef struct {
+    struct {
+        struct {
+            const char  *uri;
+            const char  *hostname;
+            uint32_t    port;
+        } address;
+    } broker;
+    struct {
+        const char  *client_id;
+        const char  *username;
+    } credentials;
+    struct {
+        int         keepalive;
+        bool        disable_auto_reconnect;
+    } session;
+    struct {
+        int         reconnect_timeout_ms;
+        int         timeout_ms;
+    } network;
+    struct {
+        int         size;
+        int         out_size;
+    } buffer;
+} esp_mqtt_client_config_t;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *f_config);
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t f_client);
+esp_err_t esp_mqtt_client_stop(esp_mqtt_client_handle_t f_client);
+esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t f_client);
+
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t f_client, const char *f_topic, const char *f_data,
+                            int f_len, int f_qos, int f_retain);
+int esp_mqtt_client_enqueue(esp_mqtt_client_handle_t f_client, const char *f_topic, const char *f_data,
+                            int f_len, int f_qos, int f_retain, bool f_store);
+int esp_mqtt_client_get_outbox_size(esp_mqtt_client_handle_t f_client);
+
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t f_client, esp_mqtt_event_id_t f_event,
+                                         esp_event_handler_t f_handler, void *f_handler_args);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_MQTT_HOST_H_
+#define	HOST_MQTT_HOST_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- host only: statistics of the loopback MQTT client and hooks to simulate outages
+
+#include <stdint.h>
+#include <string>
+
+#include "mqtt_client.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct MqttHostStats
+{
+    uint32_t    m_Published;        // --- accepted by esp_mqtt_client_publish
+    uint32_t    m_Rejected;         // --- publish returned -1 (not connected)
+    uint64_t    m_PayloadBytes;
+    std::string m_LastTopic;
+    std::string m_LastPayload;
+} MqttHostStats_t;
+
+void mqtt_host_get_stats(MqttHostStats_t *f_stats);
+void mqtt_host_reset_stats(void);
+
+// --- print every published message to stdout
+
+void mqtt_host_set_echo(bool f_echo);
+
+// --- simulate a broker outage / recovery on all clients. Generates the respective events.
+
+void mqtt_host_set_broker_available(bool f_available);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
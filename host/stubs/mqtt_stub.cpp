@@ -0,0 +1,405 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <string>
+#include <set>
+#include <algorithm>
+#include <ctype.h>
+
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "mqtt_client.h"
+#include "mqtt_host.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+static const char *TAG = "mqtt_host";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+struct HostMqttMessage
+{
+    int     m_MsgId;
+    string  m_Topic;
+    string  m_Payload;
+    int     m_Qos;
+};
+
+struct HostMqttHandler
+{
+    esp_mqtt_event_id_t m_Event;
+    esp_event_handler_t m_Handler;
+    void                *m_Args;
+};
+
+struct esp_mqtt_client
+{
+    string                      m_Uri;
+    bool                        m_Started;
+    bool                        m_Connected;
+    bool                        m_Exit;
+    int                         m_NextMsgId;
+
+    vector<HostMqttHandler>     m_Handlers;
+
+    deque<HostMqttMessage>      m_Outbox;       // --- QoS>0 messages waiting for a connection
+    deque<esp_mqtt_event_id_t>  m_Events;
+    deque<int>                  m_EventMsgIds;
+
+    thread                      m_Thread;
+};
+
+static mutex                        g_MqttMutex;
+static condition_variable           g_MqttCond;
+static set<esp_mqtt_client *>       g_MqttClients;
+static MqttHostStats_t              g_MqttStats;
+static bool                         g_MqttEcho = false;
+static bool                         g_MqttBrokerAvailable = true;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- queue an event for the client thread. Caller holds the lock.
+
+static void PostEvent(esp_mqtt_client *f_client, esp_mqtt_event_id_t f_event, int f_msg_id)
+{
+    f_client->m_Events.push_back(f_event);
+    f_client->m_EventMsgIds.push_back(f_msg_id);
+    g_MqttCond.notify_all();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- deliver a message to the "broker". Caller holds the lock.
+
+static void DeliverMessage(esp_mqtt_client *f_client, const HostMqttMessage &f_msg)
+{
+    g_MqttStats.m_Published++;
+    g_MqttStats.m_PayloadBytes += f_msg.m_Payload.size();
+    g_MqttStats.m_LastTopic     = f_msg.m_Topic;
+    g_MqttStats.m_LastPayload   = f_msg.m_Payload;
+
+    if (g_MqttEcho)
+    {
+        // --- binary payloads (CBOR) as hex, to be pasted into cbor_decode
+
+        bool l_text = all_of(f_msg.m_Payload.begin(), f_msg.m_Payload.end(), [](char c) { return isprint((unsigned char)c); });
+
+        if (l_text)
+        {
+            printf("MQTT %s (qos %d): %s\n", f_msg.m_Topic.c_str(), f_msg.m_Qos, f_msg.m_Payload.c_str());
+        }
+        else
+        {
+            printf("MQTT %s (qos %d): %zu bytes ", f_msg.m_Topic.c_str(), f_msg.m_Qos, f_msg.m_Payload.size());
+            for (unsigned char c : f_msg.m_Payload) printf("%02x", c);
+            printf("\n");
+        }
+    }
+
+    if (f_msg.m_Qos > 0) PostEvent(f_client, MQTT_EVENT_PUBLISHED, f_msg.m_MsgId);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- connect if possible and flush the outbox. Caller holds the lock.
+
+static void TryConnect(esp_mqtt_client *f_client)
+{
+    if (f_client->m_Connected || !f_client->m_Started || !g_MqttBrokerAvailable) return;
+
+    f_client->m_Connected = true;
+    PostEvent(f_client, MQTT_EVENT_CONNECTED, 0);
+
+    while (!f_client->m_Outbox.empty())
+    {
+        DeliverMessage(f_client, f_client->m_Outbox.front());
+        f_client->m_Outbox.pop_front();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the client thread only dispatches events, similar to the mqtt task on the target
+
+static void ClientThread(esp_mqtt_client *f_client)
+{
+    unique_lock<mutex> l_lock(g_MqttMutex);
+
+    while (true)
+    {
+        g_MqttCond.wait(l_lock, [f_client] { return f_client->m_Exit || !f_client->m_Events.empty(); });
+
+        if (f_client->m_Events.empty() && f_client->m_Exit) break;
+
+        esp_mqtt_event_t l_event;
+        memset(&l_event, 0, sizeof(l_event));
+
+        l_event.event_id    = f_client->m_Events.front();
+        l_event.msg_id      = f_client->m_EventMsgIds.front();
+        l_event.client      = f_client;
+
+        f_client->m_Events.pop_front();
+        f_client->m_EventMsgIds.pop_front();
+
+        vector<HostMqttHandler> l_handlers = f_client->m_Handlers;
+
+        l_lock.unlock();
+
+        for (const HostMqttHandler &l_h : l_handlers)
+        {
+            if (l_h.m_Event == MQTT_EVENT_ANY || l_h.m_Event == l_event.event_id)
+            {
+                l_h.m_Handler(l_h.m_Args, "MQTT_EVENTS", l_event.event_id, &l_event);
+            }
+        }
+
+        l_lock.lock();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *f_config)
+{
+    const char *l_uri = f_config->broker.address.uri;
+
+    if (!l_uri || strncmp(l_uri, "mqtt", 4) != 0)
+    {
+        ESP_LOGE(TAG, "Invalid broker uri '%s'", l_uri ? l_uri : "");
+        return NULL;
+    }
+
+    esp_mqtt_client *l_client = new esp_mqtt_client;
+
+    l_client->m_Uri         = l_uri;
+    l_client->m_Started     = false;
+    l_client->m_Connected   = false;
+    l_client->m_Exit        = false;
+    l_client->m_NextMsgId   = 1;
+
+    lock_guard<mutex> l_lock(g_MqttMutex);
+    g_MqttClients.insert(l_client);
+
+    return l_client;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t f_client)
+{
+    if (!f_client) return ESP_ERR_INVALID_ARG;
+
+    lock_guard<mutex> l_lock(g_MqttMutex);
+
+    if (f_client->m_Started) return ESP_FAIL;
+
+    f_client->m_Started = true;
+    f_client->m_Thread  = thread(ClientThread, f_client);
+
+    PostEvent(f_client, MQTT_EVENT_BEFORE_CONNECT, 0);
+    TryConnect(f_client);
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t esp_mqtt_client_stop(esp_mqtt_client_handle_t f_client)
+{
+    if (!f_client) return ESP_ERR_INVALID_ARG;
+
+    {
+        lock_guard<mutex> l_lock(g_MqttMutex);
+
+        if (!f_client->m_Started) return ESP_FAIL;
+
+        if (f_client->m_Connected) PostEvent(f_client, MQTT_EVENT_DISCONNECTED, 0);
+
+        f_client->m_Started     = false;
+        f_client->m_Connected   = false;
+        f_client->m_Exit        = true;
+        g_MqttCond.notify_all();
+    }
+
+    if (f_client->m_Thread.joinable()) f_client->m_Thread.join();
+
+    lock_guard<mutex> l_lock(g_MqttMutex);
+    f_client->m_Exit = false;
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t f_client)
+{
+    if (!f_client) return ESP_ERR_INVALID_ARG;
+
+    if (f_client->m_Started) esp_mqtt_client_stop(f_client);
+
+    {
+        lock_guard<mutex> l_lock(g_MqttMutex);
+        g_MqttClients.erase(f_client);
+    }
+
+    delete f_client;
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int esp_mqtt_client_enqueue(esp_mqtt_client_handle_t f_client, const char *f_topic, const char *f_data,
+                            int f_len, int f_qos, int f_retain, bool f_store)
+{
+    if (!f_client || !f_topic) return -1;
+
+    if (f_len <= 0) f_len = f_data ? strlen(f_data) : 0;
+
+    lock_guard<mutex> l_lock(g_MqttMutex);
+
+    // --- like the target: QoS0 messages are dropped when not connected unless explicitly stored,
+    //     QoS1/2 messages are kept in the outbox until the connection comes back
+
+    if (!f_client->m_Connected && f_qos == 0 && !f_store)
+    {
+        g_MqttStats.m_Rejected++;
+        return -1;
+    }
+
+    HostMqttMessage l_msg;
+
+    l_msg.m_MsgId   = f_qos > 0 ? f_client->m_NextMsgId++ : 0;
+    l_msg.m_Topic   = f_topic;
+    l_msg.m_Payload.assign(f_data ? f_data : "", f_len);
+    l_msg.m_Qos     = f_qos;
+
+    if (f_client->m_Connected) DeliverMessage(f_client, l_msg);
+    else f_client->m_Outbox.push_back(l_msg);
+
+    return l_msg.m_MsgId;
+}
+
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t f_client, const char *f_topic, const char *f_data,
+                            int f_len, int f_qos, int f_retain)
+{
+#ifdef CONFIG_MQTT_SKIP_PUBLISH_IF_DISCONNECTED
+    // --- like the target with this option: nothing is stored while disconnected, whatever the QoS
+
+    if (f_client)
+    {
+        lock_guard<mutex> l_lock(g_MqttMutex);
+
+        if (!f_client->m_Connected)
+        {
+            g_MqttStats.m_Rejected++;
+            return -1;
+        }
+    }
+#endif
+
+    return esp_mqtt_client_enqueue(f_client, f_topic, f_data, f_len, f_qos, f_retain, f_qos > 0);
+}
+
+int esp_mqtt_client_get_outbox_size(esp_mqtt_client_handle_t f_client)
+{
+    lock_guard<mutex> l_lock(g_MqttMutex);
+
+    int l_size = 0;
+    for (const HostMqttMessage &l_msg : f_client->m_Outbox) l_size += l_msg.m_Payload.size() + l_msg.m_Topic.size();
+
+    return l_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t f_client, esp_mqtt_event_id_t f_event,
+                                         esp_event_handler_t f_handler, void *f_handler_args)
+{
+    if (!f_client || !f_handler) return ESP_ERR_INVALID_ARG;
+
+    lock_guard<mutex> l_lock(g_MqttMutex);
+    f_client->m_Handlers.push_back({ f_event, f_handler, f_handler_args });
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+void mqtt_host_get_stats(MqttHostStats_t *f_stats)
+{
+    lock_guard<mutex> l_lock(g_MqttMutex);
+    *f_stats = g_MqttStats;
+}
+
+void mqtt_host_reset_stats(void)
+{
+    lock_guard<mutex> l_lock(g_MqttMutex);
+    g_MqttStats = MqttHostStats_t();
+}
+
+void mqtt_host_set_echo(bool f_echo)
+{
+    lock_guard<mutex> l_lock(g_MqttMutex);
+    g_MqttEcho = f_echo;
+}
+
+void mqtt_host_set_broker_available(bool f_available)
+{
+    lock_guard<mutex> l_lock(g_MqttMutex);
+
+    g_MqttBrokerAvailable = f_available;
+
+    for (esp_mqtt_client *l_client : g_MqttClients)
+    {
+        if (f_available)
+        {
+            TryConnect(l_client);
+        }
+        else if (l_client->m_Connected)
+        {
+            l_client->m_Connected = false;
+            PostEvent(l_client, MQTT_EVENT_DISCONNECTED, 0);
+        }
+    }
+}
@@ -0,0 +1,297 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <mutex>
+#include <map>
+#include <string>
+#include <fstream>
+
+#include "esp_log.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "nvs_host.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+static const char *TAG = "nvs_host";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- an entry remembers its type so that a get with the wrong type fails like on the target
+
+struct NvsEntry
+{
+    bool    m_IsString;
+    string  m_Str;
+    int32_t m_I32;
+};
+
+typedef map<string, NvsEntry> NvsNamespace;
+
+static mutex                        g_NvsMutex;
+static bool                         g_NvsInitialized = false;
+static string                       g_NvsBackingFile;
+static map<string, NvsNamespace>    g_NvsStore;
+static map<nvs_handle_t, string>    g_NvsHandles;
+static nvs_handle_t                 g_NvsNextHandle = 1;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- backing file format, one entry per line:  <namespace> <key> s <value>  or  <namespace> <key> i <value>
+//     Values run to the end of the line, so they may contain blanks but no newlines.
+
+static void LoadBackingFile(void)
+{
+    ifstream l_in(g_NvsBackingFile);
+    string   l_line;
+
+    while (getline(l_in, l_line))
+    {
+        size_t l_p1 = l_line.find(' ');
+        size_t l_p2 = l_p1 == string::npos ? string::npos : l_line.find(' ', l_p1 + 1);
+
+        if (l_p2 == string::npos || l_p2 + 2 >= l_line.size() + 1) continue;
+
+        string   l_ns   = l_line.substr(0, l_p1);
+        string   l_key  = l_line.substr(l_p1 + 1, l_p2 - l_p1 - 1);
+        char     l_type = l_line[l_p2 + 1];
+        string   l_val  = l_p2 + 3 <= l_line.size() ? l_line.substr(l_p2 + 3) : "";
+
+        NvsEntry &l_e = g_NvsStore[l_ns][l_key];
+
+        l_e.m_IsString  = l_type == 's';
+        l_e.m_Str       = l_val;
+        l_e.m_I32       = l_e.m_IsString ? 0 : atoi(l_val.c_str());
+    }
+}
+
+static void SaveBackingFile(void)
+{
+    if (g_NvsBackingFile.empty()) return;
+
+    ofstream l_out(g_NvsBackingFile, ios::trunc);
+
+    for (auto &l_ns : g_NvsStore)
+    {
+        for (auto &l_kv : l_ns.second)
+        {
+            if (l_kv.second.m_IsString) l_out << l_ns.first << ' ' << l_kv.first << " s " << l_kv.second.m_Str << '\n';
+            else l_out << l_ns.first << ' ' << l_kv.first << " i " << l_kv.second.m_I32 << '\n';
+        }
+    }
+
+    if (!l_out) ESP_LOGE(TAG, "Could not write %s", g_NvsBackingFile.c_str());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void nvs_host_set_backing_file(const char *f_path)
+{
+    lock_guard<mutex> l_lock(g_NvsMutex);
+    g_NvsBackingFile = f_path ? f_path : "";
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t nvs_flash_init(void)
+{
+    lock_guard<mutex> l_lock(g_NvsMutex);
+
+    if (!g_NvsInitialized && !g_NvsBackingFile.empty()) LoadBackingFile();
+    g_NvsInitialized = true;
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_deinit(void)
+{
+    lock_guard<mutex> l_lock(g_NvsMutex);
+
+    g_NvsInitialized = false;
+    g_NvsHandles.clear();
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    lock_guard<mutex> l_lock(g_NvsMutex);
+
+    g_NvsStore.clear();
+    SaveBackingFile();
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t nvs_open(const char *f_namespace, nvs_open_mode_t f_mode, nvs_handle_t *f_handle)
+{
+    lock_guard<mutex> l_lock(g_NvsMutex);
+
+    if (!g_NvsInitialized) return ESP_ERR_NVS_NOT_INITIALIZED;
+    if (f_mode == NVS_READONLY && g_NvsStore.find(f_namespace) == g_NvsStore.end()) return ESP_ERR_NVS_NOT_FOUND;
+
+    *f_handle = g_NvsNextHandle++;
+    g_NvsHandles[*f_handle] = f_namespace;
+
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t f_handle)
+{
+    lock_guard<mutex> l_lock(g_NvsMutex);
+    g_NvsHandles.erase(f_handle);
+}
+
+esp_err_t nvs_commit(nvs_handle_t f_handle)
+{
+    lock_guard<mutex> l_lock(g_NvsMutex);
+
+    if (g_NvsHandles.find(f_handle) == g_NvsHandles.end()) return ESP_ERR_INVALID_ARG;
+
+    SaveBackingFile();
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- returns the namespace of a handle or NULL. Caller holds the lock.
+
+static NvsNamespace *GetNamespace(nvs_handle_t f_handle)
+{
+    auto l_it = g_NvsHandles.find(f_handle);
+    if (l_it == g_NvsHandles.end()) return NULL;
+
+    return &g_NvsStore[l_it->second];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t nvs_set_str(nvs_handle_t f_handle, const char *f_key, const char *f_value)
+{
+    lock_guard<mutex> l_lock(g_NvsMutex);
+
+    NvsNamespace *l_ns = GetNamespace(f_handle);
+    if (!l_ns) return ESP_ERR_INVALID_ARG;
+
+    NvsEntry &l_e = (*l_ns)[f_key];
+
+    l_e.m_IsString  = true;
+    l_e.m_Str       = f_value;
+    l_e.m_I32       = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_str(nvs_handle_t f_handle, const char *f_key, char *f_out, size_t *f_length)
+{
+    lock_guard<mutex> l_lock(g_NvsMutex);
+
+    NvsNamespace *l_ns = GetNamespace(f_handle);
+    if (!l_ns) return ESP_ERR_INVALID_ARG;
+
+    auto l_it = l_ns->find(f_key);
+    if (l_it == l_ns->end()) return ESP_ERR_NVS_NOT_FOUND;
+    if (!l_it->second.m_IsString) return ESP_ERR_NVS_TYPE_MISMATCH;
+
+    // --- like on the target: a NULL buffer just queries the required length incl. terminator
+
+    size_t l_needed = l_it->second.m_Str.size() + 1;
+
+    if (!f_out)
+    {
+        *f_length = l_needed;
+        return ESP_OK;
+    }
+
+    if (*f_length < l_needed)
+    {
+        *f_length = l_needed;
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+
+    memcpy(f_out, l_it->second.m_Str.c_str(), l_needed);
+    *f_length = l_needed;
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t nvs_set_i32(nvs_handle_t f_handle, const char *f_key, int32_t f_value)
+{
+    lock_guard<mutex> l_lock(g_NvsMutex);
+
+    NvsNamespace *l_ns = GetNamespace(f_handle);
+    if (!l_ns) return ESP_ERR_INVALID_ARG;
+
+    NvsEntry &l_e = (*l_ns)[f_key];
+
+    l_e.m_IsString  = false;
+    l_e.m_Str.clear();
+    l_e.m_I32       = f_value;
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_i32(nvs_handle_t f_handle, const char *f_key, int32_t *f_out)
+{
+    lock_guard<mutex> l_lock(g_NvsMutex);
+
+    NvsNamespace *l_ns = GetNamespace(f_handle);
+    if (!l_ns) return ESP_ERR_INVALID_ARG;
+
+    auto l_it = l_ns->find(f_key);
+    if (l_it == l_ns->end()) return ESP_ERR_NVS_NOT_FOUND;
+    if (l_it->second.m_IsString) return ESP_ERR_NVS_TYPE_MISMATCH;
+
+    *f_out = l_it->second.m_I32;
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t nvs_erase_key(nvs_handle_t f_handle, const char *f_key)
+{
+    lock_guard<mutex> l_lock(g_NvsMutex);
+
+    NvsNamespace *l_ns = GetNamespace(f_handle);
+    if (!l_ns) return ESP_ERR_INVALID_ARG;
+
+    return l_ns->erase(f_key) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
@@ -0,0 +1,173 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "mbedtls/sha256.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const uint32_t g_K[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t Ror(uint32_t f_x, int f_n) { return (f_x >> f_n) | (f_x << (32 - f_n)); }
+
+static void ProcessBlock(mbedtls_sha256_context *f_ctx, const unsigned char *f_block)
+{
+    uint32_t l_w[64];
+
+    for (int i = 0; i < 16; i++)
+    {
+        l_w[i] = ((uint32_t)f_block[4 * i] << 24) | (f_block[4 * i + 1] << 16) | (f_block[4 * i + 2] << 8) | f_block[4 * i + 3];
+    }
+
+    for (int i = 16; i < 64; i++)
+    {
+        uint32_t l_s0 = Ror(l_w[i - 15], 7) ^ Ror(l_w[i - 15], 18) ^ (l_w[i - 15] >> 3);
+        uint32_t l_s1 = Ror(l_w[i - 2], 17) ^ Ror(l_w[i - 2], 19) ^ (l_w[i - 2] >> 10);
+
+        l_w[i] = l_w[i - 16] + l_s0 + l_w[i - 7] + l_s1;
+    }
+
+    uint32_t l_s[8];
+    memcpy(l_s, f_ctx->m_State, sizeof(l_s));
+
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t l_t1 = l_s[7] + (Ror(l_s[4], 6) ^ Ror(l_s[4], 11) ^ Ror(l_s[4], 25)) + ((l_s[4] & l_s[5]) ^ (~l_s[4] & l_s[6])) + g_K[i] + l_w[i];
+        uint32_t l_t2 = (Ror(l_s[0], 2) ^ Ror(l_s[0], 13) ^ Ror(l_s[0], 22)) + ((l_s[0] & l_s[1]) ^ (l_s[0] & l_s[2]) ^ (l_s[1] & l_s[2]));
+
+        memmove(l_s + 1, l_s, 7 * sizeof(uint32_t));
+        l_s[4] += l_t1;
+        l_s[0]  = l_t1 + l_t2;
+    }
+
+    for (int i = 0; i < 8; i++) f_ctx->m_State[i] += l_s[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void mbedtls_sha256_init(mbedtls_sha256_context *f_ctx)
+{
+    memset(f_ctx, 0, sizeof(*f_ctx));
+}
+
+void mbedtls_sha256_free(mbedtls_sha256_context *f_ctx)
+{
+    memset(f_ctx, 0, sizeof(*f_ctx));
+}
+
+int mbedtls_sha256_starts(mbedtls_sha256_context *f_ctx, int f_is224)
+{
+    static const uint32_t l_init[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+    if (f_is224) return -1;
+
+    memcpy(f_ctx->m_State, l_init, sizeof(l_init));
+    f_ctx->m_Length     = 0;
+    f_ctx->m_BlockLen   = 0;
+
+    return 0;
+}
+
+int mbedtls_sha256_update(mbedtls_sha256_context *f_ctx, const unsigned char *f_input, size_t f_len)
+{
+    f_ctx->m_Length += f_len;
+
+    while (f_len > 0)
+    {
+        size_t l_copy = 64 - f_ctx->m_BlockLen;
+        if (l_copy > f_len) l_copy = f_len;
+
+        memcpy(f_ctx->m_Block + f_ctx->m_BlockLen, f_input, l_copy);
+        f_ctx->m_BlockLen += l_copy;
+        f_input           += l_copy;
+        f_len             -= l_copy;
+
+        if (f_ctx->m_BlockLen == 64)
+        {
+            ProcessBlock(f_ctx, f_ctx->m_Block);
+            f_ctx->m_BlockLen = 0;
+        }
+    }
+
+    return 0;
+}
+
+int mbedtls_sha256_finish(mbedtls_sha256_context *f_ctx, unsigned char f_output[32])
+{
+    uint64_t        l_bits = f_ctx->m_Length * 8;
+    unsigned char   l_pad[72] = { 0x80 };
+    size_t          l_padlen = (f_ctx->m_BlockLen < 56 ? 56 : 120) - f_ctx->m_BlockLen;
+
+    for (int i = 0; i < 8; i++) l_pad[l_padlen + i] = (unsigned char)(l_bits >> (56 - 8 * i));
+
+    mbedtls_sha256_update(f_ctx, l_pad, l_padlen + 8);
+
+    for (int i = 0; i < 8; i++)
+    {
+        f_output[4 * i]     = (unsigned char)(f_ctx->m_State[i] >> 24);
+        f_output[4 * i + 1] = (unsigned char)(f_ctx->m_State[i] >> 16);
+        f_output[4 * i + 2] = (unsigned char)(f_ctx->m_State[i] >> 8);
+        f_output[4 * i + 3] = (unsigned char)(f_ctx->m_State[i]);
+    }
+
+    return 0;
+}
+
+int mbedtls_sha256(const unsigned char *f_input, size_t f_len, unsigned char f_output[32], int f_is224)
+{
+    mbedtls_sha256_context l_ctx;
+
+    mbedtls_sha256_init(&l_ctx);
+
+    int l_ret = mbedtls_sha256_starts(&l_ctx, f_is224);
+    if (l_ret == 0) mbedtls_sha256_update(&l_ctx, f_input, f_len);
+    if (l_ret == 0) mbedtls_sha256_finish(&l_ctx, f_output);
+
+    mbedtls_sha256_free(&l_ctx);
+
+    return l_ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -58,8 +58,10 @@
 #include <stdio.h>
 #include <ctime>
 #include "freertos/FreeRTOS.h"
-#include "rom/ets_sys.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "driver/gpio.h"
+#include "driver/gptimer.h"
 #include "esp_log.h"
 
 #include "ESP32_SHT1x.h"
@@ -79,20 +81,17 @@
 
 // some code defines
 
-// ---- HGT: chaged to 50 us (from 2) as our line length is too huge (5m STP)
+// ---- the steps of a transfer. Every pin change is followed by a half clock
+//      (SHT1x_HALF_CLOCK_US), a sample is taken right away.
 
-#define SHT1x_DELAY ets_delay_us(50);
+#define SHT1x_STEP_SCK_LO		0
+#define SHT1x_STEP_SCK_HI		1
+#define SHT1x_STEP_DATA_LO		2
+#define SHT1x_STEP_DATA_HI		3
+#define SHT1x_STEP_SAMPLE		4
 
-// ---- Macros to toggle port state of SCK line
-
-#define SHT1x_SCK_LO	gpio_set_level(m_SHT1x_pin_sck, 0)
-
-#define SHT1x_SCK_HI	gpio_set_level(m_SHT1x_pin_sck, 1)
-
-#define SHT1x_DATA_LO 	gpio_set_level(m_SHT1x_pin_data, 0);\
-						gpio_set_direction(m_SHT1x_pin_data,GPIO_MODE_OUTPUT)
-
-#define	SHT1x_DATA_HI 	gpio_set_direction(m_SHT1x_pin_data,GPIO_MODE_INPUT)
+// ---- DATA is open drain: high means released, the pullup of the breakout board
+//      pulls it up then
 
 #define SHT1x_GET_BIT 	gpio_get_level(m_SHT1x_pin_data)
 
@@ -102,6 +101,18 @@ static const char *TAG = "ESP32_SHT1x";
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
+static bool sht1x_timer_isr(gptimer_handle_t f_timer, const gptimer_alarm_event_data_t *f_edata, void *f_ctx)
+{
+	return ((SHT1x *)f_ctx)->SHT1x_Timer_Step();
+}
+
+static void sht1x_data_isr(void *f_ctx)
+{
+	((SHT1x *)f_ctx)->SHT1x_Data_Low();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
 SHT1x::SHT1x(void)
 {
 	m_Initialized		= false;
@@ -114,6 +125,14 @@ SHT1x::SHT1x(void)
 
 	m_rh				= 0;
 	m_temp				= 0;
+
+	m_StepCnt			= 0;
+	m_StepPos			= 0;
+	m_Bits				= 0;
+
+	m_Timer				= NULL;
+	m_StepsDone			= NULL;
+	m_DataLow			= NULL;
 }
 
 
@@ -156,62 +175,203 @@ bool SHT1x::SHT1x_InitPins(void)
 	l_err = gpio_set_direction(m_SHT1x_pin_sck,GPIO_MODE_OUTPUT);
 	if (l_err != ESP_OK) { ESP_LOGE(TAG, "SHT1x_InitPins error on gpio_set_direction for SCK"); return false; }
 
-	l_err = gpio_set_level(m_SHT1x_pin_sck, 0);
-	if (l_err != ESP_OK) { ESP_LOGE(TAG, "SHT1x_InitPins error on gpio_set_level for SCK"); return false; }
-
-	// --- how it works for SHT1x_pin_data: set PORT to 0 => pull data line low by setting port as output
-
 	// --- floating means - no pullup and no pulldown - so we need the one on the breakout board 
 
 	l_err = gpio_set_pull_mode(m_SHT1x_pin_data,GPIO_FLOATING);
 	if (l_err != ESP_OK) { ESP_LOGE(TAG, "SHT1x_InitPins error on gpio_set_pull_mode for DATA"); return false; }
 
-	// --- configure data output and set to low
+	// --- DATA as open drain output which can be read back, released for now
+
+	l_err = gpio_set_level(m_SHT1x_pin_data, 1);
+	if (l_err != ESP_OK) { ESP_LOGE(TAG, "SHT1x_InitPins error on gpio_set_level for DATA"); return false; }
 
-	l_err = gpio_set_direction(m_SHT1x_pin_data,GPIO_MODE_OUTPUT);
+	l_err = gpio_set_direction(m_SHT1x_pin_data,GPIO_MODE_INPUT_OUTPUT_OD);
 	if (l_err != ESP_OK) { ESP_LOGE(TAG, "SHT1x_InitPins error on gpio_set_direction for DATA"); return false; }
 
-	l_err = gpio_set_level(m_SHT1x_pin_sck, 0);
-	if (l_err != ESP_OK) { ESP_LOGE(TAG, "SHT1x_InitPins error on gpio_set_level for DATA"); return false; }
+	// --- the end of a conversion: the sensor pulls DATA low. The interrupt is only
+	//     armed while we wait for it, the clocked transfers toggle DATA all the time.
 
-	m_Initialized	= true;
+	l_err = gpio_set_intr_type(m_SHT1x_pin_data,GPIO_INTR_DISABLE);
+	if (l_err != ESP_OK) { ESP_LOGE(TAG, "SHT1x_InitPins error on gpio_set_intr_type for DATA"); return false; }
+
+	l_err = gpio_intr_disable(m_SHT1x_pin_data);
+	if (l_err != ESP_OK) { ESP_LOGE(TAG, "SHT1x_InitPins error on gpio_intr_disable for DATA"); return false; }
+
+	// --- the service is shared by all sensors, it may be installed already
+
+	l_err = gpio_install_isr_service(0);
+	if (l_err != ESP_OK && l_err != ESP_ERR_INVALID_STATE) { ESP_LOGE(TAG, "SHT1x_InitPins error on gpio_install_isr_service"); return false; }
+
+	l_err = gpio_isr_handler_add(m_SHT1x_pin_data,sht1x_data_isr,this);
+	if (l_err != ESP_OK) { ESP_LOGE(TAG, "SHT1x_InitPins error on gpio_isr_handler_add for DATA"); return false; }
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool SHT1x::SHT1x_InitTimer(void) 
+{
+	esp_err_t l_err;
+
+	m_StepsDone = xSemaphoreCreateBinary();
+	m_DataLow 	= xSemaphoreCreateBinary();
+	if (!m_StepsDone || !m_DataLow) { ESP_LOGE(TAG, "SHT1x_InitTimer out of memory"); return false; }
+
+	// --- 1 MHz, the alarm fires every half clock until the steps are done
+
+	gptimer_config_t l_config = {};
+
+	l_config.clk_src 		= GPTIMER_CLK_SRC_DEFAULT;
+	l_config.direction 		= GPTIMER_COUNT_UP;
+	l_config.resolution_hz 	= 1000000;
+
+	l_err = gptimer_new_timer(&l_config, &m_Timer);
+	if (l_err != ESP_OK) { ESP_LOGE(TAG, "SHT1x_InitTimer error on gptimer_new_timer"); return false; }
+
+	gptimer_event_callbacks_t l_cbs = {};
+
+	l_cbs.on_alarm = sht1x_timer_isr;
+
+	l_err = gptimer_register_event_callbacks(m_Timer, &l_cbs, this);
+	if (l_err != ESP_OK) { ESP_LOGE(TAG, "SHT1x_InitTimer error on gptimer_register_event_callbacks"); return false; }
+
+	gptimer_alarm_config_t l_alarm = {};
+
+	l_alarm.alarm_count 				= SHT1x_HALF_CLOCK_US;
+	l_alarm.reload_count 				= 0;
+	l_alarm.flags.auto_reload_on_alarm 	= true;
+
+	l_err = gptimer_set_alarm_action(m_Timer, &l_alarm);
+	if (l_err != ESP_OK) { ESP_LOGE(TAG, "SHT1x_InitTimer error on gptimer_set_alarm_action"); return false; }
+
+	l_err = gptimer_enable(m_Timer);
+	if (l_err != ESP_OK) { ESP_LOGE(TAG, "SHT1x_InitTimer error on gptimer_enable"); return false; }
 
 	return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
+void SHT1x::SHT1x_Add_Step(uint8_t step) 
+{
+	assert(m_StepCnt < SHT1x_MAX_STEPS);
+
+	m_Steps[m_StepCnt++] = step;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- runs the steps added since the last run, the task sleeps meanwhile. bits gets the
+//     samples, the last one in bit 0.
+
+bool SHT1x::SHT1x_Run(uint32_t *bits) 
+{
+	assert(m_Initialized);
+
+	m_StepPos 	= 0;
+	m_Bits 		= 0;
+
+	xSemaphoreTake(m_StepsDone, 0);
+
+	gptimer_set_raw_count(m_Timer, 0);
+
+	bool l_done = gptimer_start(m_Timer) == ESP_OK && xSemaphoreTake(m_StepsDone, pdMS_TO_TICKS(SHT1x_TRANSFER_TIMEOUT_MS)) == pdTRUE;
+	if (!l_done)
+	{
+		gptimer_stop(m_Timer);
+		ESP_LOGE(TAG, "Transfer on SCLK %d DATA %d did not finish", (int)m_SHT1x_pin_sck, (int)m_SHT1x_pin_data);
+	}
+
+	m_StepCnt = 0;
+
+	if (bits) *bits = m_Bits;
+
+	return l_done;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- timer interrupt: the next pin change, and the samples directly after it
+
+bool SHT1x::SHT1x_Timer_Step(void) 
+{
+	// --- work on copies of the volatile members, they are written back once
+
+	int l_pos 		= m_StepPos;
+	uint32_t l_bits = m_Bits;
+	bool l_changed 	= false;
+
+	while (l_pos < m_StepCnt && !l_changed)
+	{
+		l_changed = true;
+
+		switch (m_Steps[l_pos++])
+		{
+			case SHT1x_STEP_SCK_LO:		gpio_set_level(m_SHT1x_pin_sck, 0); break;
+			case SHT1x_STEP_SCK_HI:		gpio_set_level(m_SHT1x_pin_sck, 1); break;
+			case SHT1x_STEP_DATA_LO:	gpio_set_level(m_SHT1x_pin_data, 0); break;
+			case SHT1x_STEP_DATA_HI:	gpio_set_level(m_SHT1x_pin_data, 1); break;
+			case SHT1x_STEP_SAMPLE:		l_bits = (l_bits << 1) | (SHT1x_GET_BIT ? 1 : 0); l_changed = false; break;
+		}
+	}
+
+	m_StepPos 	= l_pos;
+	m_Bits 		= l_bits;
+
+	if (l_changed) return false;
+
+	// --- the half clock after the last pin change is over
+
+	BaseType_t l_woken = pdFALSE;
+
+	gptimer_stop(m_Timer);
+	xSemaphoreGiveFromISR(m_StepsDone, &l_woken);
+
+	return l_woken == pdTRUE;
+}
+
+// --- GPIO interrupt: DATA went low
+
+void SHT1x::SHT1x_Data_Low(void) 
+{
+	BaseType_t l_woken = pdFALSE;
+
+	xSemaphoreGiveFromISR(m_DataLow, &l_woken);
+
+	portYIELD_FROM_ISR(l_woken);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
 bool SHT1x::SHT1x_Reset(void) 
 {
 	// Chapter 3.4
 	unsigned char i;
 
-	SHT1x_DATA_HI;
-	SHT1x_DELAY;
+	SHT1x_Add_Step(SHT1x_STEP_DATA_HI);
 	for (i=9; i; i--)
 	{
-		SHT1x_SCK_HI;	SHT1x_DELAY;
-		SHT1x_SCK_LO;	SHT1x_DELAY;
+		SHT1x_Add_Step(SHT1x_STEP_SCK_HI);
+		SHT1x_Add_Step(SHT1x_STEP_SCK_LO);
 	}
 	SHT1x_Transmission_Start();
 	SHT1x_Sendbyte(SHT1x_RESET);  // Soft reset
 
-	return true;
+	return SHT1x_Run(NULL);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
 void SHT1x::SHT1x_Transmission_Start(void) 
 {
-	assert(m_Initialized);
-
 	// Chapter 3.2
-	SHT1x_SCK_HI;	SHT1x_DELAY;
-	SHT1x_DATA_LO;	SHT1x_DELAY;
-	SHT1x_SCK_LO;	SHT1x_DELAY;
-	SHT1x_SCK_HI;	SHT1x_DELAY;
-	SHT1x_DATA_HI;	SHT1x_DELAY;
-	SHT1x_SCK_LO;	SHT1x_DELAY;
+	SHT1x_Add_Step(SHT1x_STEP_SCK_HI);
+	SHT1x_Add_Step(SHT1x_STEP_DATA_LO);
+	SHT1x_Add_Step(SHT1x_STEP_SCK_LO);
+	SHT1x_Add_Step(SHT1x_STEP_SCK_HI);
+	SHT1x_Add_Step(SHT1x_STEP_DATA_HI);
+	SHT1x_Add_Step(SHT1x_STEP_SCK_LO);
 	
 	// TODO: this is a design flaw - status register is never read, just be accident
 	//		 it is always zero. 
@@ -239,88 +399,102 @@ unsigned char SHT1x::SHT1x_Mirrorbyte(unsigned char value)
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-unsigned char SHT1x::SHT1x_Readbyte(bool send_ack) 
+// --- adds the steps of one byte read, the 8 bits are sampled
+
+void SHT1x::SHT1x_Readbyte(bool send_ack) 
 {
-	unsigned char mask;
-	unsigned char value = 0;
+	unsigned char i;
 
 	// SCK is low here !
-	for(mask=0x80; mask; mask >>= 1 )
+	for(i=8; i; i--)
 	{
-		SHT1x_SCK_HI;	SHT1x_DELAY;  	// SCK hi
-		if( SHT1x_GET_BIT != 0 )  	// and read data
-			value |= mask;
-
-		SHT1x_SCK_LO;	SHT1x_DELAY; // SCK lo => sensor puts new data
+		SHT1x_Add_Step(SHT1x_STEP_SCK_HI);		// SCK hi
+		SHT1x_Add_Step(SHT1x_STEP_SAMPLE);		// and read data
+		SHT1x_Add_Step(SHT1x_STEP_SCK_LO);		// SCK lo => sensor puts new data
 	}
 
 	/* send ACK if required */
 	if ( send_ack )
 	{
-		SHT1x_DATA_LO;	SHT1x_DELAY; // Get DATA line
+		SHT1x_Add_Step(SHT1x_STEP_DATA_LO);		// Get DATA line
 	}
 	
-	SHT1x_SCK_HI;	SHT1x_DELAY;    // give a clock pulse
-	SHT1x_SCK_LO;	SHT1x_DELAY; 
+	SHT1x_Add_Step(SHT1x_STEP_SCK_HI);			// give a clock pulse
+	SHT1x_Add_Step(SHT1x_STEP_SCK_LO);
 	
 	if ( send_ack )
 	{       // Release DATA line
-		SHT1x_DATA_HI;	SHT1x_DELAY; 
+		SHT1x_Add_Step(SHT1x_STEP_DATA_HI);
 	}
-
-	return value;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-bool SHT1x::SHT1x_Sendbyte( unsigned char value) 
+// --- adds the steps of one byte sent, the ACK is sampled (0: acknowledged)
+
+void SHT1x::SHT1x_Sendbyte( unsigned char value) 
 {
 	unsigned char mask;
-	bool ack;
 
 	for(mask = 0x80; mask; mask>>=1)
 	{
-		SHT1x_SCK_LO;	SHT1x_DELAY;
-
-		if( value & mask )
-		{  
-			SHT1x_DATA_HI; 	SHT1x_DELAY;
-		}
-		else
-		{
-			SHT1x_DATA_LO;	SHT1x_DELAY;
-		}
-
-		SHT1x_SCK_HI;	SHT1x_DELAY;  // SCK hi => sensor reads data
+		SHT1x_Add_Step(SHT1x_STEP_SCK_LO);
+		SHT1x_Add_Step(value & mask ? SHT1x_STEP_DATA_HI : SHT1x_STEP_DATA_LO);
+		SHT1x_Add_Step(SHT1x_STEP_SCK_HI);		// SCK hi => sensor reads data
 	}
-	SHT1x_SCK_LO;	SHT1x_DELAY;
+	SHT1x_Add_Step(SHT1x_STEP_SCK_LO);
 
 	// Release DATA line
-	SHT1x_DATA_HI;	SHT1x_DELAY;
-	SHT1x_SCK_HI;	SHT1x_DELAY;
-
-	ack = false;
-
-	if(!SHT1x_GET_BIT)
-		ack = true;
-
-	SHT1x_SCK_LO;	SHT1x_DELAY;
+	SHT1x_Add_Step(SHT1x_STEP_DATA_HI);
+	SHT1x_Add_Step(SHT1x_STEP_SCK_HI);
+	SHT1x_Add_Step(SHT1x_STEP_SAMPLE);
+	SHT1x_Add_Step(SHT1x_STEP_SCK_LO);
 
 	SHT1x_Crc_Check(value);   // crc calculation
-
-	return ack;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
 bool SHT1x::SHT1x_Measure_Start(SHT1xMeasureType type) 
 {
-	assert(m_Initialized);
+	uint32_t l_ack;
 
 	// send a transmission start and reset crc calculation
 	SHT1x_Transmission_Start();
 	// send command. Crc gets updated!
-	return SHT1x_Sendbyte((unsigned char) type );
+	SHT1x_Sendbyte((unsigned char) type );
+
+	return SHT1x_Run(&l_ack) && l_ack == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool SHT1x::SHT1x_Wait_Conversion(void) 
+{
+	TickType_t l_start = xTaskGetTickCount();
+
+	xSemaphoreTake(m_DataLow, 0);
+	gpio_set_intr_type(m_SHT1x_pin_data, GPIO_INTR_NEGEDGE);
+	gpio_intr_enable(m_SHT1x_pin_data);
+
+	// --- the conversion may be over already, there is no edge then. A wake up only counts
+	//     if DATA is still low, after a glitch we wait on until the deadline.
+
+	bool l_done = !SHT1x_GET_BIT;
+
+	while (!l_done)
+	{
+		TickType_t l_waited = xTaskGetTickCount() - l_start;
+		if (l_waited >= pdMS_TO_TICKS(SHT1x_CONVERSION_TIMEOUT_MS)) break;
+
+		xSemaphoreTake(m_DataLow, pdMS_TO_TICKS(SHT1x_CONVERSION_TIMEOUT_MS) - l_waited);
+		l_done = !SHT1x_GET_BIT;
+	}
+
+	gpio_intr_disable(m_SHT1x_pin_data);
+	gpio_set_intr_type(m_SHT1x_pin_data, GPIO_INTR_DISABLE);
+
+	return l_done;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -329,31 +503,29 @@ bool SHT1x::SHT1x_Get_Measure_Value(unsigned short int * value )
 {
 	unsigned char * chPtr = (unsigned char*) value;
 	unsigned char checksum;
-	unsigned char delay_count=62;  /* delay is 62 * 5ms */
+	uint32_t l_bits;
 
 	assert(m_Initialized);
 
 	/* Wait for measurement to complete (DATA pin gets LOW) */
-	/* Raise an error after we waited 250ms without success (210ms + 15%) */
-	while( SHT1x_GET_BIT )
+	if (!SHT1x_Wait_Conversion())
 	{
-		ets_delay_us(5000);			// $$$$$$$$$$$$$$$$$$ 1 ms not working $$$$$$$$$$$$$$$$$$$$$$$$
-	
-		delay_count--;
-		if (delay_count == 0)
-		{
-			//g_AppLogger.Log("Timeout in SHT1x_Get_Measure_Value for Sensor with SCLK %d and DATA %d", (int)m_SHT1x_pin_sck,(int)m_SHT1x_pin_data);
-			return false;
-		}
-			
+		//g_AppLogger.Log("Timeout in SHT1x_Get_Measure_Value for Sensor with SCLK %d and DATA %d", (int)m_SHT1x_pin_sck,(int)m_SHT1x_pin_data);
+		return false;
 	}
 
-	*(chPtr + 1) = SHT1x_Readbyte(true);  // read hi byte
+	SHT1x_Readbyte(true);  		// hi byte
+	SHT1x_Readbyte(true);    	// lo byte
+	SHT1x_Readbyte(false);   	// crc
+
+	if (!SHT1x_Run(&l_bits)) return false;
+
+	*(chPtr + 1) = (unsigned char)(l_bits >> 16);
 	SHT1x_Crc_Check(*(chPtr + 1));  		// crc calculation
-	*chPtr = SHT1x_Readbyte(true);    	// read lo byte
+	*chPtr = (unsigned char)(l_bits >> 8);
 	SHT1x_Crc_Check(*chPtr);    			// crc calculation
 
-	checksum = SHT1x_Readbyte(false);   // crc calculation
+	checksum = (unsigned char)l_bits;
 
 	if (SHT1x_Mirrorbyte( checksum ) == m_SHT1x_crc)
 	{
@@ -490,12 +662,15 @@ bool SHT1x::SetupSensor(gpio_num_t f_sck,gpio_num_t f_data)
 	m_SHT1x_pin_sck		= f_sck;
 	m_SHT1x_pin_data	= f_data;
 
-	// --- set hardware pins
+	// --- set hardware pins and the timer of the bit level protocol
 
-	if (!SHT1x_InitPins())
+	if (!SHT1x_InitPins() || !SHT1x_InitTimer())
 	{
 		g_AppLogger.Log("Error initializing SHT1x");
+		return false;
 	}
+
+	m_Initialized	= true;
 	
 	// --- Reset the SHT1x
 
@@ -584,37 +759,46 @@ bool SHT1x::SetupSensor(gpio_num_t *f_pins,int *f_data)
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void SHT1x::AddValuesToJSON_MQTT(cJSON *f_root)
+void SHT1x::AddValuesToJSON_MQTT(JsonWriter &f_writer)
 {
-	cJSON_AddNumberToObject(f_root, "temp", GetTemp());
-	cJSON_AddNumberToObject(f_root, "rh", GetRH());
-	cJSON_AddNumberToObject(f_root, "dp", GetDP());
+	f_writer.Number("temp", GetTemp());
+	f_writer.Number("rh", GetRH());
+	f_writer.Number("dp", GetDP());
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void SHT1x::AddValuesToJSON_API(cJSON *f_root)
+void SHT1x::AddValuesToJSON_API(JsonWriter &f_writer)
 {
-    cJSON *temp = cJSON_CreateObject();
-    cJSON *rh 	= cJSON_CreateObject();
-    cJSON *dp 	= cJSON_CreateObject();
+	AddApiValue(f_writer, "temp", "C", "%.2f", GetTemp(), "Temperature");
+	AddApiValue(f_writer, "rh", "% rH", "%.2f", GetRH(), "Relative Humidity");
+	AddApiValue(f_writer, "dp", "C", "%.2f", GetDP(), "Dew Point");
+
+	f_writer.String("SensorType", "SHT1x Temperature Sensor");
+}
 
-	cJSON_AddStringToObject(temp, "unit", "C");
-	cJSON_AddStringToObject(temp, "value", float_2_string("%.2f",GetTemp()));
-	cJSON_AddStringToObject(temp, "text", "Temperature");
+////////////////////////////////////////////////////////////////////////////////////////
 
-	cJSON_AddStringToObject(rh, "unit", "% rH");
-	cJSON_AddStringToObject(rh, "value", float_2_string("%.2f",GetRH()));
-	cJSON_AddStringToObject(rh, "text", "Relative Humidity");
+static const char *g_SHT1x_Channels[] = { "temp", "rh", "dp" };
 
-	cJSON_AddStringToObject(dp, "unit", "C");
-	cJSON_AddStringToObject(dp, "value", float_2_string("%.2f",GetDP()));
-	cJSON_AddStringToObject(dp, "text", "Dew Point");
+int SHT1x::GetChannelCount(void)
+{
+	return sizeof(g_SHT1x_Channels) / sizeof(g_SHT1x_Channels[0]);
+}
 
-	cJSON_AddItemToObject(f_root,"temp",temp);
-	cJSON_AddItemToObject(f_root,"rh",rh);
-	cJSON_AddItemToObject(f_root,"dp",dp);
+const char *SHT1x::GetChannelName(int f_ch)
+{
+	return f_ch >= 0 && f_ch < GetChannelCount() ? g_SHT1x_Channels[f_ch] : "";
+}
 
-	cJSON_AddStringToObject(f_root, "SensorType", "SHT1x Temperature Sensor");
+float SHT1x::GetChannelValue(int f_ch)
+{
+	switch (f_ch)
+	{
+		case 0: return GetTemp();
+		case 1: return GetRH();
+		case 2: return GetDP();
+	}
 
-}
\ No newline at end of file
+	return 0;
+}
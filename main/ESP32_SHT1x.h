@@ -60,6 +60,10 @@
 
 #include <unistd.h>
 #include <stdio.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "driver/gptimer.h"
 #include "csensor.h"
 
 /* Definitions of all known SHT1x commands */
@@ -70,6 +74,15 @@
 #define SHT1x_STATUS_W	0x06			// Write status register.
 #define SHT1x_RESET		0x1E			// Perform a sensor soft reset.
 
+// --- the bit level protocol runs in a timer interrupt, one pin change every half clock.
+//     The task sleeps meanwhile and during the conversion, which ends with an interrupt
+//     when the sensor pulls DATA low.
+
+#define SHT1x_HALF_CLOCK_US				50		// --- long lines (5m STP) need the slow clock
+#define SHT1x_MAX_STEPS					128		// --- longest transfer: three bytes read
+#define SHT1x_TRANSFER_TIMEOUT_MS		50		// --- a transfer takes about 5 ms
+#define SHT1x_CONVERSION_TIMEOUT_MS		310		// --- 14 bit: 210 ms + 15%, with some reserve
+
 ////////////////////////////////////////////////////////////////////////////////////////
 
 /* Enum to select between temperature and humidity measuring */
@@ -121,20 +134,36 @@ public:
 	virtual std::string GetSensorDescriptionString(void);
  	virtual bool PerformMeasurement(void);
  	virtual bool SetupSensor(gpio_num_t *f_pins,int *f_data);
-    virtual void AddValuesToJSON_MQTT(cJSON *f_root);
-    virtual void AddValuesToJSON_API(cJSON *f_root);
+    virtual void AddValuesToJSON_MQTT(JsonWriter &f_writer);
+    virtual void AddValuesToJSON_API(JsonWriter &f_writer);
+	virtual int GetChannelCount(void);
+	virtual const char *GetChannelName(int f_ch);
+	virtual float GetChannelValue(int f_ch);
+
+	// --- temperature and humidity conversion may take up to 310 ms each (the task sleeps)
+
+	virtual uint32_t GetMeasurementDeadlineMs(void) { return 750; }
+
+	// --- internal functions do not use, called from the interrupts
+
+	bool SHT1x_Timer_Step(void);
+	void SHT1x_Data_Low(void);
 
 private:
 
 	void SHT1x_Transmission_Start(void);
-	bool SHT1x_Sendbyte(unsigned char value );
+	void SHT1x_Sendbyte(unsigned char value );
+	void SHT1x_Readbyte(bool sendAck);
+	void SHT1x_Add_Step(uint8_t step);
+	bool SHT1x_Run(uint32_t *bits);
+
 	bool SHT1x_InitPins(void);
+	bool SHT1x_InitTimer(void);
 	bool SHT1x_Measure_Start(SHT1xMeasureType type );
+	bool SHT1x_Wait_Conversion(void);
 	bool SHT1x_Get_Measure_Value(unsigned short int * value );
 	bool SHT1x_Reset(void);
 
-	unsigned char SHT1x_Readbyte(bool sendAck);
-
 	void SHT1x_Calc(unsigned short int p_humidity ,unsigned short int p_temperature);
 
 
@@ -150,6 +179,17 @@ private:
 	unsigned char m_SHT1x_crc;
 	unsigned char m_SHT1x_status_reg;
 
+	// --- the steps of the current transfer and the DATA bits sampled by them
+
+	uint8_t m_Steps[SHT1x_MAX_STEPS];
+	int m_StepCnt;
+	volatile int m_StepPos;
+	volatile uint32_t m_Bits;
+
+	gptimer_handle_t m_Timer;
+	SemaphoreHandle_t m_StepsDone;
+	SemaphoreHandle_t m_DataLow;
+
 	bool m_Initialized;
 };
 
@@ -38,15 +38,19 @@
 #include <string>
 #include <ctime>
 #include <cstring>
+#include <stdarg.h>
 
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "nvs_flash.h"
 #include "nvs.h"
 #include "driver/gpio.h"
 #include "driver/uart.h"
 
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "applogger.h"
+#include "event_stream.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -56,157 +60,424 @@ using namespace std;
 
 static const char *TAG = "AppLogger";
 
+// --- notification bits of the writer task
+
+#define APPLOGGER_BIT_LINE      (1u << 0)
+#define APPLOGGER_BIT_FLUSH     (1u << 1)
+
+// --- the arguments of a conversion, as they are packed into a slot
+
+typedef enum
+{
+    APPLOGGER_ARG_NONE = 0,     // --- "%%"
+    APPLOGGER_ARG_INT,
+    APPLOGGER_ARG_LONG,
+    APPLOGGER_ARG_LLONG,
+    APPLOGGER_ARG_SIZE,
+    APPLOGGER_ARG_DOUBLE,
+    APPLOGGER_ARG_STR,          // --- copied including the terminating 0
+    APPLOGGER_ARG_PTR,
+    APPLOGGER_ARG_BAD           // --- the line is formatted right away
+} applogger_arg_t;
+
+#define APPLOGGER_MAX_SPEC_LEN  16
+
 ////////////////////////////////////////////////////////////////////////////////////////
 
 CAppLogger g_AppLogger;
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-esp_err_t CAppLogger::InitAppLogger(void)
+static void applogger_writer_task(void *f_param)
 {
-    ESP_LOGI(TAG, "InitAppLogger()");
-
-    return ESP_OK;
+    ((CAppLogger *)f_param)->WriterLoop();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void CAppLogger::ShutdownAppLogger(void)
+// --- f_p points to a '%'. Returns the length of the conversion and its argument type.
+
+static int applogger_parse_spec(const char *f_p, applogger_arg_t *f_arg)
 {
+    const char *l_p = f_p + 1;
+    int        l_long = 0;
+
+    *f_arg = APPLOGGER_ARG_BAD;
+
+    while (*l_p && strchr("-+ #0", *l_p)) l_p++;
+    while (*l_p >= '0' && *l_p <= '9') l_p++;
+
+    if (*l_p == '.')
+    {
+        l_p++;
+        while (*l_p >= '0' && *l_p <= '9') l_p++;
+    }
+
+    if      (l_p[0] == 'h')                     l_p += l_p[1] == 'h' ? 2 : 1;
+    else if (l_p[0] == 'l' && l_p[1] == 'l')    { l_long = 2; l_p += 2; }
+    else if (l_p[0] == 'l')                     { l_long = 1; l_p++; }
+    else if (l_p[0] == 'z')                     { l_long = 3; l_p++; }
+
+    int l_len = l_p - f_p + 1;
+
+    if (!*l_p || l_len >= APPLOGGER_MAX_SPEC_LEN) return l_p - f_p;
+
+    switch (*l_p)
+    {
+        case 'd': case 'i': case 'u': case 'x': case 'X': case 'o':
+            *f_arg = l_long == 0 ? APPLOGGER_ARG_INT  : l_long == 1 ? APPLOGGER_ARG_LONG :
+                     l_long == 2 ? APPLOGGER_ARG_LLONG : APPLOGGER_ARG_SIZE;
+            break;
+
+        case 'c':
+            if (l_long == 0) *f_arg = APPLOGGER_ARG_INT;
+            break;
+
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if (l_long <= 1) *f_arg = APPLOGGER_ARG_DOUBLE;
+            break;
+
+        case 's':
+            if (l_long == 0) *f_arg = APPLOGGER_ARG_STR;
+            break;
+
+        case 'p':
+            *f_arg = APPLOGGER_ARG_PTR;
+            break;
+
+        case '%':
+            if (l_len == 2) *f_arg = APPLOGGER_ARG_NONE;
+            break;
+    }
+
+    return l_len;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void CAppLogger::SetLine(int f_line,uint32_t f_idx, const char *f_s)
+// --- copies the arguments of f_format to f_data. Returns the number of bytes used, -1 if
+//     the line has to be formatted right away. Strings are cut to the space left.
+
+#define APPLOGGER_PACK(type)                                                            \
+    do {                                                                                \
+        type l_value = va_arg(f_args, type);                                            \
+        if (l_used + sizeof(type) > f_size) return -1;                                  \
+        memcpy(f_data + l_used, &l_value, sizeof(type));                                \
+        l_used += sizeof(type);                                                         \
+    } while (0)
+
+static int applogger_pack(const char *f_format, va_list f_args, char *f_data, size_t f_size)
 {
-    assert(f_line<APPLOGGER_MAX_NUMLINES);
+    size_t l_used = 0;
 
-    m_IdLogBuffer[f_line].m_LogIndex = f_idx;
-    if  (m_IdLogBuffer[f_line].m_Text) delete [] m_IdLogBuffer[f_line].m_Text;
+    for (const char *l_p = f_format; *l_p; )
+    {
+        if (*l_p != '%')
+        {
+            l_p++;
+            continue;
+        }
+
+        applogger_arg_t l_arg;
+        l_p += applogger_parse_spec(l_p, &l_arg);
+
+        switch (l_arg)
+        {
+            case APPLOGGER_ARG_NONE:    break;
+            case APPLOGGER_ARG_INT:     APPLOGGER_PACK(int);                break;
+            case APPLOGGER_ARG_LONG:    APPLOGGER_PACK(long);               break;
+            case APPLOGGER_ARG_LLONG:   APPLOGGER_PACK(long long);          break;
+            case APPLOGGER_ARG_SIZE:    APPLOGGER_PACK(size_t);             break;
+            case APPLOGGER_ARG_DOUBLE:  APPLOGGER_PACK(double);             break;
+            case APPLOGGER_ARG_PTR:     APPLOGGER_PACK(void *);             break;
+            case APPLOGGER_ARG_BAD:     return -1;
+
+            case APPLOGGER_ARG_STR:
+            {
+                const char *l_str = va_arg(f_args, const char *);
+                if (!l_str) l_str = "(null)";
+                if (l_used >= f_size) return -1;
+
+                size_t l_len = strnlen(l_str, f_size - l_used - 1);
+                memcpy(f_data + l_used, l_str, l_len);
+                f_data[l_used + l_len] = '\0';
+                l_used += l_len + 1;
+                break;
+            }
+        }
+    }
 
-    m_IdLogBuffer[f_line].m_Text = new char [strlen(f_s)+1];
-    if (!m_IdLogBuffer[f_line].m_Text)
+    return l_used;
+}
+
+#undef APPLOGGER_PACK
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the reverse of applogger_pack(): every conversion is printed on its own with its
+//     argument from f_data
+
+#define APPLOGGER_RENDER(type)                                                          \
+    do {                                                                                \
+        type l_value;                                                                   \
+        memcpy(&l_value, f_data + l_used, sizeof(type));                                \
+        l_used += sizeof(type);                                                         \
+        l_len += snprintf(f_text + l_len, f_size - l_len, l_spec, l_value);             \
+    } while (0)
+
+static void applogger_render(const char *f_format, const char *f_data, char *f_text, size_t f_size)
+{
+    size_t l_used = 0;
+    size_t l_len  = 0;
+    char   l_spec[APPLOGGER_MAX_SPEC_LEN];
+
+    for (const char *l_p = f_format; *l_p && l_len < f_size - 1; )
     {
-        ESP_LOGE(TAG, "Failed to allocate log line buffer!");
-        ESP_ERROR_CHECK(ESP_FAIL);
+        if (*l_p != '%')
+        {
+            f_text[l_len++] = *l_p++;
+            continue;
+        }
+
+        applogger_arg_t l_arg;
+        int l_spec_len = applogger_parse_spec(l_p, &l_arg);
+
+        if (l_arg == APPLOGGER_ARG_BAD)
+        {
+            l_p += l_spec_len;
+            continue;
+        }
+
+        memcpy(l_spec, l_p, l_spec_len);
+        l_spec[l_spec_len] = '\0';
+        l_p += l_spec_len;
+
+        switch (l_arg)
+        {
+            case APPLOGGER_ARG_NONE:    f_text[l_len++] = '%';              break;
+            case APPLOGGER_ARG_INT:     APPLOGGER_RENDER(int);              break;
+            case APPLOGGER_ARG_LONG:    APPLOGGER_RENDER(long);             break;
+            case APPLOGGER_ARG_LLONG:   APPLOGGER_RENDER(long long);        break;
+            case APPLOGGER_ARG_SIZE:    APPLOGGER_RENDER(size_t);           break;
+            case APPLOGGER_ARG_DOUBLE:  APPLOGGER_RENDER(double);           break;
+            case APPLOGGER_ARG_PTR:     APPLOGGER_RENDER(void *);           break;
+            case APPLOGGER_ARG_BAD:                                         break;     // --- never packed
+
+            case APPLOGGER_ARG_STR:
+                l_len  += snprintf(f_text + l_len, f_size - l_len, l_spec, f_data + l_used);
+                l_used += strlen(f_data + l_used) + 1;
+                break;
+        }
+
+        if (l_len > f_size - 1) l_len = f_size - 1;
     }
-    
-    // --- simply copy the string to the respective buffer position
 
-    strcpy(m_IdLogBuffer[f_line].m_Text,f_s);
+    f_text[l_len] = '\0';
 }
 
+#undef APPLOGGER_RENDER
+
 ////////////////////////////////////////////////////////////////////////////////////////
 
-int CAppLogger::GetLineCount(void)
+// --- without f_dir the lines are only kept in memory. Has to be called before the
+//     first line is logged, as the numbering continues where the files end.
+
+esp_err_t CAppLogger::InitAppLogger(const char *f_dir)
 {
-    return m_NumLines;
+    ESP_LOGI(TAG, "InitAppLogger(%s)", f_dir ? f_dir : "");
+
+    if (!f_dir) return ESP_OK;
+
+    if (GetLastId() != 0)
+    {
+        ESP_LOGE(TAG, "Lines were logged before InitAppLogger(), no history");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    strlcpy(m_Dir, f_dir, sizeof(m_Dir));
+
+    m_PersistedId   = ReadLastFileId();
+    m_FirstId       = m_PersistedId + 1;
+    m_NextId.store(m_FirstId, std::memory_order_release);
+
+    m_FileMutex = xSemaphoreCreateMutex();
+    if (!m_FileMutex || xTaskCreate(applogger_writer_task, "applog", APPLOGGER_TASK_STACK, this, APPLOGGER_TASK_PRIO, &m_WriterTask) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Could not create the writer task");
+        m_Dir[0] = '\0';
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void CAppLogger::AddLine(const char *f_s)
+void CAppLogger::ShutdownAppLogger(void)
 {
-    ESP_LOGI(TAG, "%s",f_s);
-    RawAddLine(f_s);
+    Flush();
+}
+
+// --- the lines are written soon after, e.g. during the delay before a restart
+
+void CAppLogger::Flush(void)
+{
+    if (m_WriterTask) xTaskNotify(m_WriterTask, APPLOGGER_BIT_FLUSH, eSetBits);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void CAppLogger::RawAddLine(const char *f_s)
+int CAppLogger::GetLineCount(void)
 {
-    // --- add string and index to line buffer
+    uint32_t l_lines = m_NextId.load(std::memory_order_acquire) - m_FirstId;
 
-    SetLine(m_NextLine,m_NextLogIdx,f_s);
+    return l_lines < APPLOGGER_MAX_NUMLINES ? l_lines : APPLOGGER_MAX_NUMLINES;
+}
 
- 
+uint32_t CAppLogger::GetFirstId(void)
+{
+    uint32_t l_next = m_NextId.load(std::memory_order_acquire);
 
-    //ESP_LOGI(TAG, "AddLine in: nextline %d numline %d",m_NextLine,m_NumLines);
-    
-    m_NextLine++;
-    if (m_NextLine >= APPLOGGER_MAX_NUMLINES) m_NextLine = 0;
-    if (m_NumLines < APPLOGGER_MAX_NUMLINES) m_NumLines++;
+    if (l_next == m_FirstId) return 0;
 
-   // --- advance log index
-    
-    m_NextLogIdx++;
-    if (m_NextLogIdx > 1000000) m_NextLogIdx = 1;
+    return l_next - m_FirstId > APPLOGGER_MAX_NUMLINES ? l_next - APPLOGGER_MAX_NUMLINES : m_FirstId;
+}
 
-    //ESP_LOGI(TAG, "AddLine out: nextline %d numline %d",m_NextLine,m_NumLines);
+uint32_t CAppLogger::GetLastId(void)
+{
+    uint32_t l_next = m_NextId.load(std::memory_order_acquire);
+
+    return l_next == m_FirstId ? 0 : l_next - 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-int CAppLogger::FindLineNumber(uint32_t f_id)
+// --- formatting for the console is the expensive part of a line, so it is only done
+//     when the echo is switched on
+
+void CAppLogger::AddLine(const char *f_format, const char *f_data, size_t f_size)
 {
-    for (int i=0; i < APPLOGGER_MAX_NUMLINES; ++i)
-        if (m_IdLogBuffer[i].m_LogIndex == f_id) return i;
+    if (m_ConsoleEcho.load(std::memory_order_relaxed))
+    {
+        if (f_format)
+        {
+            char l_text[APPLOGGER_MAX_LINE_LEN];
+
+            applogger_render(f_format, f_data, l_text, sizeof(l_text));
+            ESP_LOGI(TAG, "%s", l_text);
+        }
+        else ESP_LOGI(TAG, "%s", f_data);
+    }
 
-    return -1;
+    RawAddLine(f_format, f_data, f_size);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-const char *CAppLogger::GetLineText(int f_line)
+void CAppLogger::RawAddLine(const char *f_format, const char *f_data, size_t f_size)
 {
-     //ESP_LOGI(TAG, "GetLine in: nextline %d numline %d",m_NextLine,m_NumLines);
-  // --- check, if the line is available
+    int64_t l_time = esp_timer_get_time();
 
-    if (f_line >= m_NumLines) return NULL;
+    // --- the number of the line decides the slot
 
-    int l_rawidx; 
-    if (m_NumLines < APPLOGGER_MAX_NUMLINES)
-    {
-        l_rawidx = f_line;
-    }
-    else
+    uint32_t l_id   = m_NextId.fetch_add(1, std::memory_order_relaxed);
+    LogSlot  &l_slot = m_Slots[l_id % APPLOGGER_MAX_NUMLINES];
+
+    // --- claim the slot. If the writer of the line a ring before is still busy, wait for
+    //     it (blocking, it may have a lower priority). If a newer line has the slot
+    //     already, this one is gone anyway.
+
+    uint32_t l_state = l_slot.m_State.load(std::memory_order_relaxed);
+
+    while (true)
     {
-        l_rawidx = f_line + m_NextLine; 
-        if (l_rawidx >= APPLOGGER_MAX_NUMLINES) l_rawidx -= APPLOGGER_MAX_NUMLINES;
+        if (l_state >= 2 * l_id) return;
+
+        if (l_state & 1)
+        {
+            vTaskDelay(1);
+            l_state = l_slot.m_State.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (l_slot.m_State.compare_exchange_weak(l_state, 2 * l_id + 1, std::memory_order_acquire, std::memory_order_relaxed)) break;
     }
 
-    //ESP_LOGI(TAG, "GetLine out: rawidx %d nextline %d numline %d",l_rawidx,m_NextLine,m_NumLines);
+    l_slot.m_Format = f_format;
+    l_slot.m_TimeUs = l_time;
+    memcpy(l_slot.m_Data, f_data, f_size);
 
-    return m_IdLogBuffer[l_rawidx].m_Text;
+    l_slot.m_State.store(2 * l_id, std::memory_order_release);
+
+    // --- push the line to the web clients and the files
+
+    g_EventStream.NotifyLog();
+
+    if (m_WriterTask) xTaskNotify(m_WriterTask, APPLOGGER_BIT_LINE, eSetBits);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-uint32_t CAppLogger::GetLineId(int f_line)
+// --- a seqlock read: the copy only counts if the slot held the same complete line
+//     before and after it. The line is formatted from the copy.
+
+bool CAppLogger::GetLine(uint32_t f_id, char *f_text, int64_t *f_time_us)
 {
-     //ESP_LOGI(TAG, "GetLine in: nextline %d numline %d",m_NextLine,m_NumLines);
-  // --- check, if the line is available
+    if (f_id == 0) return false;
 
-    if (f_line >= m_NumLines) return 0;
+    LogSlot  &l_slot  = m_Slots[f_id % APPLOGGER_MAX_NUMLINES];
+    uint32_t l_before = l_slot.m_State.load(std::memory_order_acquire);
 
-    int l_rawidx; 
-    if (m_NumLines < APPLOGGER_MAX_NUMLINES)
-    {
-        l_rawidx = f_line;
-    }
+    if (l_before != 2 * f_id) return false;
+
+    const char *l_format = l_slot.m_Format;
+    int64_t    l_time    = l_slot.m_TimeUs;
+    char       l_data[APPLOGGER_MAX_LINE_LEN];
+
+    memcpy(l_data, l_slot.m_Data, sizeof(l_data));
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (l_slot.m_State.load(std::memory_order_relaxed) != l_before) return false;
+
+    if (l_format) applogger_render(l_format, l_data, f_text, APPLOGGER_MAX_LINE_LEN);
     else
     {
-        l_rawidx = f_line + m_NextLine; 
-        if (l_rawidx >= APPLOGGER_MAX_NUMLINES) l_rawidx -= APPLOGGER_MAX_NUMLINES;
+        memcpy(f_text, l_data, APPLOGGER_MAX_LINE_LEN);
+        f_text[APPLOGGER_MAX_LINE_LEN - 1] = '\0';
     }
 
-    //ESP_LOGI(TAG, "GetLine out: rawidx %d nextline %d numline %d",l_rawidx,m_NextLine,m_NumLines);
+    if (f_time_us) *f_time_us = l_time;
 
-    return m_IdLogBuffer[l_rawidx].m_LogIndex;
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
+// --- the arguments are packed, formatting waits until somebody reads the line
+
 void CAppLogger::Log( const char * format, ... )
 {
-    char sMessage[APPLOGGER_MAX_LINE_LEN];
+    char    l_data[APPLOGGER_MAX_LINE_LEN];
     va_list args;
+    va_list l_copy;
 
     va_start (args, format);
-    vsprintf (sMessage,format, args);
+    va_copy (l_copy, args);
 
-    AddLine(sMessage);
+    int l_size = applogger_pack(format, args, l_data, sizeof(l_data));
 
+    if (l_size >= 0)
+    {
+        AddLine(format, l_data, l_size);
+    }
+    else
+    {
+        vsnprintf (l_data, sizeof(l_data), format, l_copy);
+        AddLine(NULL, l_data, strlen(l_data) + 1);
+    }
+
+    va_end (l_copy);
     va_end (args);
 }
  
@@ -214,7 +485,10 @@ void CAppLogger::Log( const char * format, ... )
 
 void CAppLogger::Log( const string& sMessage )
 {
-    AddLine(sMessage.c_str());
+    char l_text[APPLOGGER_MAX_LINE_LEN];
+
+    strlcpy(l_text, sMessage.c_str(), sizeof(l_text));
+    AddLine(NULL, l_text, strlen(l_text) + 1);
 }
  
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -223,4 +497,220 @@ CAppLogger& CAppLogger::operator<<(const string& sMessage )
 {
     Log(sMessage);
     return *this;
-}
\ No newline at end of file
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the history files hold one line per log line: "<id> <text>"
+
+void CAppLogger::GetFileName(int f_file, char *f_name, size_t f_size)
+{
+    snprintf(f_name, f_size, "%s/" APPLOGGER_FILE_NAME ".%d", m_Dir, f_file);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- lines are collected for up to APPLOGGER_FLUSH_MS, unless half of the ring is
+//     waiting already, so a burst of lines costs one write
+
+void CAppLogger::WriterLoop(void)
+{
+    while (1)
+    {
+        uint32_t l_bits = 0;
+
+        xTaskNotifyWait(0, UINT32_MAX, &l_bits, portMAX_DELAY);
+
+        TickType_t l_start = xTaskGetTickCount();
+
+        while (!(l_bits & APPLOGGER_BIT_FLUSH) && GetLastId() - m_PersistedId < APPLOGGER_MAX_NUMLINES / 2)
+        {
+            TickType_t l_waited = xTaskGetTickCount() - l_start;
+            if (l_waited >= pdMS_TO_TICKS(APPLOGGER_FLUSH_MS)) break;
+
+            uint32_t l_more = 0;
+            xTaskNotifyWait(0, UINT32_MAX, &l_more, pdMS_TO_TICKS(APPLOGGER_FLUSH_MS) - l_waited);
+            l_bits |= l_more;
+        }
+
+        WritePending();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void CAppLogger::WritePending(void)
+{
+    uint32_t l_id    = m_PersistedId + 1;
+    uint32_t l_last  = GetLastId();
+    uint32_t l_first = GetFirstId();
+    char     l_text[APPLOGGER_MAX_LINE_LEN];
+
+    if (!l_last || l_id > l_last) return;
+
+    if (l_id < l_first)
+    {
+        m_Dropped += l_first - l_id;
+        l_id = l_first;
+    }
+
+    char l_name[sizeof(m_Dir) + 16];
+    GetFileName(0, l_name, sizeof(l_name));
+
+    xSemaphoreTake(m_FileMutex, portMAX_DELAY);
+
+    FILE *l_file = fopen(l_name, "a");
+
+    if (!l_file)
+    {
+        xSemaphoreGive(m_FileMutex);
+        ESP_LOGE(TAG, "Cannot open %s", l_name);
+        return;
+    }
+
+    for (; l_id <= l_last; ++l_id)
+    {
+        if (!GetLine(l_id, l_text))
+        {
+            // --- still being written: the next notification continues here
+
+            if (l_id >= GetFirstId()) break;
+
+            m_Dropped++;
+            continue;
+        }
+
+        for (char *l_p = l_text; *l_p; ++l_p) if (*l_p == '\n') *l_p = ' ';
+
+        fprintf(l_file, "%u %s\n", (unsigned)l_id, l_text);
+    }
+
+    long l_size = ftell(l_file);
+
+    fclose(l_file);
+
+    m_PersistedId = l_id - 1;
+
+    if (l_size >= APPLOGGER_FILE_SIZE) RotateFiles();
+
+    xSemaphoreGive(m_FileMutex);
+}
+
+void CAppLogger::RotateFiles(void)
+{
+    char l_from[sizeof(m_Dir) + 16];
+    char l_to[sizeof(m_Dir) + 16];
+
+    GetFileName(APPLOGGER_FILE_CNT - 1, l_to, sizeof(l_to));
+    remove(l_to);
+
+    for (int i = APPLOGGER_FILE_CNT - 2; i >= 0; --i)
+    {
+        GetFileName(i, l_from, sizeof(l_from));
+        GetFileName(i + 1, l_to, sizeof(l_to));
+        rename(l_from, l_to);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the newest file is small, so it is simply read to the end
+
+uint32_t CAppLogger::ReadLastFileId(void)
+{
+    char     l_name[sizeof(m_Dir) + 16];
+    char     l_line[APPLOGGER_MAX_LINE_LEN + 16];
+    uint32_t l_last = 0;
+
+    for (int i = 0; i < APPLOGGER_FILE_CNT && !l_last; ++i)
+    {
+        GetFileName(i, l_name, sizeof(l_name));
+
+        FILE *l_file = fopen(l_name, "r");
+        if (!l_file) continue;
+
+        while (fgets(l_line, sizeof(l_line), l_file))
+        {
+            uint32_t l_id = strtoul(l_line, NULL, 10);
+            if (l_id > l_last) l_last = l_id;
+        }
+
+        fclose(l_file);
+    }
+
+    return l_last;
+}
+
+uint32_t CAppLogger::GetHistoryFirstId(void)
+{
+    if (!m_Dir[0]) return 0;
+
+    char     l_name[sizeof(m_Dir) + 16];
+    char     l_line[APPLOGGER_MAX_LINE_LEN + 16];
+    uint32_t l_first = 0;
+
+    xSemaphoreTake(m_FileMutex, portMAX_DELAY);
+
+    for (int i = APPLOGGER_FILE_CNT - 1; i >= 0 && !l_first; --i)
+    {
+        GetFileName(i, l_name, sizeof(l_name));
+
+        FILE *l_file = fopen(l_name, "r");
+        if (!l_file) continue;
+
+        if (fgets(l_line, sizeof(l_line), l_file)) l_first = strtoul(l_line, NULL, 10);
+
+        fclose(l_file);
+    }
+
+    xSemaphoreGive(m_FileMutex);
+
+    return l_first;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the files are locked while f_cb runs, the writer task waits meanwhile
+
+int CAppLogger::ReadHistory(uint32_t f_from_id, uint32_t f_before_id, int f_max, applogger_line_cb_t f_cb, void *f_ctx)
+{
+    if (!m_Dir[0]) return 0;
+
+    char l_name[sizeof(m_Dir) + 16];
+    char l_line[APPLOGGER_MAX_LINE_LEN + 16];
+    int  l_cnt = 0;
+
+    xSemaphoreTake(m_FileMutex, portMAX_DELAY);
+
+    for (int i = APPLOGGER_FILE_CNT - 1; i >= 0 && l_cnt < f_max; --i)
+    {
+        GetFileName(i, l_name, sizeof(l_name));
+
+        FILE *l_file = fopen(l_name, "r");
+        if (!l_file) continue;
+
+        while (l_cnt < f_max && fgets(l_line, sizeof(l_line), l_file))
+        {
+            char     *l_text;
+            uint32_t l_id = strtoul(l_line, &l_text, 10);
+
+            if (l_id < f_from_id || *l_text != ' ') continue;
+            if (l_id >= f_before_id) break;
+
+            l_text[strcspn(l_text, "\n")] = '\0';
+
+            f_cb(f_ctx, l_id, l_text + 1);
+            l_cnt++;
+        }
+
+        fclose(l_file);
+    }
+
+    xSemaphoreGive(m_FileMutex);
+
+    return l_cnt;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
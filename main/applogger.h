@@ -38,58 +38,125 @@
 ///////////////////////////////////////////////////////////////////////////////////////
 
 #include "sdkconfig.h"
+#include <stdint.h>
 #include <string>
+#include <atomic>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
 #define APPLOGGER_MAX_LINE_LEN 80
 #define APPLOGGER_MAX_NUMLINES 30
 
+// --- the history: the lines are appended to <dir>/applog.0 in batches. When it is full,
+//     the files are rotated (applog.0 -> applog.1 ...) and the oldest one is removed.
+
+#define APPLOGGER_FILE_NAME         "applog"
+#define APPLOGGER_FILE_SIZE         8192
+#define APPLOGGER_FILE_CNT          3
+#define APPLOGGER_FLUSH_MS          5000        // --- longest time a line waits for the writer
+#define APPLOGGER_TASK_STACK        4096
+#define APPLOGGER_TASK_PRIO         2
+
+// --- copy every line to the console. The copy is formatted in Log(), on the caller's
+//     thread, so it is off by default (see SetConsoleEcho()).
+
+#define APPLOGGER_CONSOLE_ECHO      false
+
+// --- for ReadHistory()
+
+typedef void (*applogger_line_cb_t)(void *f_ctx, uint32_t f_id, const char *f_text);
+
 ////////////////////////////////////////////////////////////////////////////////////////
 
+// --- the last APPLOGGER_MAX_NUMLINES lines in fixed slots, nothing is allocated. Lines
+//     are numbered from 1 on, line n lives in slot n % APPLOGGER_MAX_NUMLINES. Any task
+//     may log at the same time: a writer claims its number with one atomic increment,
+//     so writers never wait for each other unless one of them is a whole ring behind.
+//     Readers copy a line out and notice if it was overwritten meanwhile.
+//
+//     With a directory given to InitAppLogger() a writer task keeps the lines in files as
+//     well, and the numbering continues after a restart.
+
 class CAppLogger
 {
 public:
 
     CAppLogger()
     {
-        m_NumLines  = 0;
-        m_NextLine  = 0;
-
-        m_NextLogIdx = 1;
+        m_NextId.store(1, std::memory_order_relaxed);
+        m_ConsoleEcho.store(APPLOGGER_CONSOLE_ECHO, std::memory_order_relaxed);
+        m_FirstId       = 1;
+        m_PersistedId   = 0;
+        m_Dropped       = 0;
+        m_Dir[0]        = '\0';
 
         for (int i = 0;i < APPLOGGER_MAX_NUMLINES;++i)
         {
-            m_IdLogBuffer[i].m_LogIndex = 0;
-            m_IdLogBuffer[i].m_Text = NULL;
+            m_Slots[i].m_State.store(0, std::memory_order_relaxed);
+            m_Slots[i].m_Format = NULL;
+            m_Slots[i].m_TimeUs = 0;
+            m_Slots[i].m_Data[0] = '\0';
         }
     }
 
     // --- init functions
 
-    esp_err_t InitAppLogger(void);
+    esp_err_t InitAppLogger(const char *f_dir = NULL);
     void ShutdownAppLogger(void);
+    void Flush(void);
+
+    void SetConsoleEcho(bool f_echo) { m_ConsoleEcho.store(f_echo, std::memory_order_relaxed); }
 
-    // --- logger functions
+    // --- logger functions. Log(format, ...) only stores the pointer to the format and the
+    //     raw arguments (strings are copied), the line is formatted when it is read. The
+    //     format therefore has to be a literal. Formats with '*', %n or unusual length
+    //     modifiers, and arguments which don't fit, are formatted right away. So is the
+    //     console copy, if it is switched on.
 
     void Log(const std::string& sMessage);
     void Log(const char *format, ... );
 
     CAppLogger& operator<<(const std::string& sMessage );
 
-    const char *GetLineText(int f_line);
-    uint32_t GetLineId(int f_line);
-    int FindLineNumber(uint32_t f_id);
+    // --- getters. The ids of the lines in the ring are GetFirstId() ... GetLastId(),
+    //     both 0 while the log is empty. GetLine() copies a line to f_text (of
+    //     APPLOGGER_MAX_LINE_LEN bytes) and fails if the line is not in the ring anymore
+    //     or still being written. f_time_us gets the esp_timer time of the Log() call.
+
+    uint32_t GetFirstId(void);
+    uint32_t GetLastId(void);
+    bool GetLine(uint32_t f_id, char *f_text, int64_t *f_time_us = NULL);
 
     int  GetLineCount(void);
 
+    // --- the history in the files, up to the line before f_before_id. Returns the number
+    //     of lines passed to f_cb.
+
+    uint32_t GetHistoryFirstId(void);
+    int ReadHistory(uint32_t f_from_id, uint32_t f_before_id, int f_max, applogger_line_cb_t f_cb, void *f_ctx);
+    uint32_t GetDroppedCount(void) { return m_Dropped; }
+
+    // --- internal functions do not use
+
+    void WriterLoop(void);
+
 private:
 
-    typedef struct LogEntry
+    // --- m_State is 2 * id once the line is complete, 2 * id + 1 while it is written.
+    //     m_Data is the text if m_Format is NULL, otherwise the packed arguments.
+
+    struct LogSlot
     {
-        uint32_t    m_LogIndex;
-        char        *m_Text;
-    } LogEntry_t;
+        std::atomic<uint32_t>   m_State;
+        const char              *m_Format;
+        int64_t                 m_TimeUs;
+        char                    m_Data[APPLOGGER_MAX_LINE_LEN];
+    };
 
     // --- don't copy this object
 
@@ -100,18 +167,26 @@ private:
     
     // --- simple helper function
 
-    void SetLine(int f_line,uint32_t f_idx, const char *f_s);
-    void AddLine(const char *f_s); 
-    void RawAddLine(const char *f_s); 
+    void AddLine(const char *f_format, const char *f_data, size_t f_size);
+    void RawAddLine(const char *f_format, const char *f_data, size_t f_size);
 
-    // --- our buffer 
+    void WritePending(void);
+    void RotateFiles(void);
+    uint32_t ReadLastFileId(void);
+    void GetFileName(int f_file, char *f_name, size_t f_size);
 
-    int         m_NumLines;
-    int         m_NextLine;
+    // --- our buffer 
 
-    uint32_t    m_NextLogIdx;
+    std::atomic<uint32_t>   m_NextId;
+    uint32_t                m_FirstId;          // --- first line of this boot
+    std::atomic<bool>       m_ConsoleEcho;
+    LogSlot                 m_Slots[APPLOGGER_MAX_NUMLINES];
 
-    LogEntry_t m_IdLogBuffer[APPLOGGER_MAX_NUMLINES];
+    char                    m_Dir[64];          // --- empty: no history
+    uint32_t                m_PersistedId;      // --- last line in the files, writer task only
+    uint32_t                m_Dropped;          // --- lines overwritten before they were written
+    TaskHandle_t            m_WriterTask = NULL;
+    SemaphoreHandle_t       m_FileMutex = NULL; // --- writing and reading the files
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////
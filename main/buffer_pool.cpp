@@ -0,0 +1,109 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+
+#include "esp_log.h"
+
+#include "buffer_pool.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *TAG = "BufferPool";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+BufferPool g_BufferPool;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- all buffers in one block, allocated once at startup
+
+esp_err_t BufferPool::InitPool(void)
+{
+    if (m_Free) return ESP_OK;
+
+    m_Memory    = (char *)malloc(BUFFER_POOL_CNT * BUFFER_POOL_SIZE);
+    m_Free      = xQueueCreate(BUFFER_POOL_CNT, sizeof(char *));
+
+    if (!m_Memory || !m_Free)
+    {
+        ESP_LOGE(TAG, "No memory for %d buffers of %d bytes", BUFFER_POOL_CNT, BUFFER_POOL_SIZE);
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (int i = 0; i < BUFFER_POOL_CNT; ++i)
+    {
+        char *l_buf = m_Memory + i * BUFFER_POOL_SIZE;
+        xQueueSend(m_Free, &l_buf, 0);
+    }
+
+    m_MinFree = BUFFER_POOL_CNT;
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+char *BufferPool::Acquire(TickType_t f_wait)
+{
+    char *l_buf = NULL;
+
+    if (!m_Free || xQueueReceive(m_Free, &l_buf, f_wait) != pdTRUE)
+    {
+        ESP_LOGW(TAG, "No free buffer");
+        return NULL;
+    }
+
+    // --- not exact when two tasks acquire at the same time, good enough for the metrics
+
+    int l_free = GetFreeCount();
+    if (l_free < m_MinFree) m_MinFree = l_free;
+
+    return l_buf;
+}
+
+void BufferPool::Release(char *f_buf)
+{
+    xQueueSend(m_Free, &f_buf, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int BufferPool::GetFreeCount(void)
+{
+    return m_Free ? uxQueueMessagesWaiting(m_Free) : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,111 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BUFFER_POOL_H_
+#define	BUFFER_POOL_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "esp_err.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- fixed size I/O buffers of the web server: serving files, receiving the config and
+//     the firmware. Each request streams through one buffer it owns while the handler
+//     runs, so handlers never share memory. A request waits for a free buffer for up to
+//     f_wait ticks.
+
+#define BUFFER_POOL_CNT                 4
+#define BUFFER_POOL_SIZE                4096
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class BufferPool
+{
+public:
+
+    // --- action functions
+
+    esp_err_t InitPool(void);
+    char *Acquire(TickType_t f_wait);
+    void Release(char *f_buf);
+
+    // --- getters
+
+    int GetFreeCount(void);
+    int GetMinFreeCount(void) { return m_MinFree; }
+
+private:
+
+    char            *m_Memory = NULL;
+    QueueHandle_t   m_Free = NULL;          // --- pointers to the free buffers
+    int             m_MinFree;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+extern BufferPool g_BufferPool;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- one buffer for the lifetime of the object: PooledBuffer l_buf(pdMS_TO_TICKS(1000));
+//     Get() is NULL if no buffer became free in time.
+
+class PooledBuffer
+{
+public:
+
+    PooledBuffer(TickType_t f_wait) : m_Buf(g_BufferPool.Acquire(f_wait)) {}
+    ~PooledBuffer() { if (m_Buf) g_BufferPool.Release(m_Buf); }
+
+    char *Get(void) { return m_Buf; }
+    size_t GetSize(void) { return BUFFER_POOL_SIZE; }
+
+private:
+
+    PooledBuffer(const PooledBuffer &);
+    PooledBuffer &operator=(const PooledBuffer &);
+
+    char    *m_Buf;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
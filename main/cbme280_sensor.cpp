@@ -51,11 +51,7 @@
 
 #include "sensor_config.h"
 #include "cbme280_sensor.h"
-
-////////////////////////////////////////////////////////////////////////////////////////
-
-bool CBme280Sensor::m_i2c_initialized[I2C_NUM_MAX];
-bool CBme280Sensor::m_i2c_array_initialized = false;
+#include "i2c_bus_manager.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -69,10 +65,10 @@ BME280_INTF_RET_TYPE CBme280Sensor::bme280_i2c_read(uint8_t reg_addr, uint8_t *r
 
 	// --- write register address
 
-   	esp_err_t l_retcode = i2c_master_write_read_device(l_this->m_i2c_port, l_this->m_dev_address, &reg_addr, 1, reg_data, length, 1000 / portTICK_PERIOD_MS);
+   	esp_err_t l_retcode = g_I2CBusManager.Transfer(l_this->m_i2c_dev, &reg_addr, 1, reg_data, length);
 	if (l_retcode != ESP_OK)
 	{
-		ESP_LOGE(TAG,"bme280_i2c_read / i2c_master_transmit_receive failed with %d", l_retcode);
+		ESP_LOGE(TAG,"bme280_i2c_read / transfer failed with %d", l_retcode);
 		return BME280_E_COMM_FAIL;
 	}
 
@@ -99,10 +95,10 @@ BME280_INTF_RET_TYPE CBme280Sensor::bme280_i2c_write(uint8_t reg_addr, const uin
 
 
 
-   	esp_err_t l_retcode = i2c_master_write_to_device(l_this->m_i2c_port, l_this->m_dev_address, l_writebuf, length+1, 1000 / portTICK_PERIOD_MS);
+   	esp_err_t l_retcode = g_I2CBusManager.Write(l_this->m_i2c_dev, l_writebuf, length+1);
 	if (l_retcode != ESP_OK)
 	{
-		ESP_LOGE(TAG,"bme280_i2c_read / i2c_master_write_to_device (1) failed with %d", l_retcode);
+		ESP_LOGE(TAG,"bme280_i2c_write / write failed with %d", l_retcode);
 		return BME280_E_COMM_FAIL;
 	}
 
@@ -132,16 +128,11 @@ CBme280Sensor::CBme280Sensor(void)
 	m_pin_sda			= (gpio_num_t)0;
 	m_pin_scl			= (gpio_num_t)0;
 	m_i2c_port 			= (i2c_port_t)0;
+	m_i2c_dev			= -1;
 	
 	m_temp				= 0;
 	m_rh				= 0;
 	m_pressure			= 0;
-
-	if (!m_i2c_array_initialized)
-	{
-		for (int i=0;i<I2C_NUM_MAX;++i) m_i2c_initialized[i] = false;
-		m_i2c_array_initialized = true;
-	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -159,38 +150,11 @@ bool CBme280Sensor::SetupSensor(gpio_num_t f_sda,gpio_num_t f_scl,i2c_port_t f_i
 
 	assert(m_i2c_port < I2C_NUM_MAX);
 
-	// ---- initialize i2c port
+	// ---- register with the bus, the BME280 runs with fast mode
 
-	if (!m_i2c_initialized[m_i2c_port])
-	{
-		ESP_LOGI(TAG,"Setup i2c port %d",m_i2c_port);
-
-		i2c_config_t conf;
-
-		conf.mode 				= I2C_MODE_MASTER;
-		conf.sda_io_num 		= m_pin_sda;
-		conf.scl_io_num 		= m_pin_scl;
-		conf.sda_pullup_en 		= GPIO_PULLUP_ENABLE;
-		conf.scl_pullup_en 		= GPIO_PULLUP_ENABLE;
-		conf.master.clk_speed 	= 100000;
-		conf.clk_flags 			= 0;
-
-		i2c_param_config(m_i2c_port, &conf);
-		
-		esp_err_t l_retcode = i2c_driver_install(m_i2c_port,conf.mode, 0, 0, 0);
-		if (l_retcode != ESP_OK)
-		{
-			ESP_LOGE(TAG,"bme280_init / i2c_driver_install failed with %d", l_retcode);
-			return false;
-		}
-
-		// --- remember that this I2B is up and ready
-
-		m_i2c_initialized[m_i2c_port] = true;
-	}
-	else
+	if (g_I2CBusManager.AddDevice(m_i2c_port, m_pin_sda, m_pin_scl, m_dev_address, I2C_BUS_SPEED_FAST, "BME280", &m_i2c_dev) != ESP_OK)
 	{
-		ESP_LOGI(TAG,"Reuse i2c port %d - new pin settings etc are ignored!",m_i2c_port);
+		return false;
 	}
 
     // --- initialize the device structure for the low level Bosch API
@@ -321,39 +285,29 @@ std::string CBme280Sensor::GetSensorDescriptionString(void)
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void CBme280Sensor::AddValuesToJSON_MQTT(cJSON *f_root)
+void CBme280Sensor::AddValuesToJSON_MQTT(JsonWriter &f_writer)
 {
-	cJSON_AddNumberToObject(f_root, "temp", m_temp);
-	cJSON_AddNumberToObject(f_root, "rh", m_rh);
-	cJSON_AddNumberToObject(f_root, "pressure", m_pressure);	
+	f_writer.Number("temp", m_temp);
+	f_writer.Number("rh", m_rh);
+	f_writer.Number("pressure", m_pressure);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void CBme280Sensor::AddValuesToJSON_API(cJSON *f_root)
+void CBme280Sensor::AddValuesToJSON_API(JsonWriter &f_writer)
 {
-	cJSON *t 	= cJSON_CreateObject();
-    cJSON *r 	= cJSON_CreateObject();
-    cJSON *p 	= cJSON_CreateObject();
-
-	cJSON_AddStringToObject(t, "unit", "C");
-	cJSON_AddStringToObject(t, "value", float_2_string("%.2f",m_temp));
-	cJSON_AddStringToObject(t, "text", "Temperature");
-
-	cJSON_AddStringToObject(r, "unit", "%");
-	cJSON_AddStringToObject(r, "value", float_2_string("%.2f",m_rh));
-	cJSON_AddStringToObject(r, "text", "Relative Humidity");
-
-	cJSON_AddStringToObject(p, "unit", "mbar");
-	cJSON_AddStringToObject(p, "value", float_2_string("%.2f",m_pressure));
-	cJSON_AddStringToObject(p, "text", "Pressure");
+	AddApiValue(f_writer, "temp", "C", "%.2f", m_temp, "Temperature");
+	AddApiValue(f_writer, "rh", "%", "%.2f", m_rh, "Relative Humidity");
+	AddApiValue(f_writer, "pressure", "mbar", "%.2f", m_pressure, "Pressure");
 
-	cJSON_AddItemToObject(f_root,"temp",t);
-	cJSON_AddItemToObject(f_root,"rh",r);
-	cJSON_AddItemToObject(f_root,"pressure",p);
+	f_writer.String("SensorType", "Bosch BME280 Sensor");
+}
 
-	cJSON_AddStringToObject(f_root, "SensorType", "Bosch BME280 Sensor");
+////////////////////////////////////////////////////////////////////////////////////////
 
+void CBme280Sensor::AddStatsToJSON(JsonWriter &f_writer)
+{
+	g_I2CBusManager.AddDeviceStatsToJSON(m_i2c_dev, f_writer);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -372,3 +326,29 @@ bool CBme280Sensor::SetupSensor(gpio_num_t *f_pins,int *f_data)
 
 #endif
 }
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *g_CBme280Sensor_Channels[] = { "temp", "rh", "pressure" };
+
+int CBme280Sensor::GetChannelCount(void)
+{
+	return sizeof(g_CBme280Sensor_Channels) / sizeof(g_CBme280Sensor_Channels[0]);
+}
+
+const char *CBme280Sensor::GetChannelName(int f_ch)
+{
+	return f_ch >= 0 && f_ch < GetChannelCount() ? g_CBme280Sensor_Channels[f_ch] : "";
+}
+
+float CBme280Sensor::GetChannelValue(int f_ch)
+{
+	switch (f_ch)
+	{
+		case 0: return m_temp;
+		case 1: return m_rh;
+		case 2: return m_pressure;
+	}
+
+	return 0;
+}
@@ -40,7 +40,7 @@
 #include <unistd.h>
 #include <stdio.h>
 
-#include "driver/i2c.h"
+#include "driver/i2c_types.h"
 #include "csensor.h"
 
 #include "bme280.h"
@@ -82,8 +82,12 @@ public:
 	virtual std::string GetSensorValueString(void);
     virtual std::string GetSensorDescriptionString(void);
  	virtual bool PerformMeasurement(void);
-    virtual void AddValuesToJSON_MQTT(cJSON *f_root);
-    virtual void AddValuesToJSON_API(cJSON *f_root);
+    virtual void AddValuesToJSON_MQTT(JsonWriter &f_writer);
+    virtual void AddValuesToJSON_API(JsonWriter &f_writer);
+    virtual void AddStatsToJSON(JsonWriter &f_writer);
+	virtual int GetChannelCount(void);
+	virtual const char *GetChannelName(int f_ch);
+	virtual float GetChannelValue(int f_ch);
  	virtual bool SetupSensor(gpio_num_t *f_pins,int *f_data);	
 
 private:
@@ -105,11 +109,7 @@ private:
 	i2c_port_t	 	m_i2c_port;
 	int				m_bme280_i2c_adr;
 	int 			m_dev_address;
-
-	// --- I2C initialization tracking
-
-	static bool m_i2c_initialized[I2C_NUM_MAX];
-	static bool m_i2c_array_initialized;
+	int				m_i2c_dev;			// --- number at g_I2CBusManager
 
 	// --- BMW280 stuff
 
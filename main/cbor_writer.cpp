@@ -0,0 +1,213 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <string.h>
+
+#include "cbor_writer.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- major types and simple values
+
+#define CBOR_UINT           0
+#define CBOR_NEGINT         1
+#define CBOR_TEXT           3
+#define CBOR_ARRAY          4
+#define CBOR_MAP            5
+
+#define CBOR_FALSE          0xf4
+#define CBOR_TRUE           0xf5
+#define CBOR_NULL           0xf6
+#define CBOR_FLOAT32        0xfa
+#define CBOR_FLOAT64        0xfb
+
+#define CBOR_MAX_EXACT_INT  9007199254740992.0      // --- 2^53
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+CborWriter::CborWriter(uint8_t *f_buf, size_t f_size)
+    : m_Buf(f_buf), m_Size(f_size), m_Len(0), m_Overflow(false)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void CborWriter::BeginMap(const char *f_key, int f_count)
+{
+    Key(f_key);
+    Head(CBOR_MAP, f_count);
+}
+
+void CborWriter::BeginArray(const char *f_key, int f_count)
+{
+    Key(f_key);
+    Head(CBOR_ARRAY, f_count);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void CborWriter::String(const char *f_key, const char *f_value)
+{
+    Key(f_key);
+
+    if (!f_value)
+    {
+        uint8_t l_null = CBOR_NULL;
+        Put(&l_null, 1);
+        return;
+    }
+
+    size_t l_len = strlen(f_value);
+
+    Head(CBOR_TEXT, l_len);
+    Put(f_value, l_len);
+}
+
+void CborWriter::Number(const char *f_key, double f_value)
+{
+    if (isnan(f_value) || isinf(f_value))
+    {
+        Null(f_key);
+        return;
+    }
+
+    // --- whole numbers as integer, most sensor values fit a float32 exactly
+
+    if (f_value == trunc(f_value) && fabs(f_value) < CBOR_MAX_EXACT_INT)
+    {
+        Int(f_key, (int64_t)f_value);
+        return;
+    }
+
+    Key(f_key);
+
+    uint8_t l_buf[9];
+    float   l_float = (float)f_value;
+
+    if ((double)l_float == f_value)
+    {
+        uint32_t l_bits;
+        memcpy(&l_bits, &l_float, sizeof(l_bits));
+
+        l_buf[0] = CBOR_FLOAT32;
+        for (int i = 0; i < 4; ++i) l_buf[1 + i] = (uint8_t)(l_bits >> (24 - 8 * i));
+
+        Put(l_buf, 5);
+    }
+    else
+    {
+        uint64_t l_bits;
+        memcpy(&l_bits, &f_value, sizeof(l_bits));
+
+        l_buf[0] = CBOR_FLOAT64;
+        for (int i = 0; i < 8; ++i) l_buf[1 + i] = (uint8_t)(l_bits >> (56 - 8 * i));
+
+        Put(l_buf, 9);
+    }
+}
+
+void CborWriter::Int(const char *f_key, int64_t f_value)
+{
+    Key(f_key);
+
+    if (f_value >= 0) Head(CBOR_UINT, (uint64_t)f_value);
+    else Head(CBOR_NEGINT, (uint64_t)(-1 - f_value));
+}
+
+void CborWriter::Bool(const char *f_key, bool f_value)
+{
+    Key(f_key);
+
+    uint8_t l_val = f_value ? CBOR_TRUE : CBOR_FALSE;
+    Put(&l_val, 1);
+}
+
+void CborWriter::Null(const char *f_key)
+{
+    Key(f_key);
+
+    uint8_t l_val = CBOR_NULL;
+    Put(&l_val, 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void CborWriter::Key(const char *f_key)
+{
+    if (!f_key) return;
+
+    size_t l_len = strlen(f_key);
+
+    Head(CBOR_TEXT, l_len);
+    Put(f_key, l_len);
+}
+
+// --- initial byte plus the shortest argument (RFC 8949, 3.1)
+
+void CborWriter::Head(uint8_t f_major, uint64_t f_value)
+{
+    uint8_t l_buf[9];
+    int     l_bytes;
+
+    if (f_value < 24)
+    {
+        l_buf[0] = (f_major << 5) | (uint8_t)f_value;
+        Put(l_buf, 1);
+        return;
+    }
+
+    if (f_value <= 0xff)            { l_buf[0] = (f_major << 5) | 24; l_bytes = 1; }
+    else if (f_value <= 0xffff)     { l_buf[0] = (f_major << 5) | 25; l_bytes = 2; }
+    else if (f_value <= 0xffffffff) { l_buf[0] = (f_major << 5) | 26; l_bytes = 4; }
+    else                            { l_buf[0] = (f_major << 5) | 27; l_bytes = 8; }
+
+    for (int i = 0; i < l_bytes; ++i) l_buf[1 + i] = (uint8_t)(f_value >> (8 * (l_bytes - 1 - i)));
+
+    Put(l_buf, 1 + l_bytes);
+}
+
+void CborWriter::Put(const void *f_data, size_t f_len)
+{
+    if (m_Overflow || m_Len + f_len > m_Size)
+    {
+        m_Overflow = true;
+        return;
+    }
+
+    memcpy(m_Buf + m_Len, f_data, f_len);
+    m_Len += f_len;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,98 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CBOR_WRITER_H_
+#define	CBOR_WRITER_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- CBOR (RFC 8949) emitter for the binary MQTT payloads, the counterpart of
+//     JsonWriter. Maps and arrays have a definite length, so the number of entries is
+//     given when they are opened and there is no End function.
+//
+//     All value functions take the key first; pass NULL inside arrays. Number() picks
+//     the shortest exact encoding: integer, float32 or float64.
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class CborWriter
+{
+public:
+
+    CborWriter(uint8_t *f_buf, size_t f_size);
+
+    // --- structure
+
+    void BeginMap(const char *f_key, int f_count);
+    void BeginArray(const char *f_key, int f_count);
+
+    // --- values. NaN and infinity become null like in the JSON payloads.
+
+    void String(const char *f_key, const char *f_value);
+    void Number(const char *f_key, double f_value);
+    void Int(const char *f_key, int64_t f_value);
+    void Bool(const char *f_key, bool f_value);
+    void Null(const char *f_key);
+
+    // --- returns ESP_ERR_NO_MEM when the buffer was too small
+
+    esp_err_t Finish(void) const { return m_Overflow ? ESP_ERR_NO_MEM : ESP_OK; }
+
+    // --- getters
+
+    size_t GetLength(void) const { return m_Len; }
+    bool IsOverflow(void) const { return m_Overflow; }
+
+private:
+
+    void Key(const char *f_key);
+    void Head(uint8_t f_major, uint64_t f_value);
+    void Put(const void *f_data, size_t f_len);
+
+    uint8_t         *m_Buf;
+    size_t          m_Size;
+    size_t          m_Len;
+    bool            m_Overflow;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -35,8 +35,10 @@
 #include <assert.h>
 #include <math.h>
 #include <stdio.h>
-#include <string>
+#include <stdlib.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "nvs_flash.h"
 #include "nvs.h"
 #include "driver/gpio.h"
@@ -89,15 +91,100 @@ esp_err_t ConfigManager::InitConfigManager(void)
         return err;      
     }
 
+    m_Mutex = xSemaphoreCreateMutex();
+    if (!m_Mutex) return ESP_ERR_NO_MEM;
+
+    // ---- and read all values once
+
+    LoadValues();
+
     return ESP_OK;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
+// --- missing keys are 0 or empty, like before they were ever set
+
+void ConfigManager::LoadValues(void)
+{
+    char *l_pool = m_StringPool;
+
+    for (int k = 0; k < CFMGR_KEY_CNT; ++k)
+    {
+        const ConfigKeyDef &l_def = g_ConfigSchema[k];
+        esp_err_t          err;
+
+        m_Ints[k]    = 0;
+        m_Strings[k] = NULL;
+
+        if (l_def.m_Type == CFMGR_TYPE_STRING)
+        {
+            size_t l_size = l_def.m_MaxLen + 1;
+
+            m_Strings[k] = l_pool;
+            l_pool += l_size;
+
+            err = nvs_get_str(m_nvs_handle, l_def.m_Name, m_Strings[k], &l_size);
+
+            // --- stored before the key had a limit: keep what fits instead of losing it
+
+            if (err == ESP_ERR_NVS_INVALID_LENGTH)
+            {
+                err = LoadTruncated(l_def, m_Strings[k]);
+            }
+
+            if (err != ESP_OK) m_Strings[k][0] = '\0';
+        }
+        else
+        {
+            err = nvs_get_i32(m_nvs_handle, l_def.m_Name, &m_Ints[k]);
+            if (err != ESP_OK) m_Ints[k] = 0;
+        }
+
+        if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND)
+        {
+            ESP_LOGE(TAG, "Error reading key '%s': %s",l_def.m_Name,esp_err_to_name(err)); 
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- f_value has room for f_def.m_MaxLen characters. The stored value is only cut here,
+//     it is written again with the next change of the key.
+
+esp_err_t ConfigManager::LoadTruncated(const ConfigKeyDef &f_def, char *f_value)
+{
+    size_t l_size = 0;
+
+    esp_err_t err = nvs_get_str(m_nvs_handle, f_def.m_Name, NULL, &l_size);
+    if (err != ESP_OK) return err;
+
+    char *l_buf = (char *)malloc(l_size);
+    if (!l_buf) return ESP_ERR_NO_MEM;
+
+    err = nvs_get_str(m_nvs_handle, f_def.m_Name, l_buf, &l_size);
+    if (err == ESP_OK)
+    {
+        strlcpy(f_value, l_buf, f_def.m_MaxLen + 1);
+        ESP_LOGW(TAG, "Value of key '%s' longer than %d characters, truncated",f_def.m_Name,f_def.m_MaxLen);
+    }
+
+    free(l_buf);
+
+    return err;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
 void ConfigManager::ShutdownConfigManager(void)
 {
     if (m_nvs_handle)
     {
+        // --- values changed during an unfinished update are written as well
+
+        if (m_Mutex) Commit();
+
         esp_err_t err = nvs_commit(m_nvs_handle);
         if (err != ESP_OK) 
         {
@@ -111,125 +198,216 @@ void ConfigManager::ShutdownConfigManager(void)
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-esp_err_t ConfigManager::SetStringValue(const char *f_key,const char *f_value)
+// --- updates
+
+void ConfigManager::BeginUpdate(void)
 {
-    assert(m_nvs_handle);
+    assert(m_Mutex);
 
-    esp_err_t err = nvs_set_str(m_nvs_handle,f_key,f_value);
-    if (err != ESP_OK) 
-    {
-        ESP_LOGE(TAG, "Error writing key '%s' to '%s': %s",f_key,f_value,esp_err_to_name(err)); 
-        return err;
-    }
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+    m_UpdateDepth++;
+    xSemaphoreGive(m_Mutex);
+}
 
-    err = nvs_commit(m_nvs_handle);
-    if (err != ESP_OK) 
+esp_err_t ConfigManager::EndUpdate(void)
+{
+    assert(m_Mutex);
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+    bool l_last = m_UpdateDepth > 0 && --m_UpdateDepth == 0;
+    xSemaphoreGive(m_Mutex);
+
+    return l_last ? Commit() : ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- subscribers are registered during the start and never removed
+
+esp_err_t ConfigManager::Subscribe(uint32_t f_keys, cfmgr_change_cb_t f_cb, void *f_ctx)
+{
+    assert(m_Mutex);
+
+    esp_err_t l_err = ESP_OK;
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    if (m_SubscriberCnt < CFMGR_MAX_SUBSCRIBERS)
     {
-        ESP_LOGE(TAG, "Error to commit after writing key '%s' to '%s': %s",f_key,f_value,esp_err_to_name(err)); 
-        return err;
+        m_Subscribers[m_SubscriberCnt].m_Keys = f_keys;
+        m_Subscribers[m_SubscriberCnt].m_Cb   = f_cb;
+        m_Subscribers[m_SubscriberCnt].m_Ctx  = f_ctx;
+        m_SubscriberCnt++;
     }
+    else l_err = ESP_ERR_NO_MEM;
 
-    return ESP_OK;
+    xSemaphoreGive(m_Mutex);
+
+    if (l_err != ESP_OK) ESP_LOGE(TAG, "Too many subscribers");
+
+    return l_err;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-std::string ConfigManager::GetStringValue(const char *f_key)
-{    
-    assert(m_nvs_handle);
+// --- writes the dirty keys and tells the subscribers. The callbacks run without the
+//     lock, so they can read the config. A key which could not be written stays dirty
+//     and is written again with the next commit.
 
-    // --- get the size first
+esp_err_t ConfigManager::Commit(void)
+{
+    esp_err_t err = ESP_OK;
 
-    size_t required_size;
-    esp_err_t err = nvs_get_str(m_nvs_handle, f_key, NULL, &required_size);
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
 
-    // --- check for "empty" string
+    uint32_t l_changed = m_Dirty;
+    m_Dirty = 0;
 
-    if (err == ESP_ERR_NVS_NOT_FOUND)
+    for (int k = 0; k < CFMGR_KEY_CNT && l_changed; ++k)
     {
-        ESP_LOGI(TAG, "ConfigManager::GetStringValue: key not found '%s'",f_key); 
+        if (!(l_changed & CFMGR_KEY_BIT(k))) continue;
 
-        // ---- return empty string
+        const ConfigKeyDef &l_def = g_ConfigSchema[k];
 
-        return string();
+        esp_err_t l_err = l_def.m_Type == CFMGR_TYPE_STRING ? nvs_set_str(m_nvs_handle, l_def.m_Name, m_Strings[k]) :
+                                                              nvs_set_i32(m_nvs_handle, l_def.m_Name, m_Ints[k]);
+        if (l_err != ESP_OK) 
+        {
+            ESP_LOGE(TAG, "Error writing key '%s': %s",l_def.m_Name,esp_err_to_name(l_err)); 
+            m_Dirty |= CFMGR_KEY_BIT(k);
+            err = l_err;
+        }
     }
 
-    // --- every other error: fail
+    if (l_changed)
+    {
+        esp_err_t l_err = nvs_commit(m_nvs_handle);
+        if (l_err != ESP_OK) 
+        {
+            ESP_LOGE(TAG, "Error to commit: %s",esp_err_to_name(l_err)); 
+            m_Dirty |= l_changed;
+            err = l_err;
+        }
+    }
 
-    if (err != ESP_OK) 
+    Subscriber l_subscribers[CFMGR_MAX_SUBSCRIBERS];
+    int        l_cnt = m_SubscriberCnt;
+
+    memcpy(l_subscribers, m_Subscribers, sizeof(Subscriber) * l_cnt);
+
+    xSemaphoreGive(m_Mutex);
+
+    for (int i = 0; i < l_cnt; ++i)
     {
-        ESP_LOGE(TAG, "Error reading key '%s': %s",f_key,esp_err_to_name(err)); 
-        return string();
+        if (l_changed & l_subscribers[i].m_Keys) l_subscribers[i].m_Cb(l_subscribers[i].m_Ctx, l_changed & l_subscribers[i].m_Keys);
     }
 
-    // --- allocate the buffer and read the string
+    return err;
+}
 
-    char *buffer = (char *)malloc(required_size);
-    nvs_get_str(m_nvs_handle, f_key, buffer, &required_size);
+// --- called with the lock held, which it releases
 
-    // --- copy to c++ string
-    
-    string f_s(buffer);
+esp_err_t ConfigManager::Changed(cfmgr_key_t f_key)
+{
+    m_Dirty |= CFMGR_KEY_BIT(f_key);
 
-    // --- free temp buffer again
+    bool l_commit = m_UpdateDepth == 0;
 
-    free(buffer);
+    xSemaphoreGive(m_Mutex);
 
-    return f_s;    
+    return l_commit ? Commit() : ESP_OK;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-esp_err_t ConfigManager::SetIntValue(const char *f_key,int f_value)
+esp_err_t ConfigManager::SetStringValue(cfmgr_key_t f_key,const char *f_value)
 {
-    assert(m_nvs_handle);
+    assert(m_Mutex);
 
-    esp_err_t err = nvs_set_i32(m_nvs_handle,f_key,(int32_t)f_value);
-    if (err != ESP_OK) 
+    if (f_key < 0 || f_key >= CFMGR_KEY_CNT || g_ConfigSchema[f_key].m_Type != CFMGR_TYPE_STRING) return ESP_ERR_INVALID_ARG;
+
+    if (strlen(f_value) > g_ConfigSchema[f_key].m_MaxLen)
     {
-        ESP_LOGE(TAG, "Error writing key '%s' to '%d': %s",f_key,f_value,esp_err_to_name(err)); 
-        return err;
+        ESP_LOGE(TAG, "Value of key '%s' longer than %d characters",g_ConfigSchema[f_key].m_Name,g_ConfigSchema[f_key].m_MaxLen); 
+        return ESP_ERR_INVALID_SIZE;
     }
 
-    err = nvs_commit(m_nvs_handle);
-    if (err != ESP_OK) 
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    if (strcmp(m_Strings[f_key], f_value) == 0)
     {
-        ESP_LOGE(TAG, "Error to commit after writing key '%s' to '%d': %s",f_key,f_value,esp_err_to_name(err)); 
-        return err;
+        xSemaphoreGive(m_Mutex);
+        return ESP_OK;
     }
 
-    return ESP_OK;
+    strcpy(m_Strings[f_key], f_value);
+
+    return Changed(f_key);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-int ConfigManager::GetIntValue(const char *f_key)
-{
-   assert(m_nvs_handle);
+size_t ConfigManager::GetStringValue(cfmgr_key_t f_key,char *f_buf,size_t f_size)
+{    
+    assert(m_Mutex);
 
-    // --- get the size first
+    if (f_key < 0 || f_key >= CFMGR_KEY_CNT || g_ConfigSchema[f_key].m_Type != CFMGR_TYPE_STRING)
+    {
+        if (f_size) f_buf[0] = '\0';
+        return 0;
+    }
 
-    int32_t f_i;
-    esp_err_t err = nvs_get_i32(m_nvs_handle, f_key,&f_i);
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+    size_t l_len = f_size ? strlcpy(f_buf, m_Strings[f_key], f_size) : strlen(m_Strings[f_key]);
+    xSemaphoreGive(m_Mutex);
 
-    // --- check for "empty" string
+    return l_len;    
+}
 
-    if (err == ESP_ERR_NVS_NOT_FOUND)
-    {
-        ESP_LOGI(TAG, "ConfigManager::GetIntValue: key not found '%s'",f_key); 
-        
-        // ---- return zero as default
+////////////////////////////////////////////////////////////////////////////////////////
 
-        return 0;
+esp_err_t ConfigManager::SetIntValue(cfmgr_key_t f_key,int f_value)
+{
+    assert(m_Mutex);
+
+    if (f_key < 0 || f_key >= CFMGR_KEY_CNT || g_ConfigSchema[f_key].m_Type != CFMGR_TYPE_INT) return ESP_ERR_INVALID_ARG;
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    if (m_Ints[f_key] == f_value)
+    {
+        xSemaphoreGive(m_Mutex);
+        return ESP_OK;
     }
 
-    // --- every other error: fail
+    m_Ints[f_key] = f_value;
 
-    if (err != ESP_OK) 
+    return Changed(f_key);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- a single aligned word, no lock needed
+
+int ConfigManager::GetIntValue(cfmgr_key_t f_key)
+{
+    assert(m_Mutex);
+
+    if (f_key < 0 || f_key >= CFMGR_KEY_CNT || g_ConfigSchema[f_key].m_Type != CFMGR_TYPE_INT) return 0;
+
+    return (int)m_Ints[f_key];        
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int ConfigManager::FindKey(const char *f_name)
+{
+    for (int k = 0; k < CFMGR_KEY_CNT; ++k)
     {
-        ESP_LOGE(TAG, "Error reading key '%s': %s",f_key,esp_err_to_name(err)); 
-        return 0;
+        if (strcmp(g_ConfigSchema[k].m_Name, f_name) == 0) return k;
     }
 
-    return (int)f_i;        
+    return -1;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -37,11 +37,30 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-#include "vindriktning.h"
+#include <stdint.h>
 #include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "nvs.h"
+
+#include "config_manager_defines.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#define CFMGR_MAX_SUBSCRIBERS       4
+
+// --- called after changes were committed, on the task which committed them. f_changed
+//     has CFMGR_KEY_BIT(key) set for every changed key the subscriber asked for.
+
+typedef void (*cfmgr_change_cb_t)(void *f_ctx, uint32_t f_changed);
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
+// --- all values of the schema (config_manager_defines.h) are read from NVS once and then
+//     served from RAM. Setting a value changes it in RAM right away; it is written to NVS
+//     with the next commit, which is immediate unless an update is in progress. Setting a
+//     value to what it is already does nothing.
+
 class ConfigManager
 {
 public:
@@ -56,24 +75,54 @@ public:
     esp_err_t InitConfigManager(void);
     void ShutdownConfigManager(void);
 
-    // --- getters / setters
+    // --- updates: changes until the matching EndUpdate() are written with one nvs_commit()
+    //     and reported once. Updates nest, changes of other tasks meanwhile are part of it.
 
-    esp_err_t SetStringValue(const char *f_key,const char *f_value);
+    void BeginUpdate(void);
+    esp_err_t EndUpdate(void);
 
-    esp_err_t SetStringValue(const char *f_key,const std::string &f_value)
-    {
-        return SetStringValue(f_key,f_value.c_str());
-    }
-    
-    std::string GetStringValue(const char *f_key);
+    esp_err_t Subscribe(uint32_t f_keys, cfmgr_change_cb_t f_cb, void *f_ctx);
+
+    // --- getters / setters. GetStringValue() copies the value like strlcpy() and returns
+    //     its length, f_buf may be NULL with f_size 0.
 
-    esp_err_t SetIntValue(const char *f_key,int f_value);
-    int GetIntValue(const char *f_key);
+    esp_err_t SetStringValue(cfmgr_key_t f_key,const char *f_value);
+    size_t GetStringValue(cfmgr_key_t f_key,char *f_buf,size_t f_size);
+
+    esp_err_t SetIntValue(cfmgr_key_t f_key,int f_value);
+    int GetIntValue(cfmgr_key_t f_key);
+
+    // --- the schema
+
+    static const char *GetKeyName(cfmgr_key_t f_key) { return g_ConfigSchema[f_key].m_Name; }
+    static int FindKey(const char *f_name);     // --- -1 if unknown
     
 private:
 
-    nvs_handle_t m_nvs_handle;
-    
+    struct Subscriber
+    {
+        uint32_t            m_Keys;
+        cfmgr_change_cb_t   m_Cb;
+        void                *m_Ctx;
+    };
+
+    void LoadValues(void);
+    esp_err_t LoadTruncated(const ConfigKeyDef &f_def, char *f_value);
+    esp_err_t Commit(void);
+    esp_err_t Changed(cfmgr_key_t f_key);
+
+    nvs_handle_t        m_nvs_handle;
+    SemaphoreHandle_t   m_Mutex = NULL;     // --- everything below
+
+    int32_t             m_Ints[CFMGR_KEY_CNT];
+    char                *m_Strings[CFMGR_KEY_CNT];
+    char                m_StringPool[CFMGR_STRING_POOL_SIZE];
+
+    uint32_t            m_Dirty = 0;        // --- changed, not in NVS yet
+    int                 m_UpdateDepth = 0;
+
+    Subscriber          m_Subscribers[CFMGR_MAX_SUBSCRIBERS];
+    int                 m_SubscriberCnt = 0;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////
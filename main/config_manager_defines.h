@@ -37,16 +37,107 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-#define CFMGR_BOOTSTRAP_DONE    "Bootstrap_Done"
-#define CFMGR_WIFI_SSID         "Wifi_SSID"
-#define CFMGR_WIFI_PASSWORD     "Wifi_Password"
-#define CFMGR_DEVICE_NAME       "Device_Name"
-#define CFMGR_MQTT_SERVER       "mqtt_server"
-#define CFMGR_MQTT_TOPIC        "mqtt_topic"
-#define CFMGR_MQTT_TIME         "mqtt_time"
-#define CFMGR_MQTT_ENABLE       "mqtt_enable"
+#include <stdint.h>
+#include <stddef.h>
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-#endif
+// --- the config schema. Every key has an id (CFMGR_...), its NVS key, which is also its
+//     name in the REST API, the type, the longest string value and flags:
+//
+//       CFMGR_FLAG_NO_POST         not taken from a config POST
+//       CFMGR_FLAG_KEEP_IF_EMPTY   an empty string in a POST keeps the current value
+
+#define CFMGR_FLAG_NO_POST          (1 << 0)
+#define CFMGR_FLAG_KEEP_IF_EMPTY    (1 << 1)
+
+#define CFMGR_KEYS(X)                                                                             \
+    X(CFMGR_BOOTSTRAP_DONE,     "Bootstrap_Done",   CFMGR_TYPE_INT,       0,  CFMGR_FLAG_NO_POST)       \
+    X(CFMGR_WIFI_SSID,          "Wifi_SSID",        CFMGR_TYPE_STRING,   32,  0)                        \
+    X(CFMGR_WIFI_PASSWORD,      "Wifi_Password",    CFMGR_TYPE_STRING,   64,  CFMGR_FLAG_KEEP_IF_EMPTY) \
+    X(CFMGR_DEVICE_NAME,        "Device_Name",      CFMGR_TYPE_STRING,   32,  0)                        \
+    X(CFMGR_MQTT_SERVER,        "mqtt_server",      CFMGR_TYPE_STRING,  128,  0)                        \
+    X(CFMGR_MQTT_TOPIC,         "mqtt_topic",       CFMGR_TYPE_STRING,  128,  0)                        \
+    X(CFMGR_MQTT_TIME,          "mqtt_time",        CFMGR_TYPE_INT,       0,  0)                        \
+    X(CFMGR_MQTT_ENABLE,        "mqtt_enable",      CFMGR_TYPE_INT,       0,  0)                        \
+    X(CFMGR_MQTT_COMBINED,      "mqtt_combined",    CFMGR_TYPE_INT,       0,  0)                        \
+    X(CFMGR_MQTT_FORMAT,        "mqtt_format",      CFMGR_TYPE_INT,       0,  0)                        \
+    X(CFMGR_OTA_URL,            "ota_url",          CFMGR_TYPE_STRING,  255,  0)                        \
+    X(CFMGR_OTA_INTERVAL,       "ota_interval",     CFMGR_TYPE_INT,       0,  0)
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef enum
+{
+    CFMGR_TYPE_INT = 0,
+    CFMGR_TYPE_STRING
+} cfmgr_type_t;
+
+#define CFMGR_KEY_ENUM(id, name, type, maxlen, flags)       id,
+
+typedef enum
+{
+    CFMGR_KEYS(CFMGR_KEY_ENUM)
+    CFMGR_KEY_CNT
+} cfmgr_key_t;
+
+#undef CFMGR_KEY_ENUM
+
+typedef struct ConfigKeyDef_s
+{
+    const char      *m_Name;
+    cfmgr_type_t    m_Type;
+    uint16_t        m_MaxLen;           // --- strings without the terminator
+    uint8_t         m_Flags;
+} ConfigKeyDef;
+
+#define CFMGR_KEY_DEF(id, name, type, maxlen, flags)        { name, type, maxlen, flags },
+
+static constexpr ConfigKeyDef g_ConfigSchema[CFMGR_KEY_CNT] =
+{
+    CFMGR_KEYS(CFMGR_KEY_DEF)
+};
+
+#undef CFMGR_KEY_DEF
+
+// --- for subscribers, see ConfigManager::Subscribe()
 
+#define CFMGR_KEY_BIT(key)          (1u << (key))
+#define CFMGR_ALL_KEYS              (CFMGR_KEY_BIT(CFMGR_KEY_CNT) - 1)
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- checked when compiling: NVS keys have 15 characters at most, strings fit into
+//     CFMGR_MAX_STRING_LEN and the change masks have a bit per key
+
+#define CFMGR_MAX_STRING_LEN        255
+
+static constexpr size_t cfmgr_name_len(const char *f_s)
+{
+    return *f_s ? 1 + cfmgr_name_len(f_s + 1) : 0;
+}
+
+static constexpr bool cfmgr_schema_valid(int f_key = 0)
+{
+    return f_key == CFMGR_KEY_CNT ||
+           (cfmgr_name_len(g_ConfigSchema[f_key].m_Name) <= 15 &&
+            g_ConfigSchema[f_key].m_MaxLen <= CFMGR_MAX_STRING_LEN &&
+            cfmgr_schema_valid(f_key + 1));
+}
+
+// --- all string values live in one buffer of this size
+
+static constexpr size_t cfmgr_string_pool_size(int f_key = 0)
+{
+    return f_key == CFMGR_KEY_CNT ? 0 :
+           (g_ConfigSchema[f_key].m_Type == CFMGR_TYPE_STRING ? g_ConfigSchema[f_key].m_MaxLen + 1 : 0) + cfmgr_string_pool_size(f_key + 1);
+}
+
+static_assert(CFMGR_KEY_CNT < 32, "too many config keys for the change masks");
+static_assert(cfmgr_schema_valid(), "config key names are limited to 15 characters, strings to CFMGR_MAX_STRING_LEN");
+
+#define CFMGR_STRING_POOL_SIZE      cfmgr_string_pool_size()
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
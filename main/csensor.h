@@ -37,9 +37,12 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
+#include <stdio.h>
 #include <string>
 #include "sdkconfig.h"
-#include "cJSON.h"
+#include "driver/gpio.h"
+#include "json_writer.h"
+#include "cbor_writer.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -47,6 +50,11 @@
 
 #define CSENSOR_MAX_TEMP_LEN 20
 
+// --- default acquisition timing, used when a sensor does not declare its own
+
+#define CSENSOR_DEFAULT_PERIOD_MS       5000
+#define CSENSOR_DEFAULT_DEADLINE_MS     1000
+
 class CSensor
 {
 public:
@@ -55,27 +63,57 @@ public:
 
  	virtual bool PerformMeasurement(void) = 0;
  	virtual bool SetupSensor(gpio_num_t *f_pins,int *f_data) = 0;
-    virtual void AddValuesToJSON_MQTT(cJSON *f_root) = 0;
-    virtual void AddValuesToJSON_API(cJSON *f_root) = 0;
+    virtual void AddValuesToJSON_MQTT(JsonWriter &f_writer) = 0;
+    virtual void AddValuesToJSON_API(JsonWriter &f_writer) = 0;
 
-protected:
-    // --- some helper
+    // --- generic access to the measured values (e.g. for the sample store). The channel
+    //     names are the keys of the MQTT JSON.
+
+    virtual int GetChannelCount(void) = 0;
+    virtual const char *GetChannelName(int f_ch) = 0;
+    virtual float GetChannelValue(int f_ch) = 0;
 
-    const char *float_2_string(const char *f_format,const float f_value)
+    // --- binary MQTT payload: one map entry per channel (GetChannelCount()
+    //     entries), the keys are those of the MQTT JSON
+
+    void AddValuesToCBOR_MQTT(CborWriter &f_writer)
     {
-        snprintf(m_temp_str,10,f_format,f_value);
-        return m_temp_str;
+        for (int l_ch = 0; l_ch < GetChannelCount(); ++l_ch)
+        {
+            f_writer.Number(GetChannelName(l_ch), GetChannelValue(l_ch));
+        }
     }
 
-    const char *uint_2_string(const char *f_format,const uint f_value)
+    // --- acquisition timing: the sensor manager calls PerformMeasurement() every period.
+    //     A measurement finishing later than the deadline (relative to its due time) is
+    //     counted as a missed deadline.
+
+    virtual uint32_t GetMeasurementPeriodMs(void) { return CSENSOR_DEFAULT_PERIOD_MS; }
+    virtual uint32_t GetMeasurementDeadlineMs(void) { return CSENSOR_DEFAULT_DEADLINE_MS; }
+
+    // --- diagnostic counters of the sensor's interface for /api/v1/sensorstats, they
+    //     do not belong to the values
+
+    virtual void AddStatsToJSON(JsonWriter &f_writer) { }
+
+protected:
+    // --- one value of the REST API: { "unit": ..., "value": ..., "text": ... }. The value
+    //     is formatted on the stack, the REST handlers and the event stream run this
+    //     concurrently for the same sensor.
+
+    template <typename T>
+    void AddApiValue(JsonWriter &f_writer, const char *f_key, const char *f_unit, const char *f_format, const T f_value, const char *f_text)
     {
-        snprintf(m_temp_str,10,f_format,f_value);
-        return m_temp_str;
-    }
+        char l_value[CSENSOR_MAX_TEMP_LEN];
 
-private:
+        snprintf(l_value, sizeof(l_value), f_format, f_value);
 
-    char m_temp_str[CSENSOR_MAX_TEMP_LEN];
+        f_writer.BeginObject(f_key);
+        f_writer.String("unit", f_unit);
+        f_writer.String("value", l_value);
+        f_writer.String("text", f_text);
+        f_writer.EndObject();
+    }
 };
 
 #endif
\ No newline at end of file
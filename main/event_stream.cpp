@@ -0,0 +1,304 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_http_server.h"
+
+#include "event_stream.h"
+#include "json_writer.h"
+#include "sensor_manager.h"
+#include "applogger.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *TAG = "EventStream";
+
+// --- notification bits of the stream task, the low bits are the sensors
+
+#define EVENT_STREAM_BIT_CLIENT     (1u << 30)
+#define EVENT_STREAM_BIT_LOG        (1u << 31)
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+EventStream g_EventStream;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static void event_stream_task(void *f_param)
+{
+    ((EventStream *)f_param)->StreamLoop();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t EventStream::InitStream(void)
+{
+    ESP_LOGI(TAG, "EventStream::InitStream()");
+
+    memset(m_Clients, 0, sizeof(m_Clients));
+    memset(m_NeedSnapshot, 0, sizeof(m_NeedSnapshot));
+
+    // --- clients fetch the existing lines with /api/v1/log, only newer ones are streamed
+
+    m_LastLogId = g_AppLogger.GetLastId();
+
+    m_Mutex = xSemaphoreCreateMutex();
+    if (!m_Mutex || xTaskCreate(event_stream_task, "sse", EVENT_STREAM_TASK_STACK, this, EVENT_STREAM_TASK_PRIO, &m_Task) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Could not create the stream task");
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- runs on the httpd task, which is the only one adding clients. Returns
+//     ESP_ERR_NO_MEM when all slots are taken, nothing has been sent then.
+
+esp_err_t EventStream::AddClient(httpd_req_t *f_req)
+{
+    if (!m_Mutex) return ESP_ERR_INVALID_STATE;
+
+    int l_slot = -1;
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+    for (int i = 0; i < EVENT_STREAM_MAX_CLIENTS && l_slot < 0; ++i)
+    {
+        if (!m_Clients[i]) l_slot = i;
+    }
+    xSemaphoreGive(m_Mutex);
+
+    if (l_slot < 0) return ESP_ERR_NO_MEM;
+
+    // --- the headers go out with the first chunk, before the request changes hands
+
+    httpd_resp_set_type(f_req, "text/event-stream");
+    httpd_resp_set_hdr(f_req, "Cache-Control", "no-cache");
+
+    char l_retry[32];
+    snprintf(l_retry, sizeof(l_retry), "retry: %d\n\n", EVENT_STREAM_RETRY_MS);
+
+    esp_err_t l_err = httpd_resp_send_chunk(f_req, l_retry, strlen(l_retry));
+    if (l_err != ESP_OK) return l_err;
+
+    httpd_req_t *l_async;
+
+    l_err = httpd_req_async_handler_begin(f_req, &l_async);
+    if (l_err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "EventStream::AddClient / httpd_req_async_handler_begin failed (%d)", l_err);
+        return l_err;
+    }
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+    m_Clients[l_slot]       = l_async;
+    m_NeedSnapshot[l_slot]  = true;
+    xSemaphoreGive(m_Mutex);
+
+    ESP_LOGI(TAG, "Client %d connected", l_slot);
+
+    xTaskNotify(m_Task, EVENT_STREAM_BIT_CLIENT, eSetBits);
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void EventStream::NotifySample(int f_sensor)
+{
+    if (m_Task && f_sensor >= 0 && f_sensor < SENSOR_CONFIG_SENSOR_CNT) xTaskNotify(m_Task, 1u << f_sensor, eSetBits);
+}
+
+void EventStream::NotifyLog(void)
+{
+    if (m_Task) xTaskNotify(m_Task, EVENT_STREAM_BIT_LOG, eSetBits);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void EventStream::StreamLoop(void)
+{
+    while (1)
+    {
+        uint32_t l_bits = 0;
+
+        if (xTaskNotifyWait(0, UINT32_MAX, &l_bits, pdMS_TO_TICKS(EVENT_STREAM_KEEPALIVE_MS)) != pdTRUE)
+        {
+            // --- a comment line: the only way to notice clients which are gone while
+            //     nothing happens
+
+            SendToClients(": keepalive\n\n", 13, -1);
+            continue;
+        }
+
+        if (l_bits & EVENT_STREAM_BIT_CLIENT)
+        {
+            for (int c = 0; c < EVENT_STREAM_MAX_CLIENTS; ++c)
+            {
+                xSemaphoreTake(m_Mutex, portMAX_DELAY);
+                bool l_snapshot = m_NeedSnapshot[c];
+                m_NeedSnapshot[c] = false;
+                xSemaphoreGive(m_Mutex);
+
+                if (!l_snapshot) continue;
+
+                for (int s = 0; s < g_SensorManager.GetSensorCount(); ++s) SendSample(s, c);
+            }
+        }
+
+        for (int s = 0; s < g_SensorManager.GetSensorCount(); ++s)
+        {
+            if (l_bits & (1u << s)) SendSample(s, -1);
+        }
+
+        if (l_bits & EVENT_STREAM_BIT_LOG) SendNewLogLines();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- f_only_client: -1 for all clients
+
+void EventStream::SendSample(int f_sensor, int f_only_client)
+{
+    int l_len = snprintf(m_Event, sizeof(m_Event), "event: sample\ndata: ");
+
+    // --- two bytes are kept for the terminating empty line
+
+    JsonWriter l_writer(m_Event + l_len, sizeof(m_Event) - l_len - 2);
+
+    l_writer.BeginObject();
+    l_writer.Int("sensor", f_sensor + 1);
+    l_writer.BeginObject("data");
+    g_SensorManager.GetSensor(f_sensor)->AddValuesToJSON_API(l_writer);
+    l_writer.EndObject();
+    l_writer.EndObject();
+
+    if (l_writer.Finish() != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Sample event of sensor %d too large", f_sensor + 1);
+        return;
+    }
+
+    l_len += l_writer.GetLength();
+    m_Event[l_len++] = '\n';
+    m_Event[l_len++] = '\n';
+
+    SendToClients(m_Event, l_len, f_only_client);
+}
+
+void EventStream::SendNewLogLines(void)
+{
+    // --- continue after the last line sent. Lines which are not in the ring anymore are
+    //     skipped, at a line still being written the next notification continues.
+
+    uint32_t l_id   = m_LastLogId + 1;
+    uint32_t l_last = g_AppLogger.GetLastId();
+    char     l_text[APPLOGGER_MAX_LINE_LEN];
+
+    if (l_id < g_AppLogger.GetFirstId()) l_id = g_AppLogger.GetFirstId();
+
+    for (; l_id <= l_last; ++l_id)
+    {
+        if (!g_AppLogger.GetLine(l_id, l_text))
+        {
+            if (l_id >= g_AppLogger.GetFirstId()) break;
+            continue;
+        }
+
+        int l_len = snprintf(m_Event, sizeof(m_Event), "event: log\ndata: ");
+
+        JsonWriter l_writer(m_Event + l_len, sizeof(m_Event) - l_len - 2);
+
+        l_writer.BeginObject();
+        l_writer.Int("id", l_id);
+        l_writer.String("text", l_text);
+        l_writer.EndObject();
+
+        if (l_writer.Finish() != ESP_OK) continue;
+
+        l_len += l_writer.GetLength();
+        m_Event[l_len++] = '\n';
+        m_Event[l_len++] = '\n';
+
+        SendToClients(m_Event, l_len, -1);
+    }
+
+    m_LastLogId = l_id - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the sends may block up to the socket timeout, so they are done without the lock
+
+void EventStream::SendToClients(const char *f_data, size_t f_len, int f_only_client)
+{
+    httpd_req_t *l_clients[EVENT_STREAM_MAX_CLIENTS];
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+    memcpy(l_clients, m_Clients, sizeof(l_clients));
+    xSemaphoreGive(m_Mutex);
+
+    for (int c = 0; c < EVENT_STREAM_MAX_CLIENTS; ++c)
+    {
+        if (!l_clients[c] || (f_only_client >= 0 && c != f_only_client)) continue;
+
+        if (httpd_resp_send_chunk(l_clients[c], f_data, f_len) != ESP_OK) RemoveClient(c);
+    }
+}
+
+void EventStream::RemoveClient(int f_client)
+{
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    httpd_req_t *l_req = m_Clients[f_client];
+    m_Clients[f_client] = NULL;
+    m_NeedSnapshot[f_client] = false;
+
+    xSemaphoreGive(m_Mutex);
+
+    if (l_req) httpd_req_async_handler_complete(l_req);
+
+    ESP_LOGI(TAG, "Client %d disconnected", f_client);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,113 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef EVENT_STREAM_H_
+#define	EVENT_STREAM_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#include "sensor_config.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- Server-Sent Events (/api/v1/stream). The handler hands the request over with
+//     httpd_req_async_handler_begin(), so the httpd task is free again. The stream task
+//     sends every new sample and AppLogger line to all clients:
+//
+//       event: sample        data: {"sensor": n, "data": <same as /api/v1/air/n>}
+//       event: log           data: {"id": n, "text": "..."}
+//
+//     A new client first gets the current values of all sensors. Every client uses one
+//     of the httpd sockets as long as it is connected.
+
+#define EVENT_STREAM_MAX_CLIENTS        3
+#define EVENT_STREAM_TASK_STACK         4096
+#define EVENT_STREAM_TASK_PRIO          3
+#define EVENT_STREAM_KEEPALIVE_MS       15000       // --- detects clients which are gone
+#define EVENT_STREAM_RETRY_MS           3000        // --- reconnect delay for the browser
+#define EVENT_STREAM_EVENT_SIZE         1024
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class EventStream
+{
+public:
+
+    // --- action functions
+
+    esp_err_t InitStream(void);
+    esp_err_t AddClient(httpd_req_t *f_req);
+
+    // --- producers, cheap and callable from any task
+
+    void NotifySample(int f_sensor);
+    void NotifyLog(void);
+
+    // --- internal functions do not use
+
+    void StreamLoop(void);
+
+private:
+
+    void SendSample(int f_sensor, int f_only_client);
+    void SendNewLogLines(void);
+    void SendToClients(const char *f_data, size_t f_len, int f_only_client);
+    void RemoveClient(int f_client);
+
+    httpd_req_t         *m_Clients[EVENT_STREAM_MAX_CLIENTS];
+    bool                m_NeedSnapshot[EVENT_STREAM_MAX_CLIENTS];
+    uint32_t            m_LastLogId;
+
+    char                m_Event[EVENT_STREAM_EVENT_SIZE];   // --- only used by the stream task
+
+    TaskHandle_t        m_Task = NULL;
+    SemaphoreHandle_t   m_Mutex = NULL;                     // --- m_Clients, m_NeedSnapshot
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+extern EventStream g_EventStream;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -0,0 +1,360 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FRAME_DECODER_H_
+#define	FRAME_DECODER_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- framed serial protocols of UART sensors: header bytes, a length field or a fixed
+//     length, a checksum and an optional trailer byte. A protocol is a struct of
+//     constants (see the ones below), FrameDecoder<protocol> cuts frames out of the
+//     received bytes.
+
+typedef enum
+{
+    FRAME_CHECKSUM_SUM8_ZERO = 0,       // --- all bytes from CHECKSUM_FROM incl. the checksum add up to 0
+    FRAME_CHECKSUM_SUM8,                // --- checksum byte = sum of the bytes from CHECKSUM_FROM
+    FRAME_CHECKSUM_SUM16_BE,            // --- 16 bit sum of the bytes from CHECKSUM_FROM, big endian
+    FRAME_CHECKSUM_CRC16_MODBUS         // --- CRC-16/MODBUS of the bytes from CHECKSUM_FROM, little endian
+} frame_checksum_t;
+
+// --- called with every valid frame, header included
+
+typedef void (*frame_cb_t)(void *f_ctx, const uint8_t *f_frame, size_t f_len);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- Cubic PM1006 (IKEA Vindriktning): 16 <n> <n data> <cs>
+
+struct FrameProtocolPm1006
+{
+    static constexpr uint8_t            HEADER[]        = { 0x16 };
+    static constexpr size_t             MAX_LEN         = 32;
+    static constexpr size_t             FIXED_LEN       = 0;        // --- 0: from the length field
+    static constexpr size_t             LEN_OFFSET      = 1;
+    static constexpr size_t             LEN_SIZE        = 1;        // --- big endian
+    static constexpr size_t             LEN_ADJUST      = 3;        // --- frame length = field + LEN_ADJUST
+    static constexpr frame_checksum_t   CHECKSUM        = FRAME_CHECKSUM_SUM8_ZERO;
+    static constexpr size_t             CHECKSUM_FROM   = 0;
+    static constexpr int                TRAILER         = -1;       // --- -1: none
+};
+
+// --- Plantower PMS5003: 42 4d <n:16> <n - 2 data> <cs:16>
+
+struct FrameProtocolPms5003
+{
+    static constexpr uint8_t            HEADER[]        = { 0x42, 0x4d };
+    static constexpr size_t             MAX_LEN         = 40;
+    static constexpr size_t             FIXED_LEN       = 0;
+    static constexpr size_t             LEN_OFFSET      = 2;
+    static constexpr size_t             LEN_SIZE        = 2;
+    static constexpr size_t             LEN_ADJUST      = 4;
+    static constexpr frame_checksum_t   CHECKSUM        = FRAME_CHECKSUM_SUM16_BE;
+    static constexpr size_t             CHECKSUM_FROM   = 0;
+    static constexpr int                TRAILER         = -1;
+};
+
+// --- Nova SDS011: aa c0 <6 data> <cs> ab
+
+struct FrameProtocolSds011
+{
+    static constexpr uint8_t            HEADER[]        = { 0xaa, 0xc0 };
+    static constexpr size_t             MAX_LEN         = 10;
+    static constexpr size_t             FIXED_LEN       = 10;
+    static constexpr size_t             LEN_OFFSET      = 0;
+    static constexpr size_t             LEN_SIZE        = 0;
+    static constexpr size_t             LEN_ADJUST      = 0;
+    static constexpr frame_checksum_t   CHECKSUM        = FRAME_CHECKSUM_SUM8;
+    static constexpr size_t             CHECKSUM_FROM   = 2;
+    static constexpr int                TRAILER         = 0xab;
+};
+
+// --- Winsen MH-Z19 (answer to 0x86): ff 86 <6 data> <cs>
+
+struct FrameProtocolMhz19
+{
+    static constexpr uint8_t            HEADER[]        = { 0xff, 0x86 };
+    static constexpr size_t             MAX_LEN         = 9;
+    static constexpr size_t             FIXED_LEN       = 9;
+    static constexpr size_t             LEN_OFFSET      = 0;
+    static constexpr size_t             LEN_SIZE        = 0;
+    static constexpr size_t             LEN_ADJUST      = 0;
+    static constexpr frame_checksum_t   CHECKSUM        = FRAME_CHECKSUM_SUM8_ZERO;
+    static constexpr size_t             CHECKSUM_FROM   = 1;
+    static constexpr int                TRAILER         = -1;
+};
+
+// --- SenseAir S8 (Modbus answer to "read input registers"): fe 04 <n> <n data> <crc:16>
+
+struct FrameProtocolSenseairS8
+{
+    static constexpr uint8_t            HEADER[]        = { 0xfe, 0x04 };
+    static constexpr size_t             MAX_LEN         = 32;
+    static constexpr size_t             FIXED_LEN       = 0;
+    static constexpr size_t             LEN_OFFSET      = 2;
+    static constexpr size_t             LEN_SIZE        = 1;
+    static constexpr size_t             LEN_ADJUST      = 5;
+    static constexpr frame_checksum_t   CHECKSUM        = FRAME_CHECKSUM_CRC16_MODBUS;
+    static constexpr size_t             CHECKSUM_FROM   = 0;
+    static constexpr int                TRAILER         = -1;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- Feed() takes whatever the UART delivered. Between frames the next header is found
+//     with memchr(), the bytes of a frame are copied in one piece as far as they are
+//     there. After a bad frame the search restarts one byte after its header, so a
+//     header in the garbage does not hide the next frame.
+
+template <class P>
+class FrameDecoder
+{
+public:
+
+    static constexpr size_t HEADER_LEN      = sizeof(P::HEADER);
+    static constexpr size_t CHECKSUM_LEN    = P::CHECKSUM == FRAME_CHECKSUM_SUM8_ZERO || P::CHECKSUM == FRAME_CHECKSUM_SUM8 ? 1 : 2;
+    static constexpr size_t TRAILER_LEN     = P::TRAILER >= 0 ? 1 : 0;
+    static constexpr size_t PREFIX_LEN      = P::FIXED_LEN ? HEADER_LEN : P::LEN_OFFSET + P::LEN_SIZE;
+    static constexpr size_t MIN_LEN         = P::FIXED_LEN ? P::FIXED_LEN : PREFIX_LEN + CHECKSUM_LEN + TRAILER_LEN;
+
+    static_assert(HEADER_LEN > 0, "a frame needs a header");
+    static_assert(P::FIXED_LEN || (P::LEN_OFFSET >= HEADER_LEN && P::LEN_SIZE >= 1 && P::LEN_SIZE <= 2), "bad length field");
+    static_assert(P::MAX_LEN >= MIN_LEN && (!P::FIXED_LEN || P::FIXED_LEN == P::MAX_LEN), "bad frame length");
+    static_assert(P::CHECKSUM_FROM <= MIN_LEN - CHECKSUM_LEN - TRAILER_LEN, "checksum starts behind the shortest frame");
+
+    FrameDecoder(void)
+    {
+        m_Len               = 0;
+        m_Frames            = 0;
+        m_ChecksumErrors    = 0;
+        m_LengthErrors      = 0;
+        m_SkippedBytes      = 0;
+    }
+
+    // --- action functions
+
+    // --- returns the number of valid frames passed to f_cb
+
+    int Feed(const uint8_t *f_data, size_t f_len, frame_cb_t f_cb, void *f_ctx)
+    {
+        int l_frames = 0;
+
+        while (f_len > 0)
+        {
+            if (m_Len == 0)
+            {
+                const uint8_t *l_start = (const uint8_t *)memchr(f_data, P::HEADER[0], f_len);
+
+                if (!l_start)
+                {
+                    m_SkippedBytes += f_len;
+                    break;
+                }
+
+                m_SkippedBytes += l_start - f_data;
+                f_len          -= l_start - f_data;
+                f_data          = l_start;
+            }
+
+            size_t l_copy = Needed() - m_Len;
+            if (l_copy > f_len) l_copy = f_len;
+
+            memcpy(m_Frame + m_Len, f_data, l_copy);
+
+            m_Len  += l_copy;
+            f_data += l_copy;
+            f_len  -= l_copy;
+
+            l_frames += Check(f_cb, f_ctx);
+        }
+
+        return l_frames;
+    }
+
+    // --- drops a partial frame, e.g. after an overrun
+
+    void Reset(void)
+    {
+        m_Len = 0;
+    }
+
+    // --- getters
+
+    uint32_t GetFrameCount(void) const { return m_Frames; }
+    uint32_t GetChecksumErrorCount(void) const { return m_ChecksumErrors; }
+    uint32_t GetLengthErrorCount(void) const { return m_LengthErrors; }
+    uint32_t GetSkippedByteCount(void) const { return m_SkippedBytes; }
+
+private:
+
+    // --- the length of the frame as far as it is known
+
+    size_t Needed(void) const
+    {
+        if (P::FIXED_LEN) return P::FIXED_LEN;
+        if (m_Len < PREFIX_LEN) return PREFIX_LEN;
+
+        size_t l_len = FrameLen();
+
+        return l_len ? l_len : PREFIX_LEN;
+    }
+
+    // --- 0 if the length field is out of range
+
+    size_t FrameLen(void) const
+    {
+        if (P::FIXED_LEN) return P::FIXED_LEN;
+
+        size_t l_len = m_Frame[P::LEN_OFFSET];
+        if (P::LEN_SIZE == 2) l_len = (l_len << 8) | m_Frame[P::LEN_OFFSET + 1];
+
+        l_len += P::LEN_ADJUST;
+
+        return l_len >= MIN_LEN && l_len <= P::MAX_LEN ? l_len : 0;
+    }
+
+    bool ChecksumValid(size_t f_len) const
+    {
+        const uint8_t *l_cs = m_Frame + f_len - TRAILER_LEN - CHECKSUM_LEN;
+        const uint8_t *l_p  = m_Frame + P::CHECKSUM_FROM;
+
+        if (P::CHECKSUM == FRAME_CHECKSUM_SUM8_ZERO || P::CHECKSUM == FRAME_CHECKSUM_SUM8)
+        {
+            uint8_t l_sum = 0;
+            for (; l_p < l_cs; ++l_p) l_sum += *l_p;
+
+            return P::CHECKSUM == FRAME_CHECKSUM_SUM8 ? l_sum == l_cs[0] : (uint8_t)(l_sum + l_cs[0]) == 0;
+        }
+
+        if (P::CHECKSUM == FRAME_CHECKSUM_SUM16_BE)
+        {
+            uint16_t l_sum = 0;
+            for (; l_p < l_cs; ++l_p) l_sum += *l_p;
+
+            return l_sum == ((l_cs[0] << 8) | l_cs[1]);
+        }
+
+        uint16_t l_crc = 0xffff;
+
+        for (; l_p < l_cs; ++l_p)
+        {
+            l_crc ^= *l_p;
+            for (int b = 0; b < 8; ++b) l_crc = (l_crc & 1) ? (l_crc >> 1) ^ 0xa001 : l_crc >> 1;
+        }
+
+        return l_crc == (l_cs[0] | (l_cs[1] << 8));
+    }
+
+    // --- checks the bytes collected so far. After a resync they may hold more than one
+    //     frame. Returns the number of valid frames.
+
+    int Check(frame_cb_t f_cb, void *f_ctx)
+    {
+        int l_frames = 0;
+
+        while (m_Len > 0)
+        {
+            size_t l_hdr = m_Len < HEADER_LEN ? m_Len : HEADER_LEN;
+
+            if (memcmp(m_Frame, P::HEADER, l_hdr) != 0)
+            {
+                Resync();
+                continue;
+            }
+
+            if (m_Len < PREFIX_LEN) break;
+
+            size_t l_len = FrameLen();
+
+            if (!l_len)
+            {
+                m_LengthErrors++;
+                Resync();
+                continue;
+            }
+
+            if (m_Len < l_len) break;
+
+            if ((P::TRAILER < 0 || m_Frame[l_len - 1] == (uint8_t)P::TRAILER) && ChecksumValid(l_len))
+            {
+                m_Frames++;
+                l_frames++;
+
+                if (f_cb) f_cb(f_ctx, m_Frame, l_len);
+
+                m_Len -= l_len;
+                memmove(m_Frame, m_Frame + l_len, m_Len);
+                continue;
+            }
+
+            m_ChecksumErrors++;
+            Resync();
+        }
+
+        return l_frames;
+    }
+
+    // --- the frame at the start is bad: continue at the next header byte in it
+
+    void Resync(void)
+    {
+        const uint8_t *l_next = m_Len > 1 ? (const uint8_t *)memchr(m_Frame + 1, P::HEADER[0], m_Len - 1) : NULL;
+
+        size_t l_skip = l_next ? (size_t)(l_next - m_Frame) : m_Len;
+
+        m_SkippedBytes += l_skip;
+        m_Len          -= l_skip;
+
+        memmove(m_Frame, m_Frame + l_skip, m_Len);
+    }
+
+    uint8_t     m_Frame[P::MAX_LEN];
+    size_t      m_Len;
+
+    uint32_t    m_Frames;
+    uint32_t    m_ChecksumErrors;
+    uint32_t    m_LengthErrors;
+    uint32_t    m_SkippedBytes;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
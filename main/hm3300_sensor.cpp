@@ -50,11 +50,7 @@
 
 #include "sensor_config.h"
 #include "hm3300_sensor.h"
-
-////////////////////////////////////////////////////////////////////////////////////////
-
-bool CHM3300Sensor::m_i2c_initialized[I2C_NUM_MAX];
-bool CHM3300Sensor::m_i2c_array_initialized = false;
+#include "i2c_bus_manager.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -69,6 +65,7 @@ CHM3300Sensor::CHM3300Sensor(void)
 	m_pin_sda			= (gpio_num_t)0;
 	m_pin_scl			= (gpio_num_t)0;
 	m_i2c_port 			= (i2c_port_t)0;
+	m_i2c_dev			= -1;
 	
 	m_pm1_ae			= 0;
 	m_pm25_ae			= 0;
@@ -77,12 +74,6 @@ CHM3300Sensor::CHM3300Sensor(void)
 	m_pm1_spm			= 0;
 	m_pm25_spm			= 0;
 	m_pm10_spm			= 0;
-
-	if (!m_i2c_array_initialized)
-	{
-		for (int i=0;i<I2C_NUM_MAX;++i) m_i2c_initialized[i] = false;
-		m_i2c_array_initialized = true;
-	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -100,45 +91,18 @@ bool CHM3300Sensor::SetupSensor(gpio_num_t f_sda,gpio_num_t f_scl,i2c_port_t f_i
 
 	assert(m_i2c_port < I2C_NUM_MAX);
 
-	// ---- initialize i2c port
+	// ---- register with the bus, the sensor only does standard mode
 
-	if (!m_i2c_initialized[m_i2c_port])
-	{
-		ESP_LOGI(TAG,"Setup i2c port %d",m_i2c_port);
-
-		i2c_config_t conf;
-
-		conf.mode 				= I2C_MODE_MASTER;
-		conf.sda_io_num 		= m_pin_sda;
-		conf.scl_io_num 		= m_pin_scl;
-		conf.sda_pullup_en 		= GPIO_PULLUP_ENABLE;
-		conf.scl_pullup_en 		= GPIO_PULLUP_ENABLE;
-		conf.master.clk_speed 	= 100000;
-		conf.clk_flags 			= 0;
-
-		i2c_param_config(m_i2c_port, &conf);
-		
-		esp_err_t l_retcode = i2c_driver_install(m_i2c_port,conf.mode, 0, 0, 0);
-		if (l_retcode != ESP_OK)
-		{
-			ESP_LOGE(TAG,"CHM3300Sensor / i2c_driver_install failed with %d", l_retcode);
-			return false;
-		}
-
-		// --- remember that this I2C is up and ready
-
-		m_i2c_initialized[m_i2c_port] = true;
-	}
-	else
+	if (g_I2CBusManager.AddDevice(m_i2c_port, m_pin_sda, m_pin_scl, m_dev_address, I2C_BUS_SPEED_STANDARD, "HM3300", &m_i2c_dev) != ESP_OK)
 	{
-		ESP_LOGI(TAG,"Reuse i2c port %d - new pin settings etc are ignored!",m_i2c_port);
+		return false;
 	}
 
 	// --- switch sensor to I2C mode
 
 	uint8_t reg_addr = 0x88;
 
-	esp_err_t l_retcode = i2c_master_write_to_device(m_i2c_port, m_dev_address, &reg_addr, 1, 1000 / portTICK_PERIOD_MS);
+	esp_err_t l_retcode = g_I2CBusManager.Write(m_i2c_dev, &reg_addr, 1);
 	if (l_retcode != ESP_OK)
 	{
 		ESP_LOGE(TAG,"CHM3300Sensor::SetupSensor / command 0x88 failed with %d", l_retcode);
@@ -180,7 +144,7 @@ bool CHM3300Sensor::PerformMeasurement(void)
 
 	uint8_t l_data[29];
 
-	esp_err_t l_retcode = i2c_master_read_from_device(m_i2c_port, m_dev_address, l_data, 29, 1000 / portTICK_PERIOD_MS);
+	esp_err_t l_retcode = g_I2CBusManager.Read(m_i2c_dev, l_data, 29);
 	if (l_retcode != ESP_OK)
 	{
 		ESP_LOGE(TAG,"CHM3300Sensor::PerformMeasurement / read failed with %d", l_retcode);
@@ -239,63 +203,35 @@ std::string CHM3300Sensor::GetSensorDescriptionString(void)
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void CHM3300Sensor::AddValuesToJSON_MQTT(cJSON *f_root)
+void CHM3300Sensor::AddValuesToJSON_MQTT(JsonWriter &f_writer)
 {
-	cJSON_AddNumberToObject(f_root, "pm1_ae", m_pm1_ae);
-	cJSON_AddNumberToObject(f_root, "pm25_ae", m_pm25_ae);
-	cJSON_AddNumberToObject(f_root, "pm10_ae", m_pm10_ae);
-
-	cJSON_AddNumberToObject(f_root, "pm1_spm", m_pm1_spm);
-	cJSON_AddNumberToObject(f_root, "pm25_spm", m_pm25_spm);
-	cJSON_AddNumberToObject(f_root, "pm10_spm", m_pm10_spm);
+	f_writer.Number("pm1_ae", m_pm1_ae);
+	f_writer.Number("pm25_ae", m_pm25_ae);
+	f_writer.Number("pm10_ae", m_pm10_ae);
+	f_writer.Number("pm1_spm", m_pm1_spm);
+	f_writer.Number("pm25_spm", m_pm25_spm);
+	f_writer.Number("pm10_spm", m_pm10_spm);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void CHM3300Sensor::AddValuesToJSON_API(cJSON *f_root)
+void CHM3300Sensor::AddValuesToJSON_API(JsonWriter &f_writer)
 {
-	cJSON *pm25_spm 	= cJSON_CreateObject();
-    cJSON *pm10_spm 	= cJSON_CreateObject();
-    cJSON *pm1_spm 		= cJSON_CreateObject();
-
-	cJSON *pm25_ae 		= cJSON_CreateObject();
-    cJSON *pm10_ae 		= cJSON_CreateObject();
-    cJSON *pm1_ae 		= cJSON_CreateObject();
-
-
-	cJSON_AddStringToObject(pm1_spm, "unit", "ug/m3");
-	cJSON_AddStringToObject(pm1_spm, "value", uint_2_string("%d",m_pm1_spm));
-	cJSON_AddStringToObject(pm1_spm, "text", "PM1.0 concentration (Standard particulate matter)");
-
-	cJSON_AddStringToObject(pm25_spm, "unit", "ug/m3");
-	cJSON_AddStringToObject(pm25_spm, "value", uint_2_string("%d",m_pm25_spm));
-	cJSON_AddStringToObject(pm25_spm, "text", "PM2.5 concentration (Standard particulate matter)");
-
-	cJSON_AddStringToObject(pm10_spm, "unit", "ug/m3");
-	cJSON_AddStringToObject(pm10_spm, "value", uint_2_string("%d",m_pm10_spm));
-	cJSON_AddStringToObject(pm10_spm, "text", "PM10 concentration (Standard particulate matter)");
-
-	cJSON_AddStringToObject(pm1_ae, "unit", "ug/m3");
-	cJSON_AddStringToObject(pm1_ae, "value", uint_2_string("%d",m_pm1_ae));
-	cJSON_AddStringToObject(pm1_ae, "text", "PM1.0 concentration (Atmospheric environment)");
-
-	cJSON_AddStringToObject(pm25_ae, "unit", "ug/m3");
-	cJSON_AddStringToObject(pm25_ae, "value", uint_2_string("%d",m_pm25_ae));
-	cJSON_AddStringToObject(pm25_ae, "text", "PM2.5 concentration (Atmospheric environment)");
-
-	cJSON_AddStringToObject(pm10_ae, "unit", "ug/m3");
-	cJSON_AddStringToObject(pm10_ae, "value", uint_2_string("%d",m_pm10_ae));
-	cJSON_AddStringToObject(pm10_ae, "text", "PM10 concentration (Atmospheric environment)");
-
-	cJSON_AddItemToObject(f_root,"pm1_spm",pm1_spm);
-	cJSON_AddItemToObject(f_root,"pm25_spm",pm25_spm);
-	cJSON_AddItemToObject(f_root,"pm10_spm",pm10_spm);
+	AddApiValue(f_writer, "pm1_spm", "ug/m3", "%d", m_pm1_spm, "PM1.0 concentration (Standard particulate matter)");
+	AddApiValue(f_writer, "pm25_spm", "ug/m3", "%d", m_pm25_spm, "PM2.5 concentration (Standard particulate matter)");
+	AddApiValue(f_writer, "pm10_spm", "ug/m3", "%d", m_pm10_spm, "PM10 concentration (Standard particulate matter)");
+	AddApiValue(f_writer, "pm1_ae", "ug/m3", "%d", m_pm1_ae, "PM1.0 concentration (Atmospheric environment)");
+	AddApiValue(f_writer, "pm25_ae", "ug/m3", "%d", m_pm25_ae, "PM2.5 concentration (Atmospheric environment)");
+	AddApiValue(f_writer, "pm10_ae", "ug/m3", "%d", m_pm10_ae, "PM10 concentration (Atmospheric environment)");
+
+	f_writer.String("SensorType", "HM3300 Dust Sensor");
+}
 
-	cJSON_AddItemToObject(f_root,"pm1_ae",pm1_ae);
-	cJSON_AddItemToObject(f_root,"pm25_ae",pm25_ae);
-	cJSON_AddItemToObject(f_root,"pm10_ae",pm10_ae);
+////////////////////////////////////////////////////////////////////////////////////////
 
-	cJSON_AddStringToObject(f_root, "SensorType", "HM3300 Dust Sensor");
+void CHM3300Sensor::AddStatsToJSON(JsonWriter &f_writer)
+{
+	g_I2CBusManager.AddDeviceStatsToJSON(m_i2c_dev, f_writer);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -314,3 +250,32 @@ bool CHM3300Sensor::SetupSensor(gpio_num_t *f_pins,int *f_data)
 
 #endif
 }
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *g_CHM3300Sensor_Channels[] = { "pm1_ae", "pm25_ae", "pm10_ae", "pm1_spm", "pm25_spm", "pm10_spm" };
+
+int CHM3300Sensor::GetChannelCount(void)
+{
+	return sizeof(g_CHM3300Sensor_Channels) / sizeof(g_CHM3300Sensor_Channels[0]);
+}
+
+const char *CHM3300Sensor::GetChannelName(int f_ch)
+{
+	return f_ch >= 0 && f_ch < GetChannelCount() ? g_CHM3300Sensor_Channels[f_ch] : "";
+}
+
+float CHM3300Sensor::GetChannelValue(int f_ch)
+{
+	switch (f_ch)
+	{
+		case 0: return m_pm1_ae;
+		case 1: return m_pm25_ae;
+		case 2: return m_pm10_ae;
+		case 3: return m_pm1_spm;
+		case 4: return m_pm25_spm;
+		case 5: return m_pm10_spm;
+	}
+
+	return 0;
+}
@@ -0,0 +1,372 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "i2c_bus_manager.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *TAG = "I2CBusManager";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+I2CBusManager g_I2CBusManager;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- called by the driver from its interrupt, f_arg is the number of the device
+
+static bool i2c_bus_trans_done(i2c_master_dev_handle_t f_handle, const i2c_master_event_data_t *f_evt, void *f_arg)
+{
+    return g_I2CBusManager.OnTransDone((int)(intptr_t)f_arg, f_evt->event);
+}
+
+// --- completion of Transfer(), lives on the stack of the waiting task
+
+typedef struct
+{
+    SemaphoreHandle_t   m_Done;
+    esp_err_t           m_Result;
+} i2c_bus_wait_t;
+
+static bool i2c_bus_give_done(void *f_ctx, esp_err_t f_result)
+{
+    i2c_bus_wait_t *l_wait = (i2c_bus_wait_t *)f_ctx;
+    BaseType_t l_woken = pdFALSE;
+
+    l_wait->m_Result = f_result;
+    xSemaphoreGiveFromISR(l_wait->m_Done, &l_woken);
+
+    return l_woken == pdTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+I2CBusManager::I2CBusManager()
+{
+    memset(m_Buses, 0, sizeof(m_Buses));
+    memset(m_Devices, 0, sizeof(m_Devices));
+    m_DeviceCnt = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t I2CBusManager::AddDevice(i2c_port_t f_port, gpio_num_t f_sda, gpio_num_t f_scl, uint8_t f_address, uint32_t f_max_speed, const char *f_name, int *f_dev)
+{
+    if (f_port < 0 || f_port >= I2C_NUM_MAX || !f_dev) return ESP_ERR_INVALID_ARG;
+
+    // --- devices are added while the sensors are set up, which is done by one task
+
+    if (!m_Mutex) m_Mutex = xSemaphoreCreateMutex();
+    if (!m_Mutex) return ESP_ERR_NO_MEM;
+
+    if (f_max_speed == 0 || f_max_speed > I2C_BUS_SPEED_FAST) f_max_speed = I2C_BUS_SPEED_FAST;
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    esp_err_t l_err = ESP_OK;
+    Bus &l_bus = m_Buses[f_port];
+
+    for (int i = 0; i < m_DeviceCnt && l_err == ESP_OK; ++i)
+    {
+        if (m_Devices[i].m_Port == f_port && m_Devices[i].m_Address == f_address)
+        {
+            ESP_LOGE(TAG, "%s: address 0x%02x on port %d is taken by %s", f_name, f_address, f_port, m_Devices[i].m_Name);
+            l_err = ESP_ERR_INVALID_STATE;
+        }
+    }
+
+    if (l_err == ESP_OK && m_DeviceCnt >= I2C_BUS_MAX_DEVICES) l_err = ESP_ERR_NO_MEM;
+
+    if (l_err != ESP_OK)
+    {
+        xSemaphoreGive(m_Mutex);
+        ESP_LOGE(TAG, "Could not add %s on port %d (%d)", f_name, f_port, l_err);
+        return l_err;
+    }
+
+    Device &l_dev = m_Devices[m_DeviceCnt];
+
+    // --- kept for the next device if this one fails
+
+    if (!l_dev.m_Lock) l_dev.m_Lock = xSemaphoreCreateMutex();
+    if (!l_dev.m_Done) l_dev.m_Done = xSemaphoreCreateBinary();
+
+    if (!l_dev.m_Lock || !l_dev.m_Done) l_err = ESP_ERR_NO_MEM;
+
+    if (l_err == ESP_OK && !l_bus.m_Handle) l_err = CreateBus(f_port, f_sda, f_scl);
+
+    if (l_err == ESP_OK)
+    {
+        i2c_device_config_t l_conf;
+
+        memset(&l_conf, 0, sizeof(l_conf));
+
+        l_conf.dev_addr_length  = I2C_ADDR_BIT_LEN_7;
+        l_conf.device_address   = f_address;
+        l_conf.scl_speed_hz     = f_max_speed;
+
+        l_err = i2c_master_bus_add_device(l_bus.m_Handle, &l_conf, &l_dev.m_Handle);
+    }
+
+    if (l_err == ESP_OK)
+    {
+        // --- with callbacks the driver works asynchronously
+
+        i2c_master_event_callbacks_t l_cbs;
+
+        memset(&l_cbs, 0, sizeof(l_cbs));
+        l_cbs.on_trans_done = i2c_bus_trans_done;
+
+        l_err = i2c_master_register_event_callbacks(l_dev.m_Handle, &l_cbs, (void *)(intptr_t)m_DeviceCnt);
+        if (l_err != ESP_OK) i2c_master_bus_rm_device(l_dev.m_Handle);
+    }
+
+    if (l_err == ESP_OK)
+    {
+        l_dev.m_Port        = f_port;
+        l_dev.m_Address     = f_address;
+        l_dev.m_Speed       = f_max_speed;
+        l_dev.m_Name        = f_name;
+        l_dev.m_Busy        = false;
+
+        *f_dev = m_DeviceCnt++;
+    }
+
+    xSemaphoreGive(m_Mutex);
+
+    if (l_err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not add %s on port %d (%d)", f_name, f_port, l_err);
+        return l_err;
+    }
+
+    if (f_sda != l_bus.m_Sda || f_scl != l_bus.m_Scl)
+    {
+        ESP_LOGW(TAG, "%s: port %d uses sda pin %d scl pin %d, the pins sda %d scl %d are ignored", f_name, f_port,
+                 (int)l_bus.m_Sda, (int)l_bus.m_Scl, (int)f_sda, (int)f_scl);
+    }
+
+    ESP_LOGI(TAG, "%s on port %d address 0x%02x at %u kHz", f_name, f_port, f_address, (unsigned)(f_max_speed / 1000));
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t I2CBusManager::CreateBus(i2c_port_t f_port, gpio_num_t f_sda, gpio_num_t f_scl)
+{
+    Bus &l_bus = m_Buses[f_port];
+    i2c_master_bus_config_t l_conf;
+
+    memset(&l_conf, 0, sizeof(l_conf));
+
+    l_conf.i2c_port                     = f_port;
+    l_conf.sda_io_num                   = f_sda;
+    l_conf.scl_io_num                   = f_scl;
+    l_conf.clk_source                   = I2C_CLK_SRC_DEFAULT;
+    l_conf.glitch_ignore_cnt            = 7;
+    l_conf.trans_queue_depth            = I2C_BUS_QUEUE_LEN;
+    l_conf.flags.enable_internal_pullup = true;
+
+    ESP_LOGI(TAG, "Setup i2c port %d on sda pin %d scl pin %d", f_port, (int)f_sda, (int)f_scl);
+
+    esp_err_t l_err = i2c_new_master_bus(&l_conf, &l_bus.m_Handle);
+    if (l_err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "i2c_new_master_bus failed with %d", l_err);
+        l_bus.m_Handle = NULL;
+        return l_err;
+    }
+
+    l_bus.m_Sda = f_sda;
+    l_bus.m_Scl = f_scl;
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t I2CBusManager::TransferAsync(int f_dev, const uint8_t *f_write, size_t f_write_len, uint8_t *f_read, size_t f_read_len, i2c_bus_done_cb_t f_cb, void *f_ctx)
+{
+    if (f_dev < 0 || f_dev >= m_DeviceCnt || !f_cb || (!f_write_len && !f_read_len)) return ESP_ERR_INVALID_ARG;
+
+    Device &l_dev = m_Devices[f_dev];
+
+    taskENTER_CRITICAL(&m_Spinlock);
+
+    bool l_busy = l_dev.m_Busy;
+
+    if (!l_busy)
+    {
+        l_dev.m_Busy    = true;
+        l_dev.m_Cb      = f_cb;
+        l_dev.m_CbCtx   = f_ctx;
+        l_dev.m_StartUs = esp_timer_get_time();
+    }
+
+    taskEXIT_CRITICAL(&m_Spinlock);
+
+    if (l_busy) return ESP_ERR_INVALID_STATE;
+
+    // --- only fails if the transaction could not be queued, the result comes with the
+    //     callback otherwise
+
+    esp_err_t l_err;
+
+    if (f_write_len && f_read_len)
+    {
+        l_err = i2c_master_transmit_receive(l_dev.m_Handle, f_write, f_write_len, f_read, f_read_len, I2C_BUS_TIMEOUT_MS);
+    }
+    else if (f_write_len)
+    {
+        l_err = i2c_master_transmit(l_dev.m_Handle, f_write, f_write_len, I2C_BUS_TIMEOUT_MS);
+    }
+    else
+    {
+        l_err = i2c_master_receive(l_dev.m_Handle, f_read, f_read_len, I2C_BUS_TIMEOUT_MS);
+    }
+
+    if (l_err != ESP_OK)
+    {
+        taskENTER_CRITICAL(&m_Spinlock);
+        l_dev.m_Busy = false;
+        taskEXIT_CRITICAL(&m_Spinlock);
+    }
+
+    return l_err;
+}
+
+esp_err_t I2CBusManager::Transfer(int f_dev, const uint8_t *f_write, size_t f_write_len, uint8_t *f_read, size_t f_read_len)
+{
+    if (f_dev < 0 || f_dev >= m_DeviceCnt) return ESP_ERR_INVALID_ARG;
+
+    Device &l_dev = m_Devices[f_dev];
+
+    xSemaphoreTake(l_dev.m_Lock, portMAX_DELAY);
+
+    // --- the driver ends every transaction within I2C_BUS_TIMEOUT_MS, so the interrupt
+    //     always comes
+
+    i2c_bus_wait_t l_wait = { l_dev.m_Done, ESP_FAIL };
+
+    esp_err_t l_err = TransferAsync(f_dev, f_write, f_write_len, f_read, f_read_len, i2c_bus_give_done, &l_wait);
+    if (l_err == ESP_OK)
+    {
+        xSemaphoreTake(l_dev.m_Done, portMAX_DELAY);
+        l_err = l_wait.m_Result;
+    }
+
+    xSemaphoreGive(l_dev.m_Lock);
+
+    return l_err;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool I2CBusManager::OnTransDone(int f_dev, i2c_master_event_t f_event)
+{
+    if (f_dev < 0 || f_dev >= I2C_BUS_MAX_DEVICES) return false;
+
+    Device &l_dev = m_Devices[f_dev];
+    esp_err_t l_err;
+
+    switch (f_event)
+    {
+        case I2C_EVENT_DONE:    l_err = ESP_OK; break;
+        case I2C_EVENT_NACK:    l_err = ESP_FAIL; break;
+        default:                l_err = ESP_ERR_TIMEOUT; break;
+    }
+
+    taskENTER_CRITICAL_ISR(&m_Spinlock);
+
+    I2CDeviceStats &l_stats = l_dev.m_Stats;
+    uint32_t l_latency = (uint32_t)(esp_timer_get_time() - l_dev.m_StartUs);
+
+    l_stats.m_Transfers++;
+    if (l_err == ESP_FAIL) l_stats.m_Nacks++;
+    if (l_err == ESP_ERR_TIMEOUT) l_stats.m_Timeouts++;
+
+    l_stats.m_LastLatencyUs  = l_latency;
+    l_stats.m_SumLatencyUs  += l_latency;
+    if (l_latency > l_stats.m_MaxLatencyUs) l_stats.m_MaxLatencyUs = l_latency;
+
+    i2c_bus_done_cb_t l_cb  = l_dev.m_Cb;
+    void *l_ctx             = l_dev.m_CbCtx;
+
+    l_dev.m_Busy    = false;
+
+    taskEXIT_CRITICAL_ISR(&m_Spinlock);
+
+    return l_cb ? l_cb(l_ctx, l_err) : false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void I2CBusManager::GetDeviceStats(int f_dev, I2CDeviceStats *f_stats)
+{
+    memset(f_stats, 0, sizeof(*f_stats));
+
+    if (f_dev < 0 || f_dev >= m_DeviceCnt) return;
+
+    taskENTER_CRITICAL(&m_Spinlock);
+    *f_stats = m_Devices[f_dev].m_Stats;
+    taskEXIT_CRITICAL(&m_Spinlock);
+}
+
+void I2CBusManager::AddDeviceStatsToJSON(int f_dev, JsonWriter &f_writer)
+{
+    if (f_dev < 0 || f_dev >= m_DeviceCnt) return;
+
+    I2CDeviceStats l_stats;
+    GetDeviceStats(f_dev, &l_stats);
+
+    f_writer.BeginObject("i2c");
+    f_writer.Int("clock_hz", GetDeviceSpeed(f_dev));
+    f_writer.Int("transfers", l_stats.m_Transfers);
+    f_writer.Int("nacks", l_stats.m_Nacks);
+    f_writer.Int("timeouts", l_stats.m_Timeouts);
+    f_writer.Int("latency_avg_us", l_stats.m_Transfers ? l_stats.m_SumLatencyUs / l_stats.m_Transfers : 0);
+    f_writer.Int("latency_max_us", l_stats.m_MaxLatencyUs);
+    f_writer.EndObject();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
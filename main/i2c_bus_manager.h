@@ -0,0 +1,168 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef I2C_BUS_MANAGER_H_
+#define	I2C_BUS_MANAGER_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "driver/gpio.h"
+#include "driver/i2c_master.h"
+#include "esp_err.h"
+
+#include "json_writer.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- owner of the I2C ports. The first device on a port creates the bus with its
+//     pins. Transactions are queued in the driver and done one after the other by its
+//     interrupt, so a task can start transactions on several devices back to back and
+//     do something else meanwhile. Every device runs with its own clock, at most
+//     400 kHz.
+
+#define I2C_BUS_MAX_DEVICES         8
+#define I2C_BUS_QUEUE_LEN           8           // --- transactions waiting in the driver, per bus
+#define I2C_BUS_TIMEOUT_MS          50          // --- of one transaction, 29 bytes take 3 ms at 100 kHz
+
+#define I2C_BUS_SPEED_STANDARD      100000
+#define I2C_BUS_SPEED_FAST          400000
+
+// --- completion of TransferAsync(). Called from the interrupt: only ISR safe calls,
+//     returns true if a higher priority task was woken.
+
+typedef bool (*i2c_bus_done_cb_t)(void *f_ctx, esp_err_t f_result);
+
+// --- counters of one device. The latency is the time from starting a transaction
+//     until it is done, waiting for the other devices on the bus included.
+
+typedef struct I2CDeviceStats_s
+{
+    uint32_t    m_Transfers;
+    uint32_t    m_Nacks;
+    uint32_t    m_Timeouts;
+    uint32_t    m_LastLatencyUs;
+    uint32_t    m_MaxLatencyUs;
+    uint64_t    m_SumLatencyUs;
+} I2CDeviceStats;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class I2CBusManager
+{
+public:
+
+    I2CBusManager();
+
+    // --- action functions. AddDevice() returns the number of the device in f_dev. The
+    //     pins of a port are those of its first device, others are ignored.
+
+    esp_err_t AddDevice(i2c_port_t f_port, gpio_num_t f_sda, gpio_num_t f_scl, uint8_t f_address, uint32_t f_max_speed, const char *f_name, int *f_dev);
+
+    // --- one transaction: an optional write, then an optional read after a repeated
+    //     start. Returns ESP_FAIL on a NACK.
+    //
+    //     TransferAsync() returns as soon as the transaction is queued, f_cb gets the
+    //     result. The buffers must stay valid until then. A device has one transaction
+    //     at a time, ESP_ERR_INVALID_STATE while the last one is not done. Transfer()
+    //     waits for the result.
+
+    esp_err_t TransferAsync(int f_dev, const uint8_t *f_write, size_t f_write_len, uint8_t *f_read, size_t f_read_len, i2c_bus_done_cb_t f_cb, void *f_ctx);
+    esp_err_t Transfer(int f_dev, const uint8_t *f_write, size_t f_write_len, uint8_t *f_read, size_t f_read_len);
+
+    esp_err_t Write(int f_dev, const uint8_t *f_data, size_t f_len) { return Transfer(f_dev, f_data, f_len, NULL, 0); }
+    esp_err_t Read(int f_dev, uint8_t *f_data, size_t f_len) { return Transfer(f_dev, NULL, 0, f_data, f_len); }
+
+    // --- getters
+
+    int GetDeviceCount(void) const { return m_DeviceCnt; }
+    const char *GetDeviceName(int f_dev) const { return f_dev >= 0 && f_dev < m_DeviceCnt ? m_Devices[f_dev].m_Name : ""; }
+    uint32_t GetDeviceSpeed(int f_dev) const { return f_dev >= 0 && f_dev < m_DeviceCnt ? m_Devices[f_dev].m_Speed : 0; }
+
+    void GetDeviceStats(int f_dev, I2CDeviceStats *f_stats);
+    void AddDeviceStatsToJSON(int f_dev, JsonWriter &f_writer);
+
+    // --- internal functions do not use
+
+    bool OnTransDone(int f_dev, i2c_master_event_t f_event);
+
+private:
+
+    struct Device
+    {
+        i2c_master_dev_handle_t m_Handle;
+        i2c_port_t              m_Port;
+        uint8_t                 m_Address;
+        uint32_t                m_Speed;
+        const char              *m_Name;
+
+        SemaphoreHandle_t       m_Lock;         // --- callers of Transfer()
+        SemaphoreHandle_t       m_Done;         // --- given by the interrupt for Transfer()
+
+        bool                    m_Busy;         // --- m_Spinlock
+        i2c_bus_done_cb_t       m_Cb;           // --- NULL for Transfer()
+        void                    *m_CbCtx;
+        int64_t                 m_StartUs;
+        I2CDeviceStats          m_Stats;        // --- m_Spinlock
+    };
+
+    struct Bus
+    {
+        i2c_master_bus_handle_t m_Handle;       // --- NULL until the first device is added
+        gpio_num_t              m_Sda;
+        gpio_num_t              m_Scl;
+    };
+
+    esp_err_t CreateBus(i2c_port_t f_port, gpio_num_t f_sda, gpio_num_t f_scl);
+
+    Bus                 m_Buses[I2C_NUM_MAX];
+    Device              m_Devices[I2C_BUS_MAX_DEVICES];
+    int                 m_DeviceCnt;
+
+    SemaphoreHandle_t   m_Mutex = NULL;         // --- adding devices
+    portMUX_TYPE        m_Spinlock = portMUX_INITIALIZER_UNLOCKED;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+extern I2CBusManager g_I2CBusManager;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
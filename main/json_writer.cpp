@@ -0,0 +1,289 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "esp_http_server.h"
+
+#include "json_writer.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *TAG = "JsonWriter";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+JsonWriter::JsonWriter(char *f_buf, size_t f_size)
+    : m_Req(NULL), m_Buf(f_buf), m_Size(f_size), m_Len(0), m_NotFirst(0), m_Depth(0), m_Overflow(false), m_Err(ESP_OK)
+{
+}
+
+JsonWriter::JsonWriter(httpd_req_t *f_req, char *f_buf, size_t f_size)
+    : m_Req(f_req), m_Buf(f_buf), m_Size(f_size), m_Len(0), m_NotFirst(0), m_Depth(0), m_Overflow(false), m_Err(ESP_OK)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void JsonWriter::BeginObject(const char *f_key)
+{
+    Separator(f_key);
+    Put("{", 1);
+
+    if (m_Depth < JSON_WRITER_MAX_DEPTH - 1) m_Depth++;
+    m_NotFirst &= ~(1u << m_Depth);
+}
+
+void JsonWriter::EndObject(void)
+{
+    Put("}", 1);
+    if (m_Depth > 0) m_Depth--;
+}
+
+void JsonWriter::BeginArray(const char *f_key)
+{
+    Separator(f_key);
+    Put("[", 1);
+
+    if (m_Depth < JSON_WRITER_MAX_DEPTH - 1) m_Depth++;
+    m_NotFirst &= ~(1u << m_Depth);
+}
+
+void JsonWriter::EndArray(void)
+{
+    Put("]", 1);
+    if (m_Depth > 0) m_Depth--;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void JsonWriter::String(const char *f_key, const char *f_value)
+{
+    Separator(f_key);
+
+    if (f_value) PutString(f_value);
+    else Put("null", 4);
+}
+
+void JsonWriter::Number(const char *f_key, double f_value)
+{
+    Separator(f_key);
+
+    if (isnan(f_value) || isinf(f_value))
+    {
+        Put("null", 4);
+        return;
+    }
+
+    // --- same as cJSON: 15 digits, 17 if that does not give the value back
+
+    char l_num[32];
+    int  l_len = snprintf(l_num, sizeof(l_num), "%1.15g", f_value);
+
+    if (strtod(l_num, NULL) != f_value)
+    {
+        l_len = snprintf(l_num, sizeof(l_num), "%1.17g", f_value);
+    }
+
+    Put(l_num, l_len);
+}
+
+void JsonWriter::Fixed(const char *f_key, double f_value, int f_decimals)
+{
+    Separator(f_key);
+
+    if (isnan(f_value) || isinf(f_value))
+    {
+        Put("null", 4);
+        return;
+    }
+
+    char l_num[32];
+    int  l_len = snprintf(l_num, sizeof(l_num), "%.*f", f_decimals, f_value);
+
+    Put(l_num, l_len);
+}
+
+void JsonWriter::Int(const char *f_key, int64_t f_value)
+{
+    Separator(f_key);
+
+    char l_num[24];
+    int  l_len = snprintf(l_num, sizeof(l_num), "%" PRId64, f_value);
+
+    Put(l_num, l_len);
+}
+
+void JsonWriter::Bool(const char *f_key, bool f_value)
+{
+    Separator(f_key);
+
+    if (f_value) Put("true", 4);
+    else Put("false", 5);
+}
+
+void JsonWriter::Null(const char *f_key)
+{
+    Separator(f_key);
+    Put("null", 4);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t JsonWriter::Finish(void)
+{
+    if (m_Req)
+    {
+        Flush();
+
+        if (m_Err == ESP_OK) m_Err = httpd_resp_send_chunk(m_Req, NULL, 0);
+
+        return m_Err;
+    }
+
+    // --- buffer mode: the terminator always fits, Put() keeps one byte free
+
+    if (m_Size) m_Buf[m_Len] = 0;
+
+    if (m_Overflow)
+    {
+        ESP_LOGW(TAG, "Buffer of %u bytes too small", (unsigned)m_Size);
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- comma and key in front of every value
+
+void JsonWriter::Separator(const char *f_key)
+{
+    if (m_NotFirst & (1u << m_Depth)) Put(",", 1);
+    m_NotFirst |= 1u << m_Depth;
+
+    if (f_key)
+    {
+        PutString(f_key);
+        Put(":", 1);
+    }
+}
+
+void JsonWriter::Put(const char *f_str, size_t f_len)
+{
+    while (f_len)
+    {
+        // --- one byte is kept free for the terminator in buffer mode
+
+        size_t l_free = m_Size - m_Len - (m_Req ? 0 : 1);
+
+        if (l_free == 0)
+        {
+            if (!m_Req)
+            {
+                m_Overflow = true;
+                return;
+            }
+
+            Flush();
+            if (m_Err != ESP_OK) return;
+            continue;
+        }
+
+        size_t l_cnt = f_len < l_free ? f_len : l_free;
+
+        memcpy(m_Buf + m_Len, f_str, l_cnt);
+        m_Len += l_cnt;
+        f_str += l_cnt;
+        f_len -= l_cnt;
+    }
+}
+
+void JsonWriter::PutString(const char *f_str)
+{
+    Put("\"", 1);
+
+    // --- copy runs of plain characters, escape the rest
+
+    const char *l_run = f_str;
+
+    for (; *f_str; ++f_str)
+    {
+        unsigned char l_c = (unsigned char)*f_str;
+
+        if (l_c >= 0x20 && l_c != '"' && l_c != '\\') continue;
+
+        Put(l_run, f_str - l_run);
+        l_run = f_str + 1;
+
+        char l_esc[8];
+
+        switch (l_c)
+        {
+            case '"':   Put("\\\"", 2); break;
+            case '\\':  Put("\\\\", 2); break;
+            case '\n':  Put("\\n", 2); break;
+            case '\r':  Put("\\r", 2); break;
+            case '\t':  Put("\\t", 2); break;
+            default:
+                snprintf(l_esc, sizeof(l_esc), "\\u%04x", l_c);
+                Put(l_esc, 6);
+                break;
+        }
+    }
+
+    Put(l_run, f_str - l_run);
+    Put("\"", 1);
+}
+
+void JsonWriter::Flush(void)
+{
+    if (!m_Req || m_Len == 0 || m_Err != ESP_OK) return;
+
+    m_Err = httpd_resp_send_chunk(m_Req, m_Buf, m_Len);
+    m_Len = 0;
+
+    if (m_Err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Sending chunk failed (%s)", esp_err_to_name(m_Err));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,113 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef JSON_WRITER_H_
+#define	JSON_WRITER_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- streaming JSON emitter. The output goes straight into a caller supplied buffer,
+//     nothing is allocated. In http mode the buffer is sent as a chunk whenever it is
+//     full, so the size of the document is not limited by the buffer.
+//
+//     All value functions take the key first; pass NULL inside arrays.
+
+#define JSON_WRITER_MAX_DEPTH       16
+#define JSON_WRITER_CHUNK_SIZE      512     // --- suggested buffer size for http mode
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class JsonWriter
+{
+public:
+
+    JsonWriter(char *f_buf, size_t f_size);
+    JsonWriter(httpd_req_t *f_req, char *f_buf, size_t f_size);
+
+    // --- structure
+
+    void BeginObject(const char *f_key = NULL);
+    void EndObject(void);
+    void BeginArray(const char *f_key = NULL);
+    void EndArray(void);
+
+    // --- values. Number() prints like cJSON (NaN and infinity become null), Fixed() with
+    //     the given number of decimals.
+
+    void String(const char *f_key, const char *f_value);
+    void Number(const char *f_key, double f_value);
+    void Fixed(const char *f_key, double f_value, int f_decimals);
+    void Int(const char *f_key, int64_t f_value);
+    void Bool(const char *f_key, bool f_value);
+    void Null(const char *f_key);
+
+    // --- buffer mode: terminates the string. http mode: sends the rest and the final
+    //     chunk. Returns ESP_ERR_NO_MEM when the buffer was too small.
+
+    esp_err_t Finish(void);
+
+    // --- getters
+
+    size_t GetLength(void) const { return m_Len; }
+    bool IsOverflow(void) const { return m_Overflow; }
+
+private:
+
+    void Separator(const char *f_key);
+    void Put(const char *f_str, size_t f_len);
+    void PutString(const char *f_str);
+    void Flush(void);
+
+    httpd_req_t     *m_Req;
+    char            *m_Buf;
+    size_t          m_Size;
+    size_t          m_Len;
+
+    uint32_t        m_NotFirst;         // --- one bit per nesting level
+    int             m_Depth;
+    bool            m_Overflow;
+    esp_err_t       m_Err;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -56,6 +56,8 @@
 #include "sdkconfig.h"
 #include "vindriktning.h"
 #include "sensor_manager.h"
+#include "sample_store.h"
+#include "sample_journal.h"
 #include "config_manager.h"
 #include "infomanager.h"
 #include "config_manager_defines.h"
@@ -63,6 +65,7 @@
 #include "applogger.h"
 #include "esp_partition.h"
 #include "ota_manager.h"
+#include "event_stream.h"
 
 #include "timestamp.h"
 
@@ -215,11 +218,14 @@ static void start_wifi_client()
 
         // --- get config from config manager
 
-        std::string l_ssid      = g_ConfigManager.GetStringValue(CFMGR_WIFI_SSID);
-        std::string l_wlanpwd   = g_ConfigManager.GetStringValue(CFMGR_WIFI_PASSWORD);
+        char l_ssid[CFMGR_MAX_STRING_LEN + 1];
+        char l_wlanpwd[CFMGR_MAX_STRING_LEN + 1];
 
-        strncpy((char *)wifi_config.sta.ssid,l_ssid.c_str(),32);
-        strncpy((char *)wifi_config.sta.password,l_wlanpwd.c_str(),64);
+        g_ConfigManager.GetStringValue(CFMGR_WIFI_SSID, l_ssid, sizeof(l_ssid));
+        g_ConfigManager.GetStringValue(CFMGR_WIFI_PASSWORD, l_wlanpwd, sizeof(l_wlanpwd));
+
+        strncpy((char *)wifi_config.sta.ssid,l_ssid,32);
+        strncpy((char *)wifi_config.sta.password,l_wlanpwd,64);
 
         ESP_LOGI(TAG, "Connecting to '%s'...", wifi_config.sta.ssid);
 
@@ -286,13 +292,19 @@ esp_err_t init_fs(void)
 void init_sensors(void)
 {
     g_SensorManager.InitSensors();
+
+    // --- the history buffers depend on the channels of the sensors. The journal is
+    //     optional, it needs the "samples" partition.
+
+    g_SampleJournal.InitJournal();
+    ESP_ERROR_CHECK(g_SampleStore.InitStore());
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void ProcessMeasurements(void)
+void start_acquisition(void)
 {
-    g_SensorManager.ProcessMeasurements();
+    g_SensorManager.StartAcquisition();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -321,9 +333,9 @@ void app_main()
     ESP_LOGI(TAG, "Initialize file system");
     ESP_ERROR_CHECK(init_fs());
 
-    // ---- init app logger (which needs the SPIFFS)
+    // ---- init app logger (which needs the SPIFFS for the history)
 
-    ESP_ERROR_CHECK(g_AppLogger.InitAppLogger());    
+    ESP_ERROR_CHECK(g_AppLogger.InitAppLogger(CONFIG_EXAMPLE_WEB_MOUNT_POINT));    
 
     // --- start the info manager
 
@@ -363,6 +375,11 @@ void app_main()
 
             nvs_flash_deinit();
 
+            // --- keep these lines in the history
+
+            g_AppLogger.Flush();
+            vTaskDelay(200 / portTICK_PERIOD_MS);
+
             // --- and reboot
 
             esp_restart();
@@ -396,17 +413,21 @@ void app_main()
 
         // ---- default values
 
-        if (g_ConfigManager.GetStringValue(CFMGR_DEVICE_NAME).length() == 0)
+        g_ConfigManager.BeginUpdate();
+
+        if (g_ConfigManager.GetStringValue(CFMGR_DEVICE_NAME, NULL, 0) == 0)
             g_ConfigManager.SetStringValue(CFMGR_DEVICE_NAME,"IoTDevice");
 
-        if (g_ConfigManager.GetStringValue(CFMGR_MQTT_SERVER).length() == 0)
+        if (g_ConfigManager.GetStringValue(CFMGR_MQTT_SERVER, NULL, 0) == 0)
             g_ConfigManager.SetStringValue(CFMGR_MQTT_SERVER,"mqtt://192.168.1.60");
         
-        if (g_ConfigManager.GetStringValue(CFMGR_MQTT_TOPIC).length() == 0)
+        if (g_ConfigManager.GetStringValue(CFMGR_MQTT_TOPIC, NULL, 0) == 0)
             g_ConfigManager.SetStringValue(CFMGR_MQTT_TOPIC,"mytopic/templogger");
 
         if (g_ConfigManager.GetIntValue(CFMGR_MQTT_TIME) == 0)
             g_ConfigManager.SetIntValue(CFMGR_MQTT_TIME,60);
+
+        g_ConfigManager.EndUpdate();
     }
     else
     {
@@ -427,6 +448,7 @@ void app_main()
     // ---- now start the web server
 
     g_AppLogger.Log("Start web server");
+    g_EventStream.InitStream();
     start_rest_server(CONFIG_EXAMPLE_WEB_MOUNT_POINT);
 
     // --- start the mqtt manager
@@ -434,11 +456,20 @@ void app_main()
     g_AppLogger.Log("Start MQTT manager");
     g_MqttManager.InitManager();
 
+    // --- check the update server (if configured)
+
+    g_OTAManager.InitPullUpdates();
+
     // --- just before we enter the main loop - get all GPIO states to the console
 
     gpio_dump_io_configuration(stdout, SOC_GPIO_VALID_GPIO_MASK);
 
-	// ---- main measurement loop
+    // ---- from now on every sensor is measured by its own task (see SensorManager)
+
+    g_AppLogger.Log("Start sensor acquisition");
+    start_acquisition();
+
+	// ---- main loop - nothing left to do but watching the heap
 
     ESP_LOGI(TAG, "Enter the main program loop");
     while(1) 
@@ -446,7 +477,6 @@ void app_main()
         
         heap_caps_check_integrity_all(true);
 
-		ProcessMeasurements();
         vTaskDelay(5000 / portTICK_PERIOD_MS);
     }
-}
+}
\ No newline at end of file
@@ -41,28 +41,20 @@
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
 #include "driver/gpio.h"
-#include "cJSON.h"
-#include "esp_event.h"
-#include "driver/sdmmc_host.h"
-#include "driver/gpio.h"
-#include "driver/uart.h"
-#include "esp_vfs_semihost.h"
-#include "esp_vfs_fat.h"
-#include "esp_spiffs.h"
-#include "esp_wifi.h"
-#include "sdmmc_cmd.h"
-#include "nvs_flash.h"
-#include "esp_netif.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 //#include "mdns.h"
 #include "mqtt_client.h"
 
 #include "config_manager.h"
 #include "config_manager_defines.h"
 #include "mqtt_manager.h"
+#include "json_writer.h"
+#include "cbor_writer.h"
 #include "sensor_manager.h"
 #include "applogger.h"
+#include "perf_metrics.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -78,7 +70,103 @@ static void prvMqttTimerCallback( TimerHandle_t xExpiredTimer )
 
     l_mqttmgr = (MqttManager *) pvTimerGetTimerID( xExpiredTimer );
 
-    l_mqttmgr->ProcessCallback();
+    l_mqttmgr->NotifyPublisher();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static void mqtt_config_changed(void *f_ctx, uint32_t f_changed)
+{
+    ((MqttManager *)f_ctx)->UpdateConfig(f_changed);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static void mqtt_publisher_task(void *f_param)
+{
+    ((MqttManager *)f_param)->PublisherLoop();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static void prvMqttEventHandler(void *f_args, esp_event_base_t f_base, int32_t f_id, void *f_data)
+{
+    ((MqttManager *)f_args)->ProcessEvent((esp_mqtt_event_handle_t)f_data);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void MqttManager::ProcessEvent(esp_mqtt_event_handle_t f_event)
+{
+    switch (f_event->event_id)
+    {
+        case MQTT_EVENT_CONNECTED:
+            m_queue.OnConnected();
+            break;
+
+        case MQTT_EVENT_DISCONNECTED:
+            m_queue.OnDisconnected();
+            break;
+
+        case MQTT_EVENT_PUBLISHED:
+            m_queue.OnPublished(f_event->msg_id);
+            break;
+
+        default:
+            break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- runs on the timer service task: pass the expiry time (low 32 bits of the us
+//     timer, enough for the difference) and return immediately
+
+void MqttManager::NotifyPublisher(void)
+{
+    xTaskNotify(m_task, (uint32_t)esp_timer_get_time(), eSetValueWithOverwrite);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void MqttManager::PublisherLoop(void)
+{
+    while (1)
+    {
+        uint32_t l_notify_us;
+
+        xTaskNotifyWait(0, 0, &l_notify_us, portMAX_DELAY);
+
+        uint32_t l_start_us = (uint32_t)esp_timer_get_time();
+
+        xSemaphoreTake(m_lock, portMAX_DELAY);
+        ProcessCallback();
+        xSemaphoreGive(m_lock);
+
+        uint32_t l_end_us = (uint32_t)esp_timer_get_time();
+
+        // --- statistics
+
+        taskENTER_CRITICAL(&m_stats_lock);
+
+        m_stats.m_Cycles++;
+        m_stats.m_LastLatencyUs  = l_start_us - l_notify_us;
+        m_stats.m_LastDurationUs = l_end_us - l_start_us;
+
+        if (m_stats.m_LastLatencyUs > m_stats.m_MaxLatencyUs) m_stats.m_MaxLatencyUs = m_stats.m_LastLatencyUs;
+        if (m_stats.m_LastDurationUs > m_stats.m_MaxDurationUs) m_stats.m_MaxDurationUs = m_stats.m_LastDurationUs;
+
+        taskEXIT_CRITICAL(&m_stats_lock);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void MqttManager::GetPublishStats(MqttPublishStats *f_stats)
+{
+    taskENTER_CRITICAL(&m_stats_lock);
+    *f_stats = m_stats;
+    taskEXIT_CRITICAL(&m_stats_lock);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -89,7 +177,7 @@ void MqttManager::ProcessCallback(void)
 
     if (!m_mqtt_enabled) return;
 
-    // ---- decrease the counter and send message, when zero
+    // ---- decrease the counter and queue the messages, when zero
 
     --m_delay_current;
 
@@ -99,71 +187,147 @@ void MqttManager::ProcessCallback(void)
 
         m_delay_current = m_mqtt_delay;
 
-        std::string l_topic  = g_ConfigManager.GetStringValue(CFMGR_MQTT_TOPIC);
-        std::string l_server = g_ConfigManager.GetStringValue(CFMGR_MQTT_SERVER);
-
-        // --- now loop over all sensors and send a message
+        // --- messages may be sent much later, so they carry the time of the measurement
+        //     (seconds since boot)
 
-        for (int l_senidx = 0; l_senidx < g_SensorManager.GetSensorCount(); ++l_senidx)
-        {
+        double l_time = (double)(esp_timer_get_time() / 1000) / 1000.0;
 
-            // ---- now ask the sensor for the values and create a JSON from that    
+        char l_payload[MQTT_QUEUE_PAYLOAD_SIZE];
 
-            cJSON *root = cJSON_CreateObject();
-            g_SensorManager.GetSensor(l_senidx)->AddValuesToJSON_MQTT(root);
+        if (m_mqtt_combined)
+        {
+            // --- one message to the base topic: a sub-object per sensor, one timestamp
 
-            const char *sys_info = cJSON_Print(root);
-            
-            char l_snum[5];
+            size_t l_len = EncodePayload(m_mqtt_format, MQTT_QUEUE_DEVICE_TOPIC, l_time, l_payload, sizeof(l_payload));
 
-            std::string l_fulltopic = l_topic;
-            l_fulltopic += "/sensor";
-            l_fulltopic += itoa(l_senidx+1,l_snum,10);
+            if (!l_len || !m_queue.Push(MQTT_QUEUE_DEVICE_TOPIC, l_payload, l_len))
+            {
+                g_AppLogger.Log("Error queueing combined MQTT message");
+            }
+        }
+        else
+        {
+            // --- now loop over all sensors and queue a message
 
-            int l_err = esp_mqtt_client_publish(m_mqtt_hdl, l_fulltopic.c_str(), sys_info,0, 0,0);
-            if (l_err == -1)
+            for (int l_senidx = 0; l_senidx < g_SensorManager.GetSensorCount(); ++l_senidx)
             {
-                g_AppLogger.Log("Error sending MQTT message to topic '%s' to server '%s'",l_fulltopic.c_str(),l_server.c_str());
+                size_t l_len = EncodePayload(m_mqtt_format, l_senidx, l_time, l_payload, sizeof(l_payload));
+
+                if (!l_len || !m_queue.Push(l_senidx, l_payload, l_len))
+                {
+                    g_AppLogger.Log("Error queueing MQTT message of sensor %d",l_senidx+1);
+                }
             }
-            else
+        }
+    }
+
+    // ---- and send what is pending, one batch per call
+
+    m_queue.Drain(m_mqtt_hdl, m_mqtt_topic);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+size_t MqttManager::EncodePayload(int f_format, int f_sensor, double f_time, void *f_buf, size_t f_size)
+{
+    PerfTimer l_timer(PERF_STAGE_MQTT_ENCODE);
+
+    if (f_format == MQTT_FORMAT_CBOR)
+    {
+        // --- same structure as the JSON, written straight into the payload
+
+        CborWriter l_writer((uint8_t *)f_buf, f_size);
+
+        if (f_sensor == MQTT_QUEUE_DEVICE_TOPIC)
+        {
+            l_writer.BeginMap(NULL, 1 + g_SensorManager.GetSensorCount());
+            l_writer.Number("time", f_time);
+
+            for (int l_senidx = 0; l_senidx < g_SensorManager.GetSensorCount(); ++l_senidx)
             {
-                ESP_LOGI(TAG, "Successfully send mqtt message.");
+                char l_name[16];
+                snprintf(l_name, sizeof(l_name), "sensor%d", l_senidx+1);
+
+                CSensor *l_sensor = g_SensorManager.GetSensor(l_senidx);
+
+                l_writer.BeginMap(l_name, l_sensor->GetChannelCount());
+                l_sensor->AddValuesToCBOR_MQTT(l_writer);
             }
+        }
+        else
+        {
+            CSensor *l_sensor = g_SensorManager.GetSensor(f_sensor);
 
-            free((void *)sys_info);
-            cJSON_Delete(root);
+            l_writer.BeginMap(NULL, l_sensor->GetChannelCount() + 1);
+            l_sensor->AddValuesToCBOR_MQTT(l_writer);
+            l_writer.Number("time", f_time);
         }
 
+        return l_writer.Finish() == ESP_OK ? l_writer.GetLength() : 0;
+    }
+
+    // ---- JSON: ask the sensors for the values and write them straight into the payload
+
+    JsonWriter l_writer((char *)f_buf, f_size);
+
+    l_writer.BeginObject();
+
+    if (f_sensor == MQTT_QUEUE_DEVICE_TOPIC)
+    {
+        l_writer.Number("time", f_time);
+
+        for (int l_senidx = 0; l_senidx < g_SensorManager.GetSensorCount(); ++l_senidx)
+        {
+            char l_name[16];
+            snprintf(l_name, sizeof(l_name), "sensor%d", l_senidx+1);
 
+            l_writer.BeginObject(l_name);
+            g_SensorManager.GetSensor(l_senidx)->AddValuesToJSON_MQTT(l_writer);
+            l_writer.EndObject();
+        }
     }
+    else
+    {
+        g_SensorManager.GetSensor(f_sensor)->AddValuesToJSON_MQTT(l_writer);
+        l_writer.Number("time", f_time);
+    }
+
+    l_writer.EndObject();
+
+    return l_writer.Finish() == ESP_OK ? l_writer.GetLength() : 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
 esp_err_t MqttManager::SetupMqtt(void)
 {
-    std::string l_server = g_ConfigManager.GetStringValue(CFMGR_MQTT_SERVER);
+    char l_server[CFMGR_MAX_STRING_LEN + 1];
+    g_ConfigManager.GetStringValue(CFMGR_MQTT_SERVER, l_server, sizeof(l_server));
 
     esp_mqtt_client_config_t mqtt_cfg;
     memset(&mqtt_cfg,0,sizeof(esp_mqtt_client_config_t));
 
-    mqtt_cfg.broker.address.uri = l_server.c_str();
+    mqtt_cfg.broker.address.uri = l_server;
 
     m_mqtt_hdl = esp_mqtt_client_init(&mqtt_cfg);
     if (!m_mqtt_hdl)
     {
-        g_AppLogger.Log("Failed to connect to server '%s'",l_server.c_str());
+        g_AppLogger.Log("Failed to connect to server '%s'",l_server);
 
-        ESP_LOGE(TAG, "Error on esp_mqtt_client_init (%s)", l_server.c_str());
+        ESP_LOGE(TAG, "Error on esp_mqtt_client_init (%s)", l_server);
         return ESP_FAIL;
     }
 
+    // ---- connection state and acks drive the outbound queue
+
+    esp_mqtt_client_register_event(m_mqtt_hdl, MQTT_EVENT_ANY, prvMqttEventHandler, this);
+
     esp_err_t l_ee = esp_mqtt_client_start(m_mqtt_hdl);
     if (l_ee != ESP_OK)
     {
-        g_AppLogger.Log("Failed to connect to server '%s' (%d)",l_server.c_str(),l_ee);
+        g_AppLogger.Log("Failed to connect to server '%s' (%d)",l_server,l_ee);
 
-        ESP_LOGE(TAG, "Error on esp_mqtt_client_start (%s): %d", l_server.c_str(),l_ee);
+        ESP_LOGE(TAG, "Error on esp_mqtt_client_start (%s): %d", l_server,l_ee);
         return l_ee;
     }
 
@@ -192,6 +356,10 @@ void MqttManager::Shutdown(void)
     esp_mqtt_client_destroy(m_mqtt_hdl);
     m_mqtt_hdl = NULL;
 
+    // --- the queue is kept, it is sent to the new server
+
+    m_queue.OnDisconnected();
+
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -201,8 +369,12 @@ void MqttManager::ReadConfig(void)
     // ---- get some flag since we use them frequently
 
     m_mqtt_enabled = g_ConfigManager.GetIntValue(CFMGR_MQTT_ENABLE) == 1;
+    m_mqtt_combined = g_ConfigManager.GetIntValue(CFMGR_MQTT_COMBINED) == 1;
+    m_mqtt_format = g_ConfigManager.GetIntValue(CFMGR_MQTT_FORMAT);
     m_mqtt_delay = g_ConfigManager.GetIntValue(CFMGR_MQTT_TIME);
 
+    g_ConfigManager.GetStringValue(CFMGR_MQTT_TOPIC, m_mqtt_topic, sizeof(m_mqtt_topic));
+
     m_delay_current = m_mqtt_delay;
 }
 
@@ -216,6 +388,26 @@ esp_err_t MqttManager::InitManager(void)
 
     ReadConfig();
 
+    esp_err_t l_err = m_queue.InitQueue();
+    if (l_err != ESP_OK) return l_err;
+
+    // ---- the publisher task lives as long as the firmware, the timer only while MQTT is on
+
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    m_lock = xSemaphoreCreateMutex();
+    if (!m_lock || xTaskCreate(mqtt_publisher_task, "mqtt_pub", MQTT_PUBLISH_TASK_STACK, this, MQTT_PUBLISH_TASK_PRIO, &m_task) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Could not create the publisher task");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // ---- config changes apply right away
+
+    g_ConfigManager.Subscribe(CFMGR_KEY_BIT(CFMGR_MQTT_SERVER) | CFMGR_KEY_BIT(CFMGR_MQTT_TOPIC) | CFMGR_KEY_BIT(CFMGR_MQTT_TIME) |
+                              CFMGR_KEY_BIT(CFMGR_MQTT_ENABLE) | CFMGR_KEY_BIT(CFMGR_MQTT_COMBINED) | CFMGR_KEY_BIT(CFMGR_MQTT_FORMAT),
+                              mqtt_config_changed, this);
+
     // ---- and setup the 
 
     if (m_mqtt_enabled)
@@ -228,12 +420,27 @@ esp_err_t MqttManager::InitManager(void)
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void MqttManager::UpdateConfig(void)
+// --- called by the ConfigManager with the MQTT keys which changed
+
+void MqttManager::UpdateConfig(uint32_t f_changed)
 {
+    // --- the publisher task must not run while the client is replaced
+
+    xSemaphoreTake(m_lock, portMAX_DELAY);
+
     // --- read config vars
 
     ReadConfig();   
 
+    // --- the topic, format and interval are picked up by the next cycle, the client is
+    //     only touched for the server and the switch
+
+    if (!(f_changed & (CFMGR_KEY_BIT(CFMGR_MQTT_SERVER) | CFMGR_KEY_BIT(CFMGR_MQTT_ENABLE))))
+    {
+        xSemaphoreGive(m_lock);
+        return;
+    }
+
     if (m_mqtt_enabled)
     {
         // --- we want MQTT
@@ -270,6 +477,8 @@ void MqttManager::UpdateConfig(void)
             // --- do nothing
         }
     }
+
+    xSemaphoreGive(m_lock);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
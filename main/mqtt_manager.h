@@ -38,9 +38,37 @@
 ////////////////////////////////////////////////////////////////////////////////////////
 
 #include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "freertos/timers.h"
 #include "mqtt_client.h"
 
+#include "mqtt_queue.h"
+#include "config_manager_defines.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the timer only wakes the publisher task, serialization and network I/O never run
+//     on the timer service task
+
+#define MQTT_PUBLISH_TASK_STACK     4096
+#define MQTT_PUBLISH_TASK_PRIO      4
+
+// --- payload encoding (config value CFMGR_MQTT_FORMAT)
+
+#define MQTT_FORMAT_JSON            0
+#define MQTT_FORMAT_CBOR            1
+
+typedef struct MqttPublishStats_s
+{
+    uint32_t    m_Cycles;
+    uint32_t    m_LastLatencyUs;    // --- timer expiry until the publisher task runs
+    uint32_t    m_MaxLatencyUs;
+    uint32_t    m_LastDurationUs;   // --- serialization, queueing and sending of one cycle
+    uint32_t    m_MaxDurationUs;
+} MqttPublishStats;
+
 ////////////////////////////////////////////////////////////////////////////////////////
 
 class MqttManager
@@ -49,21 +77,45 @@ class MqttManager
 public:
     esp_err_t InitManager(void);
 
-    void UpdateConfig(void);
-    void ProcessCallback(void);
+    void UpdateConfig(uint32_t f_changed);
+    void ProcessEvent(esp_mqtt_event_handle_t f_event);
+
+    void GetQueueStats(MqttQueueStats *f_stats) { m_queue.GetStats(f_stats); }
+    void GetPublishStats(MqttPublishStats *f_stats);
+
+    // --- payload of one sensor or, with MQTT_QUEUE_DEVICE_TOPIC, the combined message.
+    //     Returns the length (JSON without terminator), 0 if the buffer is too small.
+
+    size_t EncodePayload(int f_format, int f_sensor, double f_time, void *f_buf, size_t f_size);
+
+    // --- internal functions do not use
+
+    void NotifyPublisher(void);
+    void PublisherLoop(void);
 
 private:
 
     esp_err_t SetupMqtt(void);
     void Shutdown(void);
     void ReadConfig(void);
+    void ProcessCallback(void);
 
     TimerHandle_t   m_timer;
     bool            m_mqtt_enabled;
+    bool            m_mqtt_combined;
+    int             m_mqtt_format;
     int             m_mqtt_delay;
     int             m_delay_current;
+    char            m_mqtt_topic[CFMGR_MAX_STRING_LEN + 1];
 
     esp_mqtt_client_handle_t m_mqtt_hdl = NULL;
+    MqttQueue       m_queue;
+
+    TaskHandle_t        m_task = NULL;
+    SemaphoreHandle_t   m_lock = NULL;      // --- client setup/shutdown vs. publisher task
+
+    MqttPublishStats    m_stats;
+    portMUX_TYPE        m_stats_lock = portMUX_INITIALIZER_UNLOCKED;
 
 };
 
@@ -0,0 +1,354 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <string>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "mqtt_client.h"
+
+#include "mqtt_queue.h"
+#include "applogger.h"
+#include "perf_metrics.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *TAG = "MqttQueue";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t MqttQueue::InitQueue(void)
+{
+    if (m_Mutex) return ESP_OK;
+
+    m_Mutex = xSemaphoreCreateMutex();
+    if (!m_Mutex)
+    {
+        ESP_LOGE(TAG, "MqttQueue::InitQueue / no memory");
+        return ESP_ERR_NO_MEM;
+    }
+
+    m_Head          = 0;
+    m_Count         = 0;
+    m_BatchCount    = 0;
+    m_BatchStartUs  = 0;
+    m_BatchGen      = 0;
+    m_EarlyAckCnt   = 0;
+    m_Connected     = false;
+    m_Overflow      = false;
+
+    memset(&m_Stats, 0, sizeof(m_Stats));
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool MqttQueue::Push(int f_sensor, const void *f_payload, size_t f_len)
+{
+    if (!m_Mutex || f_len == 0 || f_len > MQTT_QUEUE_PAYLOAD_SIZE) return false;
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    // --- queue full: the oldest message goes, even when it is in flight
+
+    if (m_Count == MQTT_QUEUE_ENTRIES)
+    {
+        if (m_BatchCount > 0)
+        {
+            m_BatchCount--;
+            m_BatchGen++;
+        }
+
+        m_Head = (m_Head + 1) % MQTT_QUEUE_ENTRIES;
+        m_Count--;
+        m_Stats.m_Dropped++;
+
+        if (!m_Overflow)
+        {
+            m_Overflow = true;
+            g_AppLogger.Log("MQTT queue full, dropping the oldest messages");
+        }
+    }
+
+    Entry &l_entry = At(m_Count);
+
+    l_entry.m_MsgId     = 0;
+    l_entry.m_Acked     = false;
+    l_entry.m_Sensor    = f_sensor;
+    l_entry.m_Len       = f_len;
+    memcpy(l_entry.m_Payload, f_payload, f_len);
+
+    m_Count++;
+    m_Stats.m_Queued++;
+
+    if (m_Count > m_Stats.m_MaxDepth) m_Stats.m_MaxDepth = m_Count;
+
+    xSemaphoreGive(m_Mutex);
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- send the next batch once the previous one is acknowledged. Publishing is done
+//     without holding the lock: the client task delivers the acks and takes the lock
+//     in OnPublished() while it may hold its own API lock.
+
+void MqttQueue::Drain(esp_mqtt_client_handle_t f_client, const char *f_topic)
+{
+    if (!m_Mutex || !f_client) return;
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    PopAcked();
+
+    if (!m_Connected || m_Count == 0)
+    {
+        xSemaphoreGive(m_Mutex);
+        return;
+    }
+
+    if (m_BatchCount > 0)
+    {
+        if (esp_timer_get_time() - m_BatchStartUs < MQTT_QUEUE_ACK_TIMEOUT_MS * 1000LL)
+        {
+            xSemaphoreGive(m_Mutex);
+            return;
+        }
+
+        // --- no ack in time: send the messages of the batch which are not acknowledged
+        //     again, the others stay until the head of the queue is acknowledged
+
+        for (int i = 0; i < m_BatchCount; ++i)
+        {
+            if (!At(i).m_Acked) m_Stats.m_Retries++;
+        }
+
+        ESP_LOGW(TAG, "MqttQueue::Drain / ack timeout, repeating batch");
+        ResetBatch();
+    }
+
+    int      l_cnt  = m_Count < MQTT_QUEUE_BATCH_SIZE ? m_Count : MQTT_QUEUE_BATCH_SIZE;
+    uint32_t l_gen  = ++m_BatchGen;
+
+    m_BatchCount    = l_cnt;
+    m_BatchStartUs  = esp_timer_get_time();
+    m_EarlyAckCnt   = 0;
+
+    xSemaphoreGive(m_Mutex);
+
+    for (int i = 0; i < l_cnt; ++i)
+    {
+        // --- copy the entry, it may be overwritten while we publish
+
+        xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+        if (l_gen != m_BatchGen)
+        {
+            xSemaphoreGive(m_Mutex);
+            break;
+        }
+
+        if (At(i).m_Acked)
+        {
+            xSemaphoreGive(m_Mutex);
+            continue;
+        }
+
+        int l_sensor = At(i).m_Sensor;
+        int l_len    = At(i).m_Len;
+        memcpy(m_SendBuf, At(i).m_Payload, l_len);
+
+        xSemaphoreGive(m_Mutex);
+
+        std::string l_fulltopic = f_topic;
+
+        if (l_sensor != MQTT_QUEUE_DEVICE_TOPIC)
+        {
+            char l_snum[5];
+
+            l_fulltopic += "/sensor";
+            l_fulltopic += itoa(l_sensor+1,l_snum,10);
+        }
+
+        int64_t l_start  = esp_timer_get_time();
+        int     l_msg_id = esp_mqtt_client_publish(f_client, l_fulltopic.c_str(), m_SendBuf, l_len, 1, 0);
+
+        g_PerfMetrics.Record(PERF_STAGE_MQTT_PUBLISH, (uint32_t)(esp_timer_get_time() - l_start));
+
+        xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+        if (l_gen != m_BatchGen)
+        {
+            xSemaphoreGive(m_Mutex);
+            break;
+        }
+
+        if (l_msg_id <= 0)
+        {
+            // --- not connected (anymore), the rest stays queued
+
+            m_BatchCount = i;
+            xSemaphoreGive(m_Mutex);
+            break;
+        }
+
+        Entry &l_entry = At(i);
+
+        l_entry.m_MsgId = l_msg_id;
+        m_Stats.m_Sent++;
+
+        // --- the ack may have been faster than we are
+
+        for (int a = 0; a < m_EarlyAckCnt; ++a)
+        {
+            if (m_EarlyAcks[a] == l_msg_id) l_entry.m_Acked = true;
+        }
+
+        xSemaphoreGive(m_Mutex);
+    }
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+    PopAcked();
+    xSemaphoreGive(m_Mutex);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void MqttQueue::OnConnected(void)
+{
+    if (!m_Mutex) return;
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    m_Connected = true;
+    m_Overflow  = false;
+
+    if (m_Count) g_AppLogger.Log("MQTT connected, replaying %d queued messages", m_Count);
+
+    xSemaphoreGive(m_Mutex);
+}
+
+void MqttQueue::OnDisconnected(void)
+{
+    if (!m_Mutex) return;
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    // --- messages in flight are sent again after the reconnect (QoS 1: at least once)
+
+    m_Connected = false;
+    ResetBatch();
+
+    xSemaphoreGive(m_Mutex);
+}
+
+void MqttQueue::OnPublished(int f_msg_id)
+{
+    if (!m_Mutex) return;
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    bool l_found = false;
+
+    for (int i = 0; i < m_BatchCount && !l_found; ++i)
+    {
+        if (At(i).m_MsgId == f_msg_id)
+        {
+            At(i).m_Acked = true;
+            l_found = true;
+        }
+    }
+
+    if (!l_found && m_EarlyAckCnt < MQTT_QUEUE_BATCH_SIZE)
+    {
+        m_EarlyAcks[m_EarlyAckCnt++] = f_msg_id;
+    }
+
+    xSemaphoreGive(m_Mutex);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void MqttQueue::GetStats(MqttQueueStats *f_stats)
+{
+    if (!m_Mutex)
+    {
+        memset(f_stats, 0, sizeof(MqttQueueStats));
+        return;
+    }
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    *f_stats         = m_Stats;
+    f_stats->m_Depth = m_Count;
+
+    xSemaphoreGive(m_Mutex);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- remove acknowledged messages from the head. Caller holds the lock. Only Drain()
+//     does this, so the batch indices stay valid while it publishes.
+
+void MqttQueue::PopAcked(void)
+{
+    while (m_BatchCount > 0 && At(0).m_Acked)
+    {
+        m_Head = (m_Head + 1) % MQTT_QUEUE_ENTRIES;
+        m_Count--;
+        m_BatchCount--;
+        m_Stats.m_Acked++;
+    }
+}
+
+// --- forget the batch in flight. Messages the broker acknowledged keep their flag, the
+//     next batch skips them. Caller holds the lock.
+
+void MqttQueue::ResetBatch(void)
+{
+    for (int i = 0; i < m_BatchCount; ++i)
+    {
+        At(i).m_MsgId = 0;
+    }
+
+    m_BatchCount = 0;
+    m_BatchGen++;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
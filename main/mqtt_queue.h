@@ -0,0 +1,129 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MQTT_QUEUE_H_
+#define	MQTT_QUEUE_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+#include "mqtt_client.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- outbound store-and-forward queue. Every message is queued first and published
+//     with QoS 1 in batches; an entry is removed only after the broker acknowledged it.
+//     During an outage the queue keeps the newest MQTT_QUEUE_ENTRIES messages.
+
+#define MQTT_QUEUE_ENTRIES              48
+#define MQTT_QUEUE_PAYLOAD_SIZE         512         // --- JSON (incl. terminator) or CBOR
+#define MQTT_QUEUE_DEVICE_TOPIC         -1          // --- sensor index of combined messages
+#define MQTT_QUEUE_BATCH_SIZE           8           // --- messages in flight at most
+#define MQTT_QUEUE_ACK_TIMEOUT_MS       10000       // --- unacknowledged messages are sent again
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct MqttQueueStats_s
+{
+    uint32_t    m_Queued;
+    uint32_t    m_Sent;             // --- publish calls incl. repetitions
+    uint32_t    m_Acked;
+    uint32_t    m_Dropped;          // --- oldest messages overwritten while the queue was full
+    uint32_t    m_Retries;
+    uint16_t    m_Depth;
+    uint16_t    m_MaxDepth;
+} MqttQueueStats;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class MqttQueue
+{
+public:
+
+    // --- action functions
+
+    esp_err_t InitQueue(void);
+    bool Push(int f_sensor, const void *f_payload, size_t f_len);
+    void Drain(esp_mqtt_client_handle_t f_client, const char *f_topic);
+
+    // --- events of the MQTT client
+
+    void OnConnected(void);
+    void OnDisconnected(void);
+    void OnPublished(int f_msg_id);
+
+    // --- getters
+
+    void GetStats(MqttQueueStats *f_stats);
+
+private:
+
+    struct Entry
+    {
+        int         m_MsgId;        // --- 0: not sent yet
+        bool        m_Acked;
+        int16_t     m_Sensor;       // --- MQTT_QUEUE_DEVICE_TOPIC: sent to the base topic
+        uint16_t    m_Len;
+        char        m_Payload[MQTT_QUEUE_PAYLOAD_SIZE];
+    };
+
+    Entry &At(int f_idx) { return m_Entries[(m_Head + f_idx) % MQTT_QUEUE_ENTRIES]; }
+    void PopAcked(void);
+    void ResetBatch(void);
+
+    Entry               m_Entries[MQTT_QUEUE_ENTRIES];
+    int                 m_Head;             // --- oldest entry
+    int                 m_Count;
+
+    int                 m_BatchCount;       // --- entries at the head which are in flight
+    int64_t             m_BatchStartUs;
+    uint32_t            m_BatchGen;         // --- changes whenever the batch is reset or shifted
+    int                 m_EarlyAcks[MQTT_QUEUE_BATCH_SIZE];
+    int                 m_EarlyAckCnt;
+    char                m_SendBuf[MQTT_QUEUE_PAYLOAD_SIZE];     // --- only used by Drain()
+    bool                m_Connected;
+    bool                m_Overflow;         // --- logged once per outage
+
+    MqttQueueStats      m_Stats;
+    SemaphoreHandle_t   m_Mutex = NULL;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
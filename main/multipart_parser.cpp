@@ -0,0 +1,233 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <strings.h>
+
+#include "esp_log.h"
+
+#include "multipart_parser.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *TAG = "Multipart";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t MultipartParser::InitParser(const char *f_content_type, multipart_data_cb_t f_cb, void *f_ctx)
+{
+    m_Callback      = f_cb;
+    m_Ctx           = f_ctx;
+    m_State         = STATE_ERROR;
+
+    // --- boundary=xyz or boundary="xyz", up to the next ';'
+
+    const char *l_boundary = f_content_type ? strcasestr(f_content_type, "boundary=") : NULL;
+    if (!l_boundary)
+    {
+        ESP_LOGE(TAG, "No boundary in the content type");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    l_boundary += 9;
+
+    size_t l_len;
+
+    if (*l_boundary == '"')
+    {
+        l_boundary++;
+        l_len = strcspn(l_boundary, "\"");
+    }
+    else
+    {
+        l_len = strcspn(l_boundary, "; \t");
+    }
+
+    if (l_len == 0 || l_len > MULTIPART_MAX_BOUNDARY)
+    {
+        ESP_LOGE(TAG, "Invalid boundary");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(m_Delimiter, "\r\n--", 4);
+    memcpy(m_Delimiter + 4, l_boundary, l_len);
+    m_DelimiterLen = l_len + 4;
+
+    // --- the first delimiter has no CRLF in front, as if the preamble ended with one
+
+    m_State         = STATE_BODY;
+    m_Part          = -1;
+    m_Match         = 2;
+    m_HeaderMatch   = 0;
+    m_HeaderLen     = 0;
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t MultipartParser::Emit(const char *f_data, size_t f_len)
+{
+    if (m_Part != 0 || f_len == 0) return ESP_OK;
+
+    return m_Callback(m_Ctx, f_data, f_len);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the delimiter starts with the only CR in it: after a mismatch no suffix of the
+//     matched bytes can be the start of a delimiter, so the search restarts at the
+//     current byte without any backtracking
+
+esp_err_t MultipartParser::Parse(const char *f_data, size_t f_len)
+{
+    if (m_State == STATE_ERROR) return ESP_FAIL;
+
+    size_t  l_run   = 0;            // --- start of the body bytes not passed on yet
+    size_t  l_held  = m_Match;      // --- delimiter bytes matched in the previous buffer
+
+    for (size_t i = 0; i < f_len; ++i)
+    {
+        char l_c = f_data[i];
+
+        switch (m_State)
+        {
+            case STATE_BODY:
+
+                if (l_c == m_Delimiter[m_Match])
+                {
+                    if (++m_Match < m_DelimiterLen) break;
+
+                    // --- the body ends in front of the delimiter
+
+                    size_t l_end = i + 1 - (m_Match - l_held);
+
+                    if (l_end > l_run && Emit(f_data + l_run, l_end - l_run) != ESP_OK)
+                    {
+                        m_State = STATE_ERROR;
+                        return ESP_FAIL;
+                    }
+
+                    m_Match     = 0;
+                    l_held      = 0;
+                    m_State     = STATE_BOUNDARY_END;
+                    m_BoundaryEnd = 0;
+                    break;
+                }
+
+                // --- the bytes held back were body after all
+
+                if (l_held && Emit(m_Delimiter, l_held) != ESP_OK)
+                {
+                    m_State = STATE_ERROR;
+                    return ESP_FAIL;
+                }
+
+                l_held  = 0;
+                m_Match = (l_c == m_Delimiter[0]) ? 1 : 0;
+                break;
+
+            case STATE_BOUNDARY_END:
+
+                // --- "--" closes the body, CRLF starts the next part (whitespace is padding)
+
+                if (m_BoundaryEnd == 0)
+                {
+                    if (l_c == '-' || l_c == '\r') m_BoundaryEnd = l_c;
+                    else if (l_c != ' ' && l_c != '\t') m_State = STATE_ERROR;
+                }
+                else if (m_BoundaryEnd == '-' && l_c == '-')
+                {
+                    m_State = STATE_DONE;
+                }
+                else if (m_BoundaryEnd == '\r' && l_c == '\n')
+                {
+                    m_State         = STATE_HEADERS;
+                    m_HeaderMatch   = 2;        // --- a part without headers starts with CRLF
+                    m_HeaderLen     = 0;
+                }
+                else
+                {
+                    m_State = STATE_ERROR;
+                }
+
+                if (m_State == STATE_ERROR)
+                {
+                    ESP_LOGE(TAG, "Malformed boundary");
+                    return ESP_FAIL;
+                }
+                break;
+
+            case STATE_HEADERS:
+
+                if (l_c == (m_HeaderMatch & 1 ? '\n' : '\r')) m_HeaderMatch++;
+                else m_HeaderMatch = (l_c == '\r') ? 1 : 0;
+
+                if (m_HeaderMatch == 4)
+                {
+                    m_State = STATE_BODY;
+                    m_Part++;
+                    l_run   = i + 1;
+                }
+                else if (++m_HeaderLen > MULTIPART_MAX_HEADERS)
+                {
+                    ESP_LOGE(TAG, "Part headers too long");
+                    m_State = STATE_ERROR;
+                    return ESP_FAIL;
+                }
+                break;
+
+            case STATE_DONE:
+            case STATE_ERROR:
+                return m_State == STATE_DONE ? ESP_OK : ESP_FAIL;
+        }
+    }
+
+    // --- pass on the body up to a possible start of a delimiter
+
+    if (m_State == STATE_BODY)
+    {
+        size_t l_end = f_len - (m_Match - l_held);
+
+        if (l_end > l_run && Emit(f_data + l_run, l_end - l_run) != ESP_OK)
+        {
+            m_State = STATE_ERROR;
+            return ESP_FAIL;
+        }
+    }
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,105 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MULTIPART_PARSER_H_
+#define	MULTIPART_PARSER_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- incremental parser of a multipart/form-data body (RFC 7578) as it is received.
+//     The body of the first part is passed to the callback in pieces which point into
+//     the buffer given to Parse(), so nothing is copied. Only the bytes which might be the
+//     start of a boundary at the end of a buffer are held back until the next one.
+//     Further parts and the headers are skipped.
+
+#define MULTIPART_MAX_BOUNDARY          70          // --- RFC 2046
+#define MULTIPART_MAX_HEADERS           1024        // --- of one part
+
+typedef esp_err_t (*multipart_data_cb_t)(void *f_ctx, const char *f_data, size_t f_len);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class MultipartParser
+{
+public:
+
+    // --- f_content_type: the Content-Type header, which carries the boundary
+
+    esp_err_t InitParser(const char *f_content_type, multipart_data_cb_t f_cb, void *f_ctx);
+
+    // --- action functions
+
+    esp_err_t Parse(const char *f_data, size_t f_len);
+
+    // --- getters
+
+    bool IsDone(void) { return m_State == STATE_DONE; }     // --- the closing boundary was seen
+
+private:
+
+    typedef enum
+    {
+        STATE_BODY = 0,             // --- looking for the next delimiter, part -1 is the preamble
+        STATE_BOUNDARY_END,         // --- after the boundary: "--" or CRLF
+        STATE_HEADERS,              // --- looking for the empty line
+        STATE_DONE,
+        STATE_ERROR
+    } state_t;
+
+    esp_err_t Emit(const char *f_data, size_t f_len);
+
+    multipart_data_cb_t m_Callback;
+    void                *m_Ctx;
+
+    char                m_Delimiter[MULTIPART_MAX_BOUNDARY + 5];    // --- CRLF "--" boundary
+    size_t              m_DelimiterLen;
+
+    state_t             m_State;
+    int                 m_Part;
+    size_t              m_Match;            // --- bytes of the delimiter matched, possibly in the previous buffer
+    int                 m_HeaderMatch;      // --- of CRLF CRLF
+    size_t              m_HeaderLen;
+    char                m_BoundaryEnd;      // --- first character after the boundary
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
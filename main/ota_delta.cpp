@@ -0,0 +1,156 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "esp_log.h"
+
+#include "ota_delta.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *TAG = "OtaDelta";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void OtaDeltaParser::InitParser(ota_delta_data_cb_t f_data_cb, ota_delta_copy_cb_t f_copy_cb, void *f_ctx)
+{
+    m_DataCallback  = f_data_cb;
+    m_CopyCallback  = f_copy_cb;
+    m_Ctx           = f_ctx;
+
+    m_State         = STATE_HEADER;
+    m_ArgsLen       = 0;
+    m_ArgsNeeded    = OTA_DELTA_HEADER_SIZE;
+    m_ImageSize     = 0;
+    m_Produced      = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t OtaDeltaParser::Parse(const char *f_data, size_t f_len)
+{
+    size_t l_pos = 0;
+
+    while (l_pos < f_len && m_State != STATE_ERROR)
+    {
+        switch (m_State)
+        {
+            case STATE_HEADER:
+            case STATE_ARGS:
+            {
+                size_t l_copy = m_ArgsNeeded - m_ArgsLen;
+                if (l_copy > f_len - l_pos) l_copy = f_len - l_pos;
+
+                memcpy(m_Args + m_ArgsLen, f_data + l_pos, l_copy);
+                m_ArgsLen += l_copy;
+                l_pos     += l_copy;
+
+                if (m_ArgsLen < m_ArgsNeeded) break;
+
+                if (m_State == STATE_HEADER)
+                {
+                    if (memcmp(m_Args, OTA_DELTA_MAGIC, 4) != 0 || m_Args[4] != OTA_DELTA_VERSION)
+                    {
+                        ESP_LOGE(TAG, "Not a delta image");
+                        m_State = STATE_ERROR;
+                        break;
+                    }
+
+                    m_ImageSize = GetU32(m_Args + 8);
+                    m_State     = STATE_OP;
+                }
+                else if (m_Op == OTA_DELTA_OP_COPY)
+                {
+                    uint32_t l_len = GetU32(m_Args + 4);
+
+                    m_State     = m_CopyCallback(m_Ctx, GetU32(m_Args), l_len) == ESP_OK ? STATE_OP : STATE_ERROR;
+                    m_Produced += l_len;
+                }
+                else
+                {
+                    m_DataLeft  = GetU32(m_Args);
+                    m_State     = m_DataLeft ? STATE_DATA : STATE_OP;
+                }
+                break;
+            }
+
+            case STATE_OP:
+
+                m_Op        = f_data[l_pos++];
+                m_ArgsLen   = 0;
+
+                if (m_Op == OTA_DELTA_OP_COPY)          { m_ArgsNeeded = 8; m_State = STATE_ARGS; }
+                else if (m_Op == OTA_DELTA_OP_DATA)     { m_ArgsNeeded = 4; m_State = STATE_ARGS; }
+                else if (m_Op == OTA_DELTA_OP_END)      { m_State = m_Produced == m_ImageSize ? STATE_DONE : STATE_ERROR; }
+                else                                    { m_State = STATE_ERROR; }
+
+                if (m_State == STATE_ERROR) ESP_LOGE(TAG, "Invalid operation or image size");
+                break;
+
+            case STATE_DATA:
+            {
+                size_t l_len = m_DataLeft;
+                if (l_len > f_len - l_pos) l_len = f_len - l_pos;
+
+                if (m_DataCallback(m_Ctx, f_data + l_pos, l_len) != ESP_OK)
+                {
+                    m_State = STATE_ERROR;
+                    break;
+                }
+
+                l_pos       += l_len;
+                m_DataLeft  -= l_len;
+                m_Produced  += l_len;
+
+                if (!m_DataLeft) m_State = STATE_OP;
+                break;
+            }
+
+            case STATE_DONE:
+
+                // --- nothing may follow the end
+
+                m_State = STATE_ERROR;
+                break;
+
+            case STATE_ERROR:
+                break;
+        }
+    }
+
+    return m_State == STATE_ERROR ? ESP_FAIL : ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,118 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef OTA_DELTA_H_
+#define	OTA_DELTA_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- delta images: the new image is rebuilt from ranges of the running partition and
+//     new bytes. All numbers are little endian.
+//
+//       header     "ESPD", version (1 byte), 3 reserved bytes, size of the new image (u32)
+//       'C'        offset (u32), length (u32)    copy from the running partition
+//       'D'        length (u32), bytes           new data
+//       'E'                                      end
+//
+//     The host build contains the generator (ota_delta).
+
+#define OTA_DELTA_MAGIC                 "ESPD"
+#define OTA_DELTA_VERSION               1
+#define OTA_DELTA_HEADER_SIZE           12
+
+#define OTA_DELTA_OP_COPY               'C'
+#define OTA_DELTA_OP_DATA               'D'
+#define OTA_DELTA_OP_END                'E'
+
+typedef esp_err_t (*ota_delta_data_cb_t)(void *f_ctx, const char *f_data, size_t f_len);
+typedef esp_err_t (*ota_delta_copy_cb_t)(void *f_ctx, uint32_t f_offset, uint32_t f_len);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- parses a delta as it is downloaded. New data is passed on pointing into the
+//     buffer given to Parse(), so it is not copied.
+
+class OtaDeltaParser
+{
+public:
+
+    void InitParser(ota_delta_data_cb_t f_data_cb, ota_delta_copy_cb_t f_copy_cb, void *f_ctx);
+
+    // --- action functions
+
+    esp_err_t Parse(const char *f_data, size_t f_len);
+
+    // --- getters
+
+    bool IsDone(void) { return m_State == STATE_DONE; }
+    uint32_t GetImageSize(void) { return m_ImageSize; }
+
+private:
+
+    typedef enum
+    {
+        STATE_HEADER = 0,
+        STATE_OP,
+        STATE_ARGS,                 // --- collecting the numbers of an operation
+        STATE_DATA,
+        STATE_DONE,
+        STATE_ERROR
+    } state_t;
+
+    static uint32_t GetU32(const uint8_t *f_p) { return f_p[0] | (f_p[1] << 8) | (f_p[2] << 16) | ((uint32_t)f_p[3] << 24); }
+
+    ota_delta_data_cb_t m_DataCallback;
+    ota_delta_copy_cb_t m_CopyCallback;
+    void                *m_Ctx;
+
+    state_t             m_State;
+    char                m_Op;
+    uint8_t             m_Args[OTA_DELTA_HEADER_SIZE];
+    size_t              m_ArgsLen;
+    size_t              m_ArgsNeeded;
+    uint32_t            m_DataLeft;
+    uint32_t            m_ImageSize;
+    uint32_t            m_Produced;     // --- bytes of the new image so far
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -36,15 +36,27 @@
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
+#include <ctype.h>
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "driver/uart.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_system.h"
 #include "esp_ota_ops.h"
 #include "esp_app_format.h"
+#include "esp_app_desc.h"
+#include "esp_http_client.h"
+#include "esp_crt_bundle.h"
+#include "cJSON.h"
 
-#include "OTA_manager.h"
+#include "ota_manager.h"
+#include "ota_delta.h"
 #include "applogger.h"
+#include "config_manager.h"
+#include "config_manager_defines.h"
+#include "sample_journal.h"
+#include "perf_metrics.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -68,14 +80,67 @@ void OTAManager::logOTAInfo(void)
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-bool OTAManager::StartOTATransfer(void)
+static void ota_writer_task(void *f_param)
+{
+    ((OTAManager *)f_param)->WriterLoop();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool OTAManager::CreateQueues(void)
+{
+    if (!m_Jobs)
+    {
+        m_Jobs          = xQueueCreate(OTA_JOB_QUEUE_LEN, sizeof(Job));
+        m_FreeBuffers   = xQueueCreate(OTA_BUFFER_CNT, sizeof(char *));
+        m_WriterDone    = xSemaphoreCreateBinary();
+        m_Busy          = xSemaphoreCreateBinary();
+
+        if (!m_Jobs || !m_FreeBuffers || !m_WriterDone || !m_Busy)
+        {
+            ESP_LOGE(TAG, "No memory for the OTA queues");
+            m_Jobs = NULL;
+            return false;
+        }
+
+        xSemaphoreGive(m_Busy);
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool OTAManager::StartOTATransfer(const uint8_t *f_sha256)
 {   
+    if (!CreateQueues()) return false;
+
+    // --- an upload and a pulled update must not write the partition at the same time
+
+    if (xSemaphoreTake(m_Busy, 0) != pdTRUE)
+    {
+        g_AppLogger.Log("OTA Update: another update is in progress");
+        return false;
+    }
+
     // --- reset our byte counter
 
     m_DataRead                 = 0;
     m_image_header_was_checked = false;
-    m_imageheader_ptr          = m_imageheader;
+    m_imageheader_len          = 0;
     m_update_handle            = 0;
+    m_Failed                   = false;
+    m_WriteUs                  = 0;
+    m_WaitUs                   = 0;
+    m_StartUs                  = esp_timer_get_time();
+    m_CheckSha256              = f_sha256 != NULL;
+    m_Pulled                   = false;
+    m_SameVersion              = false;
+
+    if (f_sha256) memcpy(m_ExpectedSha256, f_sha256, OTA_SHA256_SIZE);
+
+    mbedtls_sha256_init(&m_Sha256);
+    mbedtls_sha256_starts(&m_Sha256, 0);
 
     // --- get some current partition info
 
@@ -85,125 +150,206 @@ bool OTAManager::StartOTATransfer(void)
     g_AppLogger.Log("OTA Update: running partition %s",m_running->label);
     g_AppLogger.Log("            update partition %s",m_update_partition->label);
 
+    // --- the receive buffers come from the web server pool
+
+    for (int i = 0; i < OTA_BUFFER_CNT; ++i)
+    {
+        m_Buffers[i] = g_BufferPool.Acquire(pdMS_TO_TICKS(1000));
+
+        if (!m_Buffers[i])
+        {
+            while (--i >= 0) g_BufferPool.Release(m_Buffers[i]);
+
+            xQueueReset(m_FreeBuffers);
+            mbedtls_sha256_free(&m_Sha256);
+            xSemaphoreGive(m_Busy);
+            return false;
+        }
+
+        xQueueSend(m_FreeBuffers, &m_Buffers[i], 0);
+    }
+
+    if (xTaskCreate(ota_writer_task, "ota_writer", OTA_WRITER_STACK, this, OTA_WRITER_PRIO, NULL) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Could not create the writer task");
+
+        xQueueReset(m_FreeBuffers);
+        for (int i = 0; i < OTA_BUFFER_CNT; ++i) g_BufferPool.Release(m_Buffers[i]);
+
+        mbedtls_sha256_free(&m_Sha256);
+        xSemaphoreGive(m_Busy);
+        return false;
+    }
+
     return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-bool OTAManager::AddOTAChunk(char *f_bytes, int f_Length)
+char *OTAManager::GetBuffer(void)
 {
-    //ESP_LOG_BUFFER_HEXDUMP(TAG,f_bytes,f_Length,ESP_LOG_INFO);
+    char    *l_buf;
+    int64_t l_start = esp_timer_get_time();
 
-    // ---- check the header of the image first
+    xQueueReceive(m_FreeBuffers, &l_buf, portMAX_DELAY);
 
-    if (m_image_header_was_checked == false) 
-    {
-        // --- copy the chunk into our image header buffer. It might be that the 
-        //     first chunk is smaller than the image header, so we got to assemble it (this is 'wrong' in the IDF
-        //     OTA example)
+    m_WaitUs += esp_timer_get_time() - l_start;
 
-        // --- ensure that we do not write past the image header buffer 
+    return l_buf;
+}
 
-        int l_bytes_left_in_buf = sizeof(m_imageheader) - m_DataRead;
+bool OTAManager::AddOTAChunk(const char *f_bytes, int f_Length)
+{
+    if (m_Failed) return false;
 
-        int l_maxcopy = f_Length;
-        if (f_Length>l_bytes_left_in_buf) l_maxcopy = l_bytes_left_in_buf;
+    Job l_job = { f_bytes, f_Length, NULL };
+    xQueueSend(m_Jobs, &l_job, portMAX_DELAY);
 
-        // --- copy the next chunk to the image header buffer
+    return true;
+}
 
-        ESP_LOGI(TAG,"length %d data read %d left in buf %d maxcopy %d m_imageheader_ptr %p",f_Length,m_DataRead,l_bytes_left_in_buf,l_maxcopy,m_imageheader_ptr);
+void OTAManager::ReleaseBuffer(char *f_buf)
+{
+    Job l_job = { NULL, 0, f_buf };
+    xQueueSend(m_Jobs, &l_job, portMAX_DELAY);
+}
 
-        memcpy(m_imageheader_ptr,f_bytes,l_maxcopy);
-        m_imageheader_ptr += l_maxcopy;
+////////////////////////////////////////////////////////////////////////////////////////
 
-        // --- do we have enough bytes for the image header?
+// --- all buffers have to be released before
 
-        if (m_DataRead+f_Length >= sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t) + sizeof(esp_app_desc_t))
-        {
+bool OTAManager::EndOTATransfer(void)
+{
+    Job l_job = { NULL, 0, NULL };
+    xQueueSend(m_Jobs, &l_job, portMAX_DELAY);
 
-            // --- check if this is a valid image
+    xSemaphoreTake(m_WriterDone, portMAX_DELAY);
 
-            if (((esp_image_header_t *)m_imageheader)->magic != ESP_IMAGE_HEADER_MAGIC)
-            {
-                g_AppLogger.Log("Invalid image provided in firmware upgrade");
-                return false;                
-            }
+    xQueueReset(m_FreeBuffers);
+    for (int i = 0; i < OTA_BUFFER_CNT; ++i) g_BufferPool.Release(m_Buffers[i]);
 
-            // --- extract the app info from the image
+    uint8_t l_sha256[OTA_SHA256_SIZE];
 
-            esp_app_desc_t new_app_info;
-            memcpy(&new_app_info, m_imageheader + sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t), sizeof(esp_app_desc_t));
+    mbedtls_sha256_finish(&m_Sha256, l_sha256);
+    mbedtls_sha256_free(&m_Sha256);
 
-            // --- check firmware versions
+    if (!m_Failed && m_CheckSha256 && memcmp(l_sha256, m_ExpectedSha256, OTA_SHA256_SIZE) != 0)
+    {
+        g_AppLogger.Log("Firmware image does not match its SHA-256, update discarded");
+        m_Failed = true;
+    }
 
-            ESP_LOGI(TAG, "New firmware version: %s", new_app_info.version);
+    if (m_Failed || !m_image_header_was_checked)
+    {
+        if (m_update_handle) esp_ota_abort(m_update_handle);
+        m_update_handle = 0;
 
-            esp_app_desc_t running_app_info;
-            if (esp_ota_get_partition_description(m_running, &running_app_info) == ESP_OK) 
-            {
-                ESP_LOGI(TAG, "Running firmware version: %s", running_app_info.version);
-            }
+        xSemaphoreGive(m_Busy);
+        return false;
+    }
 
-            const esp_partition_t* last_invalid_app = esp_ota_get_last_invalid_partition();
-            esp_app_desc_t invalid_app_info;
-            if (esp_ota_get_partition_description(last_invalid_app, &invalid_app_info) == ESP_OK) 
-            {
-                ESP_LOGI(TAG, "Last invalid firmware version: %s", invalid_app_info.version);
-            }
+    double l_secs = (esp_timer_get_time() - m_StartUs) / 1000000.0;
 
-            // --- check provided version with last invalid partition
+    g_AppLogger.Log("Firmware received: %d KB in %.1fs (%.0f KB/s), flash writes %.1fs, waited for flash %.1fs",
+                    m_DataRead / 1024, l_secs, l_secs > 0 ? m_DataRead / 1024.0 / l_secs : 0.0, m_WriteUs / 1000000.0, m_WaitUs / 1000000.0);
 
-            if (last_invalid_app != NULL) 
-            {
-                if (memcmp(invalid_app_info.version, new_app_info.version, sizeof(new_app_info.version)) == 0) 
-                {
-                    ESP_LOGW(TAG, "New version is the same as invalid version.");
-                    ESP_LOGW(TAG, "Previously, there was an attempt to launch the firmware with %s version, but it failed.", invalid_app_info.version);
-                    ESP_LOGW(TAG, "The firmware has been rolled back to the previous version.");
+    return true;
+}
 
-                    return false;
-                }
-            }
+void OTAManager::AbortOTATransfer(void)
+{
+    m_Failed = true;
 
-            // --- at this point we can start the real OTA code
+    EndOTATransfer();
+}
 
-            esp_err_t err = esp_ota_begin(m_update_partition, OTA_WITH_SEQUENTIAL_WRITES, &m_update_handle);
-            if (err != ESP_OK) 
-            {
-                ESP_LOGE(TAG, "esp_ota_begin failed (%s)", esp_err_to_name(err));
-                if (m_update_handle) esp_ota_abort(m_update_handle);
-                return false;
-            }
+////////////////////////////////////////////////////////////////////////////////////////
 
-            ESP_LOGI(TAG, "esp_ota_begin succeeded");
-                
-            /*
-            // --- check if provided version and running version are the same
+// --- after an error the jobs are still taken from the queue, so the receiving side
+//     never blocks
 
-            if (memcmp(new_app_info.version, running_app_info.version, sizeof(new_app_info.version)) == 0) 
-            {
-                ESP_LOGW(TAG, "Current running version is the same as a new. We will not continue the update.");
-                return false;
-            }*/
+void OTAManager::WriterLoop(void)
+{
+    Job l_job;
 
-            m_image_header_was_checked = true;
+    while (xQueueReceive(m_Jobs, &l_job, portMAX_DELAY) == pdTRUE)
+    {
+        if (l_job.m_Data)
+        {
+            if (!m_Failed && !WriteChunk(l_job.m_Data, l_job.m_Len)) m_Failed = true;
+        }
+        else if (l_job.m_Buffer)
+        {
+            xQueueSend(m_FreeBuffers, &l_job.m_Buffer, 0);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    xSemaphoreGive(m_WriterDone);
+    vTaskDelete(NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool OTAManager::WriteChunk(const char *f_bytes, int f_Length)
+{
+    //ESP_LOG_BUFFER_HEXDUMP(TAG,f_bytes,f_Length,ESP_LOG_INFO);
+
+    // ---- check the header of the image first
+
+    if (m_image_header_was_checked == false) 
+    {
+        if (m_imageheader_len == 0 && f_Length >= (int)OTA_IMAGE_HEADER_SIZE)
+        {
+            // --- the usual case: the first chunk holds the header
+
+            if (!BeginImage(f_bytes)) return false;
+        }
+        else
+        {
+            // --- the first chunk is smaller than the image header, so we got to assemble it (this is 'wrong'
+            //     in the IDF OTA example). The assembled part is written first.
+
+            int l_copy = OTA_IMAGE_HEADER_SIZE - m_imageheader_len;
+            if (l_copy > f_Length) l_copy = f_Length;
+
+            memcpy(m_imageheader + m_imageheader_len, f_bytes, l_copy);
+            m_imageheader_len += l_copy;
+
+            if (m_imageheader_len < (int)OTA_IMAGE_HEADER_SIZE) return true;
+
+            if (!BeginImage(m_imageheader)) return false;
+
+            if (!WriteChunk(m_imageheader, m_imageheader_len)) return false;
+
+            f_bytes  += l_copy;
+            f_Length -= l_copy;
         }
-        
     }
 
     // ---- write the chunk to the flash
 
-    if (m_update_handle)
+    if (f_Length > 0)
     {
+        int64_t   l_start = esp_timer_get_time();
         esp_err_t err = esp_ota_write( m_update_handle, (const void *)f_bytes, f_Length);
+        int64_t   l_duration = esp_timer_get_time() - l_start;
+
+        g_PerfMetrics.Record(PERF_STAGE_OTA_WRITE, (uint32_t)l_duration);
+        m_WriteUs += l_duration;
+
         if (err != ESP_OK) 
         {
             ESP_LOGE(TAG, "esp_ota_write failed (%s)", esp_err_to_name(err));
-            if (m_update_handle) esp_ota_abort(m_update_handle);
             return false;
         }
 
+        mbedtls_sha256_update(&m_Sha256, (const unsigned char *)f_bytes, f_Length);
     }
+
     // ---- remember how much we got already
 
     m_DataRead += f_Length;
@@ -213,6 +359,86 @@ bool OTAManager::AddOTAChunk(char *f_bytes, int f_Length)
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
+// --- checks the image header and the versions, then starts the real OTA code
+
+bool OTAManager::BeginImage(const char *f_header)
+{
+    // --- check if this is a valid image
+
+    if (((esp_image_header_t *)f_header)->magic != ESP_IMAGE_HEADER_MAGIC)
+    {
+        g_AppLogger.Log("Invalid image provided in firmware upgrade");
+        return false;                
+    }
+
+    // --- extract the app info from the image
+
+    esp_app_desc_t new_app_info;
+    memcpy(&new_app_info, f_header + sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t), sizeof(esp_app_desc_t));
+
+    // --- check firmware versions
+
+    ESP_LOGI(TAG, "New firmware version: %s", new_app_info.version);
+
+    esp_app_desc_t running_app_info;
+    bool l_have_running = esp_ota_get_partition_description(m_running, &running_app_info) == ESP_OK;
+    if (l_have_running) 
+    {
+        ESP_LOGI(TAG, "Running firmware version: %s", running_app_info.version);
+    }
+
+    const esp_partition_t* last_invalid_app = esp_ota_get_last_invalid_partition();
+    esp_app_desc_t invalid_app_info;
+    if (esp_ota_get_partition_description(last_invalid_app, &invalid_app_info) == ESP_OK) 
+    {
+        ESP_LOGI(TAG, "Last invalid firmware version: %s", invalid_app_info.version);
+    }
+
+    // --- check provided version with last invalid partition
+
+    if (last_invalid_app != NULL) 
+    {
+        if (memcmp(invalid_app_info.version, new_app_info.version, sizeof(new_app_info.version)) == 0) 
+        {
+            ESP_LOGW(TAG, "New version is the same as invalid version.");
+            ESP_LOGW(TAG, "Previously, there was an attempt to launch the firmware with %s version, but it failed.", invalid_app_info.version);
+            ESP_LOGW(TAG, "The firmware has been rolled back to the previous version.");
+
+            return false;
+        }
+    }
+
+    // --- the manifest names a version, but the image decides. A pulled image of the running
+    //     version would be installed on every check. Any other version is taken, also an
+    //     older one: that is how the server rolls a fleet back. Uploads may reinstall.
+
+    if (m_Pulled && l_have_running && memcmp(new_app_info.version, running_app_info.version, sizeof(new_app_info.version)) == 0)
+    {
+        g_AppLogger.Log("Update aborted: the downloaded image has the running version %s", running_app_info.version);
+        m_SameVersion = true;
+        return false;
+    }
+
+    // --- at this point we can start the real OTA code
+
+    esp_err_t err = esp_ota_begin(m_update_partition, OTA_WITH_SEQUENTIAL_WRITES, &m_update_handle);
+    if (err != ESP_OK) 
+    {
+        ESP_LOGE(TAG, "esp_ota_begin failed (%s)", esp_err_to_name(err));
+        if (m_update_handle) esp_ota_abort(m_update_handle);
+        m_update_handle = 0;
+        return false;
+    }
+
+    ESP_LOGI(TAG, "esp_ota_begin succeeded");
+
+    m_image_header_was_checked = true;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
 bool OTAManager::FinishOTATransfer(void)
 {
     esp_err_t err = esp_ota_end(m_update_handle);
@@ -221,13 +447,14 @@ bool OTAManager::FinishOTATransfer(void)
         if (err == ESP_ERR_OTA_VALIDATE_FAILED) 
         {
             ESP_LOGE(TAG, "Image validation failed, image is corrupted");
-            return false;
         } 
         else 
         {
             ESP_LOGE(TAG, "esp_ota_end failed (%s)!", esp_err_to_name(err));
-            return false;
         }
+
+        xSemaphoreGive(m_Busy);
+        return false;
     }
 
     err = esp_ota_set_boot_partition(m_update_partition);
@@ -236,6 +463,12 @@ bool OTAManager::FinishOTATransfer(void)
         ESP_LOGE(TAG, "esp_ota_set_boot_partition failed (%s)!", esp_err_to_name(err));
     }
 
+    // ---- hand the pending journal page and log lines to the writer tasks, they are written
+    //      during the delay
+
+    g_SampleJournal.Flush();
+    g_AppLogger.Flush();
+
     ESP_LOGI(TAG, "Prepare to restart system (10 seconds)!");
 
     vTaskDelay(10000 / portTICK_PERIOD_MS);
@@ -247,4 +480,360 @@ bool OTAManager::FinishOTATransfer(void)
     while (1);
 
     return true;
-}
\ No newline at end of file
+}
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- pulled updates. The manifest at CFMGR_OTA_URL describes the newest firmware:
+//
+//       { "version": "1.2.0",
+//         "image":  { "url": "esplogger-1.2.0.bin", "size": 912345, "sha256": "<hex>" },
+//         "deltas": [ { "from": "<hex app_elf_sha256 of the base>", "url": "...", "size": 23456 } ] }
+//
+//     Relative URLs are taken relative to the manifest. The SHA-256 is the one of the
+//     complete image, also when it is rebuilt from a delta.
+
+static void ota_pull_task(void *f_param)
+{
+    ((OTAManager *)f_param)->PullLoop();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static esp_http_client_handle_t ota_http_open(const char *f_url, int64_t *f_length)
+{
+    esp_http_client_config_t l_config = {};
+
+    l_config.url                = f_url;
+    l_config.timeout_ms         = OTA_HTTP_TIMEOUT_MS;
+    l_config.crt_bundle_attach  = esp_crt_bundle_attach;
+
+    esp_http_client_handle_t l_client = esp_http_client_init(&l_config);
+    if (!l_client) return NULL;
+
+    esp_err_t l_err = esp_http_client_open(l_client, 0);
+    if (l_err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not connect to %s (%s)", f_url, esp_err_to_name(l_err));
+        esp_http_client_cleanup(l_client);
+        return NULL;
+    }
+
+    *f_length = esp_http_client_fetch_headers(l_client);
+
+    int l_status = esp_http_client_get_status_code(l_client);
+    if (l_status != 200)
+    {
+        ESP_LOGE(TAG, "GET %s returned %d", f_url, l_status);
+        esp_http_client_close(l_client);
+        esp_http_client_cleanup(l_client);
+        return NULL;
+    }
+
+    return l_client;
+}
+
+static void ota_http_close(esp_http_client_handle_t f_client)
+{
+    esp_http_client_close(f_client);
+    esp_http_client_cleanup(f_client);
+}
+
+// --- reads the whole body into f_buf, which gets terminated
+
+static esp_err_t ota_http_get(const char *f_url, char *f_buf, int f_size)
+{
+    int64_t                  l_length;
+    esp_http_client_handle_t l_client = ota_http_open(f_url, &l_length);
+
+    if (!l_client) return ESP_FAIL;
+
+    int l_len = 0;
+    int l_read;
+
+    while (l_len < f_size - 1 && (l_read = esp_http_client_read(l_client, f_buf + l_len, f_size - 1 - l_len)) > 0) l_len += l_read;
+
+    bool l_complete = esp_http_client_is_complete_data_received(l_client);
+
+    ota_http_close(l_client);
+
+    f_buf[l_len] = '\0';
+
+    return l_complete ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static bool ota_resolve_url(const char *f_base, const char *f_url, char *f_out, size_t f_size)
+{
+    if (strstr(f_url, "://")) return snprintf(f_out, f_size, "%s", f_url) < (int)f_size;
+
+    const char *l_host = strstr(f_base, "://");
+    if (!l_host) return false;
+
+    l_host += 3;
+
+    // --- "/path" replaces the path of the manifest, "file" its last element
+
+    const char *l_end = f_url[0] == '/' ? strchr(l_host, '/') : strrchr(l_host, '/');
+
+    if (!l_end) return snprintf(f_out, f_size, "%s%s%s", f_base, f_url[0] == '/' ? "" : "/", f_url) < (int)f_size;
+
+    int l_keep = (l_end - f_base) + (f_url[0] == '/' ? 0 : 1);
+
+    return snprintf(f_out, f_size, "%.*s%s", l_keep, f_base, f_url) < (int)f_size;
+}
+
+static bool ota_parse_hex(const char *f_hex, uint8_t *f_out, size_t f_len)
+{
+    if (!f_hex || strlen(f_hex) != f_len * 2) return false;
+
+    for (size_t i = 0; i < f_len; ++i)
+    {
+        if (!isxdigit((unsigned char)f_hex[2 * i]) || !isxdigit((unsigned char)f_hex[2 * i + 1])) return false;
+
+        char l_byte[3] = { f_hex[2 * i], f_hex[2 * i + 1], 0 };
+        f_out[i] = (uint8_t)strtoul(l_byte, NULL, 16);
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t OTAManager::InitPullUpdates(void)
+{
+    if (!CreateQueues()) return ESP_ERR_NO_MEM;
+
+    if (xTaskCreate(ota_pull_task, "ota_pull", OTA_PULL_STACK, this, OTA_PULL_PRIO, NULL) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Could not create the update task");
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the config is read before every check, so changes apply without a restart. The
+//     first check is shortly after the start, when the network is up.
+
+void OTAManager::PullLoop(void)
+{
+    while (1)
+    {
+        vTaskDelay(pdMS_TO_TICKS(OTA_PULL_IDLE_MS));
+
+        int l_minutes = g_ConfigManager.GetIntValue(CFMGR_OTA_INTERVAL);
+
+        if (l_minutes <= 0 || g_ConfigManager.GetStringValue(CFMGR_OTA_URL, NULL, 0) == 0) continue;
+
+        CheckForUpdate();
+
+        for (int i = 1; i < l_minutes; ++i) vTaskDelay(pdMS_TO_TICKS(60000));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t OTAManager::CheckForUpdate(void)
+{
+    char l_manifest_url[OTA_URL_SIZE];
+    if (g_ConfigManager.GetStringValue(CFMGR_OTA_URL, l_manifest_url, sizeof(l_manifest_url)) == 0) return ESP_ERR_INVALID_STATE;
+
+    const esp_app_desc_t *l_running = esp_app_get_description();
+
+    char     l_version[sizeof(l_running->version)];
+    char     l_image_url[OTA_URL_SIZE];
+    char     l_delta_url[OTA_URL_SIZE] = "";
+    uint8_t  l_sha256[OTA_SHA256_SIZE];
+    int      l_image_size = 0;
+    int      l_delta_size = 0;
+
+    // --- the manifest, the buffer goes back to the pool before the download needs two
+
+    {
+        PooledBuffer l_buf(pdMS_TO_TICKS(OTA_HTTP_TIMEOUT_MS));
+        if (!l_buf.Get()) return ESP_ERR_NO_MEM;
+
+        esp_err_t l_err = ota_http_get(l_manifest_url, l_buf.Get(), OTA_MANIFEST_SIZE);
+        if (l_err != ESP_OK)
+        {
+            g_AppLogger.Log("Update check: could not load %s", l_manifest_url);
+            return l_err;
+        }
+
+        cJSON *l_root    = cJSON_Parse(l_buf.Get());
+        cJSON *l_ver     = cJSON_GetObjectItem(l_root, "version");
+        cJSON *l_image   = cJSON_GetObjectItem(l_root, "image");
+        cJSON *l_url     = cJSON_GetObjectItem(l_image, "url");
+        cJSON *l_size    = cJSON_GetObjectItem(l_image, "size");
+        cJSON *l_sha     = cJSON_GetObjectItem(l_image, "sha256");
+
+        if (!cJSON_IsString(l_ver) || !cJSON_IsString(l_url) || !cJSON_IsString(l_sha) || !ota_parse_hex(l_sha->valuestring, l_sha256, OTA_SHA256_SIZE) ||
+            !ota_resolve_url(l_manifest_url, l_url->valuestring, l_image_url, sizeof(l_image_url)))
+        {
+            g_AppLogger.Log("Update check: invalid manifest %s", l_manifest_url);
+            cJSON_Delete(l_root);
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+
+        strlcpy(l_version, l_ver->valuestring, sizeof(l_version));
+        if (cJSON_IsNumber(l_size)) l_image_size = l_size->valueint;
+
+        // --- a delta is only usable if it was made against exactly the running build
+
+        cJSON *l_deltas = cJSON_GetObjectItem(l_root, "deltas");
+
+        for (int i = 0; i < cJSON_GetArraySize(l_deltas) && !l_delta_url[0]; ++i)
+        {
+            cJSON   *l_delta = cJSON_GetArrayItem(l_deltas, i);
+            cJSON   *l_from  = cJSON_GetObjectItem(l_delta, "from");
+            cJSON   *l_durl  = cJSON_GetObjectItem(l_delta, "url");
+            uint8_t l_base[OTA_SHA256_SIZE];
+
+            if (!cJSON_IsString(l_from) || !cJSON_IsString(l_durl) || !ota_parse_hex(l_from->valuestring, l_base, sizeof(l_base))) continue;
+            if (memcmp(l_base, l_running->app_elf_sha256, sizeof(l_base)) != 0) continue;
+
+            if (!ota_resolve_url(l_manifest_url, l_durl->valuestring, l_delta_url, sizeof(l_delta_url))) l_delta_url[0] = '\0';
+
+            cJSON *l_dsize = cJSON_GetObjectItem(l_delta, "size");
+            if (cJSON_IsNumber(l_dsize)) l_delta_size = l_dsize->valueint;
+        }
+
+        cJSON_Delete(l_root);
+    }
+
+    if (strcmp(l_version, l_running->version) == 0)
+    {
+        ESP_LOGI(TAG, "Firmware %s is up to date", l_running->version);
+        return ESP_OK;
+    }
+
+    g_AppLogger.Log("Update from %s to %s, %s (%d KB)", l_running->version, l_version, l_delta_url[0] ? "delta" : "full image",
+                    (l_delta_url[0] ? l_delta_size : l_image_size) / 1024);
+
+    // --- a broken delta still leaves the full image, an image of the running version not
+
+    esp_err_t l_err = ESP_FAIL;
+
+    if (l_delta_url[0]) l_err = PullImage(l_delta_url, true, l_image_size, l_sha256);
+    if (l_err != ESP_OK && l_err != ESP_ERR_INVALID_STATE && l_err != ESP_ERR_INVALID_VERSION) l_err = PullImage(l_image_url, false, l_image_size, l_sha256);
+
+    if (l_err != ESP_OK) return l_err;
+
+    FinishOTATransfer();
+
+    return ESP_FAIL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- streams the download through the OTA buffers like an upload. Returns
+//     ESP_ERR_INVALID_STATE if another update is in progress and ESP_ERR_INVALID_VERSION
+//     if the image has the running version.
+
+esp_err_t OTAManager::PullImage(const char *f_url, bool f_delta, int f_image_size, const uint8_t *f_sha256)
+{
+    int64_t                  l_length;
+    esp_http_client_handle_t l_client = ota_http_open(f_url, &l_length);
+
+    if (!l_client) return ESP_FAIL;
+
+    if (!StartOTATransfer(f_sha256))
+    {
+        ota_http_close(l_client);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    m_Pulled = true;
+
+    OtaDeltaParser l_delta;
+    l_delta.InitParser(DeltaData, DeltaCopy, this);
+
+    int       l_received = 0;
+    esp_err_t l_err      = ESP_OK;
+
+    while (l_err == ESP_OK)
+    {
+        char *l_buf = GetBuffer();
+        int  l_len  = esp_http_client_read(l_client, l_buf, OTA_BUFFER_SIZE);
+
+        if (l_len > 0)
+        {
+            l_received += l_len;
+            l_err = f_delta ? l_delta.Parse(l_buf, l_len) : DeltaData(this, l_buf, l_len);
+        }
+        else if (l_len < 0 || !esp_http_client_is_complete_data_received(l_client))
+        {
+            l_err = ESP_FAIL;
+        }
+
+        ReleaseBuffer(l_buf);
+
+        if (l_len == 0) break;
+    }
+
+    ota_http_close(l_client);
+
+    if (l_err == ESP_OK && f_delta && !l_delta.IsDone()) l_err = ESP_ERR_INVALID_SIZE;
+
+    if (l_err != ESP_OK)
+    {
+        AbortOTATransfer();
+        if (m_SameVersion) return ESP_ERR_INVALID_VERSION;
+
+        g_AppLogger.Log("Download of %s failed after %d KB", f_url, l_received / 1024);
+        return ESP_FAIL;
+    }
+
+    if (!EndOTATransfer()) return m_SameVersion ? ESP_ERR_INVALID_VERSION : ESP_FAIL;
+
+    g_AppLogger.Log("Firmware downloaded: %d KB transferred for a %d KB image", l_received / 1024, m_DataRead / 1024);
+
+    if (f_image_size && m_DataRead != f_image_size) ESP_LOGW(TAG, "Image has %d bytes, the manifest says %d", m_DataRead, f_image_size);
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t OTAManager::DeltaData(void *f_ctx, const char *f_data, size_t f_len)
+{
+    return ((OTAManager *)f_ctx)->AddOTAChunk(f_data, f_len) ? ESP_OK : ESP_FAIL;
+}
+
+// --- the download holds one buffer while it is parsed, the copy goes through the other
+
+esp_err_t OTAManager::DeltaCopy(void *f_ctx, uint32_t f_offset, uint32_t f_len)
+{
+    OTAManager *l_this = (OTAManager *)f_ctx;
+
+    if (f_offset > l_this->m_running->size || f_len > l_this->m_running->size - f_offset)
+    {
+        ESP_LOGE(TAG, "Delta copies beyond the running partition");
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    while (f_len > 0)
+    {
+        char      *l_buf = l_this->GetBuffer();
+        uint32_t  l_len  = f_len < OTA_BUFFER_SIZE ? f_len : OTA_BUFFER_SIZE;
+        esp_err_t l_err  = esp_partition_read(l_this->m_running, f_offset, l_buf, l_len);
+
+        if (l_err == ESP_OK && !l_this->AddOTAChunk(l_buf, l_len)) l_err = ESP_FAIL;
+
+        l_this->ReleaseBuffer(l_buf);
+
+        if (l_err != ESP_OK) return l_err;
+
+        f_offset += l_len;
+        f_len    -= l_len;
+    }
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -39,9 +39,38 @@
 
 #include <string>
 #include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "esp_ota_ops.h"
+#include "esp_app_format.h"
+#include "mbedtls/sha256.h"
 
-#define MAX_IMAGE_HEADER 2048
+#include "buffer_pool.h"
+
+// --- the part of the image which is checked before esp_ota_begin()
+
+#define OTA_IMAGE_HEADER_SIZE   (sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t) + sizeof(esp_app_desc_t))
+
+// --- the upload is received into one buffer while the writer task writes the other one
+//     to flash, so receiving only waits for the flash when it is slower than the network
+
+#define OTA_BUFFER_CNT          2
+#define OTA_BUFFER_SIZE         BUFFER_POOL_SIZE
+#define OTA_JOB_QUEUE_LEN       8
+#define OTA_WRITER_STACK        4096
+#define OTA_WRITER_PRIO         5
+
+// --- pulling updates: the task checks the manifest at CFMGR_OTA_URL every CFMGR_OTA_INTERVAL
+//     minutes (see README). The manifest is read into one pool buffer.
+
+#define OTA_PULL_STACK          6144
+#define OTA_PULL_PRIO           2
+#define OTA_PULL_IDLE_MS        60000       // --- config check while pulling is switched off
+#define OTA_HTTP_TIMEOUT_MS     10000
+#define OTA_MANIFEST_SIZE       BUFFER_POOL_SIZE
+#define OTA_URL_SIZE            256
+#define OTA_SHA256_SIZE         32
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -50,12 +79,48 @@ class OTAManager
 public:
     void logOTAInfo(void);
 
-    bool StartOTATransfer(void);
-    bool AddOTAChunk(char *f_bytes, int f_Length);
+    // --- the receiving side: GetBuffer(), fill it, AddOTAChunk() for the image bytes in it
+    //     (which must stay valid until) ReleaseBuffer(). EndOTATransfer() waits for the
+    //     writer and aborts the update on any error, including a SHA-256 of the image which
+    //     does not match f_sha256. Only one transfer runs at a time, StartOTATransfer()
+    //     fails while an upload or a pulled update is in progress.
+
+    bool StartOTATransfer(const uint8_t *f_sha256 = NULL);
+    char *GetBuffer(void);
+    bool AddOTAChunk(const char *f_bytes, int f_Length);
+    void ReleaseBuffer(char *f_buf);
+    bool EndOTATransfer(void);
+    void AbortOTATransfer(void);
     bool FinishOTATransfer(void);
 
+    // --- pulling updates. CheckForUpdate() only returns if there is no update or it failed,
+    //     otherwise the device restarts with the new image.
+
+    esp_err_t InitPullUpdates(void);
+    esp_err_t CheckForUpdate(void);
+
+    // --- internal functions do not use
+
+    void WriterLoop(void);
+    void PullLoop(void);
 
 private:
+
+    struct Job
+    {
+        const char  *m_Data;        // --- NULL: release m_Buffer, or stop if that is NULL too
+        int         m_Len;
+        char        *m_Buffer;
+    };
+
+    bool WriteChunk(const char *f_bytes, int f_Length);
+    bool BeginImage(const char *f_header);
+    bool CreateQueues(void);
+
+    esp_err_t PullImage(const char *f_url, bool f_delta, int f_image_size, const uint8_t *f_sha256);
+    static esp_err_t DeltaData(void *f_ctx, const char *f_data, size_t f_len);
+    static esp_err_t DeltaCopy(void *f_ctx, uint32_t f_offset, uint32_t f_len);
+
     int         m_DataRead;
     bool        m_image_header_was_checked;
     
@@ -63,10 +128,26 @@ private:
     const esp_partition_t *m_update_partition;
     esp_ota_handle_t       m_update_handle;
 
-    char                   m_imageheader[MAX_IMAGE_HEADER];
-    char                  *m_imageheader_ptr;
+    char                   m_imageheader[OTA_IMAGE_HEADER_SIZE];     // --- only if the header arrives in pieces
+    int                    m_imageheader_len;
+
+    char                   *m_Buffers[OTA_BUFFER_CNT];
+    QueueHandle_t          m_FreeBuffers = NULL;
+    QueueHandle_t          m_Jobs = NULL;
+    SemaphoreHandle_t      m_WriterDone = NULL;
+    volatile bool          m_Failed;
+    SemaphoreHandle_t      m_Busy = NULL;       // --- taken from StartOTATransfer() until the end
+
+    mbedtls_sha256_context m_Sha256;
+    uint8_t                m_ExpectedSha256[OTA_SHA256_SIZE];
+    bool                   m_CheckSha256;
 
+    bool                   m_Pulled;            // --- the image comes from the update server
+    bool                   m_SameVersion;       // --- it was refused, it has the running version
 
+    int64_t                m_StartUs;
+    int64_t                m_WriteUs;           // --- spent in esp_ota_write()
+    int64_t                m_WaitUs;            // --- receiving waited for a free buffer
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,176 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "perf_metrics.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *g_PerfStageNames[PERF_STAGE_CNT] =
+{
+    "sensor_read",
+    "rest_api",
+    "rest_file",
+    "mqtt_encode",
+    "mqtt_publish",
+    "ota_write",
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+PerfMetrics g_PerfMetrics;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+PerfMetrics::PerfMetrics()
+{
+    Reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void PerfMetrics::Record(perf_stage_t f_stage, uint32_t f_us)
+{
+    if (f_stage < 0 || f_stage >= PERF_STAGE_CNT) return;
+
+    Stage &l_stage = m_Stages[f_stage];
+
+    uint32_t l_min = l_stage.m_MinUs.load(std::memory_order_relaxed);
+    while (f_us < l_min && !l_stage.m_MinUs.compare_exchange_weak(l_min, f_us, std::memory_order_relaxed)) {}
+
+    uint32_t l_max = l_stage.m_MaxUs.load(std::memory_order_relaxed);
+    while (f_us > l_max && !l_stage.m_MaxUs.compare_exchange_weak(l_max, f_us, std::memory_order_relaxed)) {}
+
+    // --- last, a counted sample always has its min and max
+
+    l_stage.m_Buckets[BucketOf(f_us)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfMetrics::Reset(void)
+{
+    for (int s = 0; s < PERF_STAGE_CNT; ++s)
+    {
+        Stage &l_stage = m_Stages[s];
+
+        l_stage.m_MinUs.store(UINT32_MAX, std::memory_order_relaxed);
+        l_stage.m_MaxUs.store(0, std::memory_order_relaxed);
+
+        for (int b = 0; b < PERF_HIST_BUCKETS; ++b) l_stage.m_Buckets[b].store(0, std::memory_order_relaxed);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the counters are read one by one while other tasks may record, so a summary can
+//     be off by the samples recorded meanwhile
+
+void PerfMetrics::GetSummary(perf_stage_t f_stage, PerfStageSummary *f_summary)
+{
+    memset(f_summary, 0, sizeof(PerfStageSummary));
+
+    if (f_stage < 0 || f_stage >= PERF_STAGE_CNT) return;
+
+    Stage    &l_stage = m_Stages[f_stage];
+    uint32_t l_buckets[PERF_HIST_BUCKETS];
+    uint32_t l_count = 0;
+
+    for (int b = 0; b < PERF_HIST_BUCKETS; ++b)
+    {
+        l_buckets[b] = l_stage.m_Buckets[b].load(std::memory_order_relaxed);
+        l_count += l_buckets[b];
+    }
+
+    if (l_count == 0) return;
+
+    f_summary->m_Count = l_count;
+    f_summary->m_MinUs = l_stage.m_MinUs.load(std::memory_order_relaxed);
+    f_summary->m_MaxUs = l_stage.m_MaxUs.load(std::memory_order_relaxed);
+
+    // --- percentiles: the bucket which contains the n-th sample (rounded up)
+
+    uint32_t l_rank50 = (l_count * 50ULL + 99) / 100;
+    uint32_t l_rank99 = (l_count * 99ULL + 99) / 100;
+    uint32_t l_seen   = 0;
+
+    for (int b = 0; b < PERF_HIST_BUCKETS; ++b)
+    {
+        if (!l_buckets[b]) continue;
+
+        uint32_t l_before = l_seen;
+        l_seen += l_buckets[b];
+
+        uint32_t l_upper = BucketUpperBound(b);
+        if (l_upper > f_summary->m_MaxUs) l_upper = f_summary->m_MaxUs;
+
+        if (l_before < l_rank50 && l_seen >= l_rank50) f_summary->m_P50Us = l_upper;
+        if (l_before < l_rank99 && l_seen >= l_rank99) f_summary->m_P99Us = l_upper;
+    }
+}
+
+const char *PerfMetrics::GetStageName(perf_stage_t f_stage)
+{
+    return f_stage >= 0 && f_stage < PERF_STAGE_CNT ? g_PerfStageNames[f_stage] : "";
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- values below 2^SUB_BITS have their own bucket, above the power of two is split
+//     into 2^SUB_BITS linear steps
+
+int PerfMetrics::BucketOf(uint32_t f_us)
+{
+    if (f_us < (1u << PERF_HIST_SUB_BITS)) return f_us;
+
+    int l_msb = 31 - __builtin_clz(f_us);
+    if (l_msb >= PERF_HIST_MAX_BITS) return PERF_HIST_BUCKETS - 1;
+
+    int l_sub = (f_us >> (l_msb - PERF_HIST_SUB_BITS)) & ((1 << PERF_HIST_SUB_BITS) - 1);
+
+    return ((l_msb - PERF_HIST_SUB_BITS + 1) << PERF_HIST_SUB_BITS) + l_sub;
+}
+
+uint32_t PerfMetrics::BucketUpperBound(int f_bucket)
+{
+    if (f_bucket < (1 << PERF_HIST_SUB_BITS)) return f_bucket;
+    if (f_bucket == PERF_HIST_BUCKETS - 1) return UINT32_MAX;
+
+    int      l_msb   = (f_bucket >> PERF_HIST_SUB_BITS) + PERF_HIST_SUB_BITS - 1;
+    int      l_sub   = f_bucket & ((1 << PERF_HIST_SUB_BITS) - 1);
+    uint32_t l_step  = 1u << (l_msb - PERF_HIST_SUB_BITS);
+
+    return (((1u << PERF_HIST_SUB_BITS) + l_sub) << (l_msb - PERF_HIST_SUB_BITS)) + l_step - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
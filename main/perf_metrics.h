@@ -0,0 +1,131 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PERF_METRICS_H_
+#define	PERF_METRICS_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <atomic>
+
+#include "esp_timer.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- duration histograms of the processing stages. Recording is lock-free (relaxed
+//     atomics), so it can be used from any task. The buckets are logarithmic with four
+//     linear steps per power of two, percentiles are therefore exact to about 25%.
+
+typedef enum
+{
+    PERF_STAGE_SENSOR_READ = 0,     // --- PerformMeasurement() of any sensor
+    PERF_STAGE_REST_API,            // --- handlers of /api/v1/...
+    PERF_STAGE_REST_FILE,           // --- static files of the web app
+    PERF_STAGE_MQTT_ENCODE,         // --- serialization of one MQTT payload
+    PERF_STAGE_MQTT_PUBLISH,        // --- one esp_mqtt_client_publish() call
+    PERF_STAGE_OTA_WRITE,           // --- one esp_ota_write() chunk
+    PERF_STAGE_CNT
+} perf_stage_t;
+
+#define PERF_HIST_SUB_BITS          2
+#define PERF_HIST_MAX_BITS          24      // --- up to 16.7 s, longer durations in the last bucket
+#define PERF_HIST_BUCKETS           ((PERF_HIST_MAX_BITS - PERF_HIST_SUB_BITS + 1) << PERF_HIST_SUB_BITS)
+
+typedef struct PerfStageSummary_s
+{
+    uint32_t    m_Count;
+    uint32_t    m_MinUs;
+    uint32_t    m_MaxUs;
+    uint32_t    m_P50Us;            // --- upper bound of the bucket, at most m_MaxUs
+    uint32_t    m_P99Us;
+} PerfStageSummary;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class PerfMetrics
+{
+public:
+
+    PerfMetrics();
+
+    // --- action functions
+
+    void Record(perf_stage_t f_stage, uint32_t f_us);
+    void Reset(void);
+
+    // --- getters
+
+    void GetSummary(perf_stage_t f_stage, PerfStageSummary *f_summary);
+    static const char *GetStageName(perf_stage_t f_stage);
+
+private:
+
+    struct Stage
+    {
+        std::atomic<uint32_t>   m_MinUs;
+        std::atomic<uint32_t>   m_MaxUs;
+        std::atomic<uint32_t>   m_Buckets[PERF_HIST_BUCKETS];
+    };
+
+    static int BucketOf(uint32_t f_us);
+    static uint32_t BucketUpperBound(int f_bucket);
+
+    Stage   m_Stages[PERF_STAGE_CNT];
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+extern PerfMetrics g_PerfMetrics;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- records the lifetime of the object: PerfTimer l_timer(PERF_STAGE_REST_API);
+
+class PerfTimer
+{
+public:
+
+    PerfTimer(perf_stage_t f_stage) : m_Stage(f_stage), m_Start(esp_timer_get_time()) {}
+    ~PerfTimer() { g_PerfMetrics.Record(m_Stage, (uint32_t)(esp_timer_get_time() - m_Start)); }
+
+private:
+
+    perf_stage_t    m_Stage;
+    int64_t         m_Start;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -32,8 +32,11 @@
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
+#include <math.h>
+#include <stdarg.h>
 #include <string.h>
 #include <fcntl.h>
+#include <sys/stat.h>
 #include <string>
 
 #include "esp_http_server.h"
@@ -44,8 +47,10 @@
 #include "esp_app_desc.h"
 #include "esp_idf_version.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "esp_vfs.h"
 #include "cJSON.h"
+#include "json_writer.h"
 #include "freertos/FreeRTOS.h"
 #include "driver/gpio.h"
 #include "driver/uart.h"
@@ -53,27 +58,34 @@
 #include "esp_wifi.h"
 
 #include "sensor_manager.h"
+#include "sample_store.h"
+#include "sample_journal.h"
 #include "sensor_config.h"
 #include "config_manager.h"
 #include "config_manager_defines.h"
 #include "mqtt_manager.h"
 #include "applogger.h"
 #include "ota_manager.h"
+#include "perf_metrics.h"
+#include "event_stream.h"
+#include "www_files.h"
+#include "buffer_pool.h"
+#include "multipart_parser.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
 static const char *REST_TAG = "esp-rest";
 
 #define FILE_PATH_MAX (ESP_VFS_PATH_MAX + 128)
-#define SCRATCH_BUFSIZE (100*1024)
+#define REST_BUFFER_WAIT_MS 1000
 
 #define DEFAULT_SCAN_LIST_SIZE 128
+#define METRICS_CHUNK_SIZE 512
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
 typedef struct rest_server_context {
     char base_path[ESP_VFS_PATH_MAX + 1];
-    char scratch[SCRATCH_BUFSIZE];
 } rest_server_context_t;
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -151,7 +163,6 @@ inline bool CheckFileExtension(const char *filename, const char *ext)
 static esp_err_t set_content_type_from_file(httpd_req_t *req, const char *filepath)
 {
     const char *type        = "text/plain";
-    const char *encoding    = NULL;
 
     if (CheckFileExtension(filepath, ".html")) 
     {
@@ -161,13 +172,11 @@ static esp_err_t set_content_type_from_file(httpd_req_t *req, const char *filepa
     if (CheckFileExtension(filepath, ".js")) 
     {
         type     = "application/javascript";
-        encoding = "gzip";
     } 
     
     if (CheckFileExtension(filepath, ".css")) 
     {
         type     = "text/css";
-        encoding = "gzip";
     }
     
     if (CheckFileExtension(filepath, ".png")) {
@@ -186,12 +195,15 @@ static esp_err_t set_content_type_from_file(httpd_req_t *req, const char *filepa
     if (CheckFileExtension(filepath, ".gz")) {
         type = "text/xml";
     }
-    
-    // --- if an encoding is provide, set the respective header
 
-    if (encoding)
+    if (CheckFileExtension(filepath, ".woff2")) 
+    {
+        type = "font/woff2";
+    }
+
+    if (CheckFileExtension(filepath, ".woff")) 
     {
-        httpd_resp_set_hdr(req,"Content-Encoding",encoding);
+        type = "font/woff";
     }
        
     return httpd_resp_set_type(req, type);
@@ -199,72 +211,170 @@ static esp_err_t set_content_type_from_file(httpd_req_t *req, const char *filepa
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
+// ---- for requests which cannot be served right now (all I/O buffers or streams in use)
+
+static esp_err_t send_busy(httpd_req_t *req, const char *f_text)
+{
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    httpd_resp_set_hdr(req, "Retry-After", "1");
+    httpd_resp_set_type(req, "text/plain");
+    return httpd_resp_sendstr(req, f_text);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// ---- true if the If-None-Match header of the request contains the ETag (or is "*")
+
+static bool etag_matches(httpd_req_t *req, const char *f_etag)
+{
+    char l_header[256];
+
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", l_header, sizeof(l_header)) != ESP_OK)
+    {
+        return false;
+    }
+
+    return strcmp(l_header, "*") == 0 || strstr(l_header, f_etag) != NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
 // ---- this is the default handler of the http server 
 
 static esp_err_t rest_common_get_handler(httpd_req_t *req)
 {
+    PerfTimer l_timer(PERF_STAGE_REST_FILE);
+
     char filepath[FILE_PATH_MAX];
+    char l_uri[FILE_PATH_MAX];
+    char l_etag[32];
 
     // --- get the base file path (aka "/www" from the user context to our buffer to be the base of the file path
 
     rest_server_context_t *rest_context = (rest_server_context_t *)req->user_ctx;
     strlcpy(filepath, rest_context->base_path, sizeof(filepath));
-    
-    // --- check if the user is requesting "/" and append "/index.html" in this case as the root file
-    
-    if (req->uri[strlen(req->uri) - 1] == '/') 
+
+    // --- the uri without the query. Check if the user is requesting "/" and append "/index.html" 
+    //     in this case as the root file
+
+    strlcpy(l_uri, req->uri, sizeof(l_uri));
+    l_uri[strcspn(l_uri, "?")] = 0;
+
+    if (l_uri[0] == 0 || l_uri[strlen(l_uri) - 1] == '/') 
     {
-        strlcat(filepath, "/index.html", sizeof(filepath));
+        strlcat(l_uri, "index.html", sizeof(l_uri));
     } 
-    else 
-    {
-        // --- simply add the uri path from the http context to our base path
-        strlcat(filepath, req->uri, sizeof(filepath));
-    }
 
-    // --- based on the original file name, set content type. Encoding is also set!
+    // --- files of the web app are served as listed in the manifest, which also knows the ETag.
+    //     Everything else is a deep link into the app, which gets /index.html.
 
-    set_content_type_from_file(req, filepath);
+    const WwwFile *l_file = g_WwwManifest.FindFile(l_uri);
+    if (!l_file) l_file = g_WwwManifest.FindFile("/index.html");
 
-    // --- check for css and js files and add ".gz" we are serving those
+    int fd;
 
-    if (CheckFileExtension(filepath,".css") || CheckFileExtension(filepath,".js"))
+    if (l_file)
     {
-        strcat(filepath,".gz");
-    }
+        strlcpy(l_etag, l_file->m_ETag, sizeof(l_etag));
 
-    // --- now try to open the file
+        // --- bundles with a hash in their name never change, the rest is revalidated on each use
 
-    int fd;
-    fd = open(filepath, O_RDONLY, 0);
-    if (fd == -1) 
+        httpd_resp_set_hdr(req, "ETag", l_etag);
+        httpd_resp_set_hdr(req, "Cache-Control", (l_file->m_Flags & WWW_FILE_IMMUTABLE) ? "public, max-age=31536000, immutable" : "no-cache");
+
+        if (etag_matches(req, l_etag))
+        {
+            httpd_resp_set_status(req, HTTPD_304);
+            return httpd_resp_send(req, NULL, 0);
+        }
+
+        set_content_type_from_file(req, l_file->m_Uri);
+
+        if (l_file->m_Flags & WWW_FILE_GZIP)
+        {
+            httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+        }
+
+        strlcat(filepath, l_file->m_File, sizeof(filepath));
+        fd = open(filepath, O_RDONLY, 0);
+    }
+    else
     {
-        // --- this failed. We're assuming that this is a deep link attempt (or a wrong path)
-        //     we handle this by defaulting to /index.html 
+        // --- no (valid) manifest: css and js files are stored as ".gz", the ETag is made of
+        //     size and modification time of the file
+
+        strlcat(filepath, l_uri, sizeof(filepath));
+
+        set_content_type_from_file(req, filepath);
+
+        bool l_gzip = CheckFileExtension(filepath,".css") || CheckFileExtension(filepath,".js");
+
+        if (l_gzip)
+        {
+            strlcat(filepath, ".gz", sizeof(filepath));
+        }
 
-        strlcpy(filepath, rest_context->base_path, sizeof(filepath));
-        strlcat(filepath, "/index.html", sizeof(filepath));
         fd = open(filepath, O_RDONLY, 0);
         if (fd == -1) 
         {
-            // --- okay....if we cannot open this, there is something 
+            // --- this failed. We're assuming that this is a deep link attempt (or a wrong path)
+            //     we handle this by defaulting to /index.html 
 
-            ESP_LOGE(REST_TAG, "Failed to open file : %s. Serious file system issue!", filepath);
+            strlcpy(filepath, rest_context->base_path, sizeof(filepath));
+            strlcat(filepath, "/index.html", sizeof(filepath));
+            fd = open(filepath, O_RDONLY, 0);
 
-            // --- Respond with 500 Internal Server Error
+            l_gzip = false;
+            set_content_type_from_file(req, filepath);
+        }
 
-            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to open file - appliance has a severe issue!");
-            return ESP_FAIL;
+        if (l_gzip)
+        {
+            httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
         }
 
-        set_content_type_from_file(req, filepath);
+        struct stat l_stat;
+
+        if (fd != -1 && fstat(fd, &l_stat) == 0)
+        {
+            snprintf(l_etag, sizeof(l_etag), "W/\"%lx-%llx\"", (unsigned long)l_stat.st_size, (unsigned long long)l_stat.st_mtime);
+
+            httpd_resp_set_hdr(req, "ETag", l_etag);
+            httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+            if (etag_matches(req, l_etag))
+            {
+                close(fd);
+                httpd_resp_set_status(req, HTTPD_304);
+                return httpd_resp_send(req, NULL, 0);
+            }
+        }
     }
 
-    char *chunk = rest_context->scratch;
+    if (fd == -1) 
+    {
+        // --- okay....if we cannot open this, there is something 
+
+        ESP_LOGE(REST_TAG, "Failed to open file : %s. Serious file system issue!", filepath);
+
+        // --- Respond with 500 Internal Server Error
+
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to open file - appliance has a severe issue!");
+        return ESP_FAIL;
+    }
+
+    PooledBuffer l_buf(pdMS_TO_TICKS(REST_BUFFER_WAIT_MS));
+    if (!l_buf.Get())
+    {
+        close(fd);
+        return send_busy(req, "Server busy");
+    }
+
+    char *chunk = l_buf.Get();
     ssize_t read_bytes;
     do {
-        /* Read file in chunks into the scratch buffer */
-        read_bytes = read(fd, chunk, SCRATCH_BUFSIZE);
+        /* Read file in chunks into the pooled buffer */
+        read_bytes = read(fd, chunk, l_buf.GetSize());
         if (read_bytes == -1) {
             ESP_LOGE(REST_TAG, "Failed to read file : %s", filepath);
         } else if (read_bytes > 0) {
@@ -292,11 +402,13 @@ static esp_err_t rest_common_get_handler(httpd_req_t *req)
 
 static esp_err_t sensor_data_get_handler(httpd_req_t *req)
 {
+    PerfTimer l_timer(PERF_STAGE_REST_API);
+
     httpd_resp_set_type(req, "application/json");
 
     // ---- find trailing backslash
 
-    char *l_sensorint = strrchr(req->uri,'/');
+    const char *l_sensorint = strrchr(req->uri,'/');
     if (!l_sensorint)
     {
         ESP_LOGE(REST_TAG, "sensor_data_get_handler: Illegal URI");
@@ -317,47 +429,349 @@ static esp_err_t sensor_data_get_handler(httpd_req_t *req)
         return ESP_FAIL;
     }
 
-    // ---- now ask the sensor for the values and create a JSON from that    
+    // ---- now ask the sensor for the values and stream the JSON back
 
-    cJSON *root = cJSON_CreateObject();
-    g_SensorManager.GetSensor(l_sensor_idx-1)->AddValuesToJSON_API(root);
+    char       l_chunk[JSON_WRITER_CHUNK_SIZE];
+    JsonWriter l_writer(req, l_chunk, sizeof(l_chunk));
 
-    // ---- convert to a string and send the JSON back
-    
-    const char *sys_info = cJSON_Print(root);
-    httpd_resp_sendstr(req, sys_info);
-    
-    free((void *)sys_info);
-    cJSON_Delete(root);
-    
-    return ESP_OK;
+    l_writer.BeginObject();
+    g_SensorManager.GetSensor(l_sensor_idx-1)->AddValuesToJSON_API(l_writer);
+    l_writer.EndObject();
+
+    return l_writer.Finish();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the values are rounded to the resolution of the store, otherwise the float to
+//     double conversion shows up as additional digits in the JSON.
+
+static double history_round(float f_value)
+{
+    return round((double)f_value * SAMPLE_STORE_SCALE) / SAMPLE_STORE_SCALE;
+}
+
+// --- raw samples are written one array per pass: channel -1 is the time
+
+typedef struct history_json_ctx_s
+{
+    JsonWriter  *m_Writer;
+    int         m_Channel;
+} history_json_ctx_t;
+
+static void history_raw_to_json(void *f_ctx, int64_t f_time_ms, const float *f_values, int f_channels)
+{
+    history_json_ctx_t *l_ctx = (history_json_ctx_t *)f_ctx;
+
+    if (l_ctx->m_Channel < 0) l_ctx->m_Writer->Number(NULL, f_time_ms / 1000.0);
+    else l_ctx->m_Writer->Number(NULL, history_round(f_values[l_ctx->m_Channel]));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- /api/v1/history/<sensor>/<tier> with tier "raw", "1m", "15m" or "1h". Times are
+//     seconds since boot. The data is copied from the store first and streamed from
+//     the copy, the store is not locked while sending.
+
+static esp_err_t sensor_history_get_handler(httpd_req_t *req)
+{
+    PerfTimer l_timer(PERF_STAGE_REST_API);
+
+    httpd_resp_set_type(req, "application/json");
+
+    int  l_sensor_idx = 0;
+    char l_tier_name[8];
+
+    if (sscanf(req->uri, "/api/v1/history/%d/%7[a-z0-9]", &l_sensor_idx, l_tier_name) != 2)
+    {
+        ESP_LOGE(REST_TAG, "sensor_history_get_handler: Illegal URI");
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Illegal URI");
+        return ESP_FAIL;
+    }
+
+    int l_tier = SampleStore::FindTier(l_tier_name);
+
+    if (l_sensor_idx < 1 || l_sensor_idx > SENSOR_CONFIG_SENSOR_CNT || (l_tier < 0 && strcmp(l_tier_name, "raw") != 0))
+    {
+        ESP_LOGE(REST_TAG, "sensor_history_get_handler: Illegal sensor %d or tier %s", l_sensor_idx, l_tier_name);
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Illegal sensor index or tier");
+        return ESP_FAIL;
+    }
+
+    CSensor *l_sensor   = g_SensorManager.GetSensor(l_sensor_idx-1);
+    int      l_channels = g_SampleStore.GetChannelCount(l_sensor_idx-1);
+
+    // ---- take the snapshot
+
+    SampleRawSnapshot *l_raw     = NULL;
+    SampleRollup      *l_rollups = NULL;
+    int                l_maxrows = SampleStore::GetTierRows(l_tier);
+    int                l_rows    = 0;
+
+    if (l_tier < 0) l_raw = (SampleRawSnapshot *)malloc(sizeof(SampleRawSnapshot));
+    else l_rollups = (SampleRollup *)malloc((l_channels ? l_channels : 1) * l_maxrows * sizeof(SampleRollup));
+
+    if (!l_raw && !l_rollups)
+    {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Out of memory");
+        return ESP_FAIL;
+    }
+
+    if (l_raw) g_SampleStore.SnapshotRaw(l_sensor_idx-1, l_raw);
+    else l_rows = g_SampleStore.SnapshotRollups(l_sensor_idx-1, l_tier, l_rollups, l_maxrows);
+
+    // ---- and stream it
+
+    char       l_chunk[JSON_WRITER_CHUNK_SIZE];
+    JsonWriter l_writer(req, l_chunk, sizeof(l_chunk));
+
+    l_writer.BeginObject();
+    l_writer.Int("sensor", l_sensor_idx);
+    l_writer.String("tier", l_tier_name);
+
+    if (l_raw)
+    {
+        // ---- raw samples: the time and one array per channel
+
+        history_json_ctx_t l_ctx = { &l_writer, -1 };
+
+        for (int c = -1; c < l_channels; ++c)
+        {
+            l_ctx.m_Channel = c;
+
+            l_writer.BeginArray(c < 0 ? "time" : l_sensor->GetChannelName(c));
+            SampleStore::DecodeRaw(l_raw, history_raw_to_json, &l_ctx);
+            l_writer.EndArray();
+        }
+    }
+    else
+    {
+        // ---- rollups: min/max/avg arrays per channel, time and count only once
+
+        l_writer.BeginArray("time");
+        for (int r = 0; r < l_rows; ++r) l_writer.Int(NULL, l_rollups[r].m_Start);
+        l_writer.EndArray();
+
+        l_writer.BeginArray("count");
+        for (int r = 0; r < l_rows; ++r) l_writer.Int(NULL, l_rollups[r].m_Count);
+        l_writer.EndArray();
+
+        for (int c = 0; c < l_channels; ++c)
+        {
+            const SampleRollup *l_ch = l_rollups + c * l_maxrows;
+
+            l_writer.BeginObject(l_sensor->GetChannelName(c));
+
+            l_writer.BeginArray("min");
+            for (int r = 0; r < l_rows; ++r) l_writer.Number(NULL, history_round(l_ch[r].m_Min));
+            l_writer.EndArray();
+
+            l_writer.BeginArray("max");
+            for (int r = 0; r < l_rows; ++r) l_writer.Number(NULL, history_round(l_ch[r].m_Max));
+            l_writer.EndArray();
+
+            l_writer.BeginArray("avg");
+            for (int r = 0; r < l_rows; ++r) l_writer.Number(NULL, history_round(l_ch[r].m_Avg));
+            l_writer.EndArray();
+
+            l_writer.EndObject();
+        }
+    }
+
+    l_writer.EndObject();
+
+    free(l_raw);
+    free(l_rollups);
+
+    return l_writer.Finish();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- /api/v1/journal/seq-<n>/cnt-<pages> returns the records of up to cnt journal pages
+//     starting at page n (0 = oldest). Pass "next" as seq to continue reading.
+
+#define JOURNAL_MAX_PAGES_PER_REQUEST   16
+
+static esp_err_t journal_get_handler(httpd_req_t *req)
+{
+    PerfTimer l_timer(PERF_STAGE_REST_API);
+
+    httpd_resp_set_type(req, "application/json");
+
+    const char *l_seq_str = strstr(req->uri,"/seq-");
+    const char *l_cnt_str = strstr(req->uri,"/cnt-");
+
+    if (!l_seq_str || !l_cnt_str)
+    {
+        ESP_LOGE(REST_TAG, "journal_get_handler: Illegal URI");
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Illegal URI: seq or cnt missing");
+        return ESP_FAIL;
+    }
+
+    uint32_t l_seq = strtoul(l_seq_str+5, NULL, 10);
+    int      l_cnt = atoi(l_cnt_str+5);
+
+    if (l_cnt <= 0 || l_cnt > JOURNAL_MAX_PAGES_PER_REQUEST)
+    {
+        l_cnt = JOURNAL_MAX_PAGES_PER_REQUEST;
+    }
+
+    // ---- the cursor holds a page buffer, keep it off the httpd stack
+
+    SampleJournalCursor *l_cursor = (SampleJournalCursor *)malloc(sizeof(SampleJournalCursor));
+    SampleJournalRecord *l_record = (SampleJournalRecord *)malloc(sizeof(SampleJournalRecord));
+
+    if (!l_cursor || !l_record)
+    {
+        free(l_cursor);
+        free(l_record);
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Out of memory");
+        return ESP_FAIL;
+    }
+
+    SampleJournalInfo l_info;
+    g_SampleJournal.GetInfo(&l_info);
+
+    if (l_seq < l_info.m_OldestSeq)
+    {
+        l_seq = l_info.m_OldestSeq;
+    }
+
+    g_SampleJournal.CursorFromSeq(l_cursor, l_seq);
+
+    char       l_chunk[JSON_WRITER_CHUNK_SIZE];
+    JsonWriter l_writer(req, l_chunk, sizeof(l_chunk));
+
+    l_writer.BeginObject();
+    l_writer.Int("pages", l_info.m_PageCount);
+    l_writer.Int("oldest", l_info.m_OldestSeq);
+    l_writer.Int("head", l_info.m_HeadSeq);
+    l_writer.Int("boot", l_info.m_Boot);
+    l_writer.Int("pages_written", l_info.m_PagesWritten);
+    l_writer.Int("sector_erases", l_info.m_SectorErases);
+    l_writer.Int("dropped", l_info.m_Dropped);
+    l_writer.Int("pending", l_info.m_Pending);
+
+    l_writer.BeginArray("records");
+
+    // ---- read whole pages only, so "next" is always a page boundary. ReadNext() moves
+    //      on to the next page by itself: a record from a page past the limit is not
+    //      sent, the next request starts with that page.
+
+    while (g_SampleJournal.ReadNext(l_cursor, l_record))
+    {
+        if (l_cursor->m_Seq >= l_seq + l_cnt) break;
+
+        l_writer.BeginObject();
+        l_writer.Int("boot", l_record->m_Boot);
+        l_writer.Int("sensor", l_record->m_Sensor + 1);
+        l_writer.Int("time", l_record->m_Time);
+        l_writer.Int("count", l_record->m_Count);
+
+        const float *l_values[3] = { l_record->m_Min, l_record->m_Max, l_record->m_Avg };
+        const char  *l_names[3]  = { "min", "max", "avg" };
+
+        for (int k = 0; k < 3; ++k)
+        {
+            l_writer.BeginArray(l_names[k]);
+
+            for (int c = 0; c < l_record->m_Channels; ++c)
+            {
+                l_writer.Number(NULL, history_round(l_values[k][c]));
+            }
+
+            l_writer.EndArray();
+        }
+
+        l_writer.EndObject();
+    }
+
+    l_writer.EndArray();
+    l_writer.Int("next", l_cursor->m_Seq);
+    l_writer.EndObject();
+
+    free(l_cursor);
+    free(l_record);
+
+    return l_writer.Finish();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
 static esp_err_t sensor_cnt_get_handler(httpd_req_t *req)
 {
+    PerfTimer l_timer(PERF_STAGE_REST_API);
+
     httpd_resp_set_type(req, "application/json");
 
     // ---- just return the sensor count
-    
-    cJSON *root = cJSON_CreateObject();
-    
-    cJSON_AddNumberToObject(root, "cnt", SENSOR_CONFIG_SENSOR_CNT);
-    
-    const char *sys_info = cJSON_Print(root);
-    httpd_resp_sendstr(req, sys_info);
-    
-    free((void *)sys_info);
-    cJSON_Delete(root);
-    
-    return ESP_OK;
+
+    char       l_buf[32];
+    JsonWriter l_writer(l_buf, sizeof(l_buf));
+
+    l_writer.BeginObject();
+    l_writer.Int("cnt", SENSOR_CONFIG_SENSOR_CNT);
+    l_writer.EndObject();
+    l_writer.Finish();
+
+    return httpd_resp_sendstr(req, l_buf);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static esp_err_t sensor_stats_get_handler(httpd_req_t *req)
+{
+    PerfTimer l_timer(PERF_STAGE_REST_API);
+
+    httpd_resp_set_type(req, "application/json");
+
+    // ---- acquisition timing of all sensors
+
+    char       l_chunk[JSON_WRITER_CHUNK_SIZE];
+    JsonWriter l_writer(req, l_chunk, sizeof(l_chunk));
+
+    l_writer.BeginObject();
+    l_writer.BeginArray("sensors");
+
+    for (int i = 0; i < g_SensorManager.GetSensorCount(); ++i)
+    {
+        SensorAcquisitionStats l_stats;
+        g_SensorManager.GetAcquisitionStats(i, &l_stats);
+
+        CSensor *l_sensor = g_SensorManager.GetSensor(i);
+
+        l_writer.BeginObject();
+        l_writer.Int("sensor", i + 1);
+        l_writer.Int("period_ms", l_sensor->GetMeasurementPeriodMs());
+        l_writer.Int("deadline_ms", l_sensor->GetMeasurementDeadlineMs());
+        l_writer.Int("measurements", l_stats.m_Measurements);
+        l_writer.Int("failures", l_stats.m_Failures);
+        l_writer.Int("deadline_misses", l_stats.m_DeadlineMisses);
+        l_writer.Int("skipped_periods", l_stats.m_SkippedPeriods);
+        l_writer.Int("jitter_last_us", l_stats.m_LastJitterUs);
+        l_writer.Int("jitter_avg_us", l_stats.m_Measurements ? l_stats.m_SumJitterUs / l_stats.m_Measurements : 0);
+        l_writer.Int("jitter_max_us", l_stats.m_MaxJitterUs);
+        l_writer.Int("duration_last_us", l_stats.m_LastDurationUs);
+        l_writer.Int("duration_max_us", l_stats.m_MaxDurationUs);
+
+        l_sensor->AddStatsToJSON(l_writer);
+
+        l_writer.EndObject();
+    }
+
+    l_writer.EndArray();
+    l_writer.EndObject();
+
+    return l_writer.Finish();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
 static esp_err_t config_apscan_handler(httpd_req_t *req)
-{    
+{
+    PerfTimer l_timer(PERF_STAGE_REST_API);
+
     httpd_resp_set_type(req, "application/json");
 
     // ---- just return the sensor count
@@ -434,43 +848,51 @@ static esp_err_t config_apscan_handler(httpd_req_t *req)
 
 static esp_err_t config_get_handler(httpd_req_t *req)
 {
+    PerfTimer l_timer(PERF_STAGE_REST_API);
+
     httpd_resp_set_type(req, "application/json");
 
-    // ---- just return the sensor count
-    
-    cJSON *root = cJSON_CreateObject();
-    
-    cJSON_AddNumberToObject(root, CFMGR_BOOTSTRAP_DONE, g_ConfigManager.GetIntValue(CFMGR_BOOTSTRAP_DONE));
-    cJSON_AddStringToObject(root, CFMGR_WIFI_SSID,      g_ConfigManager.GetStringValue(CFMGR_WIFI_SSID).c_str());
-    cJSON_AddStringToObject(root, CFMGR_WIFI_PASSWORD,  g_ConfigManager.GetStringValue(CFMGR_WIFI_PASSWORD).c_str());
-    cJSON_AddStringToObject(root, CFMGR_DEVICE_NAME,    g_ConfigManager.GetStringValue(CFMGR_DEVICE_NAME).c_str());
+    // ---- return all config values
 
-    cJSON_AddStringToObject(root, CFMGR_MQTT_SERVER,    g_ConfigManager.GetStringValue(CFMGR_MQTT_SERVER).c_str());
-    cJSON_AddStringToObject(root, CFMGR_MQTT_TOPIC,     g_ConfigManager.GetStringValue(CFMGR_MQTT_TOPIC).c_str());
-    cJSON_AddNumberToObject(root, CFMGR_MQTT_TIME,      g_ConfigManager.GetIntValue(CFMGR_MQTT_TIME));
-    cJSON_AddNumberToObject(root, CFMGR_MQTT_ENABLE,    g_ConfigManager.GetIntValue(CFMGR_MQTT_ENABLE));
+    char       l_chunk[JSON_WRITER_CHUNK_SIZE];
+    JsonWriter l_writer(req, l_chunk, sizeof(l_chunk));
 
-    // --- now create JSON and send back
-    
-    const char *sys_info = cJSON_Print(root);
-    httpd_resp_sendstr(req, sys_info);
-    
-    free((void *)sys_info);
-    cJSON_Delete(root);
-    
-    return ESP_OK;
+    l_writer.BeginObject();
+
+    char l_value[CFMGR_MAX_STRING_LEN + 1];
+
+    for (int k = 0; k < CFMGR_KEY_CNT; ++k)
+    {
+        cfmgr_key_t l_key = (cfmgr_key_t)k;
+
+        if (g_ConfigSchema[k].m_Type == CFMGR_TYPE_STRING)
+        {
+            g_ConfigManager.GetStringValue(l_key, l_value, sizeof(l_value));
+            l_writer.String(ConfigManager::GetKeyName(l_key), l_value);
+        }
+        else l_writer.Int(ConfigManager::GetKeyName(l_key), g_ConfigManager.GetIntValue(l_key));
+    }
+
+    l_writer.EndObject();
+
+    return l_writer.Finish();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
 static esp_err_t config_version_handler(httpd_req_t *req)
 {
+    PerfTimer l_timer(PERF_STAGE_REST_API);
+
     httpd_resp_set_type(req, "application/json");
 
-    // ---- just return the sensor count
-    
-    cJSON *root = cJSON_CreateObject();
-    
+    // ---- version and chip information
+
+    char       l_chunk[JSON_WRITER_CHUNK_SIZE];
+    JsonWriter l_writer(req, l_chunk, sizeof(l_chunk));
+
+    l_writer.BeginObject();
+
     // ---- get some chip infos
 
     esp_chip_info_t chip_info;
@@ -478,8 +900,8 @@ static esp_err_t config_version_handler(httpd_req_t *req)
 
     const esp_app_desc_t *l_appdesc = esp_app_get_description();
     
-    cJSON_AddStringToObject(root, "idf_version", IDF_VER);
-    cJSON_AddNumberToObject(root, "cpu_cores", chip_info.cores);
+    l_writer.String("idf_version", IDF_VER);
+    l_writer.Int("cpu_cores", chip_info.cores);
 
     const char *l_model;
     switch (chip_info.model)
@@ -495,41 +917,272 @@ static esp_err_t config_version_handler(httpd_req_t *req)
         default:                l_model = "unknown"; break;
     };
 
-    cJSON_AddStringToObject(root, "esp_model", l_model);
-    cJSON_AddStringToObject(root, "app_compile_time", l_appdesc->time);
-    cJSON_AddStringToObject(root, "app_compile_date", l_appdesc->date);
-    cJSON_AddStringToObject(root, "app_version", l_appdesc->version);
+    l_writer.String("esp_model", l_model);
+    l_writer.String("app_compile_time", l_appdesc->time);
+    l_writer.String("app_compile_date", l_appdesc->date);
+    l_writer.String("app_version", l_appdesc->version);
 
     uint8_t l_mac[6];
     ESP_ERROR_CHECK(esp_read_mac(l_mac, ESP_MAC_WIFI_STA));
 
     char l_macstr[32];
     snprintf(l_macstr,32,"%02X:%02X:%02X:%02X:%02X:%02X",MAC2STR(l_mac));
-    cJSON_AddStringToObject(root, "mac_address", l_macstr);
+    l_writer.String("mac_address", l_macstr);
 
-    cJSON_AddNumberToObject(root, "free_heap",  esp_get_free_heap_size()/1024);
-    cJSON_AddNumberToObject(root, "min_free_heap",  esp_get_minimum_free_heap_size()/1024);
+    l_writer.Int("free_heap",  esp_get_free_heap_size()/1024);
+    l_writer.Int("min_free_heap",  esp_get_minimum_free_heap_size()/1024);
 
-    // --- now create JSON and send back
-    
-    const char *sys_info = cJSON_Print(root);
-    httpd_resp_sendstr(req, sys_info);
-    
-    free((void *)sys_info);
-    cJSON_Delete(root);
-    
-    return ESP_OK;
+    l_writer.EndObject();
+
+    return l_writer.Finish();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static esp_err_t metrics_get_handler(httpd_req_t *req)
+{
+    PerfTimer l_timer(PERF_STAGE_REST_API);
+
+    httpd_resp_set_type(req, "application/json");
+
+    char       l_chunk[JSON_WRITER_CHUNK_SIZE];
+    JsonWriter l_writer(req, l_chunk, sizeof(l_chunk));
+
+    l_writer.BeginObject();
+
+    l_writer.Fixed("uptime", esp_timer_get_time() / 1000000.0, 3);
+    l_writer.Int("free_heap", esp_get_free_heap_size());
+    l_writer.Int("min_free_heap", esp_get_minimum_free_heap_size());
+    l_writer.Int("io_buffers_free", g_BufferPool.GetFreeCount());
+    l_writer.Int("io_buffers_min_free", g_BufferPool.GetMinFreeCount());
+
+    // ---- duration histograms since boot, all values in microseconds
+
+    l_writer.BeginObject("stages");
+
+    for (int i = 0; i < PERF_STAGE_CNT; ++i)
+    {
+        PerfStageSummary l_summary;
+        g_PerfMetrics.GetSummary((perf_stage_t)i, &l_summary);
+
+        l_writer.BeginObject(PerfMetrics::GetStageName((perf_stage_t)i));
+        l_writer.Int("count", l_summary.m_Count);
+        l_writer.Int("min_us", l_summary.m_MinUs);
+        l_writer.Int("p50_us", l_summary.m_P50Us);
+        l_writer.Int("p99_us", l_summary.m_P99Us);
+        l_writer.Int("max_us", l_summary.m_MaxUs);
+        l_writer.EndObject();
+    }
+
+    l_writer.EndObject();
+
+    l_writer.EndObject();
+
+    return l_writer.Finish();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- text output of /metrics: printed into a fixed buffer which is sent as a chunk
+//     whenever the next line does not fit
+
+typedef struct metrics_out {
+    httpd_req_t *req;
+    char        buf[METRICS_CHUNK_SIZE];
+    size_t      len;
+    esp_err_t   err;
+} metrics_out_t;
+
+static void metrics_printf(metrics_out_t *f_out, const char *f_format, ...)
+{
+    for (int l_try = 0; l_try < 2 && f_out->err == ESP_OK; ++l_try)
+    {
+        size_t  l_room = sizeof(f_out->buf) - f_out->len;
+        va_list l_args;
+
+        va_start(l_args, f_format);
+        int l_len = vsnprintf(f_out->buf + f_out->len, l_room, f_format, l_args);
+        va_end(l_args);
+
+        if (l_len < 0) return;
+
+        if ((size_t)l_len < l_room)
+        {
+            f_out->len += l_len;
+            return;
+        }
+
+        // --- flush and print again into the empty buffer (a line longer than the
+        //     buffer is dropped)
+
+        if (f_out->len == 0) return;
+
+        f_out->err = httpd_resp_send_chunk(f_out->req, f_out->buf, f_out->len);
+        f_out->len = 0;
+    }
+}
+
+// --- "# TYPE" and "# HELP" of a metric family
+
+static void metrics_family(metrics_out_t *f_out, const char *f_name, const char *f_type, const char *f_help)
+{
+    metrics_printf(f_out, "# TYPE %s %s\n# HELP %s %s\n", f_name, f_type, f_name, f_help);
+}
+
+static void metrics_value(metrics_out_t *f_out, const char *f_name, const char *f_labels, double f_value)
+{
+    if (isnan(f_value)) metrics_printf(f_out, "%s%s NaN\n", f_name, f_labels);
+    else metrics_printf(f_out, "%s%s %.9g\n", f_name, f_labels, f_value);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- everything a scraper needs in one request, OpenMetrics text format
+
+static esp_err_t metrics_text_handler(httpd_req_t *req)
+{
+    PerfTimer l_timer(PERF_STAGE_REST_API);
+
+    httpd_resp_set_type(req, "application/openmetrics-text; version=1.0.0; charset=utf-8");
+
+    metrics_out_t l_out;
+    l_out.req = req;
+    l_out.len = 0;
+    l_out.err = ESP_OK;
+
+    char l_labels[96];
+
+    // ---- device
+
+    metrics_family(&l_out, "esplogger_build", "info", "Firmware version.");
+    metrics_printf(&l_out, "esplogger_build_info{version=\"%s\",idf_version=\"%s\"} 1\n", esp_app_get_description()->version, IDF_VER);
+
+    metrics_family(&l_out, "esplogger_uptime_seconds", "gauge", "Time since boot.");
+    metrics_value(&l_out, "esplogger_uptime_seconds", "", esp_timer_get_time() / 1000000.0);
+
+    metrics_family(&l_out, "esplogger_heap_free_bytes", "gauge", "Free heap.");
+    metrics_value(&l_out, "esplogger_heap_free_bytes", "", esp_get_free_heap_size());
+
+    metrics_family(&l_out, "esplogger_heap_min_free_bytes", "gauge", "Lowest free heap since boot.");
+    metrics_value(&l_out, "esplogger_heap_min_free_bytes", "", esp_get_minimum_free_heap_size());
+
+    wifi_ap_record_t l_ap;
+
+    if (esp_wifi_sta_get_ap_info(&l_ap) == ESP_OK)
+    {
+        metrics_family(&l_out, "esplogger_wifi_rssi_dbm", "gauge", "Signal strength of the access point.");
+        metrics_value(&l_out, "esplogger_wifi_rssi_dbm", "", l_ap.rssi);
+    }
+
+    // ---- sensors: one sample per channel, the channel names are those of MQTT
+
+    metrics_family(&l_out, "esplogger_sensor_value", "gauge", "Last measured value of a sensor channel.");
+
+    for (int i = 0; i < g_SensorManager.GetSensorCount(); ++i)
+    {
+        CSensor *l_sensor = g_SensorManager.GetSensor(i);
+
+        for (int c = 0; c < l_sensor->GetChannelCount(); ++c)
+        {
+            snprintf(l_labels, sizeof(l_labels), "{sensor=\"%d\",channel=\"%s\"}", i + 1, l_sensor->GetChannelName(c));
+            metrics_value(&l_out, "esplogger_sensor_value", l_labels, l_sensor->GetChannelValue(c));
+        }
+    }
+
+    static const char *s_sensor_counters[][2] =
+    {
+        { "esplogger_sensor_measurements", "Measurements performed." },
+        { "esplogger_sensor_failures", "Measurements which failed." },
+        { "esplogger_sensor_deadline_misses", "Measurements which finished after their deadline." },
+    };
+
+    SensorAcquisitionStats l_stats[SENSOR_CONFIG_SENSOR_CNT];
+
+    for (int i = 0; i < g_SensorManager.GetSensorCount(); ++i) g_SensorManager.GetAcquisitionStats(i, &l_stats[i]);
+
+    for (int k = 0; k < 3; ++k)
+    {
+        char l_name[64];
+        snprintf(l_name, sizeof(l_name), "%s_total", s_sensor_counters[k][0]);
+
+        metrics_family(&l_out, s_sensor_counters[k][0], "counter", s_sensor_counters[k][1]);
+
+        for (int i = 0; i < g_SensorManager.GetSensorCount(); ++i)
+        {
+            uint32_t l_value = k == 0 ? l_stats[i].m_Measurements : k == 1 ? l_stats[i].m_Failures : l_stats[i].m_DeadlineMisses;
+
+            snprintf(l_labels, sizeof(l_labels), "{sensor=\"%d\"}", i + 1);
+            metrics_value(&l_out, l_name, l_labels, l_value);
+        }
+    }
+
+    // ---- MQTT outbound queue
+
+    MqttQueueStats l_queue;
+    g_MqttManager.GetQueueStats(&l_queue);
+
+    metrics_family(&l_out, "esplogger_mqtt_messages", "counter", "MQTT messages by state.");
+
+    metrics_value(&l_out, "esplogger_mqtt_messages_total", "{state=\"queued\"}", l_queue.m_Queued);
+    metrics_value(&l_out, "esplogger_mqtt_messages_total", "{state=\"sent\"}", l_queue.m_Sent);
+    metrics_value(&l_out, "esplogger_mqtt_messages_total", "{state=\"acked\"}", l_queue.m_Acked);
+    metrics_value(&l_out, "esplogger_mqtt_messages_total", "{state=\"retried\"}", l_queue.m_Retries);
+    metrics_value(&l_out, "esplogger_mqtt_messages_total", "{state=\"dropped\"}", l_queue.m_Dropped);
+
+    metrics_family(&l_out, "esplogger_mqtt_queue_depth", "gauge", "MQTT messages waiting for the broker.");
+    metrics_value(&l_out, "esplogger_mqtt_queue_depth", "", l_queue.m_Depth);
+
+    metrics_printf(&l_out, "# EOF\n");
+
+    // ---- the rest and the final chunk
+
+    if (l_out.err == ESP_OK && l_out.len) l_out.err = httpd_resp_send_chunk(req, l_out.buf, l_out.len);
+    if (l_out.err == ESP_OK) l_out.err = httpd_resp_send_chunk(req, NULL, 0);
+
+    return l_out.err;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- Server-Sent Events: the request is handed over to the stream task
+
+static esp_err_t stream_get_handler(httpd_req_t *req)
+{
+    PerfTimer l_timer(PERF_STAGE_REST_API);
+
+    esp_err_t l_err = g_EventStream.AddClient(req);
+
+    if (l_err == ESP_ERR_NO_MEM)
+    {
+        return send_busy(req, "Too many event streams");
+    }
+
+    return l_err;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
+// ---- one line of the history for config_log_handler
+
+static void log_history_line(void *f_ctx, uint32_t f_id, const char *f_text)
+{
+    JsonWriter *l_writer = (JsonWriter *)f_ctx;
+
+    l_writer->BeginObject();
+    l_writer->Int("id",     f_id);
+    l_writer->String("text",   f_text);
+    l_writer->EndObject();
+}
+
 static esp_err_t config_log_handler(httpd_req_t *req)
 {
+    PerfTimer l_timer(PERF_STAGE_REST_API);
+
     httpd_resp_set_type(req, "application/json");
 
     // ---- find end value 
 
-    char *l_cntint_str = strstr(req->uri,"/cnt-");
+    const char *l_cntint_str = strstr(req->uri,"/cnt-");
     if (!l_cntint_str)
     {
         ESP_LOGE(REST_TAG, "config_log_handler: Illegal URI");
@@ -537,7 +1190,7 @@ static esp_err_t config_log_handler(httpd_req_t *req)
         return ESP_FAIL;
     }
 
-    char *l_idxint_str = strstr(req->uri,"/idx-");
+    const char *l_idxint_str = strstr(req->uri,"/idx-");
     if (!l_idxint_str)
     {
         ESP_LOGE(REST_TAG, "config_log_handler: Illegal URI");
@@ -550,22 +1203,27 @@ static esp_err_t config_log_handler(httpd_req_t *req)
     int l_cntint = atoi(l_cntint_str+5);
     int l_idxint = atoi(l_idxint_str+5);
 
-    // ---- calculate the begin line in the AppLogger
+    // ---- calculate the first line to send
+
+    uint32_t l_first   = g_AppLogger.GetFirstId();
+    uint32_t l_last    = g_AppLogger.GetLastId();
+    uint32_t l_history = g_AppLogger.GetHistoryFirstId();
+    uint32_t l_begin;
 
-    int l_begint;
     if (l_idxint == 0)
     {
         // --- special case: idx 0 means get the first line in the buffer
 
-        l_begint = 0;
+        l_begin = l_first;
     }
     else
     {
-        // --- usual case: id specified
+        // --- usual case: id specified, older lines than the ones in memory come from the
+        //     history files
 
-        l_begint  = g_AppLogger.FindLineNumber(l_idxint);
+        l_begin = l_idxint;
 
-        if (l_begint < 0)
+        if (!l_first || l_begin > l_last || (l_begin < l_first && (!l_history || l_begin < l_history)))
         {
             ESP_LOGE(REST_TAG, "config_log_handler: Illegal URI");
             httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Illegal URI: illegal log id specified");
@@ -575,77 +1233,87 @@ static esp_err_t config_log_handler(httpd_req_t *req)
 
     // --- handle special case for count: 0 means get all lines
 
-    if (l_cntint == 0)
-    {
-        l_cntint = g_AppLogger.GetLineCount();
-    }
+    int l_available = l_first ? (int)(l_last - l_begin + 1) : 0;
 
-    if (l_begint + l_cntint > g_AppLogger.GetLineCount())
+    if (l_cntint == 0 || l_cntint > l_available)
     {
-        l_cntint = g_AppLogger.GetLineCount()-l_begint;
+        l_cntint = l_available;
     }
-   
-    // ---- some sanity checks
 
-    if (l_cntint > g_AppLogger.GetLineCount())
+    if (l_cntint < 0)
     {
         ESP_LOGE(REST_TAG, "config_log_handler: Illegal URI");
         httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Illegal URI: cnt exceeds log entries");
         return ESP_FAIL;
     }
 
-    // ---- create the JSON response object
+    // ---- stream the JSON response
     
-    cJSON *root = cJSON_CreateObject();
+    char       l_chunk[JSON_WRITER_CHUNK_SIZE];
+    char       l_text[APPLOGGER_MAX_LINE_LEN];
+    JsonWriter l_writer(req, l_chunk, sizeof(l_chunk));
+
+    l_writer.BeginObject();
 
     // --- add number some interesting numeric values back to the JSON
 
-    cJSON_AddNumberToObject(root, "log_count",      g_AppLogger.GetLineCount());
-    cJSON_AddNumberToObject(root, "log_max_count",  APPLOGGER_MAX_NUMLINES);
-    cJSON_AddNumberToObject(root, "count",          l_cntint);
-    cJSON_AddNumberToObject(root, "startidx",       g_AppLogger.GetLineId(l_begint));
+    l_writer.Int("log_count",      g_AppLogger.GetLineCount());
+    l_writer.Int("log_max_count",  APPLOGGER_MAX_NUMLINES);
+    l_writer.Int("startidx",       l_begin);
+    l_writer.Int("history_startidx", l_history ? l_history : l_first);
 
-    // --- now add the log lines as an object of (id | text) pairs
+    // --- now add the log lines as an object of (id | text) pairs. Lines overwritten
+    //     while the response is sent are left out, so the count comes last.
    
-    cJSON *l_loglines_array = cJSON_AddArrayToObject(root,"log_entries");
+    int l_sent = 0;
+
+    l_writer.BeginArray("log_entries");
+
+    if (l_begin < l_first)
+    {
+        l_sent  = g_AppLogger.ReadHistory(l_begin, l_first, l_cntint, log_history_line, &l_writer);
+        l_begin = l_first;
+    }
    
-    for (int l_idx = 0; l_idx < l_cntint; l_idx++)
+    for (uint32_t l_id = l_begin; l_sent < l_cntint && l_id <= l_last; l_id++)
     {
-        cJSON *l_itemObject = cJSON_CreateObject();
+        int64_t l_time;
 
-        cJSON_AddNumberToObject(l_itemObject, "id",     g_AppLogger.GetLineId(l_begint + l_idx));
-        cJSON_AddStringToObject(l_itemObject, "text",   g_AppLogger.GetLineText(l_begint + l_idx));
+        if (!g_AppLogger.GetLine(l_id, l_text, &l_time)) continue;
 
-        cJSON_AddItemToArray(l_loglines_array,l_itemObject);
+        l_writer.BeginObject();
+        l_writer.Int("id",     l_id);
+        l_writer.String("text",   l_text);
+        l_writer.Int("uptime_ms", l_time / 1000);
+        l_writer.EndObject();
+
+        l_sent++;
     } 
-    
-    // --- now create JSON and send back
-    
-    const char *sys_info = cJSON_Print(root);
-    httpd_resp_sendstr(req, sys_info);
-    
-    free((void *)sys_info);
-    cJSON_Delete(root);
-    
-    return ESP_OK;
+
+    l_writer.EndArray();
+    l_writer.Int("count",          l_sent);
+    l_writer.EndObject();
+
+    return l_writer.Finish();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-esp_err_t ProcessJsonString(cJSON *f_root,const char *f_name, bool f_onlysetifnotempty = false)
+esp_err_t ProcessJsonString(cJSON *f_root,cfmgr_key_t f_key, bool f_onlysetifnotempty = false)
 {
-    cJSON *l_js = cJSON_GetObjectItem(f_root, f_name);
+    const char *l_name = ConfigManager::GetKeyName(f_key);
+    cJSON *l_js = cJSON_GetObjectItem(f_root, l_name);
 
     if (!l_js)
     {
-        ESP_LOGE(REST_TAG, "Config %s not found", f_name);
+        ESP_LOGE(REST_TAG, "Config %s not found", l_name);
         return ESP_FAIL;
     }
 
     const char *l_s = l_js->valuestring;
     if (!l_s)
     {
-        ESP_LOGE(REST_TAG, "Config %s is null", f_name);
+        ESP_LOGE(REST_TAG, "Config %s is null", l_name);
         return ESP_FAIL;
         
     }
@@ -654,34 +1322,41 @@ esp_err_t ProcessJsonString(cJSON *f_root,const char *f_name, bool f_onlysetifno
 
     if (f_onlysetifnotempty && strlen(l_s) == 0)
     {
-        ESP_LOGI(REST_TAG, "Config %s empty - not set!", f_name);
+        ESP_LOGI(REST_TAG, "Config %s empty - not set!", l_name);
         return ESP_OK;
     }
 
-    // --- now tell the config mgr
+    // --- now tell the config mgr, it refuses values longer than the schema allows
+
+    esp_err_t l_err = g_ConfigManager.SetStringValue(f_key,SanetizedString(l_s).c_str());
+    if (l_err != ESP_OK)
+    {
+        ESP_LOGE(REST_TAG, "Config %s not set: %s", l_name,esp_err_to_name(l_err));
+        return l_err;
+    }
 
-    g_ConfigManager.SetStringValue(f_name,SanetizedString(l_s));
-    ESP_LOGI(REST_TAG, "Config %s, value '%s'", f_name,l_s);
+    ESP_LOGI(REST_TAG, "Config %s, value '%s'", l_name,l_s);
 
     return ESP_OK;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-esp_err_t ProcessJsonInt(cJSON *f_root,const char *f_name)
+esp_err_t ProcessJsonInt(cJSON *f_root,cfmgr_key_t f_key)
 {
-    cJSON *l_js = cJSON_GetObjectItem(f_root, f_name);
+    const char *l_name = ConfigManager::GetKeyName(f_key);
+    cJSON *l_js = cJSON_GetObjectItem(f_root, l_name);
 
     if (!l_js)
     {
-        ESP_LOGE(REST_TAG, "Config %s not found", f_name);
+        ESP_LOGE(REST_TAG, "Config %s not found", l_name);
         return ESP_FAIL;
     }
 
     // --- now tell the config mgr
 
-    g_ConfigManager.SetIntValue(f_name,l_js->valueint);
-    ESP_LOGI(REST_TAG, "Config %s, value '%d'", f_name,l_js->valueint);
+    g_ConfigManager.SetIntValue(f_key,l_js->valueint);
+    ESP_LOGI(REST_TAG, "Config %s, value '%d'", l_name,l_js->valueint);
 
     return ESP_OK;
 }
@@ -690,24 +1365,32 @@ esp_err_t ProcessJsonInt(cJSON *f_root,const char *f_name)
 
 static esp_err_t config_post_handler(httpd_req_t *req)
 {
-    // --- check if we have enough space to process full post request
+    PerfTimer l_timer(PERF_STAGE_REST_API);
+
+    // --- cJSON needs the whole document, the config is a few hundred bytes. Check if it fits
+    //     into one pooled buffer (incl. the terminator).
 
     int total_len = req->content_len;
     int cur_len = 0;
-    char *buf = ((rest_server_context_t *)(req->user_ctx))->scratch;
     int received = 0;
-    if (total_len >= SCRATCH_BUFSIZE) 
+    if (total_len >= BUFFER_POOL_SIZE) 
     {
-        // --- Respond with 500 Internal Server Error
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "content too long");
+        httpd_resp_send_err(req, HTTPD_413_CONTENT_TOO_LARGE, "content too long");
         return ESP_FAIL;
     }
 
+    PooledBuffer l_buf(pdMS_TO_TICKS(REST_BUFFER_WAIT_MS));
+    char *buf = l_buf.Get();
+    if (!buf)
+    {
+        return send_busy(req, "Server busy");
+    }
+
     // --- okay, now read the full request
 
     while (cur_len < total_len) 
     {
-        received = httpd_req_recv(req, buf + cur_len, total_len);
+        received = httpd_req_recv(req, buf + cur_len, total_len - cur_len);
         if (received <= 0) 
         {
             httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to post control value");
@@ -721,24 +1404,52 @@ static esp_err_t config_post_handler(httpd_req_t *req)
 
     cJSON *root = cJSON_Parse(buf);
     
-    // --- set config to config mgr
+    // --- check all values first: a value which is too long rejects the whole update,
+    //     nothing is changed then
+
+    for (int k = 0; k < CFMGR_KEY_CNT; ++k)
+    {
+        const ConfigKeyDef &l_def = g_ConfigSchema[k];
 
-    ProcessJsonString(root,CFMGR_WIFI_SSID);
-    ProcessJsonString(root,CFMGR_WIFI_PASSWORD,true);
-    ProcessJsonString(root,CFMGR_DEVICE_NAME);  
-    ProcessJsonString(root,CFMGR_MQTT_SERVER);
-    ProcessJsonString(root,CFMGR_MQTT_TOPIC);
+        if ((l_def.m_Flags & CFMGR_FLAG_NO_POST) || l_def.m_Type != CFMGR_TYPE_STRING) continue;
 
-    ProcessJsonInt(root,CFMGR_MQTT_TIME);
-    ProcessJsonInt(root,CFMGR_MQTT_ENABLE);
+        cJSON *l_js = cJSON_GetObjectItem(root, l_def.m_Name);
+
+        if (l_js && l_js->valuestring && SanetizedString(l_js->valuestring).length() > l_def.m_MaxLen)
+        {
+            cJSON_Delete(root);
+
+            char l_msg[80];
+            snprintf(l_msg, sizeof(l_msg), "Value of %s longer than %d characters", l_def.m_Name, l_def.m_MaxLen);
+
+            ESP_LOGE(REST_TAG, "Config not set: %s", l_msg);
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, l_msg);
+            return ESP_FAIL;
+        }
+    }
+
+    // --- set config to config mgr, written and applied as one update. Missing keys keep
+    //     their value.
+
+    g_ConfigManager.BeginUpdate();
+
+    for (int k = 0; k < CFMGR_KEY_CNT; ++k)
+    {
+        const ConfigKeyDef &l_def = g_ConfigSchema[k];
+
+        if (l_def.m_Flags & CFMGR_FLAG_NO_POST) continue;
+
+        if (l_def.m_Type == CFMGR_TYPE_STRING) ProcessJsonString(root,(cfmgr_key_t)k,(l_def.m_Flags & CFMGR_FLAG_KEEP_IF_EMPTY) != 0);
+        else ProcessJsonInt(root,(cfmgr_key_t)k);
+    }
 
     // --- flag now as bootstrap done
     
     g_ConfigManager.SetIntValue(CFMGR_BOOTSTRAP_DONE,1);
 
-    // ---- tell the mqtt manager that the config might have changed
+    // ---- the subscribers (e.g. the mqtt manager) are told what has changed
 
-    g_MqttManager.UpdateConfig();
+    g_ConfigManager.EndUpdate();
 
     // --- free up the JSON object
 
@@ -756,10 +1467,25 @@ static esp_err_t config_post_handler(httpd_req_t *req)
 portMUX_TYPE g_FirmwareUpload_Spinlock = portMUX_INITIALIZER_UNLOCKED;
 bool g_FirmwareUpload_in_Progress = false;
 
+// ---- the multipart parser passes the image bytes on without copying them
+
+static esp_err_t upload_firmware_data(void *f_ctx, const char *f_data, size_t f_len)
+{
+    return g_OTAManager.AddOTAChunk(f_data, f_len) ? ESP_OK : ESP_FAIL;
+}
+
+static esp_err_t upload_firmware_failed(httpd_req_t *req, httpd_err_code_t f_code, const char *f_text)
+{
+    g_AppLogger.Log("%s", f_text);
+
+    httpd_resp_send_err(req, f_code, f_text);
+    g_FirmwareUpload_in_Progress = false;
+
+    return ESP_FAIL;
+}
+
 static esp_err_t upload_firmware_handler(httpd_req_t *req)
 {
-    rest_server_context *l_ctx_ptr = (rest_server_context *)req->user_ctx;
-    
     g_AppLogger.Log("Firmware upload started (length %d)",req->content_len);
 
     // ---- block the change of g_FirmwareUpload_in_Progress atomically as otherwise users could trick the
@@ -787,104 +1513,79 @@ static esp_err_t upload_firmware_handler(httpd_req_t *req)
         return ESP_FAIL;
     }
 
-    // --- start transferring the chunks provided by the http client
+    // --- the web app sends a multipart form, anything else is taken as the plain image
+    //     (curl --data-binary @firmware.bin)
 
-    int total_len           = req->content_len;
-    int cur_len             = 0;
-    char *buf               = l_ctx_ptr->scratch;
-    int received            = 0;
-    int f_skipped_mp_header = false;
+    char            l_type[160];
+    MultipartParser l_parser;
+    bool            l_multipart = httpd_req_get_hdr_value_str(req, "Content-Type", l_type, sizeof(l_type)) == ESP_OK &&
+                                  strncasecmp(l_type, "multipart/", 10) == 0;
+
+    if (l_multipart && l_parser.InitParser(l_type, upload_firmware_data, NULL) != ESP_OK)
+    {
+        return upload_firmware_failed(req, HTTPD_400_BAD_REQUEST, "Error while processing the firmware (multipart boundary missing)");
+    }
 
     // --- let the OTA manager know
 
-    g_OTAManager.StartOTATransfer();
+    if (!g_OTAManager.StartOTATransfer())
+    {
+        g_FirmwareUpload_in_Progress = false;
+        return send_busy(req, "Server busy");
+    }
 
-    // --- okay, now read the full request
+    // --- receive into one buffer while the OTA manager writes the other one
+
+    int total_len           = req->content_len;
+    int cur_len             = 0;
 
     while (cur_len < total_len) 
     {
-        received = httpd_req_recv(req, buf, SCRATCH_BUFSIZE);
+        char *buf       = g_OTAManager.GetBuffer();
+        int  received   = httpd_req_recv(req, buf, OTA_BUFFER_SIZE);
+
+        if (received == HTTPD_SOCK_ERR_TIMEOUT)
+        {
+            g_OTAManager.ReleaseBuffer(buf);
+            continue;
+        }
+
         if (received <= 0) 
         {
-            g_AppLogger.Log("Error during firmware upload");
+            g_OTAManager.ReleaseBuffer(buf);
+            g_OTAManager.AbortOTATransfer();
 
-            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to upload firmware image");
-            g_FirmwareUpload_in_Progress = false;
-            
-            return ESP_FAIL;
+            return upload_firmware_failed(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Error during firmware upload");
         }
 
         // --- update total length
 
         cur_len += received;
 
-        // --- we need to skip the multipart header here. We do this by searching for 0d0a0d0a in the buffer.
-        //     The byte after the last 0a is the first byte of the new image
+        esp_err_t l_err = l_multipart ? l_parser.Parse(buf, received) : upload_firmware_data(NULL, buf, received);
 
-        bool l_add_chunk_result = false;
+        g_OTAManager.ReleaseBuffer(buf);
 
-        // --- did we already skip the frame header?
-
-        if (!f_skipped_mp_header)
+        if (l_err != ESP_OK)
         {
-            // --- no, we still got to do this. Parse the received buffer for 0x0D 0A 0D 0A
-
-            char *l_findptr             = buf;
-            bool  l_found_magic_string  = false;
-            int   l_counter             = received - 4;
+            g_OTAManager.AbortOTATransfer();
 
-            while (!l_found_magic_string && l_counter > 0)
-            {
-                // --- check at the new position, if the magic word starts there
-
-                if (l_findptr[0] == 0xd && l_findptr[1] == 0xa && l_findptr[2] == 0xd && l_findptr[3] == 0xa)
-                {
-                    // ---- yes, found it! 
-
-                    f_skipped_mp_header = true;
-
-                    // ---- give the OTA manager the first chunk skipping the whole multipart header
-
-                    l_add_chunk_result = g_OTAManager.AddOTAChunk(l_findptr + 4,l_counter);
-
-                    l_found_magic_string = true;
-                }
-
-                ++l_findptr;
-                --l_counter;
-            }
-
-            // --- if we reached the end of the buffer, the provided buffer is malformed since it did not contain a 0d0a0d0a
-
-            if (!l_counter)
-            {
-                g_AppLogger.Log("Error while processing the firmware (multipart header missing)");
-
-                httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Error while processing the firmware (multipart header missing)");
-                g_FirmwareUpload_in_Progress = false;                
-            }
-        }
-        else
-        {
-            // --- yes we skipped. We just have to pass the rest of the file to the ota manager
-
-            l_add_chunk_result = g_OTAManager.AddOTAChunk(buf,received);
+            return upload_firmware_failed(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Error while processing the firmware");
         }
+    }
 
-        // --- check if the g_OTAManager.AddOTAChunk worked....
-
-        if (!l_add_chunk_result)
-        {
-            // --- something went wrong
+    if (l_multipart && !l_parser.IsDone())
+    {
+        g_OTAManager.AbortOTATransfer();
 
-            g_AppLogger.Log("Error while processing the firmware");
+        return upload_firmware_failed(req, HTTPD_400_BAD_REQUEST, "Error while processing the firmware (multipart body incomplete)");
+    }
 
-            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Error while processing the firmware");
-            g_FirmwareUpload_in_Progress = false;
-            
-            return ESP_FAIL;
-        }
+    // --- wait until everything is in the flash
 
+    if (!g_OTAManager.EndOTATransfer())
+    {
+        return upload_firmware_failed(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Error while processing the firmware");
     }
 
     g_AppLogger.Log("Successfully received a new firmware image");
@@ -910,11 +1611,17 @@ httpd_uri_t apscan_uri_items[] =
 {
     { "/api/v1/apscan", HTTP_GET, config_apscan_handler, NULL },
     { "/api/v1/version", HTTP_GET, config_version_handler, NULL },
+    { "/api/v1/metrics", HTTP_GET, metrics_get_handler, NULL },
+    { "/metrics", HTTP_GET, metrics_text_handler, NULL },
+    { "/api/v1/stream", HTTP_GET, stream_get_handler, NULL },
     { "/api/v1/log/*", HTTP_GET, config_log_handler, NULL },
     { "/api/v1/config", HTTP_GET, config_get_handler, NULL },
     { "/api/v1/config", HTTP_POST, config_post_handler, NULL },
     { "/api/v1/sensorcnt", HTTP_GET, sensor_cnt_get_handler, NULL },
+    { "/api/v1/sensorstats", HTTP_GET, sensor_stats_get_handler, NULL },
     { "/api/v1/air/*", HTTP_GET, sensor_data_get_handler, NULL },
+    { "/api/v1/history/*", HTTP_GET, sensor_history_get_handler, NULL },
+    { "/api/v1/journal/*", HTTP_GET, journal_get_handler, NULL },
     { "/upload", HTTP_POST, upload_firmware_handler, NULL },
     {  "/*", HTTP_GET, rest_common_get_handler, NULL },
 
@@ -935,6 +1642,16 @@ esp_err_t start_rest_server(const char *base_path)
     
     strlcpy(rest_context->base_path, base_path, sizeof(rest_context->base_path));
 
+    if (g_BufferPool.InitPool() != ESP_OK)
+    {
+        ESP_LOGE(REST_TAG, "No memory for the I/O buffers");
+        return ESP_FAIL;
+    }
+
+    // --- without a manifest matching the www partition files are served without it
+
+    g_WwwManifest.InitManifest(base_path);
+
         // --- how many URIs to configure?
 
     const int l_num_config = sizeof(apscan_uri_items) / sizeof(httpd_uri_t);
@@ -0,0 +1,483 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
+
+#include "varint_codec.h"
+#include "sample_journal.h"
+#include "applogger.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *TAG = "SampleJournal";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+SampleJournal g_SampleJournal;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- record layout within a page:
+//
+//     uint8    sensor
+//     uint8    channel count
+//     varint   start of the minute (seconds since boot)
+//     varint   sample count
+//     zigzag varint min, max, avg of every channel (fixed point, see SAMPLE_STORE_SCALE)
+
+#define RECORD_MAX_LEN  (2 + 2 * VARINT_MAX_LEN + 3 * VARINT_MAX_LEN * SAMPLE_STORE_MAX_CHANNELS)
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static void journal_writer_task(void *f_param)
+{
+    g_SampleJournal.WriterLoop();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t page_crc(const uint8_t *f_page)
+{
+    const SampleJournalPageHeader *l_hdr = (const SampleJournalPageHeader *)f_page;
+
+    uint32_t l_crc = esp_rom_crc32_le(0, f_page, offsetof(SampleJournalPageHeader, m_Crc));
+    return esp_rom_crc32_le(l_crc, f_page + sizeof(SampleJournalPageHeader), l_hdr->m_Len);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t SampleJournal::InitJournal(void)
+{
+    ESP_LOGI(TAG, "InitJournal");
+
+    m_Partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)SAMPLE_JOURNAL_PARTITION_SUBTYPE, SAMPLE_JOURNAL_PARTITION_LABEL);
+
+    if (!m_Partition)
+    {
+        // --- devices with an old partition table simply run without the journal
+
+        g_AppLogger.Log("No '%s' partition found - sample journal disabled", SAMPLE_JOURNAL_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    m_PagesPerSector = m_Partition->erase_size / SAMPLE_JOURNAL_PAGE_SIZE;
+    m_PageCount      = (m_Partition->size / m_Partition->erase_size) * m_PagesPerSector;
+
+    if (m_PagesPerSector == 0 || m_PageCount < 2 * m_PagesPerSector)
+    {
+        ESP_LOGE(TAG, "Partition '%s' is too small", SAMPLE_JOURNAL_PARTITION_LABEL);
+        m_Partition = NULL;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    m_Mutex = xSemaphoreCreateMutex();
+    m_Queue = xQueueCreate(SAMPLE_JOURNAL_QUEUE_PAGES, SAMPLE_JOURNAL_PAGE_SIZE);
+
+    if (!m_Mutex || !m_Queue)
+    {
+        m_Partition = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    Mount();
+
+    m_PageLen       = 0;
+    m_PagesWritten  = 0;
+    m_SectorErases  = 0;
+    m_Dropped       = 0;
+
+    if (xTaskCreate(journal_writer_task, "journal", SAMPLE_JOURNAL_TASK_STACK, NULL, SAMPLE_JOURNAL_TASK_PRIO, NULL) != pdPASS)
+    {
+        m_Partition = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    g_AppLogger.Log("Sample journal: boot %u, %u pages, head %u", m_Boot, (unsigned)m_PageCount, (unsigned)m_HeadSeq);
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SampleJournal::Mount(void)
+{
+    // --- find the page with the highest sequence number. Only the headers are read,
+    //     a page with a valid header but a bad CRC still occupies its slot.
+
+    bool     l_found   = false;
+    uint32_t l_maxseq  = 0;
+    uint16_t l_boot    = 0;
+
+    for (uint32_t l_slot = 0; l_slot < m_PageCount; ++l_slot)
+    {
+        SampleJournalPageHeader l_hdr;
+
+        if (esp_partition_read(m_Partition, l_slot * SAMPLE_JOURNAL_PAGE_SIZE, &l_hdr, sizeof(l_hdr)) != ESP_OK) continue;
+        if (l_hdr.m_Magic != SAMPLE_JOURNAL_MAGIC || l_hdr.m_Seq % m_PageCount != l_slot) continue;
+
+        if (!l_found || l_hdr.m_Seq > l_maxseq)
+        {
+            l_found  = true;
+            l_maxseq = l_hdr.m_Seq;
+            l_boot   = l_hdr.m_Boot;
+        }
+    }
+
+    m_HeadSeq = l_found ? l_maxseq + 1 : 0;
+    m_Boot    = l_boot + 1;
+
+    // --- the next slot has to be blank unless it starts a new sector (which is erased
+    //     before writing). A write interrupted by a reset may have left garbage - in that
+    //     case continue with the next sector.
+
+    if (m_HeadSeq % m_PagesPerSector)
+    {
+        uint8_t l_page[SAMPLE_JOURNAL_PAGE_SIZE];
+
+        esp_partition_read(m_Partition, (m_HeadSeq % m_PageCount) * SAMPLE_JOURNAL_PAGE_SIZE, l_page, sizeof(l_page));
+
+        for (int i = 0; i < SAMPLE_JOURNAL_PAGE_SIZE; ++i)
+        {
+            if (l_page[i] != 0xff)
+            {
+                ESP_LOGW(TAG, "Page %u is not blank, skip to the next sector", (unsigned)m_HeadSeq);
+                m_HeadSeq += m_PagesPerSector - m_HeadSeq % m_PagesPerSector;
+                break;
+            }
+        }
+    }
+
+    ESP_LOGI(TAG, "Mounted: %u pages in %u sectors, head %u, boot %u", (unsigned)m_PageCount,
+             (unsigned)(m_PageCount / m_PagesPerSector), (unsigned)m_HeadSeq, m_Boot);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t SampleJournal::GetOldestSeq(void) const
+{
+    // --- the pages of the current wrap plus the previous wrap, except for the sector
+    //     which will be erased next
+
+    int64_t l_oldest = (int64_t)m_HeadSeq - m_HeadSeq % m_PagesPerSector - (m_PageCount - m_PagesPerSector);
+
+    return l_oldest > 0 ? (uint32_t)l_oldest : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SampleJournal::AppendRollups(int f_sensor, int f_channels, const SampleRollup *f_rollups)
+{
+    if (!m_Partition) return;
+
+    uint8_t l_rec[RECORD_MAX_LEN];
+    int     l_len = 0;
+
+    l_rec[l_len++] = (uint8_t)f_sensor;
+    l_rec[l_len++] = (uint8_t)f_channels;
+
+    l_len += varint_put(l_rec + l_len, f_rollups[0].m_Start);
+    l_len += varint_put(l_rec + l_len, f_rollups[0].m_Count);
+
+    for (int c = 0; c < f_channels; ++c)
+    {
+        l_len += varint_put(l_rec + l_len, zigzag_encode(sample_to_fixed(f_rollups[c].m_Min)));
+        l_len += varint_put(l_rec + l_len, zigzag_encode(sample_to_fixed(f_rollups[c].m_Max)));
+        l_len += varint_put(l_rec + l_len, zigzag_encode(sample_to_fixed(f_rollups[c].m_Avg)));
+    }
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    if (m_PageLen + l_len > SAMPLE_JOURNAL_PAYLOAD_SIZE) QueuePage();
+
+    if (m_PageLen == 0) m_PageStartUs = esp_timer_get_time();
+
+    memcpy(m_Page + sizeof(SampleJournalPageHeader) + m_PageLen, l_rec, l_len);
+    m_PageLen += l_len;
+
+    xSemaphoreGive(m_Mutex);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- hand the current page to the writer task. Caller holds the mutex.
+
+void SampleJournal::QueuePage(void)
+{
+    if (m_PageLen == 0) return;
+
+    SampleJournalPageHeader *l_hdr = (SampleJournalPageHeader *)m_Page;
+
+    l_hdr->m_Magic  = SAMPLE_JOURNAL_MAGIC;
+    l_hdr->m_Boot   = m_Boot;
+    l_hdr->m_Len    = m_PageLen;
+
+    // --- unused bytes stay erased
+
+    memset(m_Page + sizeof(SampleJournalPageHeader) + m_PageLen, 0xff, SAMPLE_JOURNAL_PAYLOAD_SIZE - m_PageLen);
+
+    if (xQueueSend(m_Queue, m_Page, 0) != pdTRUE)
+    {
+        m_Dropped++;
+        ESP_LOGW(TAG, "Writer queue full, page dropped");
+    }
+
+    m_PageLen = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SampleJournal::Flush(void)
+{
+    if (!m_Partition) return;
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+    QueuePage();
+    xSemaphoreGive(m_Mutex);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t SampleJournal::WritePage(uint8_t *f_page)
+{
+    SampleJournalPageHeader *l_hdr = (SampleJournalPageHeader *)f_page;
+
+    // --- the sequence number is assigned here, so the slots stay strictly sequential.
+    //     The head is advanced after the write, so readers never see a page in progress.
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+    uint32_t l_seq = m_HeadSeq;
+    xSemaphoreGive(m_Mutex);
+
+    l_hdr->m_Seq = l_seq;
+    l_hdr->m_Crc = page_crc(f_page);
+
+    uint32_t  l_slot = l_seq % m_PageCount;
+    esp_err_t l_err  = ESP_OK;
+
+    if (l_slot % m_PagesPerSector == 0)
+    {
+        l_err = esp_partition_erase_range(m_Partition, l_slot * SAMPLE_JOURNAL_PAGE_SIZE, m_Partition->erase_size);
+
+        if (l_err != ESP_OK) ESP_LOGE(TAG, "Erase of sector at page %u failed: %s", (unsigned)l_slot, esp_err_to_name(l_err));
+    }
+
+    if (l_err == ESP_OK)
+    {
+        l_err = esp_partition_write(m_Partition, l_slot * SAMPLE_JOURNAL_PAGE_SIZE, f_page, SAMPLE_JOURNAL_PAGE_SIZE);
+
+        if (l_err != ESP_OK) ESP_LOGE(TAG, "Write of page %u failed: %s", (unsigned)l_seq, esp_err_to_name(l_err));
+    }
+
+    // --- the slot is used up even if the write failed
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    m_HeadSeq = l_seq + 1;
+
+    if (l_err == ESP_OK)
+    {
+        m_PagesWritten++;
+        if (l_slot % m_PagesPerSector == 0) m_SectorErases++;
+    }
+
+    xSemaphoreGive(m_Mutex);
+
+    return l_err;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SampleJournal::WriterLoop(void)
+{
+    uint8_t l_page[SAMPLE_JOURNAL_PAGE_SIZE];
+
+    while (1)
+    {
+        if (xQueueReceive(m_Queue, l_page, 1000 / portTICK_PERIOD_MS) == pdTRUE)
+        {
+            WritePage(l_page);
+            continue;
+        }
+
+        // --- nothing to write: check whether the current page waited long enough
+
+        xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+        if (m_PageLen && esp_timer_get_time() - m_PageStartUs >= (int64_t)SAMPLE_JOURNAL_FLUSH_SEC * 1000000)
+        {
+            QueuePage();
+        }
+
+        xSemaphoreGive(m_Mutex);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SampleJournal::CursorFromOldest(SampleJournalCursor *f_cursor)
+{
+    CursorFromSeq(f_cursor, 0);
+}
+
+void SampleJournal::CursorFromSeq(SampleJournalCursor *f_cursor, uint32_t f_seq)
+{
+    f_cursor->m_Seq     = f_seq;
+    f_cursor->m_Pos     = 0;
+    f_cursor->m_Loaded  = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+bool SampleJournal::ReadNext(SampleJournalCursor *f_cursor, SampleJournalRecord *f_record)
+{
+    if (!m_Partition) return false;
+
+    while (1)
+    {
+        xSemaphoreTake(m_Mutex, portMAX_DELAY);
+        uint32_t l_head   = m_HeadSeq;
+        uint32_t l_oldest = GetOldestSeq();
+        xSemaphoreGive(m_Mutex);
+
+        if (f_cursor->m_Seq < l_oldest)
+        {
+            f_cursor->m_Seq     = l_oldest;
+            f_cursor->m_Loaded  = false;
+        }
+
+        if (f_cursor->m_Seq >= l_head) return false;
+
+        SampleJournalPageHeader *l_hdr = (SampleJournalPageHeader *)f_cursor->m_Page;
+
+        if (!f_cursor->m_Loaded)
+        {
+            esp_err_t l_err = esp_partition_read(m_Partition, (f_cursor->m_Seq % m_PageCount) * SAMPLE_JOURNAL_PAGE_SIZE,
+                                                 f_cursor->m_Page, SAMPLE_JOURNAL_PAGE_SIZE);
+
+            // --- skip pages which are broken or were overwritten in the meantime
+
+            if (l_err != ESP_OK || l_hdr->m_Magic != SAMPLE_JOURNAL_MAGIC || l_hdr->m_Seq != f_cursor->m_Seq ||
+                l_hdr->m_Len > SAMPLE_JOURNAL_PAYLOAD_SIZE || l_hdr->m_Crc != page_crc(f_cursor->m_Page))
+            {
+                ESP_LOGD(TAG, "Skip page %u", (unsigned)f_cursor->m_Seq);
+                f_cursor->m_Seq++;
+                continue;
+            }
+
+            f_cursor->m_Loaded  = true;
+            f_cursor->m_Pos     = 0;
+        }
+
+        // --- decode the next record
+
+        const uint8_t *l_data = f_cursor->m_Page + sizeof(SampleJournalPageHeader);
+        int            l_pos  = f_cursor->m_Pos;
+        int            l_end  = l_hdr->m_Len;
+        bool           l_ok   = l_pos + 2 <= l_end;
+        uint32_t       l_v;
+
+        if (l_ok)
+        {
+            f_record->m_Boot     = l_hdr->m_Boot;
+            f_record->m_Sensor   = l_data[l_pos++];
+            f_record->m_Channels = l_data[l_pos++];
+
+            l_ok = f_record->m_Channels <= SAMPLE_STORE_MAX_CHANNELS;
+        }
+
+        int l_n;
+
+        if (l_ok && (l_ok = (l_n = varint_get(l_data + l_pos, l_end - l_pos, &l_v)) > 0)) { f_record->m_Time = l_v; l_pos += l_n; }
+        if (l_ok && (l_ok = (l_n = varint_get(l_data + l_pos, l_end - l_pos, &l_v)) > 0)) { f_record->m_Count = l_v; l_pos += l_n; }
+
+        for (int c = 0; l_ok && c < f_record->m_Channels; ++c)
+        {
+            float *l_dst[3] = { &f_record->m_Min[c], &f_record->m_Max[c], &f_record->m_Avg[c] };
+
+            for (int k = 0; l_ok && k < 3; ++k)
+            {
+                l_n  = varint_get(l_data + l_pos, l_end - l_pos, &l_v);
+                l_ok = l_n > 0;
+
+                *l_dst[k] = sample_from_fixed(zigzag_decode(l_v));
+                l_pos += l_n;
+            }
+        }
+
+        if (!l_ok)
+        {
+            // --- end of page (or a page we cannot decode): continue with the next one
+
+            f_cursor->m_Seq++;
+            f_cursor->m_Loaded = false;
+            continue;
+        }
+
+        f_cursor->m_Pos = l_pos;
+        return true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SampleJournal::GetInfo(SampleJournalInfo *f_info)
+{
+    memset(f_info, 0, sizeof(SampleJournalInfo));
+
+    if (!m_Partition) return;
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    f_info->m_PageCount     = m_PageCount;
+    f_info->m_OldestSeq     = GetOldestSeq();
+    f_info->m_HeadSeq       = m_HeadSeq;
+    f_info->m_Boot          = m_Boot;
+    f_info->m_PagesWritten  = m_PagesWritten;
+    f_info->m_SectorErases  = m_SectorErases;
+    f_info->m_Dropped       = m_Dropped;
+    f_info->m_Pending       = m_PageLen;
+
+    xSemaphoreGive(m_Mutex);
+}
@@ -0,0 +1,175 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SAMPLE_JOURNAL_H_
+#define	SAMPLE_JOURNAL_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "esp_partition.h"
+
+#include "sample_store.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the journal lives on its own data partition (see partitions_example.csv). It is a
+//     ring of CRC protected pages written strictly sequentially; a sector is erased just
+//     before its first page is written, so every sector sees one erase per wrap.
+
+#define SAMPLE_JOURNAL_PARTITION_LABEL      "samples"
+#define SAMPLE_JOURNAL_PARTITION_SUBTYPE    0x40
+
+#define SAMPLE_JOURNAL_PAGE_SIZE            512
+#define SAMPLE_JOURNAL_MAGIC                0x314a5345      // --- "ESJ1"
+#define SAMPLE_JOURNAL_FLUSH_SEC            600             // --- a partly filled page is written after this time
+#define SAMPLE_JOURNAL_QUEUE_PAGES          4               // --- full pages waiting for the writer task
+
+#define SAMPLE_JOURNAL_TASK_STACK           4096
+#define SAMPLE_JOURNAL_TASK_PRIO            3
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- page header, followed by m_Len bytes of records. The CRC covers the first 12 bytes
+//     of the header and the records.
+
+typedef struct SampleJournalPageHeader_s
+{
+    uint32_t    m_Magic;
+    uint32_t    m_Seq;          // --- page sequence number, the page is stored at slot m_Seq % page count
+    uint16_t    m_Boot;         // --- boot counter, times are relative to this boot
+    uint16_t    m_Len;
+    uint32_t    m_Crc;
+} SampleJournalPageHeader;
+
+#define SAMPLE_JOURNAL_PAYLOAD_SIZE         (SAMPLE_JOURNAL_PAGE_SIZE - sizeof(SampleJournalPageHeader))
+
+// --- one journal entry: the 1 minute rollups of all channels of a sensor
+
+typedef struct SampleJournalRecord_s
+{
+    uint16_t    m_Boot;
+    uint8_t     m_Sensor;       // --- 0 based
+    uint8_t     m_Channels;
+    uint32_t    m_Time;         // --- start of the minute, seconds since boot
+    uint32_t    m_Count;
+    float       m_Min[SAMPLE_STORE_MAX_CHANNELS];
+    float       m_Max[SAMPLE_STORE_MAX_CHANNELS];
+    float       m_Avg[SAMPLE_STORE_MAX_CHANNELS];
+} SampleJournalRecord;
+
+// --- read position. Pages which were overwritten in the meantime are skipped.
+
+typedef struct SampleJournalCursor_s
+{
+    uint32_t    m_Seq;          // --- page to read next
+    uint16_t    m_Pos;          // --- record offset within the loaded page
+    bool        m_Loaded;
+    uint8_t     m_Page[SAMPLE_JOURNAL_PAGE_SIZE];
+} SampleJournalCursor;
+
+typedef struct SampleJournalInfo_s
+{
+    uint32_t    m_PageCount;
+    uint32_t    m_OldestSeq;
+    uint32_t    m_HeadSeq;      // --- next page to be written
+    uint16_t    m_Boot;
+    uint32_t    m_PagesWritten; // --- since boot
+    uint32_t    m_SectorErases; // --- since boot
+    uint32_t    m_Dropped;      // --- pages lost because the writer could not keep up
+    uint16_t    m_Pending;      // --- bytes in the current page
+} SampleJournalInfo;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class SampleJournal
+{
+public:
+
+    // --- action functions
+
+    esp_err_t InitJournal(void);
+    void AppendRollups(int f_sensor, int f_channels, const SampleRollup *f_rollups);
+    void Flush(void);
+
+    // --- reading
+
+    void CursorFromOldest(SampleJournalCursor *f_cursor);
+    void CursorFromSeq(SampleJournalCursor *f_cursor, uint32_t f_seq);
+    bool ReadNext(SampleJournalCursor *f_cursor, SampleJournalRecord *f_record);
+
+    void GetInfo(SampleJournalInfo *f_info);
+
+    // --- internal functions do not use
+
+    void WriterLoop(void);
+
+private:
+
+    void Mount(void);
+    void QueuePage(void);
+    esp_err_t WritePage(uint8_t *f_page);
+    uint32_t GetOldestSeq(void) const;
+
+    const esp_partition_t   *m_Partition = NULL;
+    uint32_t                m_PageCount;
+    uint32_t                m_PagesPerSector;
+
+    uint32_t                m_HeadSeq;
+    uint16_t                m_Boot;
+
+    uint8_t                 m_Page[SAMPLE_JOURNAL_PAGE_SIZE];
+    uint16_t                m_PageLen;
+    int64_t                 m_PageStartUs;
+
+    uint32_t                m_PagesWritten;
+    uint32_t                m_SectorErases;
+    uint32_t                m_Dropped;
+
+    SemaphoreHandle_t       m_Mutex = NULL;
+    QueueHandle_t           m_Queue = NULL;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+extern SampleJournal g_SampleJournal;
+
+#endif
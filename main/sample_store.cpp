@@ -0,0 +1,447 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+
+#include "varint_codec.h"
+#include "sample_store.h"
+#include "sample_journal.h"
+#include "sensor_manager.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *TAG = "SampleStore";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+SampleStore g_SampleStore;
+
+static const uint32_t   g_TierSeconds[SAMPLE_STORE_TIER_CNT]    = SAMPLE_STORE_TIER_SECONDS;
+static const uint16_t   g_TierEntries[SAMPLE_STORE_TIER_CNT]    = SAMPLE_STORE_TIER_ENTRIES;
+static const char       *g_TierNames[SAMPLE_STORE_TIER_CNT]     = SAMPLE_STORE_TIER_NAMES;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- raw block layout:
+//
+//     int64    start time in ms (first sample)
+//     uint16   sample count
+//     uint16   used bytes including this header
+//     int32    values of the first sample, one per channel
+//     ...      one record per further sample: zigzag varint of the change of the time
+//              delta (delta of delta, usually 0 for a periodic sensor), followed by the
+//              zigzag varint value delta of each channel
+
+#define BLOCK_OFS_START     0
+#define BLOCK_OFS_COUNT     8
+#define BLOCK_OFS_USED      10
+#define BLOCK_OFS_VALUES    12
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t SampleStore::InitStore(void)
+{
+    ESP_LOGI(TAG, "InitStore");
+
+    m_Mutex = xSemaphoreCreateMutex();
+    if (!m_Mutex) return ESP_ERR_NO_MEM;
+
+    size_t l_total = 0;
+
+    for (int i = 0; i < SENSOR_CONFIG_SENSOR_CNT; ++i)
+    {
+        SensorStore &l_s = m_Stores[i];
+
+        memset(&l_s, 0, sizeof(SensorStore));
+
+        l_s.m_Channels = g_SensorManager.GetSensor(i)->GetChannelCount();
+
+        if (l_s.m_Channels > SAMPLE_STORE_MAX_CHANNELS)
+        {
+            ESP_LOGW(TAG, "Sensor %d has %d channels, only %d are stored", i+1, l_s.m_Channels, SAMPLE_STORE_MAX_CHANNELS);
+            l_s.m_Channels = SAMPLE_STORE_MAX_CHANNELS;
+        }
+
+        if (l_s.m_Channels == 0) continue;
+
+        l_s.m_Blocks = (uint8_t *)calloc(SAMPLE_STORE_RAW_BLOCKS, SAMPLE_STORE_BLOCK_SIZE);
+        if (!l_s.m_Blocks) return ESP_ERR_NO_MEM;
+
+        l_total += SAMPLE_STORE_RAW_BLOCKS * SAMPLE_STORE_BLOCK_SIZE;
+
+        for (int t = 0; t < SAMPLE_STORE_TIER_CNT; ++t)
+        {
+            l_s.m_Tiers[t].m_Ring = (SampleRollup *)calloc(g_TierEntries[t] * l_s.m_Channels, sizeof(SampleRollup));
+            if (!l_s.m_Tiers[t].m_Ring) return ESP_ERR_NO_MEM;
+
+            l_total += g_TierEntries[t] * l_s.m_Channels * sizeof(SampleRollup);
+        }
+    }
+
+    ESP_LOGI(TAG, "Sample store uses %u bytes", (unsigned)l_total);
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SampleStore::StartBlock(SensorStore &f_store, int64_t f_time_ms, const int32_t *f_values)
+{
+    if (f_store.m_UsedBlocks)
+    {
+        f_store.m_CurBlock = (f_store.m_CurBlock + 1) % SAMPLE_STORE_RAW_BLOCKS;
+    }
+
+    if (f_store.m_UsedBlocks < SAMPLE_STORE_RAW_BLOCKS) f_store.m_UsedBlocks++;
+
+    uint8_t  *l_block = f_store.m_Blocks + f_store.m_CurBlock * SAMPLE_STORE_BLOCK_SIZE;
+    uint16_t l_count  = 1;
+    uint16_t l_used   = BLOCK_OFS_VALUES + f_store.m_Channels * sizeof(int32_t);
+
+    memcpy(l_block + BLOCK_OFS_START, &f_time_ms, sizeof(int64_t));
+    memcpy(l_block + BLOCK_OFS_COUNT, &l_count, sizeof(uint16_t));
+    memcpy(l_block + BLOCK_OFS_USED, &l_used, sizeof(uint16_t));
+    memcpy(l_block + BLOCK_OFS_VALUES, f_values, f_store.m_Channels * sizeof(int32_t));
+
+    f_store.m_LastDelta = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SampleStore::AddToTier(int f_sensor, SensorStore &f_store, int f_tier, uint32_t f_sec, const int32_t *f_values)
+{
+    Tier     &l_tier   = f_store.m_Tiers[f_tier];
+    uint32_t l_bucket  = f_sec - f_sec % g_TierSeconds[f_tier];
+
+    // --- a new bucket starts: move the finished rollups to the ring
+
+    if (l_tier.m_Acc[0].m_Count && l_tier.m_Acc[0].m_Start != l_bucket)
+    {
+        for (int c = 0; c < f_store.m_Channels; ++c)
+        {
+            Accumulator  &l_acc = l_tier.m_Acc[c];
+            SampleRollup &l_r   = l_tier.m_Ring[c * g_TierEntries[f_tier] + l_tier.m_Head];
+
+            l_r.m_Start = l_acc.m_Start;
+            l_r.m_Count = l_acc.m_Count;
+            l_r.m_Min   = sample_from_fixed(l_acc.m_Min);
+            l_r.m_Max   = sample_from_fixed(l_acc.m_Max);
+            l_r.m_Avg   = (float)l_acc.m_Sum / l_acc.m_Count / SAMPLE_STORE_SCALE;
+
+            l_acc.m_Count = 0;
+        }
+
+        // --- the finest tier goes to the flash journal as well
+
+        if (f_tier == 0)
+        {
+            SampleRollup l_rollups[SAMPLE_STORE_MAX_CHANNELS];
+
+            for (int c = 0; c < f_store.m_Channels; ++c) l_rollups[c] = l_tier.m_Ring[c * g_TierEntries[f_tier] + l_tier.m_Head];
+
+            g_SampleJournal.AppendRollups(f_sensor, f_store.m_Channels, l_rollups);
+        }
+
+        l_tier.m_Head = (l_tier.m_Head + 1) % g_TierEntries[f_tier];
+        if (l_tier.m_Used < g_TierEntries[f_tier]) l_tier.m_Used++;
+    }
+
+    for (int c = 0; c < f_store.m_Channels; ++c)
+    {
+        Accumulator &l_acc = l_tier.m_Acc[c];
+
+        if (l_acc.m_Count == 0)
+        {
+            l_acc.m_Start = l_bucket;
+            l_acc.m_Min   = f_values[c];
+            l_acc.m_Max   = f_values[c];
+            l_acc.m_Sum   = 0;
+        }
+
+        if (f_values[c] < l_acc.m_Min) l_acc.m_Min = f_values[c];
+        if (f_values[c] > l_acc.m_Max) l_acc.m_Max = f_values[c];
+
+        l_acc.m_Sum += f_values[c];
+        l_acc.m_Count++;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SampleStore::AddSample(int f_sensor, int64_t f_time_ms, const float *f_values)
+{
+    assert(f_sensor < SENSOR_CONFIG_SENSOR_CNT);
+
+    SensorStore &l_s = m_Stores[f_sensor];
+
+    if (!m_Mutex || l_s.m_Channels == 0) return;
+
+    int32_t l_values[SAMPLE_STORE_MAX_CHANNELS];
+
+    for (int c = 0; c < l_s.m_Channels; ++c) l_values[c] = sample_to_fixed(f_values[c]);
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    // --- raw samples: encode the record and append it to the current block
+
+    if (l_s.m_UsedBlocks == 0)
+    {
+        StartBlock(l_s, f_time_ms, l_values);
+    }
+    else
+    {
+        uint8_t l_rec[VARINT_MAX_LEN * (SAMPLE_STORE_MAX_CHANNELS + 1)];
+        int     l_len   = 0;
+        int32_t l_delta = (int32_t)(f_time_ms - l_s.m_LastMs);
+
+        l_len += varint_put(l_rec + l_len, zigzag_encode(l_delta - l_s.m_LastDelta));
+
+        for (int c = 0; c < l_s.m_Channels; ++c)
+        {
+            l_len += varint_put(l_rec + l_len, zigzag_encode(l_values[c] - l_s.m_LastValues[c]));
+        }
+
+        uint8_t  *l_block = l_s.m_Blocks + l_s.m_CurBlock * SAMPLE_STORE_BLOCK_SIZE;
+        uint16_t l_count, l_used;
+
+        memcpy(&l_count, l_block + BLOCK_OFS_COUNT, sizeof(uint16_t));
+        memcpy(&l_used, l_block + BLOCK_OFS_USED, sizeof(uint16_t));
+
+        if (l_used + l_len > SAMPLE_STORE_BLOCK_SIZE)
+        {
+            // --- block full: start the next one (overwrites the oldest block)
+
+            StartBlock(l_s, f_time_ms, l_values);
+        }
+        else
+        {
+            memcpy(l_block + l_used, l_rec, l_len);
+
+            l_count++;
+            l_used += l_len;
+
+            memcpy(l_block + BLOCK_OFS_COUNT, &l_count, sizeof(uint16_t));
+            memcpy(l_block + BLOCK_OFS_USED, &l_used, sizeof(uint16_t));
+
+            l_s.m_LastDelta = l_delta;
+        }
+    }
+
+    l_s.m_LastMs = f_time_ms;
+    memcpy(l_s.m_LastValues, l_values, sizeof(int32_t) * l_s.m_Channels);
+
+    // --- rollups
+
+    for (int t = 0; t < SAMPLE_STORE_TIER_CNT; ++t)
+    {
+        AddToTier(f_sensor, l_s, t, (uint32_t)(f_time_ms / 1000), l_values);
+    }
+
+    xSemaphoreGive(m_Mutex);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int SampleStore::SnapshotRaw(int f_sensor, SampleRawSnapshot *f_snap)
+{
+    assert(f_sensor < SENSOR_CONFIG_SENSOR_CNT);
+
+    SensorStore &l_s = m_Stores[f_sensor];
+
+    f_snap->m_Channels  = 0;
+    f_snap->m_Blocks    = 0;
+
+    if (!m_Mutex || l_s.m_Channels == 0) return 0;
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    // --- copy the blocks oldest first, so the snapshot is contiguous
+
+    int l_first = (l_s.m_CurBlock + SAMPLE_STORE_RAW_BLOCKS + 1 - l_s.m_UsedBlocks) % SAMPLE_STORE_RAW_BLOCKS;
+
+    for (int b = 0; b < l_s.m_UsedBlocks; ++b)
+    {
+        memcpy(f_snap->m_Data + b * SAMPLE_STORE_BLOCK_SIZE,
+               l_s.m_Blocks + ((l_first + b) % SAMPLE_STORE_RAW_BLOCKS) * SAMPLE_STORE_BLOCK_SIZE, SAMPLE_STORE_BLOCK_SIZE);
+    }
+
+    f_snap->m_Channels  = l_s.m_Channels;
+    f_snap->m_Blocks    = l_s.m_UsedBlocks;
+
+    xSemaphoreGive(m_Mutex);
+
+    return f_snap->m_Blocks;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int SampleStore::DecodeRaw(const SampleRawSnapshot *f_snap, SampleStoreRawCallback f_cb, void *f_ctx)
+{
+    int     l_total = 0;
+    int     l_channels = f_snap->m_Channels;
+    int32_t l_values[SAMPLE_STORE_MAX_CHANNELS];
+    float   l_floats[SAMPLE_STORE_MAX_CHANNELS];
+
+    for (int b = 0; b < f_snap->m_Blocks; ++b)
+    {
+        const uint8_t *l_block = f_snap->m_Data + b * SAMPLE_STORE_BLOCK_SIZE;
+
+        int64_t  l_time;
+        uint16_t l_count, l_used;
+
+        memcpy(&l_time, l_block + BLOCK_OFS_START, sizeof(int64_t));
+        memcpy(&l_count, l_block + BLOCK_OFS_COUNT, sizeof(uint16_t));
+        memcpy(&l_used, l_block + BLOCK_OFS_USED, sizeof(uint16_t));
+        memcpy(l_values, l_block + BLOCK_OFS_VALUES, l_channels * sizeof(int32_t));
+
+        int     l_pos   = BLOCK_OFS_VALUES + l_channels * sizeof(int32_t);
+        int32_t l_delta = 0;
+
+        for (int i = 0; i < l_count; ++i)
+        {
+            if (i > 0)
+            {
+                uint32_t l_v = 0;
+
+                l_pos   += varint_get(l_block + l_pos, l_used - l_pos, &l_v);
+                l_delta += zigzag_decode(l_v);
+                l_time  += l_delta;
+
+                for (int c = 0; c < l_channels; ++c)
+                {
+                    l_pos       += varint_get(l_block + l_pos, l_used - l_pos, &l_v);
+                    l_values[c] += zigzag_decode(l_v);
+                }
+            }
+
+            for (int c = 0; c < l_channels; ++c) l_floats[c] = sample_from_fixed(l_values[c]);
+
+            f_cb(f_ctx, l_time, l_floats, l_channels);
+            l_total++;
+        }
+
+        assert(l_pos <= l_used);
+    }
+
+    return l_total;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int SampleStore::SnapshotRollups(int f_sensor, int f_tier, SampleRollup *f_buf, int f_max_rows)
+{
+    assert(f_sensor < SENSOR_CONFIG_SENSOR_CNT);
+    assert(f_tier < SAMPLE_STORE_TIER_CNT);
+
+    SensorStore &l_s = m_Stores[f_sensor];
+
+    if (!m_Mutex || l_s.m_Channels == 0) return 0;
+
+    Tier &l_tier   = l_s.m_Tiers[f_tier];
+    int  l_entries = g_TierEntries[f_tier];
+    int  l_rows    = 0;
+
+    xSemaphoreTake(m_Mutex, portMAX_DELAY);
+
+    int l_first = (l_tier.m_Head + l_entries - l_tier.m_Used) % l_entries;
+
+    // --- all channels are updated together, so they have the same number of rows
+
+    for (int c = 0; c < l_s.m_Channels; ++c)
+    {
+        SampleRollup *l_dst = f_buf + c * f_max_rows;
+
+        l_rows = 0;
+
+        for (int i = 0; i < l_tier.m_Used && l_rows < f_max_rows; ++i)
+        {
+            l_dst[l_rows++] = l_tier.m_Ring[c * l_entries + (l_first + i) % l_entries];
+        }
+
+        // --- the bucket currently being filled is reported as well
+
+        const Accumulator &l_acc = l_tier.m_Acc[c];
+
+        if (l_acc.m_Count && l_rows < f_max_rows)
+        {
+            SampleRollup &l_r = l_dst[l_rows++];
+
+            l_r.m_Start = l_acc.m_Start;
+            l_r.m_Count = l_acc.m_Count;
+            l_r.m_Min   = sample_from_fixed(l_acc.m_Min);
+            l_r.m_Max   = sample_from_fixed(l_acc.m_Max);
+            l_r.m_Avg   = (float)l_acc.m_Sum / l_acc.m_Count / SAMPLE_STORE_SCALE;
+        }
+    }
+
+    xSemaphoreGive(m_Mutex);
+
+    return l_rows;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+int SampleStore::GetChannelCount(int f_sensor) const
+{
+    assert(f_sensor < SENSOR_CONFIG_SENSOR_CNT);
+    return m_Stores[f_sensor].m_Channels;
+}
+
+int SampleStore::FindTier(const char *f_name)
+{
+    for (int t = 0; t < SAMPLE_STORE_TIER_CNT; ++t)
+    {
+        if (strcmp(f_name, g_TierNames[t]) == 0) return t;
+    }
+
+    return -1;
+}
+
+int SampleStore::GetTierRows(int f_tier)
+{
+    return f_tier >= 0 && f_tier < SAMPLE_STORE_TIER_CNT ? g_TierEntries[f_tier] + 1 : 0;
+}
+
+const char *SampleStore::GetTierName(int f_tier)
+{
+    return f_tier >= 0 && f_tier < SAMPLE_STORE_TIER_CNT ? g_TierNames[f_tier] : "";
+}
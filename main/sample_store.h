@@ -0,0 +1,188 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SAMPLE_STORE_H_
+#define	SAMPLE_STORE_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <math.h>
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+
+#include "sensor_config.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- memory layout. All buffers are allocated once in InitStore(), adding a sample
+//     never allocates.
+
+#define SAMPLE_STORE_MAX_CHANNELS       8           // --- per sensor, further channels are ignored
+#define SAMPLE_STORE_SCALE              100         // --- values are stored as int32 fixed point (0.01)
+
+#define SAMPLE_STORE_BLOCK_SIZE         128         // --- raw samples: delta/varint encoded blocks
+#define SAMPLE_STORE_RAW_BLOCKS         16          // --- blocks per sensor (ring)
+
+#define SAMPLE_STORE_TIER_CNT           3
+#define SAMPLE_STORE_TIER_SECONDS       { 60, 15 * 60, 60 * 60 }
+#define SAMPLE_STORE_TIER_ENTRIES       { 60, 48, 48 }          // --- 1 hour, 12 hours, 2 days
+#define SAMPLE_STORE_TIER_NAMES         { "1m", "15m", "1h" }
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- conversion to the fixed point representation, clamped to int32
+
+static inline int32_t sample_to_fixed(float f_value)
+{
+    float l_v = roundf(f_value * SAMPLE_STORE_SCALE);
+
+    if (!(l_v == l_v)) return 0;        // --- NaN
+    if (l_v > 2.0e9f) return 2000000000;
+    if (l_v < -2.0e9f) return -2000000000;
+
+    return (int32_t)l_v;
+}
+
+static inline float sample_from_fixed(int32_t f_value)
+{
+    return (float)f_value / SAMPLE_STORE_SCALE;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- one min/max/avg rollup of a channel. Times are seconds since boot.
+
+typedef struct SampleRollup_s
+{
+    uint32_t    m_Start;
+    uint32_t    m_Count;
+    float       m_Min;
+    float       m_Max;
+    float       m_Avg;
+} SampleRollup;
+
+// --- copy of the raw ring of one sensor, blocks oldest first. It is taken under the lock
+//     and decoded without it, so readers may block (e.g. on the network) while decoding.
+
+typedef struct SampleRawSnapshot_s
+{
+    int         m_Channels;
+    int         m_Blocks;
+    uint8_t     m_Data[SAMPLE_STORE_RAW_BLOCKS * SAMPLE_STORE_BLOCK_SIZE];
+} SampleRawSnapshot;
+
+// --- callback for decoding. f_values holds one value per channel.
+
+typedef void (*SampleStoreRawCallback)(void *f_ctx, int64_t f_time_ms, const float *f_values, int f_channels);
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class SampleStore
+{
+public:
+
+    // --- action functions
+
+    esp_err_t InitStore(void);
+    void AddSample(int f_sensor, int64_t f_time_ms, const float *f_values);
+
+    // --- reading. Snapshots are consistent copies, entries are oldest first. Rollups are
+    //     copied channel major into f_buf (channels * f_max_rows), the number of rows
+    //     (the same for all channels) is returned. GetTierRows() is the maximum.
+
+    int SnapshotRaw(int f_sensor, SampleRawSnapshot *f_snap);
+    static int DecodeRaw(const SampleRawSnapshot *f_snap, SampleStoreRawCallback f_cb, void *f_ctx);
+    int SnapshotRollups(int f_sensor, int f_tier, SampleRollup *f_buf, int f_max_rows);
+
+    // --- getters
+
+    int GetChannelCount(int f_sensor) const;
+    static int FindTier(const char *f_name);
+    static int GetTierRows(int f_tier);
+    static const char *GetTierName(int f_tier);
+
+private:
+
+    // --- accumulator of the rollup currently being filled
+
+    struct Accumulator
+    {
+        uint32_t    m_Start;
+        uint32_t    m_Count;
+        int32_t     m_Min;
+        int32_t     m_Max;
+        int64_t     m_Sum;
+    };
+
+    struct Tier
+    {
+        SampleRollup    *m_Ring;            // --- m_Entries * channels, channel major
+        uint16_t        m_Head;             // --- next entry to write
+        uint16_t        m_Used;
+        Accumulator     m_Acc[SAMPLE_STORE_MAX_CHANNELS];
+    };
+
+    struct SensorStore
+    {
+        int         m_Channels;
+
+        // --- raw ring
+
+        uint8_t     *m_Blocks;
+        uint16_t    m_CurBlock;
+        uint16_t    m_UsedBlocks;
+
+        int64_t     m_LastMs;
+        int32_t     m_LastDelta;
+        int32_t     m_LastValues[SAMPLE_STORE_MAX_CHANNELS];
+
+        Tier        m_Tiers[SAMPLE_STORE_TIER_CNT];
+    };
+
+    void AddToTier(int f_sensor, SensorStore &f_store, int f_tier, uint32_t f_sec, const int32_t *f_values);
+    void StartBlock(SensorStore &f_store, int64_t f_time_ms, const int32_t *f_values);
+
+    SensorStore         m_Stores[SENSOR_CONFIG_SENSOR_CNT];
+    SemaphoreHandle_t   m_Mutex = NULL;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+extern SampleStore g_SampleStore;
+
+#endif
@@ -39,12 +39,17 @@
 
 //#define SENSOR_CONFIG_STUB_SENSORS 
 
-// --- these are my device configurations - please change accordingly
+// --- these are my device configurations - please change accordingly. The host build
+//     (see host/) always uses the simulation device.
 
+#ifdef ESPLOGGER_HOST_BUILD
+#define DEVICE_HOST_SIMULATION
+#else
 //#define DEVICE_ESP_TEMPLOGGER  
 //#define DEVICE_ESP_DUSTLOGGER  
 //#define DEVICE_ESP_TEMPLOGGERV2
 #define DEVICE_ESP_DUSTLOGGERV2  
+#endif
 
 // --- how many sensors do we have?
 
@@ -116,6 +121,38 @@
 
 #endif
 
+#ifdef DEVICE_HOST_SIMULATION
+
+    #ifndef HOST_SIMULATION_SENSOR_CNT
+    #define HOST_SIMULATION_SENSOR_CNT  2
+    #endif
+
+    #define SENSOR_CONFIG_SENSOR_CNT    HOST_SIMULATION_SENSOR_CNT
+
+    // --- sensor 1 is the real HM3300 driver talking to an emulated device on the stubbed I2C bus,
+    //     all others are scriptable fake sensors
+
+	// --- HM3300 Pins: 0: SDA 1: SCL / Data: 0: I2C port 1: I2C address
+	// --- CFakeSensor Pins: <not used> / Data: 0: sensor number in the simulation script
+
+    #define SENSOR_CONFIG_SENSOR1_CLASS CHM3300Sensor
+    #define SENSOR_CONFIG_SENSOR1_PINS  {GPIO_NUM_27,GPIO_NUM_25,GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC}
+    #define SENSOR_CONFIG_SENSOR1_DATA  {0,0x40,0,0,0,0}
+
+    #define SENSOR_CONFIG_SENSOR2_CLASS CFakeSensor
+    #define SENSOR_CONFIG_SENSOR2_PINS  {GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC}
+    #define SENSOR_CONFIG_SENSOR2_DATA  {2,0,0,0,0,0}
+
+    #define SENSOR_CONFIG_SENSOR3_CLASS CFakeSensor
+    #define SENSOR_CONFIG_SENSOR3_PINS  {GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC}
+    #define SENSOR_CONFIG_SENSOR3_DATA  {3,0,0,0,0,0}
+
+    #define SENSOR_CONFIG_SENSOR4_CLASS CFakeSensor
+    #define SENSOR_CONFIG_SENSOR4_PINS  {GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC,GPIO_NUM_NC}
+    #define SENSOR_CONFIG_SENSOR4_DATA  {4,0,0,0,0,0}
+
+#endif
+
 // --- as of now up to 4 sensors are possible, just add some #if statements in the sensor manager if you need more
 
 #endif
\ No newline at end of file
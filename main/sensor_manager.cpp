@@ -36,17 +36,27 @@
 #include <math.h>
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
 #include "driver/uart.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
 
+#ifdef ESPLOGGER_HOST_BUILD
+#include "hm3300_sensor.h"
+#include "fake_sensor.h"
+#else
 #include "vindriktning.h"
 #include "ESP32_SHT1x.h"
 #include "cbme280_sensor.h"
 #include "hm3300_sensor.h"
+#endif
 
 #include "sensor_manager.h"
+#include "sample_store.h"
 #include "applogger.h"
+#include "perf_metrics.h"
+#include "event_stream.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -58,27 +68,139 @@ SensorManager g_SensorManager;
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void SensorManager::ProcessMeasurements(void)
+static void sensor_acquisition_task(void *f_param)
 {
-   // --- now measure on all sensors
+    // --- the task parameter is the sensor index
 
-    for (int i = 0; i < SENSOR_CONFIG_SENSOR_CNT; ++i)
+    g_SensorManager.AcquisitionLoop((int)(intptr_t)f_param);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SensorManager::AcquisitionLoop(int f_idx)
+{
+    CSensor *l_sensor = m_Sensors[f_idx];
+
+    const int64_t l_period_us   = (int64_t)l_sensor->GetMeasurementPeriodMs() * 1000;
+    const int64_t l_deadline_us = (int64_t)l_sensor->GetMeasurementDeadlineMs() * 1000;
+
+    // --- the schedule is kept in absolute microseconds, so the delays of the tick
+    //     based sleep do not add up
+
+    int64_t l_due = esp_timer_get_time();
+
+    while (1)
     {
-        if (!m_Sensors[i]->PerformMeasurement())
+        int64_t l_start = esp_timer_get_time();
+        bool    l_ok    = l_sensor->PerformMeasurement();
+        int64_t l_end   = esp_timer_get_time();
+
+        uint32_t l_jitter   = (uint32_t)(l_start - l_due);
+        uint32_t l_duration = (uint32_t)(l_end - l_start);
+        int64_t  l_finish   = l_end - l_due;
+        bool     l_missed   = l_finish > l_deadline_us;
+
+        g_PerfMetrics.Record(PERF_STAGE_SENSOR_READ, l_duration);
+
+        // --- next due time. If we are already behind, skip the periods we missed
+        //     instead of measuring back to back
+
+        l_due += l_period_us;
+
+        uint32_t l_skipped = 0;
+
+        if (l_end >= l_due)
         {
-             g_AppLogger.Log("Failed to perform a measurement on sensor %d", i+1);
-             g_AppLogger.Log("Sensor Identification: %s", m_Sensors[i]->GetSensorDescriptionString().c_str());
+            l_skipped = (uint32_t)((l_end - l_due) / l_period_us) + 1;
+            l_due += l_skipped * l_period_us;
+        }
+
+        taskENTER_CRITICAL(&m_StatsLock);
+
+        SensorAcquisitionStats &l_stats = m_Stats[f_idx];
+
+        l_stats.m_Measurements++;
+        if (!l_ok) l_stats.m_Failures++;
+        if (l_missed) l_stats.m_DeadlineMisses++;
+        l_stats.m_SkippedPeriods += l_skipped;
 
+        l_stats.m_LastJitterUs  = l_jitter;
+        l_stats.m_SumJitterUs  += l_jitter;
+        if (l_jitter > l_stats.m_MaxJitterUs) l_stats.m_MaxJitterUs = l_jitter;
+
+        l_stats.m_LastDurationUs = l_duration;
+        if (l_duration > l_stats.m_MaxDurationUs) l_stats.m_MaxDurationUs = l_duration;
+
+        l_stats.m_LastMeasurementUs = l_start;
+
+        taskEXIT_CRITICAL(&m_StatsLock);
+
+        if (!l_ok)
+        {
+             g_AppLogger.Log("Failed to perform a measurement on sensor %d", f_idx+1);
+             g_AppLogger.Log("Sensor Identification: %s", l_sensor->GetSensorDescriptionString().c_str());
         }
         else
         {
-            ESP_LOGI(TAG, "Sensor %d: %s",i+1,m_Sensors[i]->GetSensorValueString().c_str());
+            ESP_LOGI(TAG, "Sensor %d: %s",f_idx+1,l_sensor->GetSensorValueString().c_str());
+
+            // --- feed the history
+
+            float l_values[SAMPLE_STORE_MAX_CHANNELS];
+            int   l_channels = g_SampleStore.GetChannelCount(f_idx);
+
+            for (int c = 0; c < l_channels; ++c) l_values[c] = l_sensor->GetChannelValue(c);
+
+            g_SampleStore.AddSample(f_idx, l_start / 1000, l_values);
+
+            g_EventStream.NotifySample(f_idx);
+        }
+
+        if (l_missed) ESP_LOGW(TAG, "Sensor %d missed its deadline (%lld us after due time)", f_idx+1, (long long)l_finish);
+        if (l_skipped) ESP_LOGW(TAG, "Sensor %d skipped %u period(s)", f_idx+1, (unsigned)l_skipped);
+
+        // --- sleep until the next due time (rounded up to the next tick)
+
+        int64_t     l_wait_us   = l_due - esp_timer_get_time();
+        TickType_t  l_ticks     = l_wait_us > 0 ? (TickType_t)((l_wait_us + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000)) : 0;
+
+        vTaskDelay(l_ticks > 0 ? l_ticks : 1);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+void SensorManager::StartAcquisition(void)
+{
+    for (int i = 0; i < SENSOR_CONFIG_SENSOR_CNT; ++i)
+    {
+        char l_name[configMAX_TASK_NAME_LEN];
+        snprintf(l_name, sizeof(l_name), "sensor%d", i+1);
+
+        ESP_LOGI(TAG, "Start acquisition of sensor %d: period %u ms, deadline %u ms", i+1,
+                 (unsigned)m_Sensors[i]->GetMeasurementPeriodMs(), (unsigned)m_Sensors[i]->GetMeasurementDeadlineMs());
+
+        if (xTaskCreate(sensor_acquisition_task, l_name, SENSOR_MANAGER_TASK_STACK, (void *)(intptr_t)i, SENSOR_MANAGER_TASK_PRIO, &m_Tasks[i]) != pdPASS)
+        {
+            ESP_LOGE(TAG, "Could not create the acquisition task of sensor %d", i+1);
+            g_AppLogger.Log("Could not start sensor %d", i+1);
         }
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
+void SensorManager::GetAcquisitionStats(int f_idx, SensorAcquisitionStats *f_stats)
+{
+    assert(f_idx < SENSOR_CONFIG_SENSOR_CNT);
+
+    taskENTER_CRITICAL(&m_StatsLock);
+    *f_stats = m_Stats[f_idx];
+    taskEXIT_CRITICAL(&m_StatsLock);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
 #define CONFIG_SENS(num) {  gpio_num_t l_pins[] = SENSOR_CONFIG_SENSOR ## num ## _PINS;\
                             int l_data[]        = SENSOR_CONFIG_SENSOR ## num ## _DATA;\
                             ESP_LOGI(TAG, "Configure Sensor %d: %d %d %d %d %d / %d %d %d %d %d", num, l_pins[0],l_pins[1],l_pins[2],l_pins[3],l_pins[4],l_data[0],l_data[1],l_data[2],l_data[3],l_data[4]);\
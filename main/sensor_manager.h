@@ -43,18 +43,52 @@
 
 
 #include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "csensor.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
+// --- every sensor gets its own acquisition task, so a slow or hanging sensor only
+//     delays itself
+
+#define SENSOR_MANAGER_TASK_STACK       4096
+#define SENSOR_MANAGER_TASK_PRIO        5
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- timing statistics of one sensor. Jitter is the delay between the due time and the
+//     start of a measurement, a missed deadline is a measurement finishing later than
+//     GetMeasurementDeadlineMs() after its due time. Skipped periods are due times which
+//     passed while the previous measurement was still running.
+
+typedef struct SensorAcquisitionStats_s
+{
+    uint32_t    m_Measurements;
+    uint32_t    m_Failures;
+    uint32_t    m_DeadlineMisses;
+    uint32_t    m_SkippedPeriods;
+
+    uint32_t    m_LastJitterUs;
+    uint32_t    m_MaxJitterUs;
+    uint64_t    m_SumJitterUs;
+
+    uint32_t    m_LastDurationUs;
+    uint32_t    m_MaxDurationUs;
+
+    int64_t     m_LastMeasurementUs;        // --- esp_timer_get_time() of the last start
+} SensorAcquisitionStats;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
 class SensorManager
 {
 public:
 
     // --- action functions
 
-    void ProcessMeasurements(void);
     void InitSensors(void);
+    void StartAcquisition(void);
 
     // --- low level getters
 
@@ -69,8 +103,20 @@ public:
         return SENSOR_CONFIG_SENSOR_CNT;
     }
 
+    // --- returns a consistent copy of the statistics of one sensor
+
+    void GetAcquisitionStats(int f_idx, SensorAcquisitionStats *f_stats);
+
+    // --- internal functions do not use
+
+    void AcquisitionLoop(int f_idx);
+
 private:
-    CSensor *m_Sensors[SENSOR_CONFIG_SENSOR_CNT];
+    CSensor                 *m_Sensors[SENSOR_CONFIG_SENSOR_CNT];
+    TaskHandle_t            m_Tasks[SENSOR_CONFIG_SENSOR_CNT];
+
+    SensorAcquisitionStats  m_Stats[SENSOR_CONFIG_SENSOR_CNT];
+    portMUX_TYPE            m_StatsLock = portMUX_INITIALIZER_UNLOCKED;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,95 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef VARINT_CODEC_H_
+#define	VARINT_CODEC_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- LEB128 style varints (7 bits per byte, MSB set on all but the last byte) and
+//     zigzag mapping of signed values, so small negative deltas stay short
+
+#define VARINT_MAX_LEN      5
+
+static inline uint32_t zigzag_encode(int32_t f_v)
+{
+    return ((uint32_t)f_v << 1) ^ (uint32_t)(f_v >> 31);
+}
+
+static inline int32_t zigzag_decode(uint32_t f_v)
+{
+    return (int32_t)(f_v >> 1) ^ -(int32_t)(f_v & 1);
+}
+
+static inline int varint_put(uint8_t *f_buf, uint32_t f_v)
+{
+    int l_len = 0;
+
+    while (f_v >= 0x80)
+    {
+        f_buf[l_len++] = (uint8_t)(f_v | 0x80);
+        f_v >>= 7;
+    }
+
+    f_buf[l_len++] = (uint8_t)f_v;
+    return l_len;
+}
+
+// --- returns the number of bytes consumed, 0 if the varint does not end within f_max bytes
+
+static inline int varint_get(const uint8_t *f_buf, int f_max, uint32_t *f_v)
+{
+    uint32_t l_v     = 0;
+    int      l_shift = 0;
+
+    for (int l_len = 0; l_len < f_max && l_len < VARINT_MAX_LEN; ++l_len)
+    {
+        l_v |= (uint32_t)(f_buf[l_len] & 0x7f) << l_shift;
+        l_shift += 7;
+
+        if (!(f_buf[l_len] & 0x80))
+        {
+            *f_v = l_v;
+            return l_len + 1;
+        }
+    }
+
+    return 0;
+}
+
+#endif
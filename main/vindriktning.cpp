@@ -38,19 +38,20 @@
 #include <cstring>
 #include <ctime>
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
 #include "driver/uart.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_task_wdt.h"
 
 #include "sensor_config.h"
+#include "frame_decoder.h"
 #include "vindriktning.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-#define BUF_SIZE (1024)
-#define STACK_SIZE (2048)
-#define DATAGRAM_LEN 30
+#define BUF_SIZE (128)
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -73,122 +74,22 @@ int stub_uart_read_bytes(uart_port_t uart_num, void* buf, uint32_t length, TickT
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-typedef enum {
-    PM1006_HEADER,
-    PM1006_LENGTH,
-    PM1006_DATA,
-    PM1006_CHECK
-} pm1006_state_t;
+// --- a PM1006 frame: 16 11 0b <df1..df16> <cs>, the values are big endian
 
-////////////////////////////////////////////////////////////////////////////////////////
+#define PM1006_FRAME_LEN_MIN    16
 
-class CReceiver
+static void vindriktning_frame(void *f_ctx, const uint8_t *f_frame, size_t f_len)
 {
+	if (f_len < PM1006_FRAME_LEN_MIN) return;
 
-public:
-
-	CReceiver(void)
-	{
-		_state 		= PM1006_HEADER;
-		_rxlen 		= 0;
-		_index 		= 0;
-		_checksum 	= 0;		
-
-		memset(_rxbuf, 0, sizeof(_rxbuf));
-	}
-
-	// --------------------------------------------
-
-	void dump(void)
-	{
-		char l_s[100];
-
-		strcpy(l_s,"Buffer:");
-
-		for (int i=0;i<_rxlen;++i)
-		{
-			char l_buf[5];
-			snprintf(l_buf,5,"%0x ",_rxbuf[i]);
-			strcat(l_s,l_buf);
-		}
-		ESP_LOGI(TAG, "%s",l_s); 
-
-	}
-
-	// --------------------------------------------
-
-	bool process_rx(uint8_t c)
-	{
-		//ESP_LOGI(TAG, "process_rx(%x): IN state %d checksum %d _rxlen %d index %d",c,_state,_checksum,_rxlen,_index);
-
-		switch (_state) {
-		case PM1006_HEADER:
-			_checksum = c;
-			if (c == 0x16) {
-				_state = PM1006_LENGTH;
-			}
-			break;
-
-		case PM1006_LENGTH:
-			_checksum += c;
-			if (c <= sizeof(_rxbuf)) {
-				_rxlen = c;
-				_index = 0;
-				_state = (_rxlen > 0) ? PM1006_DATA : PM1006_CHECK;
-			} 
-			else 
-			{
-				ESP_LOGE(TAG, "process_rx(%x): message too long for buffer!",c);
-				_state = PM1006_HEADER;
-			}
-			break;
-
-		case PM1006_DATA:
-			_checksum += c;
-			_rxbuf[_index++] = c;
-			if (_index == _rxlen) {
-				_state = PM1006_CHECK;
-			}
-			break;
-
-		case PM1006_CHECK:
-			_checksum += c;
-			_state = PM1006_HEADER;
-	
-			if (_checksum) ESP_LOGE(TAG, "process_rx(%x): checksum error. Expected 0, got %x",c,_checksum);
-
-			//ESP_LOGI(TAG, "process_rx(%x): OUT state %d checksum %d _rxlen %d index %d",c,_state,_checksum,_rxlen,_index);
-
-			return (_checksum == 0);
+	const uint16_t pm25 = (f_frame[5] << 8) | f_frame[6];
+	const uint16_t pm1  = (f_frame[9] << 8) | f_frame[10];
+	const uint16_t pm10 = (f_frame[13] << 8) | f_frame[14];
 
-		default:
-			_state = PM1006_HEADER;
-			break;
-		}
-
-		//ESP_LOGI(TAG, "process_rx(%x): OUT state %d checksum %d _rxlen %d index %d",c,_state,_checksum,_rxlen,_index);
-
-		return false;
-	}
+	ESP_LOGD(TAG, "Datagram valid pm25 %d pm1 %d pm10 %d",pm25,pm1,pm10);
 
-	// --------------------------------------------
-
-	uint8_t GetByte(int f_idx)
-	{
-		assert(f_idx < DATAGRAM_LEN);
-		
-		return _rxbuf[f_idx];
-	}
-
-	// --------------------------------------------
-
-    pm1006_state_t 	_state;
-    size_t 			_rxlen;
-    size_t 			_index;
-    uint8_t 		_rxbuf[DATAGRAM_LEN];
-    uint8_t 		_checksum;
- 
-};
+	((CVindriktning *)f_ctx)->SetValues(pm25,pm1,pm10);
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -201,6 +102,11 @@ CVindriktning::CVindriktning(void)
 
 	m_pin_data			= (gpio_num_t)0;
 	m_uart 				= (uart_port_t)0;
+	m_EventQueue		= NULL;
+
+	m_FramesOk			= 0;
+	m_FramesBad			= 0;
+	m_FramesDropped		= 0;
 	
 	m_pm1				= 0;
 	m_pm2				= 0;
@@ -211,56 +117,76 @@ CVindriktning::CVindriktning(void)
 
 static void uart_task(void *arg)
 {
-	CVindriktning 	*l_this = (CVindriktning *)arg;
-	
-	// ---- local instance of our shifter for the datagram
+	((CVindriktning *)arg)->ReceiveLoop();
+}
 
-	CReceiver l_receiver;
+////////////////////////////////////////////////////////////////////////////////////////
 
-	// ---- tell the monitor where we are 
+// --- the task only wakes up for driver events, frames are decoded as soon as the line
+//     is idle after them
 
-	ESP_LOGI(TAG,"UART read task started for uart %d on GPIO pin %d", l_this->GetUart(), l_this->GetDataPin());
+void CVindriktning::ReceiveLoop(void)
+{
+	FrameDecoder<FrameProtocolPm1006> 	l_decoder;
+	uart_event_t 						l_event;
+	uint8_t 							l_data[BUF_SIZE];
+	uint32_t 							l_overruns = 0;
 
-    // --- Configure a temporary buffer for the incoming data
+	// ---- tell the monitor where we are 
 
-    uint8_t *l_data = (uint8_t *) malloc(BUF_SIZE);
-	assert(l_data);
+	ESP_LOGI(TAG,"UART read task started for uart %d on GPIO pin %d", GetUart(), GetDataPin());
 
 	// --- never ending loop 
 
 	while (1) 
 	{
-        // --- Read data from the UART. This might be one or more bytes in the middle of a datagram
+		if (xQueueReceive(m_EventQueue, &l_event, portMAX_DELAY) != pdTRUE) continue;
 
-        int len = uart_read_bytes(l_this->GetUart(), l_data, BUF_SIZE, 20 / portTICK_PERIOD_MS);
-
-		// --- add them to the shifter
-
-		for (int i=0;i < len;++i)
+		switch (l_event.type)
 		{
-			//ESP_LOGI(TAG, "received byte %x",l_data[i]);
-
-			if (l_receiver.process_rx(l_data[i]))
+			case UART_DATA:
 			{
-					// --- header and length are not stored in the receiver. We start with "0x0B" --> idx0, DF1 --> idx 1
+				// --- read all buffered bytes, the event size may be behind if events were merged
 
-					const uint16_t pm25 = (l_receiver.GetByte(3) << 8) | l_receiver.GetByte(4);
-					const uint16_t pm1  = (l_receiver.GetByte(7) << 8) | l_receiver.GetByte(8);
-					const uint16_t pm10 = (l_receiver.GetByte(11) << 8) | l_receiver.GetByte(12);
+				size_t l_avail = 0;
+				uart_get_buffered_data_len(m_uart, &l_avail);
 
-					ESP_LOGI(TAG, "Datagram valid pm25 %d pm1 %d pm10 %d",pm25,pm1,pm10);
+				while (l_avail > 0)
+				{
+					int len = uart_read_bytes(m_uart, l_data, l_avail < sizeof(l_data) ? l_avail : sizeof(l_data), 0);
+					if (len <= 0) break;
 
-					//l_receiver.dump();
+					l_avail -= len;
 
-					l_this->SetValues(pm25,pm1,pm10);
+					m_FramesOk += l_decoder.Feed(l_data, len, vindriktning_frame, this);
+				}
+
+				m_FramesBad 	= l_decoder.GetChecksumErrorCount();
+				m_FramesDropped = l_decoder.GetLengthErrorCount() + l_overruns;
+				break;
 			}
-		}
 
-		vTaskDelay(3000 / portTICK_PERIOD_MS);
+			case UART_FIFO_OVF:
+			case UART_BUFFER_FULL:
+			{
+				// --- bytes were lost, so is the frame in progress. Start over with an empty
+				//     buffer and queue.
 
-    }
-}
+				ESP_LOGW(TAG, "UART %d overrun (event %d)", m_uart, l_event.type);
 
+				uart_flush_input(m_uart);
+				xQueueReset(m_EventQueue);
+				l_decoder.Reset();
+
+				m_FramesDropped = l_decoder.GetLengthErrorCount() + ++l_overruns;
+				break;
+			}
+
+			default:
+				break;
+		}
+	}
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -283,13 +209,21 @@ bool CVindriktning::SetupSensor(gpio_num_t f_data,uart_port_t f_uart)
         .source_clk = UART_SCLK_APB,
     };
 
-    ESP_ERROR_CHECK(uart_driver_install(m_uart, BUF_SIZE * 2, 0, 0, NULL, 0));
+    ESP_ERROR_CHECK(uart_driver_install(m_uart, VINDRIKTNING_RX_BUF_SIZE, 0, VINDRIKTNING_EVENT_QUEUE_LEN, &m_EventQueue, 0));
     ESP_ERROR_CHECK(uart_param_config(m_uart, &uart_config));
     ESP_ERROR_CHECK(uart_set_pin(m_uart, UART_PIN_NO_CHANGE, m_pin_data, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE));
 
+	// --- a UART_DATA event shortly after the last byte of a frame
+
+    ESP_ERROR_CHECK(uart_set_rx_timeout(m_uart, VINDRIKTNING_RX_TOUT));
+
 	// --- now start a free rtos task to receive the sensor data
 
-    xTaskCreate(uart_task, "CVindriktning__uart_task", STACK_SIZE, this, 10, NULL);
+    if (xTaskCreate(uart_task, "CVindriktning__uart_task", VINDRIKTNING_TASK_STACK, this, VINDRIKTNING_TASK_PRIO, NULL) != pdPASS)
+	{
+		ESP_LOGE(TAG, "Could not create the UART task");
+		return false;
+	}
 
 	m_Initialized = true;
 
@@ -338,39 +272,33 @@ std::string CVindriktning::GetSensorDescriptionString(void)
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void CVindriktning::AddValuesToJSON_MQTT(cJSON *f_root)
+void CVindriktning::AddValuesToJSON_MQTT(JsonWriter &f_writer)
 {
-	cJSON_AddNumberToObject(f_root, "pm1", GetPM1());
-	cJSON_AddNumberToObject(f_root, "pm2", GetPM2());
-	cJSON_AddNumberToObject(f_root, "pm10", GetPM10());	
+	f_writer.Number("pm1", GetPM1());
+	f_writer.Number("pm2", GetPM2());
+	f_writer.Number("pm10", GetPM10());
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-void CVindriktning::AddValuesToJSON_API(cJSON *f_root)
+void CVindriktning::AddValuesToJSON_API(JsonWriter &f_writer)
 {
-    cJSON *pm1 	= cJSON_CreateObject();
-    cJSON *pm2 	= cJSON_CreateObject();
-    cJSON *pm10 = cJSON_CreateObject();
+	AddApiValue(f_writer, "pm1", "ppm (1 um)", "%.2f", GetPM1(), "Small particles");
+	AddApiValue(f_writer, "pm2", "ppm (2.5 um)", "%.2f", GetPM2(), "Medium particles");
+	AddApiValue(f_writer, "pm10", "ppm (10 um)", "%.2f", GetPM10(), "Big particles");
 
-	cJSON_AddStringToObject(pm1, "unit", "ppm (1 um)");
-	cJSON_AddStringToObject(pm1, "value", float_2_string("%.2f",GetPM1()));
-	cJSON_AddStringToObject(pm1, "text", "Small particles");
-
-	cJSON_AddStringToObject(pm2, "unit", "ppm (2.5 um)");
-	cJSON_AddStringToObject(pm2, "value", float_2_string("%.2f",GetPM2()));
-	cJSON_AddStringToObject(pm2, "text", "Medium particles");
-
-	cJSON_AddStringToObject(pm10, "unit", "ppm (10 um)");
-	cJSON_AddStringToObject(pm10, "value", float_2_string("%.2f",GetPM10()));
-	cJSON_AddStringToObject(pm10, "text", "Big particles");
-
-	cJSON_AddItemToObject(f_root,"pm1",pm1);
-	cJSON_AddItemToObject(f_root,"pm2",pm2);
-	cJSON_AddItemToObject(f_root,"pm10",pm10);
+	f_writer.String("SensorType", "Vindriktning Particles Sensor");
+}
 
-	cJSON_AddStringToObject(f_root, "SensorType", "Vindriktning Particles Sensor");
+////////////////////////////////////////////////////////////////////////////////////////
 
+void CVindriktning::AddStatsToJSON(JsonWriter &f_writer)
+{
+	f_writer.BeginObject("frames");
+	f_writer.Int("valid", GetFrameCount());
+	f_writer.Int("checksum_errors", GetChecksumErrorCount());
+	f_writer.Int("dropped", GetDroppedFrameCount());
+	f_writer.EndObject();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -389,3 +317,29 @@ bool CVindriktning::SetupSensor(gpio_num_t *f_pins,int *f_data)
 
 #endif
 }
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *g_CVindriktning_Channels[] = { "pm1", "pm2", "pm10" };
+
+int CVindriktning::GetChannelCount(void)
+{
+	return sizeof(g_CVindriktning_Channels) / sizeof(g_CVindriktning_Channels[0]);
+}
+
+const char *CVindriktning::GetChannelName(int f_ch)
+{
+	return f_ch >= 0 && f_ch < GetChannelCount() ? g_CVindriktning_Channels[f_ch] : "";
+}
+
+float CVindriktning::GetChannelValue(int f_ch)
+{
+	switch (f_ch)
+	{
+		case 0: return GetPM1();
+		case 1: return GetPM2();
+		case 2: return GetPM10();
+	}
+
+	return 0;
+}
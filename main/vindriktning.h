@@ -39,10 +39,26 @@
 
 #include <unistd.h>
 #include <stdio.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "driver/uart.h"
 #include "csensor.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
+// --- the receive task sleeps on the UART event queue. The driver reports the received
+//     bytes when the line has been idle for VINDRIKTNING_RX_TOUT characters, i.e. right
+//     after every frame of the sensor.
+
+#define VINDRIKTNING_RX_BUF_SIZE        512         // --- driver ring, about 25 frames
+#define VINDRIKTNING_EVENT_QUEUE_LEN    8
+#define VINDRIKTNING_RX_TOUT            4
+#define VINDRIKTNING_TASK_STACK         2560
+#define VINDRIKTNING_TASK_PRIO          5
+
+////////////////////////////////////////////////////////////////////////////////////////
+
 class CVindriktning : public CSensor
 {
 
@@ -73,11 +89,20 @@ public:
 		return m_pm10;
 	}
 
+	// --- frame counters of the receiver: valid frames, checksum errors and frames lost to
+	//     overruns or bad lengths
+
+	uint32_t GetFrameCount(void) const { return m_FramesOk; }
+	uint32_t GetChecksumErrorCount(void) const { return m_FramesBad; }
+	uint32_t GetDroppedFrameCount(void) const { return m_FramesDropped; }
+
 	// --- internal functions do not use
 
 	gpio_num_t GetDataPin(void) { return m_pin_data; }
 	uart_port_t GetUart(void) { return m_uart; }
 
+	void ReceiveLoop(void);
+
 	void SetValues(const uint16_t f_pm2,const uint16_t f_pm1,const uint16_t f_pm10)
 	{
 		m_pm2 	= f_pm2;
@@ -88,8 +113,16 @@ public:
 	virtual std::string GetSensorValueString(void);
     virtual std::string GetSensorDescriptionString(void);
  	virtual bool PerformMeasurement(void);
-    virtual void AddValuesToJSON_MQTT(cJSON *f_root);
-    virtual void AddValuesToJSON_API(cJSON *f_root);
+    virtual void AddValuesToJSON_MQTT(JsonWriter &f_writer);
+    virtual void AddValuesToJSON_API(JsonWriter &f_writer);
+    virtual void AddStatsToJSON(JsonWriter &f_writer);
+	virtual int GetChannelCount(void);
+	virtual const char *GetChannelName(int f_ch);
+	virtual float GetChannelValue(int f_ch);
+
+	// --- the values are received by the UART task, a measurement just checks them
+
+	virtual uint32_t GetMeasurementDeadlineMs(void) { return 50; }
  	virtual bool SetupSensor(gpio_num_t *f_pins,int *f_data);	
 
 private:
@@ -100,6 +133,11 @@ private:
 	
 	gpio_num_t m_pin_data;
 	uart_port_t m_uart;
+	QueueHandle_t m_EventQueue;
+
+	std::atomic<uint32_t> m_FramesOk;
+	std::atomic<uint32_t> m_FramesBad;
+	std::atomic<uint32_t> m_FramesDropped;
 	
 	bool m_Initialized;
 };
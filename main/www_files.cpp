@@ -0,0 +1,118 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_vfs.h"
+
+#include "www_files.h"
+#include "www_manifest.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *TAG = "WwwManifest";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+WwwManifest g_WwwManifest;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- an OTA update only replaces the app, not the www partition. If the partition does
+//     not match the manifest anymore, its ETags would be wrong: then the manifest is not
+//     used and the web server falls back to reading the file system. The partition holds
+//     the build id of its files (www_manifest.cmake), sizes alone would miss small edits.
+
+esp_err_t WwwManifest::InitManifest(const char *f_base_path)
+{
+    m_Valid = false;
+
+    int l_count = GetFileCount();
+
+    if (l_count == 0)
+    {
+        ESP_LOGI(TAG, "The manifest is empty");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    char l_path[ESP_VFS_PATH_MAX + 128];
+    char l_id[sizeof(WWW_MANIFEST_ID) + 1] = { 0 };
+
+    snprintf(l_path, sizeof(l_path), "%s/%s", f_base_path, WWW_MANIFEST_ID_FILE);
+
+    FILE *l_file = fopen(l_path, "r");
+
+    if (l_file)
+    {
+        fread(l_id, 1, sizeof(l_id) - 1, l_file);
+        fclose(l_file);
+    }
+
+    if (strcmp(l_id, WWW_MANIFEST_ID) != 0)
+    {
+        ESP_LOGW(TAG, "%s does not match the manifest, the www partition is from another build", l_path);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    ESP_LOGI(TAG, "%d files in the manifest", l_count);
+
+    m_Valid = true;
+
+    return ESP_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the few files of the web app do not need anything but a linear search
+
+const WwwFile *WwwManifest::FindFile(const char *f_uri)
+{
+    if (!m_Valid) return NULL;
+
+    for (const WwwFile *l_file = g_WwwManifestFiles; l_file->m_Uri; ++l_file)
+    {
+        if (strcmp(l_file->m_Uri, f_uri) == 0) return l_file;
+    }
+
+    return NULL;
+}
+
+int WwwManifest::GetFileCount(void)
+{
+    return sizeof(g_WwwManifestFiles) / sizeof(g_WwwManifestFiles[0]) - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
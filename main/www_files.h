@@ -0,0 +1,90 @@
+/*
+    --------------------------------------------------------------------------------
+
+    way2.net ESPLogger       
+    
+    ESP32 based IoT Device for various sensor logging featuring an MQTT client and 
+    REST API access. 
+    
+    --------------------------------------------------------------------------------
+
+    Copyright (c) 2024 Tim Hagemann / way2.net Services
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+    --------------------------------------------------------------------------------
+*/
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef WWW_FILES_H_
+#define	WWW_FILES_H_
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// --- the files of the web app as they were packed into the "www" partition. The table
+//     is generated at build time (www_manifest.cmake), so the web server knows the ETag
+//     of a file without reading it and can answer a revalidation with 304.
+
+#define WWW_FILE_GZIP               0x01    // --- stored compressed, m_File ends with ".gz"
+#define WWW_FILE_IMMUTABLE          0x02    // --- content hash in the name, cached for a year
+
+#define WWW_MANIFEST_ID_FILE        ".manifest_id"  // --- build id of the files, in the partition
+
+typedef struct WwwFile_s
+{
+    const char  *m_Uri;             // --- as requested, e.g. "/assets/index-2b6c1d.js"
+    const char  *m_File;            // --- below the mount point, e.g. "/assets/index-2b6c1d.js.gz"
+    uint32_t    m_Size;             // --- of the stored file
+    const char  *m_ETag;            // --- including the quotes
+    uint8_t     m_Flags;
+} WwwFile;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class WwwManifest
+{
+public:
+
+    // --- action functions
+
+    esp_err_t InitManifest(const char *f_base_path);
+
+    // --- getters
+
+    const WwwFile *FindFile(const char *f_uri);
+    int GetFileCount(void);
+
+private:
+
+    bool    m_Valid = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+extern WwwManifest g_WwwManifest;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
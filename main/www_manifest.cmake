@@ -0,0 +1,60 @@
+# ----- generates the manifest of the web app, i.e. of the files in the "www" partition:
+#       the URI each file is served under, its size and an ETag (part of the MD5 of the
+#       stored file). Files vite compressed are stored with ".gz" and served without it.
+#
+#       cmake -DWWW_DIR=<front/webapp/dist> -DOUT=<header> -P www_manifest.cmake
+#
+#       A missing WWW_DIR gives an empty manifest. The header is only rewritten if it
+#       changes, so an unchanged web app does not recompile anything.
+#
+#       The build id (the MD5 of all file names and MD5s) goes into the header and into
+#       WWW_DIR/.manifest_id, which is packed into the partition with the other files.
+#       The firmware compares both to know if the partition is the one of its manifest.
+
+set(l_id_file ".manifest_id")
+set(l_id "")
+
+set(l_out "static const WwwFile g_WwwManifestFiles[] =\n{\n")
+
+if(WWW_DIR AND EXISTS "${WWW_DIR}")
+    file(GLOB_RECURSE l_files RELATIVE "${WWW_DIR}" "${WWW_DIR}/*")
+    list(REMOVE_ITEM l_files "${l_id_file}")
+    list(SORT l_files)
+
+    foreach(l_file ${l_files})
+        file(SIZE "${WWW_DIR}/${l_file}" l_size)
+        file(MD5 "${WWW_DIR}/${l_file}" l_md5)
+        string(SUBSTRING "${l_md5}" 0 16 l_etag)
+        string(APPEND l_id "${l_file} ${l_md5}\n")
+
+        set(l_uri "/${l_file}")
+        set(l_flags "0")
+
+        if(l_uri MATCHES "\\.gz$")
+            string(REGEX REPLACE "\\.gz$" "" l_uri "${l_uri}")
+            set(l_flags "WWW_FILE_GZIP")
+        endif()
+
+        # ----- vite puts the bundles with a content hash in their name to assets/
+
+        if(l_uri MATCHES "^/assets/" AND l_flags STREQUAL "0")
+            set(l_flags "WWW_FILE_IMMUTABLE")
+        elseif(l_uri MATCHES "^/assets/")
+            string(APPEND l_flags " | WWW_FILE_IMMUTABLE")
+        endif()
+
+        string(APPEND l_out "    { \"${l_uri}\", \"/${l_file}\", ${l_size}, \"\\\"${l_etag}\\\"\", ${l_flags} },\n")
+    endforeach()
+
+    string(MD5 l_id "${l_id}")
+
+    file(WRITE "${OUT}.id.tmp" "${l_id}")
+    configure_file("${OUT}.id.tmp" "${WWW_DIR}/${l_id_file}" COPYONLY)
+endif()
+
+string(APPEND l_out "    { NULL, NULL, 0, NULL, 0 }\n};\n")
+
+set(l_out "// ----- generated by www_manifest.cmake from the web app, do not edit\n\n#define WWW_MANIFEST_ID \"${l_id}\"\n\n${l_out}")
+
+file(WRITE "${OUT}.tmp" "${l_out}")
+configure_file("${OUT}.tmp" "${OUT}" COPYONLY)